@@ -103,6 +103,7 @@ target_link_libraries(fboss_types
 
 add_library(core
   fboss/agent/AclNexthopHandler.cpp
+  fboss/agent/AclPriorityAllocator.cpp
   fboss/agent/ApplyThriftConfig.cpp
   fboss/agent/ArpCache.cpp
   fboss/agent/ArpHandler.cpp
@@ -134,6 +135,7 @@ add_library(core
   fboss/agent/NeighborUpdater.cpp
   fboss/agent/NeighborUpdaterImpl.cpp
   fboss/agent/NeighborUpdaterNoopImpl.cpp
+  fboss/agent/PeriodicTxScheduler.cpp
   fboss/agent/PortUpdateHandler.cpp
   fboss/agent/ResolvedNexthopMonitor.cpp
   fboss/agent/ResolvedNexthopProbe.cpp
@@ -196,6 +198,7 @@ target_link_libraries(core
   ${NETLINK3}
   ${NETLINKROUTE3}
   thread_heartbeat
+  function_call_time_reporter
 )
 
 add_library(error
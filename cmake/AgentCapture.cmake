@@ -17,3 +17,14 @@ target_link_libraries(capture
   packet_observer
   Folly::folly
 )
+
+add_executable(pkt_capture_benchmark
+  fboss/agent/capture/test/PktCaptureBenchmark.cpp
+)
+
+target_link_libraries(pkt_capture_benchmark
+  capture
+  pkt
+  Folly::folly
+  Folly::follybenchmark
+)
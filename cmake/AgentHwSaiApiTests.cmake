@@ -55,3 +55,20 @@ set_target_properties(api_test PROPERTIES COMPILE_FLAGS
 )
 
 gtest_discover_tests(api_test)
+
+add_executable(sai_api_create_benchmark
+    fboss/agent/hw/sai/api/tests/SaiApiCreateBenchmark.cpp
+)
+
+target_link_libraries(sai_api_create_benchmark
+    fake_sai
+    sai_api
+    Folly::folly
+    Folly::follybenchmark
+)
+
+set_target_properties(sai_api_create_benchmark PROPERTIES COMPILE_FLAGS
+  "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+  -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+  -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+)
@@ -24,6 +24,7 @@ add_library(sai_tracer
   fboss/agent/hw/sai/tracer/QueueApiTracer.cpp
   fboss/agent/hw/sai/tracer/RouteApiTracer.cpp
   fboss/agent/hw/sai/tracer/RouterInterfaceApiTracer.cpp
+  fboss/agent/hw/sai/tracer/SaiBinaryTrace.cpp
   fboss/agent/hw/sai/tracer/SaiTracer.cpp
   fboss/agent/hw/sai/tracer/SamplePacketApiTracer.cpp
   fboss/agent/hw/sai/tracer/SchedulerApiTracer.cpp
@@ -60,3 +61,19 @@ target_link_options(sai_tracer
   "LINKER:-wrap,sai_api_uninitialize"
   "LINKER:-wrap,sai_get_object_key"
 )
+
+add_executable(sai_binary_log_converter
+  fboss/agent/hw/sai/tracer/SaiBinaryLogConverter.cpp
+)
+
+target_link_libraries(sai_binary_log_converter
+  sai_tracer
+  fake_sai
+  Folly::folly
+)
+
+set_target_properties(sai_binary_log_converter PROPERTIES COMPILE_FLAGS
+  "-DSAI_VER_MAJOR=${SAI_VER_MAJOR} \
+  -DSAI_VER_MINOR=${SAI_VER_MINOR}  \
+  -DSAI_VER_RELEASE=${SAI_VER_RELEASE}"
+)
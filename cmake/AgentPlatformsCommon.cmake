@@ -3,9 +3,50 @@
 # In general, libraries and binaries in fboss/foo/bar are built by
 # cmake/FooBar.cmake
 
+# Compiles the JSON platform mappings embedded in these sources into compact
+# thrift at build time, see PrecompiledPlatformMappings.h
+add_executable(platform_mapping_compiler
+  fboss/agent/platforms/common/PlatformMappingCompiler.cpp
+)
+
+target_link_libraries(platform_mapping_compiler
+  platform_config_cpp2
+  Folly::folly
+)
+
+set(PRECOMPILED_PLATFORM_MAPPING_SOURCES
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/cloud_ripper/CloudRipperPlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/ebb_lab/Wedge400CEbbLabPlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/elbert/Elbert16QPimPlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/fuji/Fuji16QPimPlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/lassen/LassenPlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/sandia/SandiaPlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/wedge100/Wedge100PlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/wedge40/Wedge40PlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/wedge400/Wedge400AcadiaPlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/wedge400/Wedge400GrandTetonPlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/wedge400/Wedge400PlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/wedge400c/Wedge400CPlatformMapping.cpp
+  ${CMAKE_CURRENT_SOURCE_DIR}/fboss/agent/platforms/common/yamp/Yamp16QPimPlatformMapping.cpp
+)
+
+set(PRECOMPILED_PLATFORM_MAPPINGS_GEN
+  ${CMAKE_CURRENT_BINARY_DIR}/fboss/agent/platforms/common/PrecompiledPlatformMappings-gen.cpp
+)
+
+add_custom_command(
+  OUTPUT ${PRECOMPILED_PLATFORM_MAPPINGS_GEN}
+  COMMAND platform_mapping_compiler
+    --output ${PRECOMPILED_PLATFORM_MAPPINGS_GEN}
+    ${PRECOMPILED_PLATFORM_MAPPING_SOURCES}
+  DEPENDS platform_mapping_compiler ${PRECOMPILED_PLATFORM_MAPPING_SOURCES}
+)
+
 add_library(platform_mapping
   fboss/agent/platforms/common/MultiPimPlatformMapping.cpp
   fboss/agent/platforms/common/PlatformMapping.cpp
+  fboss/agent/platforms/common/PrecompiledPlatformMappings.cpp
+  ${PRECOMPILED_PLATFORM_MAPPINGS_GEN}
 )
 
 target_link_libraries(platform_mapping
@@ -44,3 +44,17 @@ target_link_libraries(fsdb_syncer
   FBThrift::thriftcpp2
   fb303::fb303
 )
+
+add_library(fsdb_storage_replica
+  fboss/fsdb/client/FsdbStorageReplica.h
+)
+
+set_target_properties(fsdb_storage_replica PROPERTIES LINKER_LANGUAGE CXX)
+
+target_link_libraries(fsdb_storage_replica
+  fsdb_oper_cpp2
+  fsdb_pub_sub
+  cow_storage
+  thrift_cow_visitors
+  Folly::folly
+)
@@ -3,10 +3,14 @@ add_executable(fsdb_client_test
   fboss/fsdb/client/test/FsdbPubSubManagerTest.cpp
   fboss/fsdb/client/test/FsdbStreamClientTest.cpp
   fboss/fsdb/client/test/FsdbPublisherTest.cpp
+  fboss/fsdb/client/test/FsdbStorageReplicaTest.cpp
 )
 
 target_link_libraries(fsdb_client_test
   fsdb_pub_sub
+  fsdb_storage_replica
+  thriftpath_test_cpp2
+  thrift_cow_serializer
   error
   ${GTEST}
   ${LIBGMOCK_LIBRARIES}
@@ -121,5 +121,6 @@ add_library(thread_heartbeat
 )
 
 target_link_libraries(thread_heartbeat
+  fb303::fb303
   Folly::folly
 )
@@ -5,6 +5,7 @@
 
 add_library(snapshot_manager
   fboss/lib/link_snapshots/SnapshotManager.cpp
+  fboss/lib/link_snapshots/SnapshotRecorder.cpp
 )
 
 target_link_libraries(snapshot_manager
@@ -12,4 +13,15 @@ target_link_libraries(snapshot_manager
   fboss_cpp2
   phy_cpp2
   alert_logger
+  fboss_error
+  Folly::folly
+)
+
+add_executable(link_snapshot_reader
+  fboss/lib/link_snapshots/SnapshotRecorderReader.cpp
+)
+
+target_link_libraries(link_snapshot_reader
+  snapshot_manager
+  Folly::folly
 )
@@ -39,6 +39,7 @@ set_target_properties(cow_storage PROPERTIES LINKER_LANGUAGE CXX)
 target_link_libraries(cow_storage
   thrift_cow_nodes
   thrift_cow_visitors
+  thrift_storage_visitors
   Folly::folly
 )
 
@@ -5,6 +5,8 @@
 
 add_library(
   thrift_storage_visitors
+  fboss/thrift_storage/visitors/CompactPathCodec.h
+  fboss/thrift_storage/visitors/CompactPathVisitor.h
   fboss/thrift_storage/visitors/NameToPathVisitor.h
   fboss/thrift_storage/visitors/ThriftDeltaVisitor.h
   fboss/thrift_storage/visitors/ThriftLeafVisitor.h
@@ -14,6 +16,7 @@ add_library(
 target_compile_options(thrift_storage_visitors PUBLIC "-ftemplate-backtrace-limit=0")
 
 target_link_libraries(thrift_storage_visitors
+  thrift_cow_nodes
   fsdb_oper_cpp2
   Folly::folly
   FBThrift::thriftcpp2
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/AclPriorityAllocator.h"
+
+#include "fboss/agent/FbossError.h"
+
+#include <algorithm>
+
+namespace facebook::fboss {
+
+AclPriorityAllocator::AclPriorityAllocator(int start, int end, int gap)
+    : start_(start), end_(end), gap_(gap) {
+  if (start_ >= end_ || gap_ < 1) {
+    throw FbossError(
+        "Invalid ACL priority range [",
+        start_,
+        ", ",
+        end_,
+        ") with gap ",
+        gap_);
+  }
+}
+
+std::vector<int> AclPriorityAllocator::allocate(
+    const std::vector<std::optional<int>>& previous) const {
+  auto numEntries = previous.size();
+  if (static_cast<int64_t>(numEntries) > static_cast<int64_t>(end_) - start_) {
+    throw FbossError(
+        "Cannot fit ",
+        numEntries,
+        " ACL entries in priorities [",
+        start_,
+        ", ",
+        end_,
+        ")");
+  }
+
+  auto keep = keepPrevious(previous);
+  std::vector<int> priorities(numEntries);
+  size_t first = 0;
+  while (first < numEntries) {
+    if (keep[first]) {
+      priorities[first] = *previous[first];
+      ++first;
+      continue;
+    }
+    auto last = first;
+    while (last < numEntries && !keep[last]) {
+      ++last;
+    }
+    // No room left between the neighbours, so move them as well, preferring
+    // the entries that follow. Placing all entries always succeeds, so this
+    // terminates.
+    while (!place(previous, first, last, &priorities)) {
+      if (last < numEntries) {
+        keep[last] = false;
+        while (last < numEntries && !keep[last]) {
+          ++last;
+        }
+      } else {
+        --first;
+        keep[first] = false;
+      }
+    }
+    first = last;
+  }
+  return priorities;
+}
+
+std::vector<bool> AclPriorityAllocator::keepPrevious(
+    const std::vector<std::optional<int>>& previous) const {
+  // Longest strictly increasing subsequence of the previous priorities in
+  // range. tails[len] is the entry ending the increasing subsequence of
+  // length len + 1 with the smallest last priority.
+  constexpr auto kNone = static_cast<size_t>(-1);
+  std::vector<size_t> tails;
+  std::vector<size_t> predecessor(previous.size(), kNone);
+  for (size_t i = 0; i < previous.size(); ++i) {
+    if (!previous[i] || *previous[i] < start_ || *previous[i] >= end_) {
+      continue;
+    }
+    auto it = std::lower_bound(
+        tails.begin(), tails.end(), *previous[i], [&](size_t entry, int prio) {
+          return *previous[entry] < prio;
+        });
+    if (it != tails.begin()) {
+      predecessor[i] = *(it - 1);
+    }
+    if (it == tails.end()) {
+      tails.push_back(i);
+    } else {
+      *it = i;
+    }
+  }
+
+  std::vector<bool> keep(previous.size(), false);
+  for (auto i = tails.empty() ? kNone : tails.back(); i != kNone;
+       i = predecessor[i]) {
+    keep[i] = true;
+  }
+  return keep;
+}
+
+bool AclPriorityAllocator::place(
+    const std::vector<std::optional<int>>& previous,
+    size_t first,
+    size_t last,
+    std::vector<int>* priorities) const {
+  int64_t count = last - first;
+  int64_t lo = first == 0 ? start_ - 1 : (*priorities)[first - 1];
+  int64_t hi = last == previous.size() ? end_ : *previous[last];
+
+  if (last == previous.size()) {
+    // Nothing follows, so append with the full gap if it fits
+    int64_t next = first == 0 ? start_ : lo + gap_;
+    if (next + (count - 1) * gap_ < end_) {
+      for (auto i = first; i < last; ++i, next += gap_) {
+        (*priorities)[i] = next;
+      }
+      return true;
+    }
+  }
+  if (hi - lo - 1 < count) {
+    return false;
+  }
+  // Spread the entries evenly between the neighbours, to leave room for
+  // later inserts on either side of each of them
+  for (int64_t i = 0; i < count; ++i) {
+    (*priorities)[first + i] = lo + (hi - lo) * (i + 1) / (count + 1);
+  }
+  return true;
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <optional>
+#include <vector>
+
+namespace facebook::fboss {
+
+/*
+ * AclPriorityAllocator assigns priorities to an ordered list of ACL entries
+ * from the range [start, end), leaving gaps between consecutive entries.
+ *
+ * Hardware needs to reprogram an ACL entry whenever its priority changes, so
+ * numbering entries one after the other would move every entry that follows
+ * a newly inserted one. Instead, entries keep the priority they had before
+ * as long as they stay in the same order, and new or reordered entries are
+ * placed in the gap between their neighbours. Only when a gap runs out are
+ * the neighbouring entries spread out again, as few of them as it takes.
+ */
+class AclPriorityAllocator {
+ public:
+  AclPriorityAllocator(int start, int end, int gap);
+
+  /*
+   * Returns a strictly increasing priority for each entry, given the
+   * priority it had before, if any. Throws FbossError if the entries don't
+   * fit in the range.
+   */
+  std::vector<int> allocate(
+      const std::vector<std::optional<int>>& previous) const;
+
+ private:
+  // Largest set of entries which can keep their previous priority
+  std::vector<bool> keepPrevious(
+      const std::vector<std::optional<int>>& previous) const;
+  // Place entries [first, last) between their neighbours, if there is room
+  bool place(
+      const std::vector<std::optional<int>>& previous,
+      size_t first,
+      size_t last,
+      std::vector<int>* priorities) const;
+
+  const int start_;
+  const int end_;
+  const int gap_;
+};
+
+} // namespace facebook::fboss
@@ -17,6 +17,7 @@
 #include <string>
 
 #include "fboss/agent/AclNexthopHandler.h"
+#include "fboss/agent/AclPriorityAllocator.h"
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/LacpTypes.h"
 #include "fboss/agent/LoadBalancerConfigApplier.h"
@@ -64,6 +65,7 @@
 #include <folly/Range.h>
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <utility>
 #include <vector>
 
@@ -89,11 +91,19 @@ DEFINE_bool(
     false,
     "Allow multiple acl tables (acl table group)");
 
+DEFINE_int32(
+    acl_priority_gap,
+    16,
+    "Gap left between the priorities of consecutive ACL entries, so entries "
+    "can be inserted without renumbering the ones that follow");
+
 namespace {
 
 const uint8_t kV6LinkLocalAddrMask{64};
 // Needed until CoPP is removed from code and put into config
 const int kAclStartPriority = 100000;
+// CPU acls are numbered from 1 up to the data plane acls
+const int kCpuAclStartPriority = 1;
 
 // Only one buffer pool is supported systemwide. Variable to track the name
 // and validate during a config change.
@@ -291,6 +301,10 @@ class ThriftConfigApplier {
       cfg::AclStage aclStage,
       std::vector<cfg::AclEntry> configEntries,
       std::optional<std::string> tableName = std::nullopt);
+  std::shared_ptr<AclEntry> getOrigAcl(
+      cfg::AclStage aclStage,
+      const std::string& name,
+      const std::optional<std::string>& tableName) const;
   std::shared_ptr<AclEntry> createAcl(
       const cfg::AclEntry* config,
       int priority,
@@ -2179,25 +2193,26 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls(
   AclMap::NodeContainer newAcls;
   bool changed = false;
   int numExistingProcessed = 0;
-  int priority = kAclStartPriority;
-  int cpuPriority = 1;
+
+  // Acls in the order they are matched in, along with their actions. Their
+  // priorities are only assigned once all of them are known.
+  struct PendingAcl {
+    const cfg::AclEntry* config;
+    std::optional<MatchAction> action;
+    bool enable;
+  };
+  std::vector<PendingAcl> dataPlaneAcls;
+  std::vector<PendingAcl> cpuAcls;
 
   // Start with the DROP acls, these should have highest priority
-  auto acls = folly::gen::from(configEntries) |
+  folly::gen::from(configEntries) |
       folly::gen::filter([](const cfg::AclEntry& entry) {
-                return *entry.actionType() == cfg::AclActionType::DENY;
-              }) |
-      folly::gen::map([&](const cfg::AclEntry& entry) {
-                auto acl = updateAcl(
-                    aclStage,
-                    entry,
-                    priority++,
-                    &numExistingProcessed,
-                    &changed,
-                    tableName);
-                return std::make_pair(acl->getID(), acl);
-              }) |
-      folly::gen::appendTo(newAcls);
+        return *entry.actionType() == cfg::AclActionType::DENY;
+      }) |
+      folly::gen::map([](const cfg::AclEntry& entry) {
+        return PendingAcl{&entry, std::nullopt, true};
+      }) |
+      folly::gen::appendTo(dataPlaneAcls);
 
   // Let's get a map of acls to name so we don't have to search the acl list
   // for every new use
@@ -2217,16 +2232,15 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls(
 
   // Generates new acls from template
   auto addToAcls = [&](const cfg::TrafficPolicyConfig& policy,
-                       bool isCoppAcl = false)
-      -> const std::vector<std::pair<std::string, std::shared_ptr<AclEntry>>> {
-    std::vector<std::pair<std::string, std::shared_ptr<AclEntry>>> entries;
+                       bool isCoppAcl = false) {
+    auto& pendingAcls = isCoppAcl ? cpuAcls : dataPlaneAcls;
     for (const auto& mta : *policy.matchToAction()) {
       auto a = aclByName.find(*mta.matcher());
       if (a != aclByName.end()) {
-        auto aclCfg = *(a->second);
+        const auto* aclCfg = a->second;
 
         // We've already added any DENY acls
-        if (*aclCfg.actionType() == cfg::AclActionType::DENY) {
+        if (*aclCfg->actionType() == cfg::AclActionType::DENY) {
           continue;
         }
 
@@ -2270,47 +2284,66 @@ std::shared_ptr<AclMap> ThriftConfigApplier::updateAcls(
             enableAcl = false;
           }
         }
-
-        auto acl = updateAcl(
-            aclStage,
-            aclCfg,
-            isCoppAcl ? cpuPriority++ : priority++,
-            &numExistingProcessed,
-            &changed,
-            tableName,
-            &matchAction,
-            enableAcl);
-
-        if (acl->getAclAction().has_value()) {
-          const auto& inMirror = acl->getAclAction().value().getIngressMirror();
-          const auto& egMirror = acl->getAclAction().value().getIngressMirror();
-          if (inMirror.has_value() &&
-              !new_->getMirrors()->getMirrorIf(inMirror.value())) {
-            throw FbossError("Mirror ", inMirror.value(), " is undefined");
-          }
-          if (egMirror.has_value() &&
-              !new_->getMirrors()->getMirrorIf(egMirror.value())) {
-            throw FbossError("Mirror ", egMirror.value(), " is undefined");
-          }
-        }
-        entries.push_back(std::make_pair(acl->getID(), acl));
+        pendingAcls.push_back(PendingAcl{aclCfg, matchAction, enableAcl});
       }
     }
-    return entries;
   };
 
   // Add controlPlane traffic acls
   if (cfg_->cpuTrafficPolicy() && cfg_->cpuTrafficPolicy()->trafficPolicy()) {
-    folly::gen::from(
-        addToAcls(*cfg_->cpuTrafficPolicy()->trafficPolicy(), true)) |
-        folly::gen::appendTo(newAcls);
+    addToAcls(*cfg_->cpuTrafficPolicy()->trafficPolicy(), true);
   }
 
   // Add dataPlane traffic acls
   if (auto dataPlaneTrafficPolicy = cfg_->dataPlaneTrafficPolicy()) {
-    folly::gen::from(addToAcls(*dataPlaneTrafficPolicy)) |
-        folly::gen::appendTo(newAcls);
-  }
+    addToAcls(*dataPlaneTrafficPolicy);
+  }
+
+  // Existing acls keep their priority as long as their order doesn't change,
+  // so inserting an acl doesn't reprogram all the ones following it
+  auto updatePendingAcls = [&](const std::vector<PendingAcl>& pendingAcls,
+                               int startPriority,
+                               int endPriority) {
+    std::vector<std::optional<int>> origPriorities;
+    for (const auto& pending : pendingAcls) {
+      auto origAcl = getOrigAcl(aclStage, *pending.config->name(), tableName);
+      origPriorities.push_back(
+          origAcl ? std::make_optional(origAcl->getPriority()) : std::nullopt);
+    }
+    auto priorities =
+        AclPriorityAllocator(startPriority, endPriority, FLAGS_acl_priority_gap)
+            .allocate(origPriorities);
+
+    for (size_t i = 0; i < pendingAcls.size(); ++i) {
+      const auto& pending = pendingAcls[i];
+      auto acl = updateAcl(
+          aclStage,
+          *pending.config,
+          priorities[i],
+          &numExistingProcessed,
+          &changed,
+          tableName,
+          pending.action ? &pending.action.value() : nullptr,
+          pending.enable);
+
+      if (acl->getAclAction().has_value()) {
+        const auto& inMirror = acl->getAclAction().value().getIngressMirror();
+        const auto& egMirror = acl->getAclAction().value().getIngressMirror();
+        if (inMirror.has_value() &&
+            !new_->getMirrors()->getMirrorIf(inMirror.value())) {
+          throw FbossError("Mirror ", inMirror.value(), " is undefined");
+        }
+        if (egMirror.has_value() &&
+            !new_->getMirrors()->getMirrorIf(egMirror.value())) {
+          throw FbossError("Mirror ", egMirror.value(), " is undefined");
+        }
+      }
+      newAcls.insert(std::make_pair(acl->getID(), acl));
+    }
+  };
+  updatePendingAcls(cpuAcls, kCpuAclStartPriority, kAclStartPriority);
+  updatePendingAcls(
+      dataPlaneAcls, kAclStartPriority, std::numeric_limits<int>::max());
 
   if (FLAGS_enable_acl_table_group) {
     if (orig_->getAclsForTable(aclStage, tableName.value()) &&
@@ -2349,22 +2382,7 @@ std::shared_ptr<AclEntry> ThriftConfigApplier::updateAcl(
     std::optional<std::string> tableName,
     const MatchAction* action,
     bool enable) {
-  std::shared_ptr<AclEntry> origAcl;
-
-  if (FLAGS_enable_acl_table_group) { // multiple acl tables implementation
-    CHECK(tableName.has_value());
-
-    if (orig_->getAclsForTable(aclStage, tableName.value())) {
-      origAcl = orig_->getAclsForTable(aclStage, tableName.value())
-                    ->getEntryIf(*acl.name());
-    }
-  } else { // single acl table implementation
-    CHECK(!tableName.has_value());
-    origAcl = orig_->getAcls()->getEntryIf(
-        *acl.name()); // orig_ empty in coldboot, or comes from
-                      // follydynamic in warmboot
-  }
-
+  auto origAcl = getOrigAcl(aclStage, *acl.name(), tableName);
   auto newAcl =
       createAcl(&acl, priority, action, enable); // new always comes from config
 
@@ -2379,6 +2397,25 @@ std::shared_ptr<AclEntry> ThriftConfigApplier::updateAcl(
   return newAcl;
 }
 
+std::shared_ptr<AclEntry> ThriftConfigApplier::getOrigAcl(
+    cfg::AclStage aclStage,
+    const std::string& name,
+    const std::optional<std::string>& tableName) const {
+  if (FLAGS_enable_acl_table_group) { // multiple acl tables implementation
+    CHECK(tableName.has_value());
+
+    if (orig_->getAclsForTable(aclStage, tableName.value())) {
+      return orig_->getAclsForTable(aclStage, tableName.value())
+          ->getEntryIf(name);
+    }
+    return nullptr;
+  }
+  // single acl table implementation
+  CHECK(!tableName.has_value());
+  // orig_ empty in coldboot, or comes from follydynamic in warmboot
+  return orig_->getAcls()->getEntryIf(name);
+}
+
 void ThriftConfigApplier::checkAcl(const cfg::AclEntry* config) const {
   // check l4 port
   if (auto l4SrcPort = config->l4SrcPort()) {
@@ -90,7 +90,8 @@ void ArpHandler::handlePacket(
   }
 
   // Look up the Vlan state.
-  auto state = sw_->getState();
+  auto snapshot = sw_->getStateSnapshot();
+  const auto& state = snapshot.get();
   auto vlan = state->getVlans()->getVlanIf(pkt->getSrcVlan());
   if (!vlan) {
     // Hmm, we don't actually have this VLAN configured.
@@ -8,17 +8,26 @@
  *
  */
 
+#include <sys/uio.h>
+#include <algorithm>
+#include <array>
+#include <climits>
 #include <cstdlib>
+#include <cstring>
 #include <exception>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
+#include <sstream>
+#include <vector>
 
 #include "fboss/agent/AsyncLogger.h"
 #include "fboss/agent/SysError.h"
 
 #include <fb303/ServiceData.h>
 #include <folly/FileUtil.h>
+#include <folly/logging/xlog.h>
 #include <gflags/gflags.h>
 
 DEFINE_bool(
@@ -26,13 +35,25 @@ DEFINE_bool(
     false,
     "Flag to indicate whether to disable async logging and directly write into the file");
 
-enum BufferToWrite { BUFFER0, BUFFER1 };
+DEFINE_bool(
+    async_logger_drop_when_full,
+    false,
+    "Drop log records when the async logger buffer is full, instead of "
+    "blocking the logging thread until the buffer is flushed");
 
+/*
+ * The ring buffer holds records of an 8 byte header followed by the record
+ * itself, padded to a multiple of 8 bytes so headers stay aligned. Records
+ * may wrap around the end of the ring. The header holds the record size and
+ * a bit which the producer sets once it has copied the record in. reserved
+ * and flushed count bytes since the start, so their difference is the
+ * number of bytes in use.
+ */
 static std::string exitFilePath;
-static uint32_t offset = 0;
-static BufferToWrite currentBuffer = BUFFER0;
-static std::array<char, facebook::fboss::AsyncLogger::kBufferSize> buffer0;
-static std::array<char, facebook::fboss::AsyncLogger::kBufferSize> buffer1;
+alignas(8) static std::array<char, facebook::fboss::AsyncLogger::kRingSize>
+    ringBuffer;
+static std::atomic<uint64_t> reserved{0};
+static std::atomic<uint64_t> flushed{0};
 
 static std::mutex bootTypeLatch_;
 
@@ -41,20 +62,58 @@ namespace {
 constexpr auto kBuildRevision = "build_revision";
 constexpr auto kSdkVersion = "SDK Version";
 
+constexpr uint64_t kHeaderSize = sizeof(uint64_t);
+constexpr uint64_t kCommitted = 1ULL << 63;
+
+uint64_t* headerAt(uint64_t pos) {
+  return reinterpret_cast<uint64_t*>(
+      ringBuffer.data() + pos % ringBuffer.size());
+}
+
+uint64_t recordSize(size_t logSize) {
+  return kHeaderSize + (logSize + kHeaderSize - 1) / kHeaderSize * kHeaderSize;
+}
+
+/*
+ * Call fn(data, size) for each piece of the complete records in
+ * [from, to), returning the end of the last complete record
+ */
+template <typename Fn>
+uint64_t forEachCommitted(uint64_t from, uint64_t to, Fn&& fn) {
+  auto pos = from;
+  while (pos < to) {
+    auto header = __atomic_load_n(headerAt(pos), __ATOMIC_ACQUIRE);
+    if (!(header & kCommitted)) {
+      break;
+    }
+    auto size = header & ~kCommitted;
+    auto start = (pos + kHeaderSize) % ringBuffer.size();
+    auto firstPiece = std::min<uint64_t>(size, ringBuffer.size() - start);
+    fn(ringBuffer.data() + start, firstPiece);
+    if (firstPiece < size) {
+      fn(ringBuffer.data(), size - firstPiece);
+    }
+    pos += recordSize(size);
+  }
+  return pos;
+}
+
 void terminateHandler() {
-  if (offset > 0) {
+  auto from = flushed.load();
+  auto to = reserved.load();
+  if (from < to) {
     // Use standard library instead of folly because in unclean exit, folly
     // library could be inaccessible so there's a higher chance of writing into
     // file using standard library.
     std::ofstream logfile;
     logfile.open(exitFilePath, std::ofstream::app);
 
-    if (currentBuffer == BUFFER0) {
-      logfile.write(buffer0.data(), offset);
-    } else {
-      logfile.write(buffer1.data(), offset);
-    }
-    std::cerr << "Async logger exit with " << offset
+    uint64_t bytes = 0;
+    forEachCommitted(from, to, [&](const char* data, uint64_t size) {
+      logfile.write(data, size);
+      bytes += size;
+    });
+    std::cerr << "Async logger exit with " << bytes
               << " bytes written to file " << std::endl;
   }
 
@@ -79,13 +138,10 @@ AsyncLogger::AsyncLogger(
     std::string filePath,
     uint32_t logTimeout,
     LoggerSrcType srcType)
-    : bufferSize_(AsyncLogger::kBufferSize), srcType_(srcType) {
+    : srcType_(srcType) {
   openLogFile(filePath);
 
   if (!FLAGS_disable_async_logger) {
-    logBuffer_ = buffer0.data();
-    flushBuffer_ = buffer1.data();
-
     exitFilePath = filePath;
 
     logTimeout_ = std::chrono::milliseconds(logTimeout);
@@ -105,52 +161,71 @@ void AsyncLogger::setBootType(bool canWarmBoot) {
 
 void AsyncLogger::worker_thread() {
   while (enableLogging_) {
-    std::unique_lock<std::mutex> lock(latch_);
-
-    // Wait for either 1. Timeout 2. Force flush or full flush
-    cv_.wait_for(lock, logTimeout_, [this] {
-      return this->forceFlush_ || this->fullFlush_;
-    });
-
-    // Swap log buffer and flush buffer
-    char* writeBuffer = logBuffer_;
-    uint32_t currSize = offset;
-    offset = 0;
-    currentBuffer = ((currentBuffer == BUFFER0) ? BUFFER1 : BUFFER0);
-    logBuffer_ = flushBuffer_;
-
-    if (fullFlush_) {
-      fullFlush_ = false;
-    }
-
-    lock.unlock();
-    cv_.notify_one();
+    // Wait for either 1. Timeout 2. Force flush, half full ring or a
+    // producer waiting for space
+    flushSignal_.try_wait_for(logTimeout_);
+    flushSignal_.reset();
+    flush();
+  }
+  flush();
+}
 
-    // Write content in swap buffer to file
-    if (currSize > 0) {
-      flushCount_++;
-      auto bytesWritten = logFile_.withWLock([&](auto& lockedFile) {
-        return folly::writeFull(lockedFile.fd(), writeBuffer, currSize);
-      });
+void AsyncLogger::flush() {
+  auto from = flushed.load(std::memory_order_relaxed);
+  auto to = reserved.load(std::memory_order_acquire);
+  std::vector<iovec> iov;
+  uint64_t bytes = 0;
+  auto end = forEachCommitted(from, to, [&](const char* data, uint64_t size) {
+    iov.push_back({const_cast<char*>(data), size});
+    bytes += size;
+  });
+  if (end == from) {
+    return;
+  }
 
-      if (bytesWritten < 0) {
-        throw SysError(
-            errno, "error writing ", currSize, " bytes to log file.");
+  flushCount_++;
+  logFile_.withWLock([&](auto& lockedFile) {
+    for (size_t i = 0; i < iov.size(); i += IOV_MAX) {
+      auto count = std::min<size_t>(IOV_MAX, iov.size() - i);
+      if (folly::writevFull(lockedFile.fd(), iov.data() + i, count) < 0) {
+        throw SysError(errno, "error writing ", bytes, " bytes to log file.");
       }
     }
+  });
+
+  // Clear the flushed records, so that the next lap of the ring does not
+  // mistake stale record bytes for a complete header
+  auto start = from % ringBuffer.size();
+  auto firstPiece = std::min<uint64_t>(end - from, ringBuffer.size() - start);
+  memset(ringBuffer.data() + start, 0, firstPiece);
+  memset(ringBuffer.data(), 0, end - from - firstPiece);
+  flushed.store(end);
+  notifyFlushWaiters();
+}
 
-    memset(writeBuffer, 0, bufferSize_);
-    flushBuffer_ = writeBuffer;
-
-    // Notify force flush that write completes
-    if (forceFlush_) {
-      forceFlush_ = false;
-      promise_.set_value(0);
-      promise_ = std::promise<int>();
+void AsyncLogger::notifyFlushWaiters() {
+  // Pairs with the increment in waitForFlush(), either we see the waiter or
+  // it sees the new flushed offset
+  if (flushWaiters_.load() > 0) {
+    {
+      std::lock_guard<std::mutex> g(flushedLock_);
     }
+    flushedCv_.notify_all();
   }
 }
 
+template <typename Pred>
+void AsyncLogger::waitForFlush(Pred&& flushedEnough) {
+  flushWaiters_++;
+  flushSignal_.post();
+  {
+    std::unique_lock<std::mutex> l(flushedLock_);
+    flushedCv_.wait(
+        l, [&]() { return !enableLogging_ || flushedEnough(flushed.load()); });
+  }
+  flushWaiters_--;
+}
+
 void AsyncLogger::startFlushThread() {
   enableLogging_ = true;
   if (!FLAGS_disable_async_logger) {
@@ -164,29 +239,40 @@ void AsyncLogger::startFlushThread() {
 void AsyncLogger::stopFlushThread() {
   if (!FLAGS_disable_async_logger && enableLogging_) {
     enableLogging_ = false;
+    flushSignal_.post();
     flushThread_->join();
+    // Release producers still waiting for space
+    {
+      std::lock_guard<std::mutex> g(flushedLock_);
+    }
+    flushedCv_.notify_all();
     delete flushThread_;
   }
 }
 
 void AsyncLogger::forceFlush() {
   if (!FLAGS_disable_async_logger) {
-    future_ = promise_.get_future();
-
-    forceFlush_ = true;
-    cv_.notify_one();
-
-    // Wait for flush to complete
-    future_.get();
+    auto target = reserved.load(std::memory_order_acquire);
+    // Records still being copied in keep the flush thread from getting past
+    // them, their producers wake it up again once they are complete
+    waitForFlush([target](uint64_t head) { return head >= target; });
   }
 }
 
+void AsyncLogger::dropRecord(size_t logSize) {
+  droppedCount_++;
+  droppedBytes_ += logSize;
+  XLOG_EVERY_MS(WARN, 10000)
+      << "[Async Logger] Dropped " << droppedCount_ << " records, "
+      << droppedBytes_ << " bytes";
+}
+
 void AsyncLogger::appendLog(const char* logRecord, size_t logSize) {
-  if (!enableLogging_) {
+  if (!enableLogging_ || logSize == 0) {
     return;
   }
 
-  if (FLAGS_disable_async_logger && logSize > 0) {
+  if (FLAGS_disable_async_logger) {
     auto bytesWritten = logFile_.withWLock([&](auto& lockedFile) {
       return folly::writeFull(lockedFile.fd(), logRecord, logSize);
     });
@@ -197,32 +283,51 @@ void AsyncLogger::appendLog(const char* logRecord, size_t logSize) {
     return;
   }
 
-  // Acquire the lock and check if there's enough space in the buffer
-  latch_.lock();
-
-  if (logSize + offset >= bufferSize_) {
-    // Release the lock and notify worker thread to flush logs
-    fullFlush_ = true;
-    latch_.unlock();
-    cv_.notify_one();
-
-    // Wait for worker to finish
-    std::unique_lock<std::mutex> lock(latch_);
-    cv_.wait(lock, [logSize] {
-      return logSize + offset < AsyncLogger::kBufferSize;
-    });
-
-    // Write to buffer
-    memcpy(logBuffer_ + offset, logRecord, logSize);
-    offset += logSize;
+  auto size = recordSize(logSize);
+  if (size > ringBuffer.size()) {
+    dropRecord(logSize);
+    return;
+  }
 
-    lock.unlock();
-  } else {
-    // Directly write to buffer
-    memcpy(logBuffer_ + offset, logRecord, logSize);
-    offset += logSize;
+  // Reserve space in the ring
+  bool waited = false;
+  uint64_t pos;
+  do {
+    // Load flushed first so it can never be ahead of pos
+    auto head = flushed.load(std::memory_order_acquire);
+    pos = reserved.load(std::memory_order_relaxed);
+    if (pos + size - head > ringBuffer.size()) {
+      if (FLAGS_async_logger_drop_when_full || !enableLogging_) {
+        dropRecord(logSize);
+        return;
+      }
+      // Wait for the flush thread to make room
+      waited = true;
+      waitForFlush([size](uint64_t head) {
+        return reserved.load() + size - head <= ringBuffer.size();
+      });
+      continue;
+    }
+    if (reserved.compare_exchange_weak(
+            pos, pos + size, std::memory_order_relaxed)) {
+      break;
+    }
+  } while (true);
+
+  // Copy the record in, wrapping around the end of the ring
+  auto start = (pos + kHeaderSize) % ringBuffer.size();
+  auto firstPiece = std::min<uint64_t>(logSize, ringBuffer.size() - start);
+  memcpy(ringBuffer.data() + start, logRecord, firstPiece);
+  if (firstPiece < logSize) {
+    memcpy(ringBuffer.data(), logRecord + firstPiece, logSize - firstPiece);
+  }
+  __atomic_store_n(headerAt(pos), logSize | kCommitted, __ATOMIC_RELEASE);
 
-    latch_.unlock();
+  // Wake up the flush thread for every half ring of records, or if someone
+  // waits for it to get past this record
+  if (waited || flushWaiters_.load() > 0 ||
+      pos / kBufferSize != (pos + size) / kBufferSize) {
+    flushSignal_.post();
   }
 }
 
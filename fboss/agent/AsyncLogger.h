@@ -10,16 +10,36 @@
 
 #pragma once
 
+#include <atomic>
 #include <chrono>
 #include <condition_variable>
-#include <future>
+#include <cstdint>
 #include <mutex>
+#include <string>
+#include <thread>
 
 #include <folly/File.h>
 #include <folly/Synchronized.h>
+#include <folly/synchronization/SaturatingSemaphore.h>
 
 namespace facebook::fboss {
 
+/*
+ * AsyncLogger buffers log records in memory and writes them to a file from a
+ * background thread.
+ *
+ * Records go into a bounded ring buffer shared by all producer threads.
+ * Producers reserve space with a compare-and-swap and copy their record in
+ * without taking any lock, then mark it complete in its header. The flush
+ * thread writes out all complete records at the head of the ring with a
+ * single writev whenever the log timeout expires, another half of the ring has
+ * been filled, a producer is waiting for space or a flush is forced.
+ *
+ * When the ring is full, producers block until the flush thread has made
+ * room, or drop their record with --async_logger_drop_when_full.
+ * forceFlush() likewise blocks until the flush thread has written out
+ * everything logged before the call.
+ */
 class AsyncLogger {
  public:
   enum LoggerSrcType { BCM_CINTER, SAI_REPLAYER };
@@ -43,9 +63,11 @@ class AsyncLogger {
    * Therefore, we chose the buffer size of 409600, which is an appropriate
    * number that's not introducing too much memory overhead (roughly 0.035% of
    * current prod usage), but still perform well in frequent updates and
-   * benchmark tests.
+   * benchmark tests. The ring holds two buffers worth of records, so producers
+   * keep appending while the flush thread writes out the first one.
    */
   static auto constexpr kBufferSize = 409600;
+  static auto constexpr kRingSize = 2 * kBufferSize;
 
   void startFlushThread();
   void stopFlushThread();
@@ -60,30 +82,43 @@ class AsyncLogger {
     return flushCount_;
   }
 
+  // Records dropped because the ring was full or the record too large
+  uint64_t getDroppedCount() const {
+    return droppedCount_;
+  }
+  uint64_t getDroppedBytes() const {
+    return droppedBytes_;
+  }
+
  private:
   std::atomic_uint32_t flushCount_{0};
   void worker_thread();
   void openLogFile(std::string& file_path);
   void writeNewBootHeader();
+  // Write out the complete records at the head of the ring
+  void flush();
+  void dropRecord(size_t logSize);
+  // Block until flushedEnough(flushed offset) holds or logging stops
+  template <typename Pred>
+  void waitForFlush(Pred&& flushedEnough);
+  void notifyFlushWaiters();
 
-  std::atomic_bool forceFlush_{false};
-  bool fullFlush_{false};
   std::atomic_bool enableLogging_{false};
-
-  uint32_t bufferSize_;
-
-  char* logBuffer_;
-  char* flushBuffer_;
+  std::atomic<uint64_t> droppedCount_{0};
+  std::atomic<uint64_t> droppedBytes_{0};
 
   LoggerSrcType srcType_;
 
-  std::promise<int> promise_;
-  std::future<int> future_;
-  std::mutex latch_;
   std::thread* flushThread_;
-  std::condition_variable cv_;
+  // Wakes up the flush thread before the log timeout
+  folly::SaturatingSemaphore<true> flushSignal_;
   std::chrono::milliseconds logTimeout_;
 
+  // Signaled by the flush thread after it has written out records
+  std::mutex flushedLock_;
+  std::condition_variable flushedCv_;
+  std::atomic<uint32_t> flushWaiters_{0};
+
   folly::Synchronized<folly::File> logFile_;
 };
 
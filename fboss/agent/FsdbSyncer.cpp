@@ -6,6 +6,7 @@
 #include "fboss/fsdb/Flags.h"
 #include "fboss/fsdb/client/FsdbPubSubManager.h"
 #include "fboss/fsdb/if/gen-cpp2/fsdb_oper_types.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
 
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 #include <optional>
@@ -51,6 +52,7 @@ void FsdbSyncer::stateUpdated(const StateDelta& stateDelta) {
     return;
   }
 
+  PROFILE_SPAN("fsdb_publish");
   publishDeltas(deltaConverter_.computeDeltas(stateDelta));
 }
 
@@ -139,7 +139,8 @@ void IPv4Handler::handlePacket(
   cursor.reset(payload.get());
 
   // retrieve the current switch state
-  auto state = sw_->getState();
+  auto snapshot = sw_->getStateSnapshot();
+  const auto& state = snapshot.get();
   // Need to check if the packet is for self or not. We store our IP
   // in the ARP response table. Use that for now.
   auto vlan = state->getVlans()->getVlanIf(pkt->getSrcVlan());
@@ -149,7 +149,8 @@ void IPv6Handler::handlePacket(
   cursor.reset(payload.get());
 
   // retrieve the current switch state
-  auto state = sw_->getState();
+  auto snapshot = sw_->getStateSnapshot();
+  const auto& state = snapshot.get();
   PortID port = pkt->getSrcPort();
 
   // NOTE: DHCPv6 solicit packet from client has hoplimit set to 1,
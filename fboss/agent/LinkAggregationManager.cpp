@@ -23,14 +23,23 @@
 #include "fboss/agent/state/PortMap.h"
 #include "fboss/agent/state/SwitchState.h"
 
+#include <boost/container/flat_set.hpp>
 #include <folly/io/async/EventBase.h>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
 
 #include <algorithm>
 #include <iterator>
 #include <tuple>
 #include <utility>
 
+DEFINE_int32(
+    lacp_forwarding_update_coalesce_ms,
+    0,
+    "How long to gather LACP member forwarding and partner state changes "
+    "before programming them in a single state update. With 0, the changes "
+    "made while handling one batch of LACP events are programmed together");
+
 namespace facebook::fboss {
 
 void LinkAggregationManager::recordStatistics(
@@ -65,32 +74,38 @@ ProgramForwardingAndPartnerState::ProgramForwardingAndPartnerState(
     AggregatePortID aggPortID,
     AggregatePort::Forwarding fwdState,
     AggregatePort::PartnerState partnerState)
-    : portID_(portID),
-      aggregatePortID_(aggPortID),
-      forwardingState_(fwdState),
-      partnerState_(partnerState) {}
+    : updates_({{portID, aggPortID, fwdState, partnerState}}) {}
+
+ProgramForwardingAndPartnerState::ProgramForwardingAndPartnerState(
+    std::vector<MemberUpdate> updates)
+    : updates_(std::move(updates)) {}
 
 std::shared_ptr<SwitchState> ProgramForwardingAndPartnerState::operator()(
     const std::shared_ptr<SwitchState>& state) {
   std::shared_ptr<SwitchState> nextState(state);
-  auto* aggPort = nextState->getAggregatePorts()
-                      ->getAggregatePortIf(aggregatePortID_)
-                      .get();
-  if (!aggPort) {
-    return nullptr;
-  }
+  bool changed = false;
+  for (const auto& update : updates_) {
+    auto* aggPort = nextState->getAggregatePorts()
+                        ->getAggregatePortIf(update.aggregatePortID)
+                        .get();
+    if (!aggPort) {
+      continue;
+    }
 
-  XLOG(DBG2) << "Updating " << aggPort->getName() << ": ForwardingState["
-             << nextState->getPorts()->getPort(portID_)->getName() << "] --> "
-             << (forwardingState_ == AggregatePort::Forwarding::ENABLED
-                     ? "ENABLED"
-                     : "DISABLED")
-             << " PartnerState " << partnerState_.describe();
-
-  aggPort = aggPort->modify(&nextState);
-  aggPort->setForwardingState(portID_, forwardingState_);
-  aggPort->setPartnerState(portID_, partnerState_);
-  return nextState;
+    XLOG(DBG2) << "Updating " << aggPort->getName() << ": ForwardingState["
+               << nextState->getPorts()->getPort(update.portID)->getName()
+               << "] --> "
+               << (update.forwardingState == AggregatePort::Forwarding::ENABLED
+                       ? "ENABLED"
+                       : "DISABLED")
+               << " PartnerState " << update.partnerState.describe();
+
+    aggPort = aggPort->modify(&nextState);
+    aggPort->setForwardingState(update.portID, update.forwardingState);
+    aggPort->setPartnerState(update.portID, update.partnerState);
+    changed = true;
+  }
+  return changed ? nextState : nullptr;
 }
 
 // Needed for CHECK_* macros to work with PortIDToController::iterator
@@ -101,7 +116,11 @@ std::ostream& operator<<(
 }
 
 LinkAggregationManager::LinkAggregationManager(SwSwitch* sw)
-    : portToController_(), sw_(sw) {
+    : portToController_(),
+      sw_(sw),
+      memberUpdateFlusher_(folly::AsyncTimeout::make(
+          *sw->getLacpEvb(),
+          [this]() noexcept { flushForwardingAndPartnerState(); })) {
   sw_->registerStateObserver(this, "LinkAggregationManager");
 }
 
@@ -354,26 +373,72 @@ void LinkAggregationManager::enableForwardingAndSetPartnerState(
     PortID portID,
     AggregatePortID aggPortID,
     const AggregatePort::PartnerState& partnerState) {
-  CHECK(sw_->getLacpEvb()->inRunningEventBaseThread());
-
-  auto enableFwdStateFn = ProgramForwardingAndPartnerState(
+  queueForwardingAndPartnerState(
       portID, aggPortID, AggregatePort::Forwarding::ENABLED, partnerState);
-
-  sw_->updateStateNoCoalescing(
-      "AggregatePort ForwardingAndPartnerState", std::move(enableFwdStateFn));
 }
 
 void LinkAggregationManager::disableForwardingAndSetPartnerState(
     PortID portID,
     AggregatePortID aggPortID,
     const ParticipantInfo& partnerState) {
+  queueForwardingAndPartnerState(
+      portID, aggPortID, AggregatePort::Forwarding::DISABLED, partnerState);
+}
+
+void LinkAggregationManager::queueForwardingAndPartnerState(
+    PortID portID,
+    AggregatePortID aggPortID,
+    AggregatePort::Forwarding fwdState,
+    const ParticipantInfo& partnerState) {
   CHECK(sw_->getLacpEvb()->inRunningEventBaseThread());
 
-  auto disableFwdStateFn = ProgramForwardingAndPartnerState(
-      portID, aggPortID, AggregatePort::Forwarding::DISABLED, partnerState);
+  ProgramForwardingAndPartnerState::MemberUpdate update{
+      portID, aggPortID, fwdState, partnerState};
+  auto last = std::find_if(
+      pendingMemberUpdates_.rbegin(),
+      pendingMemberUpdates_.rend(),
+      [portID](const auto& pending) { return pending.portID == portID; });
+  if (last != pendingMemberUpdates_.rend() &&
+      last->forwardingState == fwdState) {
+    // Only the partner state changed since
+    *last = std::move(update);
+  } else {
+    pendingMemberUpdates_.push_back(std::move(update));
+  }
+  if (!memberUpdateFlusher_->isScheduled()) {
+    memberUpdateFlusher_->scheduleTimeout(
+        std::chrono::milliseconds(FLAGS_lacp_forwarding_update_coalesce_ms));
+  }
+}
 
-  sw_->updateStateNoCoalescing(
-      "AggregatePort ForwardingAndPartnerState", std::move(disableFwdStateFn));
+void LinkAggregationManager::flushForwardingAndPartnerState() {
+  CHECK(sw_->getLacpEvb()->inRunningEventBaseThread());
+  if (pendingMemberUpdates_.empty()) {
+    return;
+  }
+
+  // A member toggled more than once, e.g. enabled, disabled and enabled
+  // again, must go through every state, so its later transitions go into
+  // later state updates
+  std::vector<std::vector<ProgramForwardingAndPartnerState::MemberUpdate>>
+      batches(1);
+  boost::container::flat_set<PortID> batchPorts;
+  for (auto& update : pendingMemberUpdates_) {
+    if (!batchPorts.insert(update.portID).second) {
+      batches.emplace_back();
+      batchPorts = {update.portID};
+    }
+    batches.back().push_back(std::move(update));
+  }
+  pendingMemberUpdates_.clear();
+
+  for (auto& updates : batches) {
+    XLOG(DBG2) << "Programming forwarding and partner state of "
+               << updates.size() << " aggregate port members";
+    sw_->updateStateNoCoalescing(
+        "AggregatePort ForwardingAndPartnerState",
+        ProgramForwardingAndPartnerState(std::move(updates)));
+  }
 }
 
 void LinkAggregationManager::recordLacpTimeout() {
@@ -412,6 +477,10 @@ LinkAggregationManager::~LinkAggregationManager() {
   for (auto controller : portToController_) {
     controller.second->stopMachines();
   }
+  // Member updates still queued are dropped, like the state updates they
+  // would have scheduled once the switch is stopping
+  sw_->getLacpEvb()->runInEventBaseThreadAndWait(
+      [this]() { memberUpdateFlusher_.reset(); });
   sw_->unregisterStateObserver(this);
 }
 
@@ -18,6 +18,7 @@
 
 #include <folly/SharedMutex.h>
 #include <folly/io/Cursor.h>
+#include <folly/io/async/AsyncTimeout.h>
 
 #include <memory>
 #include <vector>
@@ -53,19 +54,26 @@ struct LacpServicerIf {
 
 class ProgramForwardingAndPartnerState {
  public:
+  struct MemberUpdate {
+    PortID portID;
+    AggregatePortID aggregatePortID;
+    AggregatePort::Forwarding forwardingState;
+    AggregatePort::PartnerState partnerState;
+  };
+
   ProgramForwardingAndPartnerState(
       PortID portID,
       AggregatePortID aggPortID,
       AggregatePort::Forwarding fwdState,
       AggregatePort::PartnerState partnerState);
+  // Program several members, possibly of different aggregate ports, at once
+  explicit ProgramForwardingAndPartnerState(std::vector<MemberUpdate> updates);
+
   std::shared_ptr<SwitchState> operator()(
       const std::shared_ptr<SwitchState>& state);
 
  private:
-  PortID portID_;
-  AggregatePortID aggregatePortID_;
-  AggregatePort::Forwarding forwardingState_;
-  AggregatePort::PartnerState partnerState_;
+  std::vector<MemberUpdate> updates_;
 };
 
 class LinkAggregationManager : public StateObserver, public LacpServicerIf {
@@ -115,6 +123,20 @@ class LinkAggregationManager : public StateObserver, public LacpServicerIf {
       const std::shared_ptr<AggregatePort>& oldAggPort,
       const std::shared_ptr<AggregatePort>& newAggPort);
 
+  /*
+   * Members of several aggregate ports often change state together, e.g.
+   * when a peer reboots.  Rather than running a state update per member,
+   * member updates are queued and flushed as one state update once the LACP
+   * thread is done with its current loop iteration, or after
+   * --lacp_forwarding_update_coalesce_ms.
+   */
+  void queueForwardingAndPartnerState(
+      PortID portID,
+      AggregatePortID aggPortID,
+      AggregatePort::Forwarding fwdState,
+      const ParticipantInfo& partnerState);
+  void flushForwardingAndPartnerState();
+
   // Forbidden copy constructor and assignment operator
   LinkAggregationManager(LinkAggregationManager const&) = delete;
   LinkAggregationManager& operator=(LinkAggregationManager const&) = delete;
@@ -128,6 +150,13 @@ class LinkAggregationManager : public StateObserver, public LacpServicerIf {
   PortIDToController portToController_;
   mutable folly::SharedMutexWritePriority controllersLock_;
   SwSwitch* sw_{nullptr};
+
+  // Only accessed in the LACP thread, in the order they were queued. A
+  // later update of a member only replaces an earlier one still queued if
+  // both leave forwarding in the same state, so no transition is lost.
+  std::vector<ProgramForwardingAndPartnerState::MemberUpdate>
+      pendingMemberUpdates_;
+  std::unique_ptr<folly::AsyncTimeout> memberUpdateFlusher_;
 };
 
 } // namespace facebook::fboss
@@ -71,7 +71,9 @@ LldpManager::LldpManager(SwSwitch* sw)
       sw_(sw),
       intervalMsecs_(LLDP_INTERVAL) {}
 
-LldpManager::~LldpManager() {}
+LldpManager::~LldpManager() {
+  removePortFrames();
+}
 
 void LldpManager::start() {
   sw_->getBackgroundEvb()->runInEventBaseThread(
@@ -81,6 +83,7 @@ void LldpManager::start() {
 void LldpManager::stop() {
   sw_->getBackgroundEvb()->runInEventBaseThreadAndWait(
       [this] { this->cancelTimeout(); });
+  removePortFrames();
 }
 
 void LldpManager::handlePacket(
@@ -140,25 +143,100 @@ void LldpManager::handlePacket(
 
 void LldpManager::timeoutExpired() noexcept {
   try {
-    sendLldpOnAllPorts();
+    updatePortFrames(false /* sendAll */);
   } catch (const std::exception& ex) {
-    XLOG(ERR) << "Failed to send LLDP on all ports. Error:"
+    XLOG(ERR) << "Failed to update LLDP frames. Error:"
               << folly::exceptionStr(ex);
   }
   scheduleTimeout(intervalMsecs_);
 }
 
 void LldpManager::sendLldpOnAllPorts() {
-  // send lldp frames through all the ports here.
+  updatePortFrames(true /* sendAll */);
+}
+
+void LldpManager::updatePortFrames(bool sendAll) {
+  auto scheduler = sw_->getPeriodicTxScheduler();
   std::shared_ptr<SwitchState> state = sw_->getState();
+  std::vector<std::shared_ptr<Port>> upPorts;
   for (const auto& port : *state->getPorts()) {
     if (port->isPortUp()) {
-      sendLldpInfo(port);
+      upPorts.push_back(port);
     } else {
       XLOG(DBG5) << "Skipping LLDP send as this port is disabled "
                  << port->getID();
     }
   }
+
+  const size_t kMaxLen = 64;
+  std::array<char, kMaxLen> hostnameBuf;
+  if (0 == gethostname(hostnameBuf.data(), kMaxLen)) {
+    // make sure it is null terminated
+    hostnameBuf[kMaxLen - 1] = '\0';
+  } else {
+    hostnameBuf[0] = '\0';
+  }
+  std::string hostname(hostnameBuf.data());
+  MacAddress cpuMac = sw_->getPlatform()->getLocalMac();
+
+  std::lock_guard<std::mutex> g(portFramesMutex_);
+  if (hostname != hostname_ || cpuMac != cpuMac_) {
+    // Every frame carries these, rebuild them all
+    for (const auto& portAndFrame : portFrames_) {
+      scheduler->removeFrame(portAndFrame.second.frameID);
+    }
+    portFrames_.clear();
+    hostname_ = std::move(hostname);
+    cpuMac_ = cpuMac;
+  }
+
+  folly::F14FastMap<PortID, PortFrame> portFrames;
+  for (size_t i = 0; i < upPorts.size(); ++i) {
+    const auto& port = upPorts[i];
+    auto it = portFrames_.find(port->getID());
+    std::optional<PeriodicTxScheduler::FrameID> frameID;
+    if (it != portFrames_.end()) {
+      frameID = it->second.frameID;
+      // Ports are copied on write, so an unchanged port is the same object
+      bool unchanged = it->second.port == port;
+      portFrames_.erase(it);
+      if (unchanged) {
+        portFrames.emplace(port->getID(), PortFrame{port, *frameID});
+        if (sendAll) {
+          scheduler->sendNow(*frameID);
+        }
+        continue;
+      }
+      scheduler->updateFrame(*frameID, createLldpFrame(port));
+    } else {
+      // Spread the ports over the interval, after announcing the port now
+      auto offset = intervalMsecs_ * i / upPorts.size();
+      frameID = scheduler->addFrame(
+          createLldpFrame(port),
+          intervalMsecs_,
+          intervalMsecs_ + offset,
+          PortDescriptor(port->getID()));
+    }
+    portFrames.emplace(port->getID(), PortFrame{port, *frameID});
+    scheduler->sendNow(*frameID);
+    XLOG(DBG4) << "updated LLDP frame on port " << port->getID()
+               << " with CPU MAC " << cpuMac_.toString() << " port id "
+               << port->getName() << " and vlan " << port->getIngressVlan();
+  }
+
+  // Whatever is left is for ports that went down or away
+  for (const auto& portAndFrame : portFrames_) {
+    scheduler->removeFrame(portAndFrame.second.frameID);
+  }
+  portFrames_ = std::move(portFrames);
+}
+
+void LldpManager::removePortFrames() {
+  std::lock_guard<std::mutex> g(portFramesMutex_);
+  for (const auto& portAndFrame : portFrames_) {
+    sw_->getPeriodicTxScheduler()->removeFrame(portAndFrame.second.frameID);
+  }
+  portFrames_.clear();
 }
 
 uint16_t tlvHeader(uint16_t type, uint16_t length) {
@@ -333,37 +411,20 @@ std::unique_ptr<TxPacket> LldpManager::createLldpPkt(
   return pkt;
 }
 
-void LldpManager::sendLldpInfo(const std::shared_ptr<Port>& port) {
-  MacAddress cpuMac = sw_->getPlatform()->getLocalMac();
-  PortID thisPortID = port->getID();
-
-  const size_t kMaxLen = 64;
-  std::array<char, kMaxLen> hostname;
-  if (0 == gethostname(hostname.data(), kMaxLen)) {
-    // make sure it is null terminated
-    hostname[kMaxLen - 1] = '\0';
-  } else {
-    hostname[0] = '\0';
-  }
-
+std::unique_ptr<folly::IOBuf> LldpManager::createLldpFrame(
+    const std::shared_ptr<Port>& port) const {
   auto pkt = LldpManager::createLldpPkt(
       sw_,
-      cpuMac,
+      cpuMac_,
       port->getIngressVlan(),
-      std::string(hostname.data()),
+      hostname_,
       port->getName(),
       port->getDescription(),
       TTL_TLV_VALUE,
       SYSTEM_CAPABILITY_ROUTER);
-
-  // this LLDP packet HAS to exit out of the port specified here.
-  sw_->sendNetworkControlPacketAsync(
-      std::move(pkt), PortDescriptor(thisPortID));
-
-  XLOG(DBG4) << "sent LLDP "
-             << " on port " << port->getID() << " with CPU MAC "
-             << cpuMac.toString() << " port id " << port->getName()
-             << " and vlan " << port->getIngressVlan();
+  // Keep the frame in regular memory, the scheduler copies it into a new
+  // packet each time it is sent
+  return folly::IOBuf::copyBuffer(pkt->buf()->data(), pkt->buf()->length());
 }
 
 } // namespace facebook::fboss
@@ -9,9 +9,12 @@
  */
 // Copyright 2014-present Facebook. All Rights Reserved.
 #pragma once
+#include <folly/container/F14Map.h>
 #include <folly/io/async/AsyncTimeout.h>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
+#include "fboss/agent/PeriodicTxScheduler.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/lldp/LinkNeighborDB.h"
 #include "fboss/agent/state/Port.h"
@@ -35,8 +38,12 @@ class LldpManager : private folly::AsyncTimeout {
    * Responsible for processing received LLDP frames and maintaining the
    * LLDP neighbors table.
    * Also, responsible for periodically sending LLDP frames on all the ports
-   * to inform of this switch's presence to its neighbors. Hence inheriting
-   * the AsyncTimeout class for that purpose.
+   * to inform of this switch's presence to its neighbors. The frames are
+   * sent by the SwSwitch's PeriodicTxScheduler, spread over the LLDP
+   * interval. LldpManager inherits the AsyncTimeout class to check every
+   * interval whether ports came up or went down, or changed in a way that
+   * requires rebuilding their frame. A port's frame is also sent right away
+   * when it is first built or rebuilt.
    *
    * http://www.ieee802.org/1/files/public/docs2002/lldp-protocol-00.pdf
    */
@@ -104,6 +111,7 @@ class LldpManager : private folly::AsyncTimeout {
       const uint16_t capabilities);
 
   // This function is internal.  It is only public for use in unit tests.
+  // Sends the LLDP frame of every port that is up right away.
   void sendLldpOnAllPorts();
 
   LinkNeighborDB* getDB() {
@@ -123,12 +131,28 @@ class LldpManager : private folly::AsyncTimeout {
       const std::string& sysDesc);
 
  private:
+  // The frame registered with the scheduler for a port that is up
+  struct PortFrame {
+    // The port the frame was built from
+    std::shared_ptr<Port> port;
+    PeriodicTxScheduler::FrameID frameID;
+  };
+
   void timeoutExpired() noexcept override;
-  void sendLldpInfo(const std::shared_ptr<Port>& port);
+  void updatePortFrames(bool sendAll);
+  void removePortFrames();
+  std::unique_ptr<folly::IOBuf> createLldpFrame(
+      const std::shared_ptr<Port>& port) const;
 
   SwSwitch* sw_{nullptr};
   std::chrono::milliseconds intervalMsecs_;
   LinkNeighborDB db_;
+
+  std::mutex portFramesMutex_;
+  folly::F14FastMap<PortID, PortFrame> portFrames_;
+  // What the frames in portFrames_ were built with
+  std::string hostname_;
+  folly::MacAddress cpuMac_;
 };
 
 } // namespace facebook::fboss
@@ -37,17 +37,75 @@ namespace facebook::fboss {
 
 // Helper methods
 
-void LookupClassRouteUpdater::reAddAllRoutes(const StateDelta& stateDelta) {
-  auto addRoute = [&stateDelta, this](RouterID rid, const auto& route) {
-    if (!route->getClassID().has_value()) {
+void LookupClassRouteUpdater::reAddRoutesForNewSubnets(
+    const StateDelta& stateDelta) {
+  if (newSubnets_.empty() || vlan2SubnetsCache_.empty()) {
+    return;
+  }
+  if (!nextHopIndexComplete_) {
+    reAddAllRoutes(stateDelta);
+    newSubnets_.clear();
+    return;
+  }
+
+  /*
+   * Only routes with a nexthop in one of the new subnets could start
+   * inheriting a classID. Collect them first, a route may have several
+   * nexthops in the new subnets.
+   */
+  folly::F14FastSet<RidAndCidr> routesToReAdd;
+  for (const auto& [vlanID, subnet] : newSubnets_) {
+    auto it = vlan2NextHop2Routes_.find(vlanID);
+    if (it == vlan2NextHop2Routes_.end()) {
+      continue;
+    }
+    for (const auto& [nextHop, routes] : it->second) {
+      if (nextHop.inSubnet(subnet.first, subnet.second)) {
+        routesToReAdd.insert(routes.begin(), routes.end());
+      }
+    }
+  }
+  newSubnets_.clear();
+
+  auto& newState = stateDelta.newState();
+  auto reAddRoute = [&stateDelta, this](RouterID rid, const auto& route) {
+    if (route && !route->getClassID().has_value()) {
       processRouteAdded(stateDelta, rid, route);
+      ++numRoutesReAdded_;
     }
   };
-  if (!vlan2SubnetsCache_.empty()) {
-    forAllRoutes(stateDelta.newState(), addRoute);
+  for (const auto& [rid, cidr] : routesToReAdd) {
+    if (cidr.first.isV6()) {
+      reAddRoute(rid, findRoute<folly::IPAddressV6>(rid, cidr, newState));
+    } else {
+      reAddRoute(rid, findRoute<folly::IPAddressV4>(rid, cidr, newState));
+    }
   }
 }
 
+void LookupClassRouteUpdater::reAddAllRoutes(const StateDelta& stateDelta) {
+  /*
+   * Routes are not processed while vlan2SubnetsCache_ is empty, so this
+   * also (re)builds the nexthop index from scratch.
+   */
+  vlan2NextHop2Routes_.clear();
+  auto& newState = stateDelta.newState();
+  auto addRoute = [&stateDelta, &newState, this](
+                      RouterID rid, const auto& route) {
+    if (!route->isResolved() || route->isToCPU()) {
+      return;
+    }
+    if (route->getClassID().has_value()) {
+      addRouteToNextHopIndex(newState, rid, route);
+    } else {
+      processRouteAdded(stateDelta, rid, route);
+      ++numRoutesReAdded_;
+    }
+  };
+  forAllRoutes(newState, addRoute);
+  nextHopIndexComplete_ = true;
+}
+
 bool LookupClassRouteUpdater::vlanHasOtherPortsWithClassIDs(
     const std::shared_ptr<SwitchState>& switchState,
     const std::shared_ptr<Vlan>& vlan,
@@ -172,6 +230,16 @@ bool LookupClassRouteUpdater::belongsToSubnetInCache(
   return false;
 }
 
+bool LookupClassRouteUpdater::addSubnetToCache(
+    VlanID vlanID,
+    const folly::CIDRNetwork& subnet) {
+  if (!vlan2SubnetsCache_[vlanID].insert(subnet).second) {
+    return false;
+  }
+  newSubnets_.emplace_back(vlanID, subnet);
+  return true;
+}
+
 void LookupClassRouteUpdater::updateSubnetsCache(
     const StateDelta& stateDelta,
     std::shared_ptr<Port> port,
@@ -186,12 +254,11 @@ void LookupClassRouteUpdater::updateSubnetsCache(
       continue;
     }
 
-    auto& subnetsCache = vlan2SubnetsCache_[vlanID];
     auto interface =
         newState->getInterfaces()->getInterfaceIf(vlan->getInterfaceID());
     if (interface) {
       for (auto address : interface->getAddresses()) {
-        subnetCacheUpdated = subnetsCache.insert(address).second;
+        subnetCacheUpdated |= addSubnetToCache(vlanID, address);
       }
     }
   }
@@ -201,9 +268,10 @@ void LookupClassRouteUpdater::updateSubnetsCache(
      * routes may become eligible for caching in
      * nextHopAndVlan2Prefixes_. Furthermore, such a nextHop may have
      * classID associated with it, and in that case, the corresponding
-     * route could inherit that classID. Thus, re-add all the routes.
+     * route could inherit that classID. Thus, re-add the routes with
+     * nextHops in the new subnets.
      */
-    reAddAllRoutes(stateDelta);
+    reAddRoutesForNewSubnets(stateDelta);
   }
 }
 
@@ -355,8 +423,7 @@ void LookupClassRouteUpdater::processInterfaceAdded(
 
     for (const auto& address : addedInterface->getAddresses()) {
       if (blockedNeighborIP.inSubnet(address.first, address.second)) {
-        auto& subnetsCache = vlan2SubnetsCache_[vlanID];
-        subnetsCache.insert(address);
+        addSubnetToCache(vlanID, address);
       }
     }
   }
@@ -391,15 +458,14 @@ void LookupClassRouteUpdater::processInterfaceAdded(
     for (const auto& address : addedInterface->getAddresses()) {
       for (auto& neighborIP : neighborIPAddr) {
         if (neighborIP.inSubnet(address.first, address.second)) {
-          auto& subnetsCache = vlan2SubnetsCache_[vlanID];
-          subnetsCache.insert(address);
+          addSubnetToCache(vlanID, address);
           break;
         }
       }
     }
   }
 
-  reAddAllRoutes(stateDelta);
+  reAddRoutesForNewSubnets(stateDelta);
 }
 
 void LookupClassRouteUpdater::processInterfaceRemoved(
@@ -946,6 +1012,8 @@ void LookupClassRouteUpdater::processRouteAdded(
     return;
   }
 
+  addRouteToNextHopIndex(stateDelta.newState(), rid, addedRoute);
+
   auto ridAndCidr = std::make_pair(
       rid,
       folly::CIDRNetwork{
@@ -974,6 +1042,8 @@ void LookupClassRouteUpdater::processRouteRemoved(
     return;
   }
 
+  removeRouteFromNextHopIndex(stateDelta.newState(), rid, removedRoute);
+
   // ClassID is associated with (and refCnt'ed for) MAC and ARP/NDP neighbor.
   // Route simply inherits classID of its nexthop, so we need not release
   // classID here. Furthermore, the route is already removed, so we don't need
@@ -1089,22 +1159,70 @@ void LookupClassRouteUpdater::processRouteUpdates(
   forEachChangedRoute<AddrT>(stateDelta, changedFn, addedFn, removedFn);
 }
 
+// Methods for dealing with vlan2NextHop2Routes_
+
+template <typename RouteT>
+void LookupClassRouteUpdater::addRouteToNextHopIndex(
+    const std::shared_ptr<SwitchState>& switchState,
+    RouterID rid,
+    const std::shared_ptr<RouteT>& route) {
+  auto ridAndCidr = std::make_pair(
+      rid,
+      folly::CIDRNetwork{route->prefix().network(), route->prefix().mask()});
+  for (const auto& nextHop : route->getForwardInfo().getNextHopSet()) {
+    auto interface =
+        switchState->getInterfaces()->getInterfaceIf(nextHop.intf());
+    if (!interface) {
+      continue;
+    }
+    vlan2NextHop2Routes_[interface->getVlanID()][nextHop.addr()].insert(
+        ridAndCidr);
+  }
+}
+
+template <typename RouteT>
+void LookupClassRouteUpdater::removeRouteFromNextHopIndex(
+    const std::shared_ptr<SwitchState>& switchState,
+    RouterID rid,
+    const std::shared_ptr<RouteT>& route) {
+  auto ridAndCidr = std::make_pair(
+      rid,
+      folly::CIDRNetwork{route->prefix().network(), route->prefix().mask()});
+  for (const auto& nextHop : route->getForwardInfo().getNextHopSet()) {
+    auto interface =
+        switchState->getInterfaces()->getInterfaceIf(nextHop.intf());
+    if (!interface) {
+      continue;
+    }
+    auto vlanIt = vlan2NextHop2Routes_.find(interface->getVlanID());
+    if (vlanIt == vlan2NextHop2Routes_.end()) {
+      continue;
+    }
+    auto nextHopIt = vlanIt->second.find(nextHop.addr());
+    if (nextHopIt == vlanIt->second.end()) {
+      continue;
+    }
+    nextHopIt->second.erase(ridAndCidr);
+    if (nextHopIt->second.empty()) {
+      vlanIt->second.erase(nextHopIt);
+    }
+  }
+}
+
 // Methods for scheduling state updates
 
 void LookupClassRouteUpdater::updateClassIDsForRoutes(
     const std::vector<RouteAndClassID>& routesAndClassIDs) const {
-  std::unordered_map<
-      std::pair<RouterID, std::optional<cfg::AclLookupClass>>,
-      std::vector<folly::CIDRNetwork>>
-      ridClassId2Prefixes;
+  // One RIB/FIB update per VRF, regardless of how many classIDs change
+  boost::container::flat_map<RouterID, std::vector<PrefixAndClassID>>
+      rid2PrefixesAndClassIDs;
   for (const auto& [ridAndCidr, classID] : routesAndClassIDs) {
     auto& [rid, cidr] = ridAndCidr;
-    ridClassId2Prefixes[std::make_pair(rid, classID)].emplace_back(cidr);
+    rid2PrefixesAndClassIDs[rid].emplace_back(cidr, classID);
   }
   auto updater = sw_->getRouteUpdater();
-  for (const auto& [ridAndClassId, prefixes] : ridClassId2Prefixes) {
-    updater.programClassID(
-        ridAndClassId.first, prefixes, ridAndClassId.second, true /*async*/);
+  for (auto& [rid, prefixesAndClassIDs] : rid2PrefixesAndClassIDs) {
+    updater.programClassID(rid, std::move(prefixesAndClassIDs), true /*async*/);
   }
 }
 
@@ -1208,8 +1326,7 @@ void LookupClassRouteUpdater::processBlockNeighborAdded(
     auto address =
         getInterfaceSubnetForIPIf(newState, vlanID, blockedNeighborIP);
     if (address.has_value()) {
-      auto& subnetsCache = vlan2SubnetsCache_[vlanID];
-      subnetCacheUpdated |= subnetsCache.insert(address.value()).second;
+      subnetCacheUpdated |= addSubnetToCache(vlanID, address.value());
     }
   }
 
@@ -1219,9 +1336,10 @@ void LookupClassRouteUpdater::processBlockNeighborAdded(
      * routes may become eligible for caching in
      * nextHopAndVlan2Prefixes_. Furthermore, such a nextHop may have
      * classID associated with it, and in that case, the corresponding
-     * route could inherit that classID. Thus, re-add all the routes.
+     * route could inherit that classID. Thus, re-add the routes with
+     * nextHops in the new subnets.
      */
-    reAddAllRoutes(stateDelta);
+    reAddRoutesForNewSubnets(stateDelta);
   }
 }
 
@@ -1307,8 +1425,7 @@ bool LookupClassRouteUpdater::addBlockedNeighborIPtoSubnetCache(
     auto address =
         getInterfaceSubnetForIPIf(newState, vlanID, neighborIPToBlock);
     if (address.has_value()) {
-      auto& subnetsCache = vlan2SubnetsCache_[vlanID];
-      subnetCacheUpdated |= subnetsCache.insert(address.value()).second;
+      subnetCacheUpdated |= addSubnetToCache(vlanID, address.value());
     }
   }
   return subnetCacheUpdated;
@@ -1371,9 +1488,10 @@ void LookupClassRouteUpdater::processMacAddrsToBlockAdded(
      * routes may become eligible for caching in
      * nextHopAndVlan2Prefixes_. Furthermore, such a nextHop may have
      * classID associated with it, and in that case, the corresponding
-     * route could inherit that classID. Thus, re-add all the routes.
+     * route could inherit that classID. Thus, re-add the routes with
+     * nextHops in the new subnets.
      */
-    reAddAllRoutes(stateDelta);
+    reAddRoutesForNewSubnets(stateDelta);
   }
 }
 
@@ -1448,6 +1566,9 @@ void LookupClassRouteUpdater::stateUpdated(const StateDelta& stateDelta) {
     inited_ = true;
   }
 
+  // Subnets cached while processing a previous delta were already handled
+  newSubnets_.clear();
+
   /*
    * If vlan2SubnetsCache_ is updated after routes are added, every update to
    * vlan2SubnetsCache_ must check if the nextHops of previously processed
@@ -1471,6 +1592,9 @@ void LookupClassRouteUpdater::stateUpdated(const StateDelta& stateDelta) {
    * Skip the processing on other setups.
    */
   if (vlan2SubnetsCache_.empty()) {
+    // Routes are not tracked anymore, the index will be rebuilt on demand
+    vlan2NextHop2Routes_.clear();
+    nextHopIndexComplete_ = false;
     return;
   }
 
@@ -38,9 +38,13 @@ class LookupClassRouteUpdater : public StateObserver {
   int getNumPrefixesWithMultiNextHops() const {
     return prefixesWithMultiNextHops_.size();
   }
+  size_t getNumRoutesReAdded() const {
+    return numRoutesReAdded_;
+  }
 
  private:
   // Helper methods
+  void reAddRoutesForNewSubnets(const StateDelta& stateDelta);
   void reAddAllRoutes(const StateDelta& stateDelta);
 
   bool vlanHasOtherPortsWithClassIDs(
@@ -58,6 +62,8 @@ class LookupClassRouteUpdater : public StateObserver {
       VlanID vlanID,
       const folly::IPAddress& ipToSearch);
 
+  bool addSubnetToCache(VlanID vlanID, const folly::CIDRNetwork& subnet);
+
   void updateSubnetsCache(
       const StateDelta& stateDelta,
       std::shared_ptr<Port> port,
@@ -161,6 +167,18 @@ class LookupClassRouteUpdater : public StateObserver {
   template <typename AddrT>
   void processRouteUpdates(const StateDelta& stateDelta);
 
+  // Methods for dealing with vlan2NextHop2Routes_
+  template <typename RouteT>
+  void addRouteToNextHopIndex(
+      const std::shared_ptr<SwitchState>& switchState,
+      RouterID rid,
+      const std::shared_ptr<RouteT>& route);
+  template <typename RouteT>
+  void removeRouteFromNextHopIndex(
+      const std::shared_ptr<SwitchState>& switchState,
+      RouterID rid,
+      const std::shared_ptr<RouteT>& route);
+
   using RidAndCidr = std::pair<RouterID, folly::CIDRNetwork>;
   using NextHopAndVlan = std::pair<folly::IPAddress, VlanID>;
   using WithAndWithoutClassIDPrefixes =
@@ -345,6 +363,31 @@ class LookupClassRouteUpdater : public StateObserver {
   // pending routes with classID to be updated
   std::vector<RouteAndClassID> toUpdateRoutesAndClassIDs_;
 
+  /*
+   * Resolved routes indexed by [vlan, nexthop], for every nexthop, whether
+   * or not it belongs to a cached subnet.
+   *
+   * When a subnet is added to vlan2SubnetsCache_, only routes with a
+   * nexthop in that subnet may change classID. This index lets us find and
+   * re-add just those routes instead of walking the whole FIB, which matters
+   * with queue-per-host on boxes carrying a large number of routes.
+   *
+   * Routes are only processed while vlan2SubnetsCache_ is non-empty. The
+   * index is dropped when the cache becomes empty, and rebuilt by walking
+   * all the routes once when a subnet is cached again.
+   */
+  boost::container::flat_map<
+      VlanID,
+      folly::F14FastMap<folly::IPAddress, folly::F14FastSet<RidAndCidr>>>
+      vlan2NextHop2Routes_;
+  bool nextHopIndexComplete_{false};
+
+  // subnets added to vlan2SubnetsCache_ whose routes are yet to be re-added
+  std::vector<std::pair<VlanID, folly::CIDRNetwork>> newSubnets_;
+
+  // Number of routes re-added due to new subnets, used by unit tests
+  size_t numRoutesReAdded_{0};
+
   SwSwitch* sw_;
 
   bool inited_{false};
@@ -0,0 +1,150 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/PeriodicTxScheduler.h"
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/TxPacket.h"
+
+#include <folly/io/Cursor.h>
+#include <folly/logging/xlog.h>
+
+DEFINE_int32(
+    periodic_tx_tick_ms,
+    100,
+    "Granularity at which periodic control plane frames (LLDP, RA) are "
+    "sent. Frames that come due within the same tick are sent together");
+
+namespace facebook::fboss {
+
+PeriodicTxScheduler::PeriodicTxScheduler(SwSwitch* sw)
+    : folly::AsyncTimeout(sw->getBackgroundEvb()),
+      sw_(sw),
+      tick_(FLAGS_periodic_tx_tick_ms) {}
+
+PeriodicTxScheduler::~PeriodicTxScheduler() {}
+
+void PeriodicTxScheduler::start() {
+  sw_->getBackgroundEvb()->runInEventBaseThread(
+      [this] { this->timeoutExpired(); });
+}
+
+void PeriodicTxScheduler::stop() {
+  sw_->getBackgroundEvb()->runInEventBaseThreadAndWait(
+      [this] { this->cancelTimeout(); });
+}
+
+PeriodicTxScheduler::FrameID PeriodicTxScheduler::addFrame(
+    std::unique_ptr<folly::IOBuf> frame,
+    std::chrono::milliseconds interval,
+    std::chrono::milliseconds firstDelay,
+    std::optional<PortDescriptor> port,
+    OnSentFn onSent) {
+  if (interval.count() <= 0) {
+    throw FbossError("invalid periodic tx interval ", interval.count(), "ms");
+  }
+  frame->coalesce();
+  Frame entry{
+      std::move(frame),
+      interval,
+      Clock::now() + firstDelay,
+      port,
+      onSent ? std::make_shared<OnSentFn>(std::move(onSent)) : nullptr};
+
+  std::lock_guard<std::mutex> g(mutex_);
+  auto id = nextID_++;
+  dueFrames_.emplace(entry.nextSend, id);
+  frames_.emplace(id, std::move(entry));
+  return id;
+}
+
+void PeriodicTxScheduler::updateFrame(
+    FrameID id,
+    std::unique_ptr<folly::IOBuf> frame) {
+  frame->coalesce();
+  std::shared_ptr<const folly::IOBuf> buf(std::move(frame));
+  std::lock_guard<std::mutex> g(mutex_);
+  auto it = frames_.find(id);
+  if (it == frames_.end()) {
+    throw FbossError("no periodic tx frame with id ", id);
+  }
+  it->second.buf = std::move(buf);
+}
+
+void PeriodicTxScheduler::removeFrame(FrameID id) {
+  std::lock_guard<std::mutex> g(mutex_);
+  frames_.erase(id);
+}
+
+void PeriodicTxScheduler::sendNow(FrameID id) {
+  std::vector<PendingTx> pending;
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    auto it = frames_.find(id);
+    if (it == frames_.end()) {
+      throw FbossError("no periodic tx frame with id ", id);
+    }
+    pending.push_back({it->second.buf, it->second.port, it->second.onSent});
+  }
+  send(pending);
+}
+
+size_t PeriodicTxScheduler::numFrames() const {
+  std::lock_guard<std::mutex> g(mutex_);
+  return frames_.size();
+}
+
+void PeriodicTxScheduler::timeoutExpired() noexcept {
+  batch_.clear();
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    // Everything due before the next tick goes out in this batch
+    auto batchEnd = Clock::now() + tick_;
+    while (!dueFrames_.empty() && dueFrames_.top().first < batchEnd) {
+      auto [due, id] = dueFrames_.top();
+      dueFrames_.pop();
+      auto it = frames_.find(id);
+      if (it == frames_.end() || it->second.nextSend != due) {
+        continue;
+      }
+      auto& frame = it->second;
+      batch_.push_back({frame.buf, frame.port, frame.onSent});
+      // Keep the frame in its slot of the interval, unless we fell behind
+      frame.nextSend += frame.interval;
+      if (frame.nextSend < batchEnd) {
+        frame.nextSend = batchEnd + frame.interval;
+      }
+      dueFrames_.emplace(frame.nextSend, id);
+    }
+  }
+  send(batch_);
+  scheduleTimeout(tick_);
+}
+
+void PeriodicTxScheduler::send(const std::vector<PendingTx>& batch) {
+  for (const auto& pending : batch) {
+    try {
+      // The TxPacket has to be allocated from the HwSwitch, so we can't just
+      // clone the frame
+      auto pkt = sw_->allocatePacket(pending.buf->length());
+      folly::io::RWPrivateCursor cursor(pkt->buf());
+      cursor.push(pending.buf->data(), pending.buf->length());
+      sw_->sendNetworkControlPacketAsync(std::move(pkt), pending.port);
+      if (pending.onSent) {
+        (*pending.onSent)();
+      }
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Failed to send periodic control frame: "
+                << folly::exceptionStr(ex);
+    }
+  }
+}
+
+} // namespace facebook::fboss
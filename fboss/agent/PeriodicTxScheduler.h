@@ -0,0 +1,117 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/container/F14Map.h>
+#include <folly/io/IOBuf.h>
+#include <folly/io/async/AsyncTimeout.h>
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <queue>
+#include <vector>
+
+#include "fboss/agent/state/PortDescriptor.h"
+
+namespace facebook::fboss {
+
+class SwSwitch;
+
+/*
+ * PeriodicTxScheduler sends control plane frames whose contents rarely
+ * change (LLDP, IPv6 RA) at a fixed interval from the SwSwitch background
+ * thread.
+ *
+ * Owners register a prebuilt frame and only replace it when the state it was
+ * built from changes, so nothing is rebuilt per transmission.  Owners also
+ * pick the delay before the first transmission, so frames sharing an
+ * interval can be spread over it instead of all going out at once.  All
+ * frames that come due within the same tick are sent as one batch.
+ *
+ * All methods may be called from any thread.
+ */
+class PeriodicTxScheduler : private folly::AsyncTimeout {
+ public:
+  using FrameID = uint64_t;
+  using Clock = std::chrono::steady_clock;
+  using OnSentFn = std::function<void()>;
+
+  explicit PeriodicTxScheduler(SwSwitch* sw);
+  ~PeriodicTxScheduler() override;
+
+  /*
+   * Start and stop sending frames on their schedule. Frames can be added,
+   * and sent with sendNow(), while the scheduler is stopped.
+   */
+  void start();
+  void stop();
+
+  /*
+   * Send frame every interval, starting after firstDelay.  The frame goes
+   * out of port if one is given, and is switched otherwise.  onSent is
+   * called after each transmission.
+   */
+  FrameID addFrame(
+      std::unique_ptr<folly::IOBuf> frame,
+      std::chrono::milliseconds interval,
+      std::chrono::milliseconds firstDelay,
+      std::optional<PortDescriptor> port,
+      OnSentFn onSent = nullptr);
+
+  // Replace the contents of a frame, keeping its schedule
+  void updateFrame(FrameID id, std::unique_ptr<folly::IOBuf> frame);
+  void removeFrame(FrameID id);
+
+  // Send a frame right away, outside of its schedule
+  void sendNow(FrameID id);
+
+  size_t numFrames() const;
+
+ private:
+  struct Frame {
+    std::shared_ptr<const folly::IOBuf> buf;
+    std::chrono::milliseconds interval;
+    Clock::time_point nextSend;
+    std::optional<PortDescriptor> port;
+    std::shared_ptr<OnSentFn> onSent;
+  };
+  // What we need to send a frame once the lock is dropped
+  struct PendingTx {
+    std::shared_ptr<const folly::IOBuf> buf;
+    std::optional<PortDescriptor> port;
+    std::shared_ptr<OnSentFn> onSent;
+  };
+  using DueFrame = std::pair<Clock::time_point, FrameID>;
+
+  // Forbidden copy constructor and assignment operator
+  PeriodicTxScheduler(PeriodicTxScheduler const&) = delete;
+  PeriodicTxScheduler& operator=(PeriodicTxScheduler const&) = delete;
+
+  void timeoutExpired() noexcept override;
+  void send(const std::vector<PendingTx>& batch);
+
+  SwSwitch* sw_{nullptr};
+  const std::chrono::milliseconds tick_;
+
+  mutable std::mutex mutex_;
+  FrameID nextID_{0};
+  folly::F14FastMap<FrameID, Frame> frames_;
+  // Entries of removed frames, or for times a frame is no longer due at,
+  // are skipped when they reach the top.
+  std::priority_queue<DueFrame, std::vector<DueFrame>, std::greater<DueFrame>>
+      dueFrames_;
+  // Only used in the background thread
+  std::vector<PendingTx> batch_;
+};
+
+} // namespace facebook::fboss
@@ -0,0 +1,102 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/synchronization/Hazptr.h>
+
+#include <atomic>
+#include <memory>
+
+namespace facebook::fboss {
+
+class SwitchState;
+
+/*
+ * PublishedSwitchState holds the SwitchState SwSwitch last applied to
+ * hardware.
+ *
+ * Readers pin the current state with a hazard pointer instead of taking a
+ * lock, and only touch the state's reference count if they copy the
+ * shared_ptr out of their snapshot. set() swaps in a new state with a single
+ * atomic exchange; the old state is released once no snapshot of it is left.
+ *
+ * Replaced states are retired to the default hazptr domain, which reclaims
+ * them asynchronously once enough objects are retired or enough time has
+ * passed, so set() never scans the hazard pointers itself. Retired states
+ * may outlive the publisher; they only hold a reference to their state.
+ *
+ * All methods may be called from any thread.
+ */
+class PublishedSwitchState {
+  struct Node : folly::hazptr_obj_base<Node> {
+    explicit Node(std::shared_ptr<SwitchState> state)
+        : state(std::move(state)) {}
+    const std::shared_ptr<SwitchState> state;
+  };
+
+ public:
+  /*
+   * Keeps the state that was current when the snapshot was taken alive, for
+   * as long as the snapshot lives. Snapshots are meant to be short lived,
+   * e.g. for handling one packet; copy the shared_ptr to hold on to a state.
+   */
+  class Snapshot {
+   public:
+    const std::shared_ptr<SwitchState>& get() const {
+      return node_->state;
+    }
+    const SwitchState* operator->() const {
+      return node_->state.get();
+    }
+    const SwitchState& operator*() const {
+      return *node_->state;
+    }
+    explicit operator bool() const {
+      return node_->state != nullptr;
+    }
+
+   private:
+    friend class PublishedSwitchState;
+    explicit Snapshot(const std::atomic<Node*>& src)
+        : holder_(folly::make_hazard_pointer<>()),
+          node_(holder_.protect(src)) {}
+
+    folly::hazptr_holder<> holder_;
+    const Node* node_;
+  };
+
+  PublishedSwitchState() : node_(new Node(nullptr)) {}
+  ~PublishedSwitchState() {
+    node_.load(std::memory_order_acquire)->retire();
+  }
+
+  Snapshot snapshot() const {
+    return Snapshot(node_);
+  }
+
+  std::shared_ptr<SwitchState> get() const {
+    return snapshot().get();
+  }
+
+  void set(std::shared_ptr<SwitchState> state) {
+    auto old =
+        node_.exchange(new Node(std::move(state)), std::memory_order_acq_rel);
+    old->retire();
+  }
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  PublishedSwitchState(PublishedSwitchState const&) = delete;
+  PublishedSwitchState& operator=(PublishedSwitchState const&) = delete;
+
+  std::atomic<Node*> node_;
+};
+
+} // namespace facebook::fboss
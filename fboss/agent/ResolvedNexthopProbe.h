@@ -3,49 +3,80 @@
 #pragma once
 
 #include "fboss/agent/state/RouteNextHop.h"
-#include "fboss/lib/ExponentialBackoff.h"
 
-#include <folly/io/async/AsyncTimeout.h>
-#include <folly/io/async/EventBase.h>
+#include <chrono>
+#include <cstdint>
+#include <optional>
 
 namespace facebook::fboss {
 
-class SwSwitch;
-
-class ResolvedNextHopProbe : public folly::AsyncTimeout {
+class ResolvedNextHopProbe {
+  /*
+   * per next hop probe state. probes carry no timer of their own, they are
+   * driven by the scheduling wheel of ResolvedNexthopProbeScheduler and are
+   * only ever accessed from the background thread.
+   */
  public:
-  ResolvedNextHopProbe(
-      SwSwitch* sw,
-      folly::EventBase* evb,
-      ResolvedNextHop nexthop);
+  static constexpr std::chrono::milliseconds kInitialBackoff{1000};
+  static constexpr std::chrono::milliseconds kMaximumBackoff{10000};
+
+  explicit ResolvedNextHopProbe(ResolvedNextHop nexthop)
+      : nexthop_(std::move(nexthop)) {}
 
-  ~ResolvedNextHopProbe() override {
-    stop();
+  const ResolvedNextHop& getNexthop() const {
+    return nexthop_;
   }
 
-  void start() {
-    evb_->runImmediatelyOrRunInEventBaseThreadAndWait([=]() { _start(); });
+  bool isActive() const {
+    return active_;
   }
 
-  void stop() {
-    evb_->runImmediatelyOrRunInEventBaseThreadAndWait([=]() { _stop(); });
+  uint64_t getGeneration() const {
+    return generation_;
   }
 
- private:
-  void _start() {
-    scheduleTimeout(backoff_.getTimeRemainingUntilRetry());
+  /*
+   * time to wait after the last probe before probing again
+   */
+  std::chrono::milliseconds getBackoff() const {
+    return backoff_;
   }
 
-  void _stop() {
-    cancelTimeout();
-    backoff_.reportSuccess();
+  std::optional<uint64_t> getLastProbeTick() const {
+    return lastProbeTick_;
   }
-  void timeoutExpired() noexcept override;
 
-  SwSwitch* sw_;
-  folly::EventBase* evb_;
+  /*
+   * activate probe for a new slot on the scheduling wheel. returns generation
+   * which identifies this arming, wheel slots holding an older generation are
+   * stale and skipped.
+   */
+  uint64_t arm();
+
+  /*
+   * deactivate probe, invalidating any wheel slot still referring to it.
+   * backoff is retained so that a probe paused by a pending neighbor entry
+   * resumes where it left off.
+   */
+  void disarm();
+
+  /*
+   * deactivate probe and forget its backoff, used once next hop resolves.
+   */
+  void reset();
+
+  /*
+   * record a probe sent at given tick, every probe after the first one
+   * doubles backoff up to kMaximumBackoff.
+   */
+  void probed(uint64_t tick);
+
+ private:
   ResolvedNextHop nexthop_;
-  ExponentialBackoff<std::chrono::milliseconds> backoff_;
+  bool active_{false};
+  uint64_t generation_{0};
+  std::chrono::milliseconds backoff_{kInitialBackoff};
+  std::optional<uint64_t> lastProbeTick_;
 };
 
 } // namespace facebook::fboss
@@ -2,20 +2,64 @@
 
 #include "fboss/agent/ResolvedNexthopProbeScheduler.h"
 
+#include "fboss/agent/ArpHandler.h"
+#include "fboss/agent/IPv6Handler.h"
+#include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/ResolvedNexthopProbe.h"
 #include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/SwitchStats.h"
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/SwitchState.h"
 
+#include <folly/logging/xlog.h>
+
+#include <algorithm>
+
+DEFINE_int32(
+    resolved_nexthop_probe_tick_ms,
+    100,
+    "Granularity of the scheduling wheel driving resolved next hop probes");
+DEFINE_int32(
+    resolved_nexthop_probe_window_ms,
+    1000,
+    "Window over which probes to next hops that start together are spread");
+DEFINE_int32(
+    resolved_nexthop_probes_per_tick,
+    64,
+    "Maximum number of resolved next hop probes handled per wheel tick, "
+    "remaining probes are deferred to the next tick");
+
 namespace facebook::fboss {
 
+bool ResolvedNexthopProbeScheduler::WheelEntry::isStale() const {
+  return !probe->isActive() || probe->getGeneration() != generation;
+}
+
 ResolvedNexthopProbeScheduler::ResolvedNexthopProbeScheduler(SwSwitch* sw)
-    : sw_(sw) {}
+    : sw_(sw),
+      tickInterval_(std::max(FLAGS_resolved_nexthop_probe_tick_ms, 1)),
+      windowTicks_(std::max<uint64_t>(
+          std::max(FLAGS_resolved_nexthop_probe_window_ms, 0) /
+              tickInterval_.count(),
+          1)),
+      clock_([]() { return Clock::now(); }),
+      epoch_(clock_()),
+      wheelTimer_(folly::AsyncTimeout::make(
+          *sw->getBackgroundEvb(),
+          [this]() noexcept { wheelTick(); })),
+      slots_(
+          toTicks(ResolvedNextHopProbe::kMaximumBackoff) + windowTicks_ + 1) {}
 
 ResolvedNexthopProbeScheduler::~ResolvedNexthopProbeScheduler() {
-  for (auto entry : resolvedNextHop2Probes_) {
-    entry.second->stop();
-  }
+  sw_->getBackgroundEvb()->runImmediatelyOrRunInEventBaseThreadAndWait(
+      [this]() {
+        for (const auto& entry : resolvedNextHop2Probes_) {
+          entry.second->reset();
+        }
+        wheelTimer_.reset();
+        slots_.clear();
+        ready_.clear();
+      });
 }
 
 void ResolvedNexthopProbeScheduler::processChangedResolvedNexthops(
@@ -27,44 +71,286 @@ void ResolvedNexthopProbeScheduler::processChangedResolvedNexthops(
       // add probe
       resolvedNextHop2UseCount_.emplace(nexthop, 1);
       resolvedNextHop2Probes_.emplace(
-          nexthop,
-          std::make_shared<ResolvedNextHopProbe>(
-              sw_, sw_->getBackgroundEvb(), nexthop));
+          nexthop, std::make_shared<ResolvedNextHopProbe>(nexthop));
       continue;
     }
     itr->second++;
   }
 
+  std::vector<std::shared_ptr<ResolvedNextHopProbe>> toReset;
   for (auto nexthop : removed) {
     auto itr = resolvedNextHop2UseCount_.find(nexthop);
     CHECK(itr != resolvedNextHop2UseCount_.end());
     if (itr->second == 1) {
       // remove probe
       resolvedNextHop2UseCount_.erase(itr);
-      resolvedNextHop2Probes_[nexthop]->stop();
-      resolvedNextHop2Probes_.erase(nexthop);
+      auto probeItr = resolvedNextHop2Probes_.find(nexthop);
+      toReset.push_back(std::move(probeItr->second));
+      resolvedNextHop2Probes_.erase(probeItr);
     } else {
       itr->second--;
     }
   }
+
+  if (!toReset.empty()) {
+    sw_->getBackgroundEvb()->runImmediatelyOrRunInEventBaseThreadAndWait(
+        [this, &toReset]() { updateProbes({}, {}, std::move(toReset)); });
+  }
 }
 
 void ResolvedNexthopProbeScheduler::schedule() {
   auto state = sw_->getState();
+  std::vector<std::shared_ptr<ResolvedNextHopProbe>> toStart;
+  std::vector<std::shared_ptr<ResolvedNextHopProbe>> toPause;
+  std::vector<std::shared_ptr<ResolvedNextHopProbe>> toReset;
   for (const auto& entry : resolvedNextHop2UseCount_) {
     auto intf =
         state->getInterfaces()->getInterface(entry.first.intfID().value());
     auto vlanId = intf->getVlanID();
     auto vlan = state->getVlans()->getVlan(vlanId);
-    auto startProbe = entry.first.addr().isV4()
-        ? shouldProbe(entry.first.addr().asV4(), vlan.get())
-        : shouldProbe(entry.first.addr().asV6(), vlan.get());
-    if (startProbe) {
-      resolvedNextHop2Probes_[entry.first]->start();
-    } else {
-      resolvedNextHop2Probes_[entry.first]->stop();
+    const auto& probe = resolvedNextHop2Probes_[entry.first];
+    switch (getProbeAction(entry.first, vlan.get())) {
+      case ProbeAction::START:
+        toStart.push_back(probe);
+        break;
+      case ProbeAction::PAUSE:
+        toPause.push_back(probe);
+        break;
+      case ProbeAction::RESET:
+        toReset.push_back(probe);
+        break;
+    }
+  }
+  // apply all changes in a single hop to background thread
+  sw_->getBackgroundEvb()->runImmediatelyOrRunInEventBaseThreadAndWait([&]() {
+    updateProbes(std::move(toStart), std::move(toPause), std::move(toReset));
+  });
+}
+
+void ResolvedNexthopProbeScheduler::setClockForTesting(
+    std::function<Clock::time_point()> clock) {
+  sw_->getBackgroundEvb()->runImmediatelyOrRunInEventBaseThreadAndWait(
+      [this, &clock]() {
+        clock_ = std::move(clock);
+        epoch_ = clock_();
+        lastTick_ = 0;
+        probesThisTick_ = 0;
+      });
+}
+
+void ResolvedNexthopProbeScheduler::runWheelForTesting() {
+  sw_->getBackgroundEvb()->runImmediatelyOrRunInEventBaseThreadAndWait(
+      [this]() { wheelTick(); });
+}
+
+void ResolvedNexthopProbeScheduler::updateProbes(
+    std::vector<std::shared_ptr<ResolvedNextHopProbe>> toStart,
+    std::vector<std::shared_ptr<ResolvedNextHopProbe>> toPause,
+    std::vector<std::shared_ptr<ResolvedNextHopProbe>> toReset) {
+  advance();
+  for (const auto& probe : toReset) {
+    deactivate(probe.get(), true /* resetBackoff */);
+  }
+  for (const auto& probe : toPause) {
+    if (probe->isActive()) {
+      // a pending entry exists, neighbor cache is already probing next hop
+      probesSuppressed_++;
+      sw_->stats()->resolvedNexthopProbeSuppressed();
+    }
+    deactivate(probe.get(), false /* resetBackoff */);
+  }
+
+  toStart.erase(
+      std::remove_if(
+          toStart.begin(),
+          toStart.end(),
+          [](const auto& probe) { return probe->isActive(); }),
+      toStart.end());
+  // spread probes which start together evenly over the window, so that a
+  // burst of newly resolved next hops does not become a burst of probes
+  for (size_t i = 0; i < toStart.size(); ++i) {
+    const auto& probe = toStart[i];
+    auto tick = lastTick_ + i * windowTicks_ / toStart.size();
+    if (auto lastProbeTick = probe->getLastProbeTick()) {
+      // resumed probe honors backoff accumulated before it was paused
+      tick = std::max(tick, *lastProbeTick + toTicks(probe->getBackoff()));
+    }
+    activeProbes_++;
+    arm(probe, tick);
+  }
+
+  sendReadyProbes();
+  scheduleWheel();
+}
+
+void ResolvedNexthopProbeScheduler::deactivate(
+    ResolvedNextHopProbe* probe,
+    bool resetBackoff) {
+  if (probe->isActive()) {
+    activeProbes_--;
+  }
+  if (resetBackoff) {
+    probe->reset();
+  } else {
+    probe->disarm();
+  }
+}
+
+void ResolvedNexthopProbeScheduler::arm(
+    const std::shared_ptr<ResolvedNextHopProbe>& probe,
+    uint64_t tick) {
+  WheelEntry entry{probe, probe->arm()};
+  if (tick <= lastTick_) {
+    ready_.push_back(std::move(entry));
+    return;
+  }
+  DCHECK_LT(tick - lastTick_, slots_.size());
+  slots_[tick % slots_.size()].push_back(std::move(entry));
+}
+
+void ResolvedNexthopProbeScheduler::wheelTick() {
+  advance();
+  sendReadyProbes();
+  scheduleWheel();
+}
+
+void ResolvedNexthopProbeScheduler::advance() {
+  auto elapsed =
+      std::chrono::duration_cast<std::chrono::milliseconds>(clock_() - epoch_);
+  if (elapsed.count() < 0) {
+    return;
+  }
+  uint64_t tick = elapsed.count() / tickInterval_.count();
+  if (tick <= lastTick_) {
+    return;
+  }
+
+  // probes still ready did not fit in the budget of previous tick
+  auto deferred = std::count_if(
+      ready_.begin(), ready_.end(), [](const WheelEntry& entry) {
+        return !entry.isStale();
+      });
+  if (deferred) {
+    probesDeferred_ += deferred;
+    sw_->stats()->resolvedNexthopProbesDeferred(deferred);
+  }
+
+  // after a long stall visit every slot once
+  auto numTicks = std::min<uint64_t>(tick - lastTick_, slots_.size());
+  for (auto t = lastTick_ + 1; t <= lastTick_ + numTicks; ++t) {
+    auto& slot = slots_[t % slots_.size()];
+    for (auto& entry : slot) {
+      if (!entry.isStale()) {
+        ready_.push_back(std::move(entry));
+      }
+    }
+    slot.clear();
+  }
+  lastTick_ = tick;
+  probesThisTick_ = 0;
+}
+
+void ResolvedNexthopProbeScheduler::sendReadyProbes() {
+  uint32_t maxProbes = std::max(FLAGS_resolved_nexthop_probes_per_tick, 1);
+  boost::container::
+      flat_map<InterfaceID, std::vector<std::shared_ptr<ResolvedNextHopProbe>>>
+          intf2Probes;
+  while (!ready_.empty() && probesThisTick_ < maxProbes) {
+    auto entry = std::move(ready_.front());
+    ready_.pop_front();
+    if (entry.isStale()) {
+      continue;
+    }
+    auto intfID = entry.probe->getNexthop().intfID().value();
+    intf2Probes[intfID].push_back(std::move(entry.probe));
+    probesThisTick_++;
+  }
+  if (intf2Probes.empty()) {
+    return;
+  }
+
+  // look up interface and vlan once for all probes sent through it
+  auto state = sw_->getState();
+  for (const auto& [intfID, probes] : intf2Probes) {
+    auto intf = state->getInterfaces()->getInterfaceIf(intfID);
+    auto vlan =
+        intf ? state->getVlans()->getVlanIf(intf->getVlanID()) : nullptr;
+    if (!vlan) {
+      // probe and state update runs in distinct threads. probe runs in
+      // background thread while state update in update thread.
+      // imagine that probe is invoked right after state is updated but before
+      // probe is either stopped or removed by probe scheduler.  in this state
+      // update has either deleted interface or vlan. in such a case, a probe
+      // may attempt to access interface or vlan which no longer exists. in
+      // such a case simply stop scheduling these probes.
+      XLOG(ERR) << "spurios probes to " << probes.size()
+                << " next hops on interface " << intfID << " exist!";
+      for (const auto& probe : probes) {
+        deactivate(probe.get(), true /* resetBackoff */);
+      }
+      continue;
+    }
+    for (const auto& probe : probes) {
+      processProbe(probe, vlan);
+    }
+  }
+}
+
+void ResolvedNexthopProbeScheduler::processProbe(
+    const std::shared_ptr<ResolvedNextHopProbe>& probe,
+    const std::shared_ptr<Vlan>& vlan) {
+  const auto& nexthop = probe->getNexthop();
+  switch (getProbeAction(nexthop, vlan.get())) {
+    case ProbeAction::RESET:
+      // next hop resolved after probe was scheduled
+      deactivate(probe.get(), true /* resetBackoff */);
+      return;
+    case ProbeAction::PAUSE:
+      // neighbor cache is already probing next hop, check back after backoff
+      probesSuppressed_++;
+      sw_->stats()->resolvedNexthopProbeSuppressed();
+      arm(probe, lastTick_ + toTicks(probe->getBackoff()));
+      return;
+    case ProbeAction::START:
+      break;
+  }
+
+  auto ip = nexthop.addr();
+  if (ip.isV4()) {
+    // send arp request
+    ArpHandler::sendArpRequest(sw_, vlan, ip.asV4());
+    sw_->getNeighborUpdater()->sentArpRequest(vlan->getID(), ip.asV4());
+  } else {
+    // send ndp request
+    IPv6Handler::sendMulticastNeighborSolicitation(sw_, ip.asV6(), vlan);
+    sw_->getNeighborUpdater()->sentNeighborSolicitation(
+        vlan->getID(), ip.asV6());
+  }
+  probesSent_++;
+  sw_->stats()->resolvedNexthopProbeSent();
+  // exponential back-off
+  probe->probed(lastTick_);
+  arm(probe, lastTick_ + toTicks(probe->getBackoff()));
+}
+
+void ResolvedNexthopProbeScheduler::scheduleWheel() {
+  if (activeProbes_ == 0) {
+    wheelTimer_->cancelTimeout();
+    for (auto& slot : slots_) {
+      slot.clear();
     }
+    ready_.clear();
+    return;
+  }
+  if (!wheelTimer_->isScheduled()) {
+    wheelTimer_->scheduleTimeout(tickInterval_);
   }
 }
 
+uint64_t ResolvedNexthopProbeScheduler::toTicks(
+    std::chrono::milliseconds duration) const {
+  return (duration.count() + tickInterval_.count() - 1) /
+      tickInterval_.count();
+}
+
 } // namespace facebook::fboss
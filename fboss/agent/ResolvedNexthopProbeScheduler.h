@@ -6,6 +6,19 @@
 #include "fboss/agent/state/Vlan.h"
 
 #include <boost/container/flat_map.hpp>
+#include <folly/io/async/AsyncTimeout.h>
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <vector>
+
+DECLARE_int32(resolved_nexthop_probe_tick_ms);
+DECLARE_int32(resolved_nexthop_probe_window_ms);
+DECLARE_int32(resolved_nexthop_probes_per_tick);
 
 namespace facebook::fboss {
 
@@ -18,8 +31,18 @@ class ResolvedNexthopProbeScheduler {
    * next hop monitor triggers scheduler a probe is removed if no route
    * references resolved next hop a probe is added if no probe exists to that
    * resolved next hop
+   *
+   * probes are driven by a single scheduling wheel in the background thread
+   * instead of a timer per next hop. probes started together are spread over
+   * resolved_nexthop_probe_window_ms, probes due in the same tick are sent in
+   * batches grouped by interface and at most resolved_nexthop_probes_per_tick
+   * are handled per tick, the rest are deferred to the next tick. a probe is
+   * not sent while the neighbor table holds a pending entry for its next hop,
+   * since neighbor cache is already probing it.
    */
  public:
+  using Clock = std::chrono::steady_clock;
+
   explicit ResolvedNexthopProbeScheduler(SwSwitch* sw);
   ~ResolvedNexthopProbeScheduler();
   void processChangedResolvedNexthops(
@@ -39,19 +62,100 @@ class ResolvedNexthopProbeScheduler {
 
   void schedule();
 
+  uint64_t getProbesSent() const {
+    return probesSent_.load();
+  }
+
+  uint64_t getProbesSuppressed() const {
+    return probesSuppressed_.load();
+  }
+
+  uint64_t getProbesDeferred() const {
+    return probesDeferred_.load();
+  }
+
+  /*
+   * replace clock driving the scheduling wheel, must be called before any
+   * probe is started.
+   */
+  void setClockForTesting(std::function<Clock::time_point()> clock);
+
+  /*
+   * advance scheduling wheel to the current time of its clock and send
+   * probes which are due.
+   */
+  void runWheelForTesting();
+
  private:
+  enum class ProbeAction {
+    START,
+    PAUSE,
+    RESET,
+  };
+
+  struct WheelEntry {
+    std::shared_ptr<ResolvedNextHopProbe> probe;
+    uint64_t generation;
+
+    bool isStale() const;
+  };
+
   template <typename AddrT>
-  bool shouldProbe(const AddrT& addr, Vlan* vlan) {
+  ProbeAction getProbeAction(const AddrT& addr, Vlan* vlan) const {
     auto table = vlan->template getNeighborEntryTable<AddrT>();
-    return table->getEntryIf(addr) == nullptr;
+    auto entry = table->getEntryIf(addr);
+    if (!entry) {
+      return ProbeAction::START;
+    }
+    return entry->isPending() ? ProbeAction::PAUSE : ProbeAction::RESET;
   }
 
+  ProbeAction getProbeAction(const ResolvedNextHop& nexthop, Vlan* vlan)
+      const {
+    return nexthop.addr().isV4()
+        ? getProbeAction(nexthop.addr().asV4(), vlan)
+        : getProbeAction(nexthop.addr().asV6(), vlan);
+  }
+
+  // following run in background thread only
+  void updateProbes(
+      std::vector<std::shared_ptr<ResolvedNextHopProbe>> toStart,
+      std::vector<std::shared_ptr<ResolvedNextHopProbe>> toPause,
+      std::vector<std::shared_ptr<ResolvedNextHopProbe>> toReset);
+  void deactivate(ResolvedNextHopProbe* probe, bool resetBackoff);
+  void arm(const std::shared_ptr<ResolvedNextHopProbe>& probe, uint64_t tick);
+  void wheelTick();
+  void advance();
+  void sendReadyProbes();
+  void processProbe(
+      const std::shared_ptr<ResolvedNextHopProbe>& probe,
+      const std::shared_ptr<Vlan>& vlan);
+  void scheduleWheel();
+  uint64_t toTicks(std::chrono::milliseconds duration) const;
+
   SwSwitch* sw_{nullptr};
   boost::container::
       flat_map<ResolvedNextHop, std::shared_ptr<ResolvedNextHopProbe>>
           resolvedNextHop2Probes_;
   boost::container::flat_map<ResolvedNextHop, uint32_t>
       resolvedNextHop2UseCount_;
+
+  const std::chrono::milliseconds tickInterval_;
+  const uint64_t windowTicks_;
+  std::function<Clock::time_point()> clock_;
+  Clock::time_point epoch_;
+  std::unique_ptr<folly::AsyncTimeout> wheelTimer_;
+  // slot for tick t is slots_[t % slots_.size()]
+  std::vector<std::vector<WheelEntry>> slots_;
+  // probes due at or before lastTick_, in the order they became due
+  std::deque<WheelEntry> ready_;
+  uint64_t lastTick_{0};
+  uint32_t probesThisTick_{0};
+  uint32_t activeProbes_{0};
+
+  std::atomic<uint64_t> probesSent_{0};
+  std::atomic<uint64_t> probesSuppressed_{0};
+  std::atomic<uint64_t> probesDeferred_{0};
 };
 
 } // namespace facebook::fboss
@@ -204,6 +204,19 @@ void RouteUpdateWrapper::programClassID(
   }
 }
 
+void RouteUpdateWrapper::programClassID(
+    RouterID rid,
+    std::vector<PrefixAndClassID> prefixesAndClassIDs,
+    bool async) {
+  if (async) {
+    getRib()->setClassIDAsync(
+        rid, std::move(prefixesAndClassIDs), *fibUpdateFn_, fibUpdateCookie_);
+  } else {
+    getRib()->setClassID(
+        rid, std::move(prefixesAndClassIDs), *fibUpdateFn_, fibUpdateCookie_);
+  }
+}
+
 void RouteUpdateWrapper::setRoutesToConfig(
     const RouterIDAndNetworkToInterfaceRoutes& _configRouterIDToInterfaceRoutes,
     const std::vector<cfg::StaticRouteWithNextHops>& _staticRoutesWithNextHops,
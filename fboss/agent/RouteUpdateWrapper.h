@@ -104,6 +104,11 @@ class RouteUpdateWrapper {
       const std::vector<folly::CIDRNetwork>& prefixes,
       std::optional<cfg::AclLookupClass> classId,
       bool async);
+  // Program classIDs of several prefixes, in a single FIB update
+  void programClassID(
+      RouterID rid,
+      std::vector<PrefixAndClassID> prefixesAndClassIDs,
+      bool async);
 
  private:
   RoutingInformationBase* getRib() {
@@ -40,6 +40,7 @@
 #include "fboss/agent/NeighborUpdater.h"
 #include "fboss/agent/PacketLogger.h"
 #include "fboss/agent/PacketObserver.h"
+#include "fboss/agent/PeriodicTxScheduler.h"
 #include "fboss/agent/PhySnapshotManager-defs.h"
 #include "fboss/agent/Platform.h"
 #include "fboss/agent/PortStats.h"
@@ -73,6 +74,7 @@
 #include "fboss/agent/state/StateDelta.h"
 #include "fboss/agent/state/StateUpdateHelpers.h"
 #include "fboss/agent/state/SwitchState.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
 #include "fboss/lib/phy/gen-cpp2/phy_types.h"
 #include "fboss/qsfp_service/lib/QsfpCache.h"
 
@@ -120,6 +122,12 @@ using namespace apache::thrift::transport;
 using namespace apache::thrift::protocol;
 
 DEFINE_int32(thread_heartbeat_ms, 1000, "Thread heartbeat interval (ms)");
+DEFINE_int32(
+    thread_callback_budget_ms,
+    0,
+    "Count and log callbacks of event base threads running for longer than "
+    "this (ms), 0 to disable. See --thread_callback_stack_sampling to also "
+    "sample their stacks");
 DEFINE_int32(
     distribution_timeout_ms,
     1000,
@@ -191,6 +199,7 @@ SwSwitch::SwSwitch(std::unique_ptr<Platform> platform)
     : hw_(platform->getHwSwitch()),
       platform_(std::move(platform)),
       pktObservers_(new PacketObservers()),
+      periodicTxScheduler_(new PeriodicTxScheduler(this)),
       arp_(new ArpHandler(this)),
       ipv4_(new IPv4Handler(this)),
       ipv6_(new IPv6Handler(this)),
@@ -262,6 +271,7 @@ void SwSwitch::stop(bool revertToMinAlpmState) {
   if (lldpManager_) {
     lldpManager_->stop();
   }
+  periodicTxScheduler_->stop();
 
   if (lagManager_) {
     lagManager_.reset();
@@ -617,6 +627,8 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
     lldpManager_ = std::make_unique<LldpManager>(this);
   }
 
+  auto callbackBudget =
+      std::chrono::milliseconds(FLAGS_thread_callback_budget_ms);
   auto bgHeartbeatStatsFunc = [this](int delay, int backLog) {
     stats()->bgHeartbeatDelay(delay);
     stats()->bgEventBacklog(backLog);
@@ -625,7 +637,8 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
       &backgroundEventBase_,
       "fbossBgThread",
       FLAGS_thread_heartbeat_ms,
-      bgHeartbeatStatsFunc);
+      bgHeartbeatStatsFunc,
+      callbackBudget);
 
   auto updHeartbeatStatsFunc = [this](int delay, int backLog) {
     stats()->updHeartbeatDelay(delay);
@@ -635,7 +648,8 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
       &updateEventBase_,
       "fbossUpdateThread",
       FLAGS_thread_heartbeat_ms,
-      updHeartbeatStatsFunc);
+      updHeartbeatStatsFunc,
+      callbackBudget);
 
   auto packetTxHeartbeatStatsFunc = [this](int delay, int backLog) {
     stats()->packetTxHeartbeatDelay(delay);
@@ -645,7 +659,8 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
       &packetTxEventBase_,
       "fbossPktTxThread",
       FLAGS_thread_heartbeat_ms,
-      packetTxHeartbeatStatsFunc);
+      packetTxHeartbeatStatsFunc,
+      callbackBudget);
 
   auto updateLacpThreadHeartbeatStats = [this](int delay, int backLog) {
     stats()->lacpHeartbeatDelay(delay);
@@ -655,7 +670,8 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
       &lacpEventBase_,
       *folly::getThreadName(lacpThread_->get_id()),
       FLAGS_thread_heartbeat_ms,
-      updateLacpThreadHeartbeatStats);
+      updateLacpThreadHeartbeatStats,
+      callbackBudget);
 
   neighborCacheThreadHeartbeat_ = std::make_shared<ThreadHeartbeat>(
       &neighborCacheEventBase_,
@@ -664,7 +680,8 @@ void SwSwitch::init(std::unique_ptr<TunManager> tunMgr, SwitchFlags flags) {
       [this](int delay, int backlog) {
         stats()->neighborCacheHeartbeatDelay(delay);
         stats()->neighborCacheEventBacklog(backlog);
-      });
+      },
+      callbackBudget);
 
   heartbeatWatchdog_ = std::make_unique<ThreadHeartbeatWatchdog>(
       std::chrono::milliseconds(FLAGS_thread_heartbeat_ms * 10),
@@ -712,6 +729,7 @@ void SwSwitch::initialConfigApplied(const steady_clock::time_point& startTime) {
     tunMgr_->forceInitialSync();
   }
 
+  periodicTxScheduler_->start();
   if (lldpManager_) {
     lldpManager_->start();
   }
@@ -1023,14 +1041,14 @@ void SwSwitch::setStateInternal(std::shared_ptr<SwitchState> newAppliedState) {
   // stateDontUseDirectly_.  (getState() being the other one.)
   CHECK(bool(newAppliedState));
   CHECK(newAppliedState->isPublished());
-  std::unique_lock guard(stateLock_);
-  appliedStateDontUseDirectly_.swap(newAppliedState);
+  appliedStateDontUseDirectly_.set(std::move(newAppliedState));
 }
 
 std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
     const shared_ptr<SwitchState>& oldState,
     const shared_ptr<SwitchState>& newState,
     bool isTransaction) {
+  PROFILE_SPAN("state_update.apply");
   // Check that we are starting from what has been already applied
   DCHECK_EQ(oldState, getAppliedState());
 
@@ -1051,8 +1069,8 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
 
   // Inform the HwSwitch of the change.
   //
-  // Note that at this point we have already updated the state pointer and
-  // released stateLock_, so the new state is already published and visible to
+  // Note that at this point we have already updated the state pointer, so
+  // the new state is already published and visible to
   // other threads.  This does mean that there is a window where the new state
   // is visible but the hardware is not using the new configuration yet.
   //
@@ -1080,7 +1098,10 @@ std::shared_ptr<SwitchState> SwSwitch::applyUpdate(
   setStateInternal(newAppliedState);
 
   // Notifies all observers of the current state update.
-  notifyStateObservers(StateDelta(oldState, newAppliedState));
+  {
+    PROFILE_SPAN("state_update.notify_observers");
+    notifyStateObservers(StateDelta(oldState, newAppliedState));
+  }
 
   auto end = std::chrono::steady_clock::now();
   auto duration =
@@ -11,6 +11,7 @@
 
 #include "fboss/agent/HwSwitch.h"
 #include "fboss/agent/PacketObserver.h"
+#include "fboss/agent/PublishedSwitchState.h"
 #include "fboss/agent/RestartTimeTracker.h"
 #include "fboss/agent/SwSwitchRouteUpdateWrapper.h"
 #include "fboss/agent/Utils.h"
@@ -46,6 +47,7 @@ class IPv4Handler;
 class IPv6Handler;
 class LinkAggregationManager;
 class LldpManager;
+class PeriodicTxScheduler;
 class MPLSHandler;
 class PktCaptureManager;
 class Platform;
@@ -212,6 +214,15 @@ class SwSwitch : public HwSwitch::Callback {
   std::shared_ptr<SwitchState> getState() const {
     return getAppliedState();
   }
+
+  /*
+   * Pin the current switch state without copying the shared_ptr, for hot
+   * paths like packet handling. The state stays valid for as long as the
+   * snapshot lives, so keep it short lived.
+   */
+  PublishedSwitchState::Snapshot getStateSnapshot() const {
+    return appliedStateDontUseDirectly_.snapshot();
+  }
   /**
    * Schedule an update to the switch state.
    *
@@ -603,6 +614,13 @@ class SwSwitch : public HwSwitch::Callback {
   LldpManager* getLldpMgr() {
     return lldpManager_.get();
   }
+
+  /*
+   * Get the scheduler for periodic control plane transmissions
+   */
+  PeriodicTxScheduler* getPeriodicTxScheduler() {
+    return periodicTxScheduler_.get();
+  }
 #if FOLLY_HAS_COROUTINES
   /*
    *
@@ -776,8 +794,7 @@ class SwSwitch : public HwSwitch::Callback {
    * to h/w
    */
   std::shared_ptr<SwitchState> getAppliedState() const {
-    std::unique_lock guard(stateLock_);
-    return appliedStateDontUseDirectly_;
+    return appliedStateDontUseDirectly_.get();
   }
 
   typedef folly::IntrusiveList<StateUpdate, &StateUpdate::listHook_>
@@ -876,17 +893,15 @@ class SwSwitch : public HwSwitch::Callback {
    *
    *
    * BEWARE: You generally shouldn't access these states directly, even
-   * internally within SwSwitch private methods.  These should only be accessed
-   * while holding stateLock_.
+   * internally within SwSwitch private methods.
    *
-   * You almost certainly should call getAppliedState() setStateInternal()
-   * instead of directly accessing appliedState
+   * You almost certainly should call getAppliedState(), getStateSnapshot()
+   * or setStateInternal() instead of directly accessing appliedState
    *
    * This intentionally has an awkward name so people won't forget and try to
    * directly access this pointer.
    */
-  std::shared_ptr<SwitchState> appliedStateDontUseDirectly_;
-  mutable folly::SpinLock stateLock_;
+  PublishedSwitchState appliedStateDontUseDirectly_;
 
   /*
    * A thread for performing various background tasks.
@@ -952,6 +967,8 @@ class SwSwitch : public HwSwitch::Callback {
    */
   std::map<StateObserver*, std::string> stateObservers_;
   std::unique_ptr<PacketObservers> pktObservers_;
+  // Must outlive the LldpManager and the IPv6Handler, which send through it
+  std::unique_ptr<PeriodicTxScheduler> periodicTxScheduler_;
 
   std::unique_ptr<ArpHandler> arp_;
   std::unique_ptr<IPv4Handler> ipv4_;
@@ -229,7 +229,22 @@ SwitchStats::SwitchStats(ThreadLocalStatsMap* map)
       threadHeartbeatMissCount_(
           map,
           kCounterPrefix + "thread_heartbeat_miss",
-          SUM) {}
+          SUM),
+      resolvedNexthopProbesSent_(
+          map,
+          kCounterPrefix + "resolved_nexthop_probes.sent",
+          SUM,
+          RATE),
+      resolvedNexthopProbesSuppressed_(
+          map,
+          kCounterPrefix + "resolved_nexthop_probes.suppressed",
+          SUM,
+          RATE),
+      resolvedNexthopProbesDeferred_(
+          map,
+          kCounterPrefix + "resolved_nexthop_probes.deferred",
+          SUM,
+          RATE) {}
 
 PortStats* FOLLY_NULLABLE SwitchStats::port(PortID portID) {
   auto it = ports_.find(portID);
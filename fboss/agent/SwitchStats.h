@@ -363,6 +363,16 @@ class SwitchStats : public boost::noncopyable {
     threadHeartbeatMissCount_.addValue(1);
   }
 
+  void resolvedNexthopProbeSent() {
+    resolvedNexthopProbesSent_.addValue(1);
+  }
+  void resolvedNexthopProbeSuppressed() {
+    resolvedNexthopProbesSuppressed_.addValue(1);
+  }
+  void resolvedNexthopProbesDeferred(uint64_t count) {
+    resolvedNexthopProbesDeferred_.addValue(count);
+  }
+
   typedef fb303::ThreadCachedServiceData::ThreadLocalStatsMap
       ThreadLocalStatsMap;
   typedef fb303::ThreadCachedServiceData::TLTimeseries TLTimeseries;
@@ -577,6 +587,12 @@ class SwitchStats : public boost::noncopyable {
   TLTimeseries pfcDeadlockRecoveryCount_;
   // Number of thread heartbeat misses
   TLTimeseries threadHeartbeatMissCount_;
+  // Number of probes sent to resolved next hops
+  TLTimeseries resolvedNexthopProbesSent_;
+  // Number of resolved next hop probes skipped as neighbor cache was probing
+  TLTimeseries resolvedNexthopProbesSuppressed_;
+  // Number of resolved next hop probes pushed to a later wheel tick
+  TLTimeseries resolvedNexthopProbesDeferred_;
 };
 
 } // namespace facebook::fboss
@@ -51,6 +51,7 @@
 #include "fboss/agent/state/Transceiver.h"
 #include "fboss/agent/state/Vlan.h"
 #include "fboss/agent/state/VlanMap.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
 #include "fboss/lib/LogThriftCall.h"
 #include "fboss/lib/config/PlatformConfigUtils.h"
 #include "fboss/lib/phy/gen-cpp2/phy_types.h"
@@ -105,6 +106,11 @@ DEFINE_bool(
     false,
     "Allow external mutations of running config");
 
+DEFINE_string(
+    profiling_span_dump_dir,
+    "/tmp/fboss_profiling_spans",
+    "Directory dumpProfilingSpans writes its trace files to");
+
 namespace facebook::fboss {
 
 namespace util {
@@ -2581,4 +2587,35 @@ void ThriftHandler::getTeFlowTableDetails(
     flowTable.emplace_back(flowDetails);
   }
 }
+
+void ThriftHandler::getProfilingSpanStats(
+    std::vector<ProfilingSpanStats>& spanStats) {
+  auto log = LOG_THRIFT_CALL(DBG1);
+  for (const auto& stats : ProfilingSpan::getStats()) {
+    ProfilingSpanStats entry;
+    entry.name() = stats.name;
+    entry.count() = stats.count;
+    entry.totalNsecs() = stats.totalNsecs;
+    entry.p50Nsecs() = stats.p50Nsecs;
+    entry.p90Nsecs() = stats.p90Nsecs;
+    entry.p99Nsecs() = stats.p99Nsecs;
+    entry.maxNsecs() = stats.maxNsecs;
+    spanStats.push_back(std::move(entry));
+  }
+}
+
+void ThriftHandler::dumpProfilingSpans(std::unique_ptr<std::string> fileName) {
+  auto log = LOG_THRIFT_CALL(DBG1, *fileName);
+  // Only a bare file name, the trace always goes to the dump directory
+  if (fileName->empty() || *fileName == "." || *fileName == ".." ||
+      fileName->find('/') != std::string::npos) {
+    throw FbossError("Invalid profiling span dump file name: ", *fileName);
+  }
+  utilCreateDir(FLAGS_profiling_span_dump_dir);
+  auto path = folly::to<std::string>(
+      FLAGS_profiling_span_dump_dir, "/", *fileName);
+  if (!ProfilingSpan::dumpChromeTrace(path)) {
+    throw FbossError("Failed to write profiling spans to ", path);
+  }
+}
 } // namespace facebook::fboss
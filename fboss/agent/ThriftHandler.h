@@ -278,6 +278,10 @@ class ThriftHandler : virtual public FbossCtrlSvIf,
       std::map<std::string, std::int64_t>& routeCounters) override;
 
   void getTeFlowTableDetails(std::vector<TeFlowDetails>& flowTable) override;
+
+  void getProfilingSpanStats(
+      std::vector<ProfilingSpanStats>& spanStats) override;
+  void dumpProfilingSpans(std::unique_ptr<std::string> fileName) override;
   /*
    * Event handler for when a connection is destroyed.  When there is an ongoing
    * duplex connection, there may be other threads that depend on the connection
@@ -9,12 +9,20 @@
  */
 #include "fboss/agent/capture/PcapFile.h"
 
+#include "fboss/agent/FbossError.h"
 #include "fboss/agent/capture/PcapPkt.h"
 
+#include <folly/Conv.h>
 #include <folly/Exception.h>
 #include <folly/FileUtil.h>
+#include <folly/logging/xlog.h>
 
+#include <sys/mman.h>
+#include <unistd.h>
+#include <algorithm>
+#include <cstdio>
 #include <chrono>
+#include <cstring>
 
 using folly::IOBuf;
 using folly::writeFull;
@@ -22,6 +30,18 @@ using folly::writevFull;
 using std::chrono::microseconds;
 using std::chrono::seconds;
 
+namespace {
+struct GlobalHeader {
+  uint32_t magic;
+  uint16_t versionMajor;
+  uint16_t versionMinor;
+  uint32_t tzOffset;
+  uint32_t sigfigs;
+  uint32_t snaplen;
+  uint32_t linkType;
+};
+} // namespace
+
 namespace facebook::fboss {
 
 PcapFile::PktHeader::PktHeader(const PcapPkt& pkt) {
@@ -38,25 +58,122 @@ PcapFile::PktHeader::PktHeader(const PcapPkt& pkt) {
 
 PcapFile::PcapFile() {}
 
-PcapFile::PcapFile(folly::StringPiece path, bool overwriteExisting)
-    : file_(path.str().c_str(), openFlags(overwriteExisting), 0644) {}
+PcapFile::PcapFile(
+    folly::StringPiece path,
+    bool overwriteExisting,
+    uint64_t mmapFileSize,
+    uint32_t maxMmapFiles)
+    : path_(path.str()),
+      file_(
+          path_.c_str(),
+          openFlags(overwriteExisting, mmapFileSize > 0),
+          0644),
+      mmapFileSize_(mmapFileSize),
+      maxMmapFiles_(maxMmapFiles) {
+  if (mmapFileSize_ > 0 &&
+      mmapFileSize_ <= sizeof(GlobalHeader) + sizeof(PktHeader)) {
+    throw FbossError(
+        "pcap mmap file size ", mmapFileSize_, " is too small to hold packets");
+  }
+  if (mmapFileSize_ > 0) {
+    mapFile();
+  }
+}
+
+PcapFile::~PcapFile() {
+  try {
+    unmapFile();
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "error unmapping pcap file " << path_ << ": "
+              << folly::exceptionStr(ex);
+  }
+}
 
-PcapFile::~PcapFile() {}
+PcapFile::PcapFile(PcapFile&& other) noexcept {
+  *this = std::move(other);
+}
+
+PcapFile& PcapFile::operator=(PcapFile&& other) noexcept {
+  try {
+    unmapFile();
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "error unmapping pcap file " << path_ << ": "
+              << folly::exceptionStr(ex);
+  }
+  path_ = std::move(other.path_);
+  file_ = std::move(other.file_);
+  mmapFileSize_ = other.mmapFileSize_;
+  maxMmapFiles_ = other.maxMmapFiles_;
+  map_ = std::exchange(other.map_, nullptr);
+  mapUsed_ = std::exchange(other.mapUsed_, 0);
+  return *this;
+}
 
 void PcapFile::close() {
+  unmapFile();
   file_.close();
 }
 
+void PcapFile::mapFile() {
+  int ret = ftruncate(file_.fd(), mmapFileSize_);
+  folly::checkUnixError(ret, "error sizing pcap file ", path_);
+  auto map = mmap(
+      nullptr, mmapFileSize_, PROT_READ | PROT_WRITE, MAP_SHARED, file_.fd(), 0);
+  if (map == MAP_FAILED) {
+    folly::throwSystemError("error mapping pcap file ", path_);
+  }
+  map_ = static_cast<uint8_t*>(map);
+  mapUsed_ = 0;
+}
+
+void PcapFile::unmapFile() {
+  if (!map_) {
+    return;
+  }
+  munmap(map_, mmapFileSize_);
+  map_ = nullptr;
+  // Drop the unused tail of the file
+  int ret = ftruncate(file_.fd(), mapUsed_);
+  folly::checkUnixError(ret, "error truncating pcap file ", path_);
+}
+
+void PcapFile::rotateFile() {
+  unmapFile();
+  file_.close();
+
+  // <path>.<n> -> <path>.<n+1>, dropping the oldest file
+  auto rotatedPath = [this](uint32_t n) {
+    return folly::to<std::string>(path_, ".", n);
+  };
+  if (maxMmapFiles_ == 0) {
+    unlink(path_.c_str());
+  } else {
+    unlink(rotatedPath(maxMmapFiles_).c_str());
+    for (auto n = maxMmapFiles_ - 1; n > 0; --n) {
+      rename(rotatedPath(n).c_str(), rotatedPath(n + 1).c_str());
+    }
+    int ret = rename(path_.c_str(), rotatedPath(1).c_str());
+    folly::checkUnixError(ret, "error rotating pcap file ", path_);
+  }
+
+  file_ = folly::File(path_.c_str(), openFlags(true, true) | O_TRUNC, 0644);
+  mapFile();
+  writeGlobalHeader();
+}
+
+void PcapFile::write(const void* data, size_t len) {
+  if (map_) {
+    DCHECK_LE(mapUsed_ + len, mmapFileSize_);
+    memcpy(map_ + mapUsed_, data, len);
+    mapUsed_ += len;
+    return;
+  }
+  int ret = writeFull(file_.fd(), data, len);
+  folly::checkUnixError(ret, "error writing pcap data");
+}
+
 void PcapFile::writeGlobalHeader() {
-  struct GlobalHeader {
-    uint32_t magic;
-    uint16_t versionMajor;
-    uint16_t versionMinor;
-    uint32_t tzOffset;
-    uint32_t sigfigs;
-    uint32_t snaplen;
-    uint32_t linkType;
-  } hdr;
+  GlobalHeader hdr;
   hdr.magic = 0xa1b2c3d4;
   hdr.versionMajor = 2;
   hdr.versionMinor = 4;
@@ -67,11 +184,34 @@ void PcapFile::writeGlobalHeader() {
   // include 113 for linux "cooked" capture format.
   hdr.linkType = 1;
 
-  int ret = writeFull(file_.fd(), &hdr, sizeof(hdr));
-  folly::checkUnixError(ret, "error writing pcap global header");
+  write(&hdr, sizeof(hdr));
 }
 
 void PcapFile::writePackets(const std::vector<PcapPkt>& pkts) {
+  if (map_) {
+    // The largest packet that fits in a file of its own
+    const uint64_t maxLen =
+        mmapFileSize_ - sizeof(GlobalHeader) - sizeof(PktHeader);
+    for (const auto& pkt : pkts) {
+      PktHeader hdr(pkt);
+      hdr.includedLen = std::min<uint64_t>(hdr.includedLen, maxLen);
+      if (mapUsed_ + sizeof(hdr) + hdr.includedLen > mmapFileSize_) {
+        rotateFile();
+      }
+      write(&hdr, sizeof(hdr));
+      size_t remaining = hdr.includedLen;
+      for (const auto& range : *pkt.buf()) {
+        auto len = std::min(remaining, range.size());
+        write(range.data(), len);
+        remaining -= len;
+        if (remaining == 0) {
+          break;
+        }
+      }
+    }
+    return;
+  }
+
   folly::fbvector<PktHeader> hdrs;
   hdrs.reserve(pkts.size());
   folly::fbvector<struct iovec> iov;
@@ -92,8 +232,9 @@ void PcapFile::writePackets(const std::vector<PcapPkt>& pkts) {
   folly::checkUnixError(ret, "error writing pcap data");
 }
 
-int PcapFile::openFlags(bool overwriteExisting) {
-  int flags = O_CREAT | O_WRONLY;
+int PcapFile::openFlags(bool overwriteExisting, bool mmap) {
+  // Shared writable maps need the file open for reading too
+  int flags = O_CREAT | (mmap ? O_RDWR : O_WRONLY);
   if (!overwriteExisting) {
     flags |= O_EXCL;
   }
@@ -11,6 +11,7 @@
 
 #include <folly/File.h>
 #include <folly/Range.h>
+#include <string>
 #include <vector>
 
 namespace facebook::fboss {
@@ -23,11 +24,22 @@ class PcapPkt;
  * PcapFile uses blocking I/O.  If you are recording packets from a
  * non-blocking thread, you should use PcapWriter instead of using PcapFile
  * directly.
+ *
+ * If mmapFileSize is non zero, the file is instead sized up front and
+ * written through a shared memory map, which saves a write() system call
+ * per batch of packets.  Once the map is full the file is truncated to the
+ * bytes written and rotated to <path>.1, shifting older files up to
+ * <path>.<maxMmapFiles>, and a new file is started.  Packets larger than a
+ * whole file are truncated.
  */
 class PcapFile {
  public:
   PcapFile();
-  explicit PcapFile(folly::StringPiece path, bool overwriteExisting = false);
+  explicit PcapFile(
+      folly::StringPiece path,
+      bool overwriteExisting = false,
+      uint64_t mmapFileSize = 0,
+      uint32_t maxMmapFiles = 0);
   ~PcapFile();
 
   void close();
@@ -36,8 +48,8 @@ class PcapFile {
   void writePackets(const std::vector<PcapPkt>& pkt);
 
   // Move constructor and assignment operator
-  PcapFile(PcapFile&&) = default;
-  PcapFile& operator=(PcapFile&&) = default;
+  PcapFile(PcapFile&& other) noexcept;
+  PcapFile& operator=(PcapFile&& other) noexcept;
 
  private:
   struct PktHeader {
@@ -53,9 +65,19 @@ class PcapFile {
   PcapFile(PcapFile const&) = delete;
   PcapFile& operator=(PcapFile const&) = delete;
 
-  static int openFlags(bool overwriteExisting);
+  static int openFlags(bool overwriteExisting, bool mmap);
+
+  void write(const void* data, size_t len);
+  void mapFile();
+  void unmapFile();
+  void rotateFile();
 
+  std::string path_;
   folly::File file_;
+  uint64_t mmapFileSize_{0};
+  uint32_t maxMmapFiles_{0};
+  uint8_t* map_{nullptr};
+  uint64_t mapUsed_{0};
 };
 
 } // namespace facebook::fboss
@@ -11,7 +11,8 @@
 
 #include "fboss/agent/RxPacket.h"
 #include "fboss/agent/TxPacket.h"
-#include "fboss/agent/capture/PcapPkt.h"
+
+#include <algorithm>
 
 DEFINE_int32(
     fboss_pcap_queue_depth,
@@ -20,100 +21,136 @@ DEFINE_int32(
     "to buffer in memory while waiting them to be written to the "
     "capture file");
 
+DEFINE_int32(
+    fboss_pcap_queue_poll_interval_ms,
+    10,
+    "How long the packet capture writer sleeps between checks for new "
+    "packets when its queue is empty");
+
 namespace facebook::fboss {
 
 PcapQueue::PcapQueue(uint32_t pktCapacity, uint64_t bytesCapacity)
     : pktCapacity_(
           pktCapacity == 0 ? FLAGS_fboss_pcap_queue_depth : pktCapacity),
-      bytesCapacity_(bytesCapacity) {
-  queue_.reserve(pktCapacity_);
-}
+      bytesCapacity_(bytesCapacity) {}
 
 PcapQueue::~PcapQueue() {}
 
+PcapQueue::Ring& PcapQueue::localRing() {
+  auto& ring = *localRing_;
+  if (!ring) {
+    // pktCapacity_ bounds the packets in all rings, so a single ring can
+    // never be full. ProducerConsumerQueue holds one less than its size.
+    ring = std::make_shared<Ring>(pktCapacity_ + 1);
+    rings_.wlock()->push_back(ring);
+  }
+  return *ring;
+}
+
 template <typename PktType>
 void PcapQueue::addPktInternal(const PktType* pkt) {
   // Check to see if this would exceed the queue capacity.
-  if (queue_.size() >= pktCapacity_) {
-    pktsDropped_ += 1;
+  if (pktsInQueue_.fetch_add(1, std::memory_order_relaxed) >= pktCapacity_) {
+    pktsInQueue_.fetch_sub(1, std::memory_order_relaxed);
+    pktsDropped_.fetch_add(1, std::memory_order_relaxed);
     return;
   }
-  auto newBytes = bytesInQueue_ + pkt->buf()->computeChainDataLength();
-  if (bytesCapacity_ > 0 && newBytes >= bytesCapacity_) {
-    pktsDropped_ += 1;
-    return;
+  if (bytesCapacity_ > 0) {
+    auto len = pkt->buf()->computeChainDataLength();
+    if (bytesInQueue_.fetch_add(len, std::memory_order_relaxed) + len >=
+        bytesCapacity_) {
+      bytesInQueue_.fetch_sub(len, std::memory_order_relaxed);
+      pktsInQueue_.fetch_sub(1, std::memory_order_relaxed);
+      pktsDropped_.fetch_add(1, std::memory_order_relaxed);
+      return;
+    }
   }
 
-  queue_.emplace_back(pkt);
+  auto seq = nextSeq_.fetch_add(1, std::memory_order_relaxed);
+  auto written = localRing().write(seq, PcapPkt(pkt));
+  DCHECK(written);
 }
 
 void PcapQueue::addPkt(const RxPacket* pkt) {
-  {
-    std::lock_guard<std::mutex> guard(mutex_);
-    addPktInternal(pkt);
-  }
-  cv_.notify_one();
-}
-
-void PcapQueue::addPktLocked(const RxPacket* pkt) {
   addPktInternal(pkt);
-  // It is preferred not to be holding the lock when we signal cv_,
-  // but it is okay to call it with the lock held anyway.  (Having the lock
-  // held will just prevent the reader thread from being able to acquire it
-  // immediately when the reader wakes.)
-  cv_.notify_one();
 }
 
 void PcapQueue::addPkt(const TxPacket* pkt) {
-  {
-    std::lock_guard<std::mutex> guard(mutex_);
-    addPktInternal(pkt);
-  }
-  cv_.notify_one();
-}
-
-void PcapQueue::addPktLocked(const TxPacket* pkt) {
   addPktInternal(pkt);
-  // It is preferred not to be holding the lock when we signal cv_,
-  // but it is okay to call it with the lock held anyway.  (Having the lock
-  // held will just prevent the reader thread from being able to acquire it
-  // immediately when the reader wakes.)
-  cv_.notify_one();
 }
 
 void PcapQueue::finish() {
-  std::lock_guard<std::mutex> guard(mutex_);
-  finished_ = true;
+  {
+    std::lock_guard<std::mutex> guard(waitMutex_);
+    finished_.store(true, std::memory_order_release);
+  }
   cv_.notify_all();
 }
 
 bool PcapQueue::isFinished() const {
-  std::lock_guard<std::mutex> guard(mutex_);
-  return finished_;
+  return finished_.load(std::memory_order_acquire);
 }
 
 uint64_t PcapQueue::numDropped() const {
-  std::lock_guard<std::mutex> guard(mutex_);
-  return pktsDropped_;
+  return pktsDropped_.load(std::memory_order_relaxed);
 }
 
-bool PcapQueue::wait(std::vector<PcapPkt>* swapQueue) {
-  swapQueue->clear();
-  swapQueue->reserve(pktCapacity_);
-
-  std::unique_lock<std::mutex> guard(mutex_);
-  while (queue_.empty() && !finished_) {
-    cv_.wait(guard);
+bool PcapQueue::drain(std::vector<PcapPkt>* pkts) {
+  drained_.clear();
+  {
+    auto rings = rings_.rlock();
+    for (const auto& ring : *rings) {
+      while (auto sequencedPkt = ring->frontPtr()) {
+        drained_.push_back(std::move(*sequencedPkt));
+        ring->popFront();
+      }
+    }
   }
-  if (queue_.empty()) {
-    DCHECK(finished_);
-    queue_.shrink_to_fit();
+  if (drained_.empty()) {
     return false;
   }
 
-  swapQueue->swap(queue_);
-  bytesInQueue_ = 0;
+  // Packets from different threads interleave, restore the order in which
+  // they were added
+  std::sort(
+      drained_.begin(),
+      drained_.end(),
+      [](const SequencedPkt& a, const SequencedPkt& b) {
+        return a.first < b.first;
+      });
+  uint64_t bytes = 0;
+  for (auto& sequencedPkt : drained_) {
+    if (bytesCapacity_ > 0) {
+      bytes += sequencedPkt.second.buf()->computeChainDataLength();
+    }
+    pkts->push_back(std::move(sequencedPkt.second));
+  }
+  pktsInQueue_.fetch_sub(drained_.size(), std::memory_order_relaxed);
+  bytesInQueue_.fetch_sub(bytes, std::memory_order_relaxed);
   return true;
 }
 
+bool PcapQueue::wait(std::vector<PcapPkt>* swapQueue) {
+  swapQueue->clear();
+  swapQueue->reserve(pktCapacity_);
+
+  while (true) {
+    // Check finished_ before draining, so packets added before finish() are
+    // always drained before we return false
+    auto finished = finished_.load(std::memory_order_acquire);
+    if (drain(swapQueue)) {
+      return true;
+    }
+    if (finished) {
+      drained_.shrink_to_fit();
+      return false;
+    }
+    std::unique_lock<std::mutex> guard(waitMutex_);
+    cv_.wait_for(
+        guard,
+        std::chrono::milliseconds(FLAGS_fboss_pcap_queue_poll_interval_ms),
+        [this] { return finished_.load(std::memory_order_acquire); });
+  }
+}
+
 } // namespace facebook::fboss
@@ -9,7 +9,15 @@
  */
 #pragma once
 
+#include "fboss/agent/capture/PcapPkt.h"
+
+#include <folly/ProducerConsumerQueue.h>
+#include <folly/Synchronized.h>
+#include <folly/ThreadLocal.h>
+
+#include <atomic>
 #include <condition_variable>
+#include <memory>
 #include <mutex>
 #include <vector>
 
@@ -17,13 +25,18 @@ namespace facebook::fboss {
 
 class RxPacket;
 class TxPacket;
-class PcapPkt;
 
 /*
  * PcapQueue stores a queue of PcapPkt objects, for transferring packets
  * from an asynchronous capture thread to a blocking thread that will process
  * the packets.  (For instance, writing them to disk using blocking I/O.)
  *
+ * Packets may be added from any number of threads without taking a lock:
+ * each adding thread gets its own single producer ring, and packets are
+ * stamped with a global sequence number so the reader can restore the order
+ * they were added in.  Since adding a packet never signals the reader, the
+ * reader polls the rings while waiting.
+ *
  * There can only be a single reader.
  */
 class PcapQueue {
@@ -32,25 +45,11 @@ class PcapQueue {
   virtual ~PcapQueue();
 
   uint32_t getPktCapacity() const {
-    // pktCapacity_ is const, so no need for locking
     return pktCapacity_;
   }
 
-  /*
-   * Get the mutex protecting this PcapQueue.
-   *
-   * This is exposed to allow callers to also protect their own data
-   * with the same mutex if desired.  Callers should call addPktLocked()
-   * instead of addPkt() when they are already holding the PcapQueue mutex.
-   */
-  std::mutex& mutex() const {
-    return mutex_;
-  }
-
   void addPkt(const RxPacket* pkt);
-  void addPktLocked(const RxPacket* pkt);
   void addPkt(const TxPacket* pkt);
-  void addPktLocked(const TxPacket* pkt);
 
   /*
    * finish() signals that no more packets will be added to the queue.
@@ -80,22 +79,38 @@ class PcapQueue {
   bool wait(std::vector<PcapPkt>* swapQueue);
 
  private:
+  using SequencedPkt = std::pair<uint64_t, PcapPkt>;
+  using Ring = folly::ProducerConsumerQueue<SequencedPkt>;
+
   // Forbidden copy constructor and assignment operator
   PcapQueue(PcapQueue const&) = delete;
   PcapQueue& operator=(PcapQueue const&) = delete;
 
   template <typename PktType>
   void addPktInternal(const PktType* pkt);
+  Ring& localRing();
+  bool drain(std::vector<PcapPkt>* pkts);
 
-  mutable std::mutex mutex_;
-  std::condition_variable cv_;
-
-  bool finished_{false};
   const uint32_t pktCapacity_{0};
-  uint64_t bytesCapacity_{0};
-  uint64_t bytesInQueue_{0};
-  uint64_t pktsDropped_{0};
-  std::vector<PcapPkt> queue_;
+  const uint64_t bytesCapacity_{0};
+
+  std::atomic<bool> finished_{false};
+  std::atomic<uint64_t> nextSeq_{0};
+  std::atomic<uint32_t> pktsInQueue_{0};
+  std::atomic<uint64_t> bytesInQueue_{0};
+  std::atomic<uint64_t> pktsDropped_{0};
+
+  // Rings of threads that have exited stay registered until they are
+  // drained and the queue is destroyed
+  folly::ThreadLocal<std::shared_ptr<Ring>> localRing_;
+  folly::Synchronized<std::vector<std::shared_ptr<Ring>>> rings_;
+
+  // Only used by the reader
+  std::vector<SequencedPkt> drained_;
+
+  // Only used to sleep between polls and to wake up the reader on finish()
+  std::mutex waitMutex_;
+  std::condition_variable cv_;
 };
 
 } // namespace facebook::fboss
@@ -14,6 +14,18 @@
 #include <folly/String.h>
 #include <folly/logging/xlog.h>
 
+DEFINE_uint64(
+    pcap_mmap_file_size,
+    0,
+    "If non zero, write packet captures through a memory map of this many "
+    "bytes, rotating the capture file once it is full");
+
+DEFINE_uint32(
+    pcap_mmap_max_files,
+    4,
+    "When writing packet captures through a memory map, the number of "
+    "rotated capture files to keep besides the current one");
+
 using folly::StringPiece;
 
 namespace facebook::fboss {
@@ -24,7 +36,11 @@ PcapWriter::PcapWriter(
     StringPiece path,
     bool overwriteExisting,
     uint32_t maxBufferedPkts)
-    : file_(path, overwriteExisting),
+    : file_(
+          path,
+          overwriteExisting,
+          FLAGS_pcap_mmap_file_size,
+          FLAGS_pcap_mmap_max_files),
       queue_(maxBufferedPkts),
       thread_(&PcapWriter::threadMain, this) {}
 
@@ -41,7 +57,11 @@ PcapWriter::~PcapWriter() {
 }
 
 void PcapWriter::start(folly::StringPiece path, bool overwriteExisting) {
-  file_ = PcapFile(path, overwriteExisting);
+  file_ = PcapFile(
+      path,
+      overwriteExisting,
+      FLAGS_pcap_mmap_file_size,
+      FLAGS_pcap_mmap_max_files);
   thread_ = std::thread(&PcapWriter::threadMain, this);
 }
 
@@ -21,6 +21,10 @@ namespace facebook::fboss {
  * to a pcap file.
  *
  * It performs blocking disk I/O, so it performs the writes in its own thread.
+ *
+ * With --pcap_mmap_file_size set, the file is written through a memory map
+ * instead, and rotated to <path>.1, <path>.2, ... once it is full.  See
+ * PcapFile.
  */
 class PcapWriter {
  public:
@@ -33,29 +37,13 @@ class PcapWriter {
 
   void start(folly::StringPiece path, bool overwriteExisting = false);
 
-  /*
-   * Get the mutex protecting this PcapWriter.
-   *
-   * This is exposed to allow callers to also protect their own data
-   * with the same mutex if desired.  Callers should call addPktLocked()
-   * instead of addPkt() when they are already holding the PcapWriter mutex.
-   */
-  std::mutex& mutex() const {
-    return queue_.mutex();
-  }
-
+  // Safe to call concurrently from multiple threads
   void addPkt(const RxPacket* pkt) {
     queue_.addPkt(pkt);
   }
-  void addPktLocked(const RxPacket* pkt) {
-    queue_.addPktLocked(pkt);
-  }
   void addPkt(const TxPacket* pkt) {
     queue_.addPkt(pkt);
   }
-  void addPktLocked(const TxPacket* pkt) {
-    queue_.addPktLocked(pkt);
-  }
   void finish();
 
   /*
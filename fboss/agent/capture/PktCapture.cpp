@@ -10,13 +10,118 @@
 #include "fboss/agent/capture/PktCapture.h"
 
 #include <folly/Conv.h>
+#include <folly/io/Cursor.h>
 #include <folly/logging/xlog.h>
 #include <sstream>
 
 using folly::StringPiece;
 
+namespace {
+constexpr uint16_t kEtherTypeVlan = 0x8100;
+constexpr uint16_t kEtherTypeQinQ = 0x88a8;
+constexpr uint16_t kEtherTypeIPv4 = 0x0800;
+constexpr uint16_t kEtherTypeIPv6 = 0x86dd;
+constexpr uint8_t kIpProtoTcp = 6;
+constexpr uint8_t kIpProtoUdp = 17;
+
+template <typename SetT, typename ValuesT>
+SetT toSet(const ValuesT& values) {
+  SetT set;
+  for (auto value : values) {
+    set.insert(value);
+  }
+  return set;
+}
+} // namespace
+
 namespace facebook::fboss {
 
+PacketFilter::PacketFilter(const CaptureFilter& captureFilter)
+    : rxPacketFilter_(captureFilter.get_rxCaptureFilter()) {
+  const auto& filter = *captureFilter.packetFilter();
+  etherTypes_ =
+      toSet<boost::container::flat_set<uint16_t>>(*filter.etherTypes());
+  ipProtocols_ =
+      toSet<boost::container::flat_set<uint8_t>>(*filter.ipProtocols());
+  l4Ports_ = toSet<boost::container::flat_set<uint16_t>>(*filter.l4Ports());
+  if (!l4Ports_.empty()) {
+    depth_ = ParseDepth::L4;
+  } else if (!ipProtocols_.empty()) {
+    depth_ = ParseDepth::L3;
+  } else if (!etherTypes_.empty()) {
+    depth_ = ParseDepth::L2;
+  }
+}
+
+bool PacketFilter::headerPasses(const folly::IOBuf* buf) const {
+  if (depth_ == ParseDepth::NONE) {
+    return true;
+  }
+  // Truncated packets never match a filter that needs their headers
+  folly::io::Cursor cursor(buf);
+  if (!cursor.tryAdvance(12)) {
+    return false;
+  }
+  uint16_t etherType;
+  if (!cursor.tryReadBE(etherType)) {
+    return false;
+  }
+  while (etherType == kEtherTypeVlan || etherType == kEtherTypeQinQ) {
+    if (!cursor.tryAdvance(2) || !cursor.tryReadBE(etherType)) {
+      return false;
+    }
+  }
+  if (!etherTypes_.empty() && etherTypes_.find(etherType) == etherTypes_.end()) {
+    return false;
+  }
+  if (depth_ == ParseDepth::L2) {
+    return true;
+  }
+
+  uint8_t ipProto;
+  size_t l4Offset;
+  bool fragment = false;
+  if (etherType == kEtherTypeIPv4) {
+    uint8_t versionIhl;
+    uint16_t fragmentOffset;
+    if (!cursor.tryRead(versionIhl) || !cursor.tryAdvance(5) ||
+        !cursor.tryReadBE(fragmentOffset) || !cursor.tryAdvance(1) ||
+        !cursor.tryRead(ipProto)) {
+      return false;
+    }
+    // We have read 10 bytes of the IPv4 header
+    l4Offset = (versionIhl & 0xf) * 4 - 10;
+    // Only the first fragment has the L4 header
+    fragment = (fragmentOffset & 0x1fff) != 0;
+  } else if (etherType == kEtherTypeIPv6) {
+    if (!cursor.tryAdvance(6) || !cursor.tryRead(ipProto)) {
+      return false;
+    }
+    // We have read 7 bytes of the 40 byte IPv6 header
+    l4Offset = 33;
+  } else {
+    return false;
+  }
+  if (!ipProtocols_.empty() &&
+      ipProtocols_.find(ipProto) == ipProtocols_.end()) {
+    return false;
+  }
+  if (depth_ == ParseDepth::L3) {
+    return true;
+  }
+
+  if (fragment || (ipProto != kIpProtoTcp && ipProto != kIpProtoUdp)) {
+    return false;
+  }
+  uint16_t srcPort, dstPort;
+  if (!cursor.tryAdvance(l4Offset) || !cursor.tryReadBE(srcPort) ||
+      !cursor.tryReadBE(dstPort)) {
+    return false;
+  }
+  return l4Ports_.find(srcPort) != l4Ports_.end() ||
+      l4Ports_.find(dstPort) != l4Ports_.end();
+}
+
 PktCapture::PktCapture(
     folly::StringPiece name,
     uint64_t maxPackets,
@@ -44,22 +149,27 @@ void PktCapture::stop() {
 }
 
 bool PktCapture::packetReceived(const RxPacket* pkt) {
-  std::lock_guard<std::mutex> guard(writer_.mutex());
   if (direction_ != CaptureDirection::CAPTURE_ONLY_TX &&
-      true == packetFilter_.passes(pkt)) {
-    ++numPacketsReceived_;
-    writer_.addPktLocked(pkt);
+      packetFilter_.passes(pkt)) {
+    if (!reservePacket()) {
+      return false;
+    }
+    numPacketsReceived_.fetch_add(1, std::memory_order_relaxed);
+    writer_.addPkt(pkt);
   }
-  return (numPacketsSent_ + numPacketsReceived_) < maxPackets_;
+  return !isFull();
 }
 
 bool PktCapture::packetSent(const TxPacket* pkt) {
-  std::lock_guard<std::mutex> guard(writer_.mutex());
-  if (direction_ != CaptureDirection::CAPTURE_ONLY_RX) {
-    ++numPacketsSent_;
-    writer_.addPktLocked(pkt);
+  if (direction_ != CaptureDirection::CAPTURE_ONLY_RX &&
+      packetFilter_.passes(pkt)) {
+    if (!reservePacket()) {
+      return false;
+    }
+    numPacketsSent_.fetch_add(1, std::memory_order_relaxed);
+    writer_.addPkt(pkt);
   }
-  return (numPacketsSent_ + numPacketsReceived_) < maxPackets_;
+  return !isFull();
 }
 
 std::string PktCapture::toString(bool withStats) const {
@@ -70,14 +180,14 @@ std::string PktCapture::toString(bool withStats) const {
              : ((direction_ == CaptureDirection::CAPTURE_ONLY_RX) ? "RX only"
                                                                   : "TX only"));
   if (withStats) {
-    ss << ", Packet received:" << numPacketsReceived_
-       << ", Packet sent:" << numPacketsSent_;
+    ss << ", Packet received:" << numPacketsReceived_.load()
+       << ", Packet sent:" << numPacketsSent_.load();
   }
   return ss.str();
 }
 
 int PktCapture::getCaptureCount() {
-  std::lock_guard<std::mutex> guard(writer_.mutex());
-  return (numPacketsSent_ + numPacketsReceived_);
+  return numPacketsSent_.load(std::memory_order_relaxed) +
+      numPacketsReceived_.load(std::memory_order_relaxed);
 }
 } // namespace facebook::fboss
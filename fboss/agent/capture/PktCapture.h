@@ -14,6 +14,7 @@
 
 #include <boost/container/flat_set.hpp>
 #include <folly/Range.h>
+#include <atomic>
 #include <string>
 #include "fboss/agent/RxPacket.h"
 #include "fboss/agent/TxPacket.h"
@@ -37,17 +38,35 @@ class RxPacketFilter {
   boost::container::flat_set<CpuCosQueueId> cosQueues_;
 };
 
+/*
+ * PacketFilter is evaluated on the packet RX/TX threads before anything is
+ * copied, so a capture with a narrow filter costs little on the slow path.
+ * The thrift filter is compiled once into sorted value sets, and a packet is
+ * only parsed as deep as the filter needs.
+ */
 class PacketFilter {
  public:
-  explicit PacketFilter(const CaptureFilter& captureFilter)
-      : rxPacketFilter_(captureFilter.get_rxCaptureFilter()) {}
+  explicit PacketFilter(const CaptureFilter& captureFilter);
+
+  bool passes(const RxPacket* pkt) const {
+    return rxPacketFilter_.passes(pkt) && headerPasses(pkt->buf());
+  }
 
-  bool passes(const RxPacket* pkt) {
-    return rxPacketFilter_.passes(pkt);
+  bool passes(const TxPacket* pkt) const {
+    return headerPasses(pkt->buf());
   }
 
  private:
+  // How many headers we need to parse to evaluate the filter
+  enum class ParseDepth { NONE, L2, L3, L4 };
+
+  bool headerPasses(const folly::IOBuf* buf) const;
+
   RxPacketFilter rxPacketFilter_;
+  boost::container::flat_set<uint16_t> etherTypes_;
+  boost::container::flat_set<uint8_t> ipProtocols_;
+  boost::container::flat_set<uint16_t> l4Ports_;
+  ParseDepth depth_{ParseDepth::NONE};
 };
 
 /*
@@ -83,15 +102,24 @@ class PktCapture {
   PktCapture(PktCapture const&) = delete;
   PktCapture& operator=(PktCapture const&) = delete;
 
+  // Reserves a slot for a packet, returns false if the capture is full
+  bool reservePacket() {
+    return numPackets_.fetch_add(1, std::memory_order_relaxed) < maxPackets_;
+  }
+  bool isFull() const {
+    return numPackets_.load(std::memory_order_relaxed) >= maxPackets_;
+  }
+
   const std::string name_;
 
-  // Note: the rest of the state in this class is protcted by
-  // the PcapWriter's mutex.
+  // packetReceived() and packetSent() may be called concurrently from the
+  // RX and TX threads, so the counters are atomic
   PcapWriter writer_;
-  uint64_t maxPackets_{0};
-  uint64_t numPacketsReceived_{0};
-  uint64_t numPacketsSent_{0};
-  CaptureDirection direction_{CaptureDirection::CAPTURE_TX_RX};
-  PacketFilter packetFilter_;
+  const uint64_t maxPackets_{0};
+  std::atomic<uint64_t> numPackets_{0};
+  std::atomic<uint64_t> numPacketsReceived_{0};
+  std::atomic<uint64_t> numPacketsSent_{0};
+  const CaptureDirection direction_{CaptureDirection::CAPTURE_TX_RX};
+  const PacketFilter packetFilter_;
 };
 } // namespace facebook::fboss
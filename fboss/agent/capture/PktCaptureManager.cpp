@@ -56,7 +56,7 @@ void PktCaptureManager::startCapture(unique_ptr<PktCapture> capture) {
   auto path =
       folly::to<std::string>(captureDir_, "/", capture->name(), ".pcap");
 
-  std::lock_guard<std::mutex> g(mutex_);
+  folly::SharedMutexWritePriority::WriteHolder g(&mutex_);
 
   const auto& name = capture->name();
   if (activeCaptures_.find(name) != activeCaptures_.end()) {
@@ -69,7 +69,7 @@ void PktCaptureManager::startCapture(unique_ptr<PktCapture> capture) {
 }
 
 void PktCaptureManager::stopCapture(StringPiece name) {
-  std::lock_guard<std::mutex> g(mutex_);
+  folly::SharedMutexWritePriority::WriteHolder g(&mutex_);
 
   auto nameStr = name.str();
   auto it = activeCaptures_.find(nameStr);
@@ -83,7 +83,7 @@ void PktCaptureManager::stopCapture(StringPiece name) {
 }
 
 unique_ptr<PktCapture> PktCaptureManager::forgetCapture(StringPiece name) {
-  std::lock_guard<std::mutex> g(mutex_);
+  folly::SharedMutexWritePriority::WriteHolder g(&mutex_);
   auto nameStr = name.str();
   auto activeIt = activeCaptures_.find(nameStr);
   if (activeIt != activeCaptures_.end()) {
@@ -105,49 +105,59 @@ unique_ptr<PktCapture> PktCaptureManager::forgetCapture(StringPiece name) {
 }
 
 void PktCaptureManager::stopAllCaptures() {
-  std::lock_guard<std::mutex> g(mutex_);
+  folly::SharedMutexWritePriority::WriteHolder g(&mutex_);
 
   // FIXME
 }
 
 void PktCaptureManager::forgetAllCaptures() {
-  std::lock_guard<std::mutex> g(mutex_);
+  folly::SharedMutexWritePriority::WriteHolder g(&mutex_);
 
   // FIXME
 }
 
 template <typename Fn>
 void PktCaptureManager::invokeCaptures(const Fn& fn) {
-  std::lock_guard<std::mutex> g(mutex_);
-
-  for (auto it = activeCaptures_.begin(); it != activeCaptures_.end();
-       /* increment in loop */) {
-    // Increment the iterator now, in case this capture deactivates itself and
-    // we need to remove it from the active captures.
-    auto thisIt = it;
-    ++it;
-    PktCapture* capture = thisIt->second.get();
-    bool stillActive = false;
-    try {
-      stillActive = fn(capture);
-    } catch (const std::exception& ex) {
-      XLOG(ERR) << "error when processing packet for capture "
-                << capture->name() << " : " << folly::exceptionStr(ex);
-      stillActive = false;
-    }
-
-    if (!stillActive) {
-      XLOG(DBG2) << "auto-stopping packet capture \"" << capture->name()
-                 << "\"";
+  std::vector<PktCapture*> finishedCaptures;
+  {
+    folly::SharedMutexWritePriority::ReadHolder g(&mutex_);
+    for (const auto& nameAndCapture : activeCaptures_) {
+      PktCapture* capture = nameAndCapture.second.get();
+      bool stillActive = false;
       try {
-        inactiveCaptures_[capture->name()] = std::move(thisIt->second);
+        stillActive = fn(capture);
       } catch (const std::exception& ex) {
-        XLOG(ERR) << "error adding capture " << capture->name()
-                  << " to the inactive list";
-        // Can't do much else here.  Just continue and forget the capture.
+        XLOG(ERR) << "error when processing packet for capture "
+                  << capture->name() << " : " << folly::exceptionStr(ex);
+        stillActive = false;
       }
-      activeCaptures_.erase(thisIt);
+      if (!stillActive) {
+        finishedCaptures.push_back(capture);
+      }
+    }
+  }
+  if (finishedCaptures.empty()) {
+    return;
+  }
+
+  folly::SharedMutexWritePriority::WriteHolder g(&mutex_);
+  for (auto capture : finishedCaptures) {
+    // Another packet thread may have retired this capture, or it may have
+    // been stopped, while we were not holding the lock
+    auto it = activeCaptures_.find(capture->name());
+    if (it == activeCaptures_.end() || it->second.get() != capture) {
+      continue;
+    }
+    XLOG(DBG2) << "auto-stopping packet capture \"" << capture->name()
+               << "\"";
+    try {
+      inactiveCaptures_[capture->name()] = std::move(it->second);
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "error adding capture " << capture->name()
+                << " to the inactive list";
+      // Can't do much else here.  Just continue and forget the capture.
     }
+    activeCaptures_.erase(it);
   }
 
   bool running = !activeCaptures_.empty();
@@ -177,7 +187,7 @@ void PktCaptureManager::checkCaptureName(folly::StringPiece name) {
 // routine as used in tests to verify if the pkt capture buffer
 // limit has been reached
 int PktCaptureManager::getCaptureCount(StringPiece name) {
-  std::lock_guard<std::mutex> g(mutex_);
+  folly::SharedMutexWritePriority::ReadHolder g(&mutex_);
   auto nameStr = name.str();
   auto it = activeCaptures_.find(nameStr);
   if (it == activeCaptures_.end()) {
@@ -10,12 +10,13 @@
 #pragma once
 
 #include <folly/Range.h>
+#include <folly/SharedMutex.h>
 
 #include <atomic>
 #include <map>
 #include <memory>
-#include <mutex>
 #include <string>
+#include <vector>
 #include "fboss/agent/PacketObserver.h"
 
 namespace facebook::fboss {
@@ -80,7 +81,10 @@ class PktCaptureManager : public PacketObserverIf {
 
   std::atomic<bool> capturesRunning_{false};
 
-  std::mutex mutex_;
+  // The packet RX/TX paths only take this for reading, so captures do not
+  // serialize them.  It is only taken for writing to start and stop
+  // captures.
+  folly::SharedMutexWritePriority mutex_;
   std::string captureDir_;
   std::map<std::string, std::unique_ptr<PktCapture>> activeCaptures_;
   std::map<std::string, std::unique_ptr<PktCapture>> inactiveCaptures_;
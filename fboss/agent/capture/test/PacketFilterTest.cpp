@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/capture/PktCapture.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+
+#include <folly/Format.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+
+namespace {
+
+std::unique_ptr<MockRxPacket> makeUdpPacket(
+    uint16_t srcPort,
+    uint16_t dstPort) {
+  auto pkt = MockRxPacket::fromHex(folly::sformat(
+      // dst mac, src mac
+      "02 00 01 00 00 01  02 00 02 01 02 03"
+      // 802.1q, VLAN 1
+      "81 00 00 01"
+      // IPv4
+      "08 00"
+      // Version(4), IHL(5), DSCP(0), ECN(0), Total Length(28)
+      "45  00  00 1c"
+      // Identification(0), Flags(0), Fragment offset(0)
+      "00 00  00 00"
+      // TTL(31), Protocol(17), Checksum (0, fake)
+      "1F  11  00 00"
+      // Source IP (1.2.3.4)
+      "01 02 03 04"
+      // Destination IP (10.0.0.10)
+      "0a 00 00 0a"
+      // Source port, destination port, length(8), checksum(0)
+      "{:04x} {:04x} 00 08 00 00",
+      srcPort,
+      dstPort));
+  pkt->padToLength(68);
+  return pkt;
+}
+
+std::unique_ptr<MockRxPacket> makeArpPacket() {
+  auto pkt = MockRxPacket::fromHex(
+      // dst mac, src mac
+      "ff ff ff ff ff ff  02 00 02 01 02 03"
+      // ARP
+      "08 06"
+      // Hardware type(1), protocol type(IPv4), sizes(6, 4), request(1)
+      "00 01 08 00 06 04 00 01");
+  pkt->padToLength(68);
+  return pkt;
+}
+
+CaptureFilter makeFilter(
+    std::vector<int32_t> etherTypes,
+    std::vector<int32_t> ipProtocols,
+    std::vector<int32_t> l4Ports) {
+  CaptureFilter filter;
+  filter.packetFilter()->etherTypes() = std::move(etherTypes);
+  filter.packetFilter()->ipProtocols() = std::move(ipProtocols);
+  filter.packetFilter()->l4Ports() = std::move(l4Ports);
+  return filter;
+}
+
+} // namespace
+
+TEST(PacketFilterTest, EmptyFilter) {
+  PacketFilter filter{CaptureFilter()};
+  EXPECT_TRUE(filter.passes(makeUdpPacket(1000, 2000).get()));
+  EXPECT_TRUE(filter.passes(makeArpPacket().get()));
+}
+
+TEST(PacketFilterTest, EtherType) {
+  PacketFilter filter{makeFilter({0x0806}, {}, {})};
+  EXPECT_FALSE(filter.passes(makeUdpPacket(1000, 2000).get()));
+  EXPECT_TRUE(filter.passes(makeArpPacket().get()));
+}
+
+TEST(PacketFilterTest, IpProtocol) {
+  PacketFilter udpFilter{makeFilter({}, {17}, {})};
+  EXPECT_TRUE(udpFilter.passes(makeUdpPacket(1000, 2000).get()));
+  EXPECT_FALSE(udpFilter.passes(makeArpPacket().get()));
+
+  PacketFilter tcpFilter{makeFilter({}, {6}, {})};
+  EXPECT_FALSE(tcpFilter.passes(makeUdpPacket(1000, 2000).get()));
+}
+
+TEST(PacketFilterTest, L4Port) {
+  PacketFilter filter{makeFilter({0x0800}, {17}, {67, 68})};
+  EXPECT_TRUE(filter.passes(makeUdpPacket(68, 67).get()));
+  EXPECT_TRUE(filter.passes(makeUdpPacket(1000, 67).get()));
+  EXPECT_FALSE(filter.passes(makeUdpPacket(1000, 2000).get()));
+  EXPECT_FALSE(filter.passes(makeArpPacket().get()));
+}
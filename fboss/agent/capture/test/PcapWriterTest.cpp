@@ -11,10 +11,15 @@
 #include "fboss/agent/capture/test/PcapUtil.h"
 #include "fboss/agent/hw/mock/MockRxPacket.h"
 
+#include <folly/Conv.h>
 #include <folly/Exception.h>
 #include <folly/ScopeGuard.h>
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+DECLARE_uint64(pcap_mmap_file_size);
+DECLARE_uint32(pcap_mmap_max_files);
+
 using namespace facebook::fboss;
 
 void addPackets(PcapWriter* writer, uint32_t count) {
@@ -101,3 +106,39 @@ TEST(PcapWriterTest, Drop) {
     EXPECT_EQ(68, pktInfo.hdr.caplen);
   }
 }
+
+TEST(PcapWriterTest, MmapRotate) {
+  char tmpPath[] = "fbossPcapTest.XXXXXX";
+  int tmpFD = mkstemp(tmpPath);
+  folly::checkUnixError(tmpFD, "failed to create temporary file");
+  auto rotatedPath = [&](int n) {
+    return folly::to<std::string>(tmpPath, ".", n);
+  };
+  SCOPE_EXIT {
+    close(tmpFD);
+    unlink(tmpPath);
+    for (int n = 1; n <= 3; ++n) {
+      unlink(rotatedPath(n).c_str());
+    }
+  };
+
+  // Room for the 24 byte global header and 10 packets of 16 + 68 bytes
+  gflags::FlagSaver flagSaver;
+  FLAGS_pcap_mmap_file_size = 24 + 10 * (16 + 68);
+  FLAGS_pcap_mmap_max_files = 2;
+
+  PcapWriter writer(tmpPath, true);
+  addPackets(&writer, 35);
+  writer.finish();
+  EXPECT_EQ(0, writer.numDropped());
+
+  // The first 10 packets were rotated out
+  EXPECT_EQ(5, readPcapFile(tmpPath).size());
+  EXPECT_EQ(10, readPcapFile(rotatedPath(1).c_str()).size());
+  EXPECT_EQ(10, readPcapFile(rotatedPath(2).c_str()).size());
+  EXPECT_NE(0, access(rotatedPath(3).c_str(), F_OK));
+  for (const auto& pktInfo : readPcapFile(tmpPath)) {
+    EXPECT_EQ(68, pktInfo.hdr.len);
+    EXPECT_EQ(68, pktInfo.hdr.caplen);
+  }
+}
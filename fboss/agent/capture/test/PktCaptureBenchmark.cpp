@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/capture/PktCapture.h"
+#include "fboss/agent/hw/mock/MockRxPacket.h"
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+
+#include <limits>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+
+/*
+ * Measures what an active packet capture adds to the cost of receiving a
+ * packet on the slow path, for packets the capture filter drops and for
+ * packets it captures.  The captured packets are written to /dev/null; the
+ * capture queue drops packets once it fills up, which only makes capturing
+ * cheaper.
+ */
+namespace {
+
+std::unique_ptr<MockRxPacket> makeUdpPacket() {
+  auto pkt = MockRxPacket::fromHex(
+      // dst mac, src mac
+      "02 00 01 00 00 01  02 00 02 01 02 03"
+      // 802.1q, VLAN 1
+      "81 00 00 01"
+      // IPv4
+      "08 00"
+      // Version(4), IHL(5), DSCP(0), ECN(0), Total Length(28)
+      "45  00  00 1c"
+      // Identification(0), Flags(0), Fragment offset(0)
+      "00 00  00 00"
+      // TTL(31), Protocol(17), Checksum (0, fake)
+      "1F  11  00 00"
+      // Source IP (1.2.3.4)
+      "01 02 03 04"
+      // Destination IP (10.0.0.10)
+      "0a 00 00 0a"
+      // Source port(68), destination port(67), length(8), checksum(0)
+      "00 44 00 43 00 08 00 00");
+  pkt->padToLength(128);
+  pkt->setSrcPort(PortID(1));
+  pkt->setSrcVlan(VlanID(1));
+  return pkt;
+}
+
+void capturePackets(size_t iters, int32_t l4Port, size_t numThreads) {
+  std::unique_ptr<PktCapture> capture;
+  std::unique_ptr<MockRxPacket> pkt;
+  BENCHMARK_SUSPEND {
+    CaptureFilter filter;
+    filter.packetFilter()->l4Ports() = {l4Port};
+    capture = std::make_unique<PktCapture>(
+        "benchmark",
+        std::numeric_limits<uint64_t>::max(),
+        CaptureDirection::CAPTURE_TX_RX,
+        filter);
+    capture->start("/dev/null");
+    pkt = makeUdpPacket();
+  }
+
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < numThreads; ++t) {
+    threads.emplace_back([&] {
+      for (size_t i = 0; i < iters / numThreads; ++i) {
+        folly::doNotOptimizeAway(capture->packetReceived(pkt.get()));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  BENCHMARK_SUSPEND {
+    capture->stop();
+    capture.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK(CaptureFilterMiss, iters) {
+  capturePackets(iters, 179, 1);
+}
+
+BENCHMARK(CaptureFilterHit, iters) {
+  capturePackets(iters, 67, 1);
+}
+
+BENCHMARK(CaptureFilterMissFourThreads, iters) {
+  capturePackets(iters, 179, 4);
+}
+
+BENCHMARK(CaptureFilterHitFourThreads, iters) {
+  capturePackets(iters, 67, 4);
+}
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
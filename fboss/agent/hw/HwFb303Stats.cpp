@@ -67,6 +67,13 @@ void HwFb303Stats::removeStat(const std::string& statName) {
   counters_.erase(stat->getName());
 }
 
+stats::MonotonicCounter* HwFb303Stats::getCounterHandle(
+    const std::string& statName) {
+  auto stat = getCounterIf(statName);
+  CHECK(stat) << "Missing stat: " << statName;
+  return stat;
+}
+
 void HwFb303Stats::updateStat(
     const std::chrono::seconds& now,
     const std::string& statName,
@@ -36,6 +36,12 @@ class HwFb303Stats {
       int64_t val);
   void removeStat(const std::string& statName);
 
+  /*
+   * Counter for statName, which can be updated directly instead of looking
+   * it up by name. Stays valid until the stat is reinited or removed.
+   */
+  stats::MonotonicCounter* getCounterHandle(const std::string& statName);
+
  private:
   /*
    * Update queue stat
@@ -44,6 +50,7 @@ class HwFb303Stats {
   const stats::MonotonicCounter* getCounterIf(
       const std::string& statName) const;
 
-  folly::F14FastMap<std::string, stats::MonotonicCounter> counters_;
+  // Node map, so counter handles stay valid as other stats come and go
+  folly::F14NodeMap<std::string, stats::MonotonicCounter> counters_;
 };
 } // namespace facebook::fboss
@@ -16,7 +16,25 @@
 
 namespace facebook::fboss {
 
-std::array<folly::StringPiece, 24> HwPortFb303Stats::kPortStatKeys() {
+namespace {
+/*
+ * Update the first numValues counters, with values in the same order as the
+ * counters
+ */
+template <size_t N>
+void updateCounters(
+    const std::chrono::seconds& now,
+    const std::array<stats::MonotonicCounter*, N>& counters,
+    const std::array<int64_t, N>& values,
+    size_t numValues = N) {
+  for (size_t i = 0; i < numValues; ++i) {
+    counters[i]->updateValue(now, values[i]);
+  }
+}
+} // namespace
+
+std::array<folly::StringPiece, HwPortFb303Stats::kNumPortStats>
+HwPortFb303Stats::kPortStatKeys() {
   return {
       kInBytes(),
       kInUnicastPkts(),
@@ -45,7 +63,8 @@ std::array<folly::StringPiece, 24> HwPortFb303Stats::kPortStatKeys() {
   };
 }
 
-std::array<folly::StringPiece, 5> HwPortFb303Stats::kQueueStatKeys() {
+std::array<folly::StringPiece, HwPortFb303Stats::kNumQueueStats>
+HwPortFb303Stats::kQueueStatKeys() {
   return {
       kOutCongestionDiscardsBytes(),
       kOutCongestionDiscards(),
@@ -54,7 +73,8 @@ std::array<folly::StringPiece, 5> HwPortFb303Stats::kQueueStatKeys() {
       kWredDroppedPackets()};
 }
 
-std::array<folly::StringPiece, 15> HwPortFb303Stats::kInMacsecPortStatKeys() {
+std::array<folly::StringPiece, HwPortFb303Stats::kNumInMacsecPortStats>
+HwPortFb303Stats::kInMacsecPortStatKeys() {
   return {
       kInPreMacsecDropPkts(),
       kInMacsecControlPkts(),
@@ -74,7 +94,8 @@ std::array<folly::StringPiece, 15> HwPortFb303Stats::kInMacsecPortStatKeys() {
   };
 }
 
-std::array<folly::StringPiece, 6> HwPortFb303Stats::kOutMacsecPortStatKeys() {
+std::array<folly::StringPiece, HwPortFb303Stats::kNumOutMacsecPortStats>
+HwPortFb303Stats::kOutMacsecPortStatKeys() {
   return {
       kOutPreMacsecDropPkts(),
       kOutMacsecControlPkts(),
@@ -128,6 +149,31 @@ void HwPortFb303Stats::reinitStats(std::optional<std::string> oldPortName) {
   if (macsecStatsInited_) {
     reinitMacsecStats(oldPortName);
   }
+  reinitStatHandles();
+}
+
+void HwPortFb303Stats::reinitStatHandles() {
+  auto reinitHandles = [this](const auto& statKeys, auto& handles) {
+    for (size_t i = 0; i < statKeys.size(); ++i) {
+      handles[i] =
+          portCounters_.getCounterHandle(statName(statKeys[i], portName_));
+    }
+  };
+  reinitHandles(kPortStatKeys(), portStatHandles_);
+  if (macsecStatsInited_) {
+    reinitHandles(kInMacsecPortStatKeys(), inMacsecStatHandles_);
+    reinitHandles(kOutMacsecPortStatKeys(), outMacsecStatHandles_);
+  }
+  queueStatHandles_.clear();
+  auto queueStatKeys = kQueueStatKeys();
+  for (const auto& [queueId, queueName] : queueId2Name_) {
+    QueueStatHandles queue{queueId, {}};
+    for (size_t i = 0; i < queueStatKeys.size(); ++i) {
+      queue.counters[i] = portCounters_.getCounterHandle(
+          statName(queueStatKeys[i], portName_, queueId, queueName));
+    }
+    queueStatHandles_.push_back(queue);
+  }
 }
 
 /*
@@ -181,6 +227,7 @@ void HwPortFb303Stats::queueChanged(int queueId, const std::string& queueName) {
   for (auto statKey : kQueueStatKeys()) {
     reinitStat(statKey, queueId, oldQueueName);
   }
+  reinitStatHandles();
 }
 
 void HwPortFb303Stats::queueRemoved(int queueId) {
@@ -190,89 +237,82 @@ void HwPortFb303Stats::queueRemoved(int queueId) {
         statName(statKey, portName_, queueId, queueId2Name_[queueId]));
   }
   queueId2Name_.erase(queueId);
+  reinitStatHandles();
 }
 
 void HwPortFb303Stats::updateStats(
     const HwPortStats& curPortStats,
     const std::chrono::seconds& retrievedAt) {
   timeRetrieved_ = retrievedAt;
-  updateStat(timeRetrieved_, kInBytes(), *curPortStats.inBytes_());
-  updateStat(timeRetrieved_, kInUnicastPkts(), *curPortStats.inUnicastPkts_());
-  updateStat(
-      timeRetrieved_, kInMulticastPkts(), *curPortStats.inMulticastPkts_());
-  updateStat(
-      timeRetrieved_, kInBroadcastPkts(), *curPortStats.inBroadcastPkts_());
-  updateStat(timeRetrieved_, kInDiscardsRaw(), *curPortStats.inDiscardsRaw_());
-  updateStat(timeRetrieved_, kInDiscards(), *curPortStats.inDiscards_());
-  updateStat(timeRetrieved_, kInErrors(), *curPortStats.inErrors_());
-  updateStat(timeRetrieved_, kInPause(), *curPortStats.inPause_());
-  updateStat(
-      timeRetrieved_, kInIpv4HdrErrors(), *curPortStats.inIpv4HdrErrors_());
-  updateStat(
-      timeRetrieved_, kInIpv6HdrErrors(), *curPortStats.inIpv6HdrErrors_());
-  updateStat(
-      timeRetrieved_, kInDstNullDiscards(), *curPortStats.inDstNullDiscards_());
-  // Egress Stats
-  updateStat(timeRetrieved_, kOutBytes(), *curPortStats.outBytes_());
-  updateStat(
-      timeRetrieved_, kOutUnicastPkts(), *curPortStats.outUnicastPkts_());
-  updateStat(
-      timeRetrieved_, kOutMulticastPkts(), *curPortStats.outMulticastPkts_());
-  updateStat(
-      timeRetrieved_, kOutBroadcastPkts(), *curPortStats.outBroadcastPkts_());
-  updateStat(timeRetrieved_, kOutDiscards(), *curPortStats.outDiscards_());
-  updateStat(timeRetrieved_, kOutErrors(), *curPortStats.outErrors_());
-  updateStat(timeRetrieved_, kOutPause(), *curPortStats.outPause_());
-  updateStat(
-      timeRetrieved_,
-      kOutCongestionDiscards(),
-      *curPortStats.outCongestionDiscardPkts_());
-  updateStat(
+  // Values in kPortStatKeys() order
+  updateCounters<kNumPortStats>(
       timeRetrieved_,
-      kWredDroppedPackets(),
-      *curPortStats.wredDroppedPackets_());
-  updateStat(timeRetrieved_, kOutEcnCounter(), *curPortStats.outEcnCounter_());
-  updateStat(
-      timeRetrieved_, kFecCorrectable(), *curPortStats.fecCorrectableErrors());
-  updateStat(
-      timeRetrieved_,
-      kFecUncorrectable(),
-      *curPortStats.fecUncorrectableErrors());
-  updateStat(
-      timeRetrieved_,
-      kInLabelMissDiscards(),
-      *curPortStats.inLabelMissDiscards_());
+      portStatHandles_,
+      {
+          *curPortStats.inBytes_(),
+          *curPortStats.inUnicastPkts_(),
+          *curPortStats.inMulticastPkts_(),
+          *curPortStats.inBroadcastPkts_(),
+          *curPortStats.inDiscards_(),
+          *curPortStats.inErrors_(),
+          *curPortStats.inPause_(),
+          *curPortStats.inIpv4HdrErrors_(),
+          *curPortStats.inIpv6HdrErrors_(),
+          *curPortStats.inDstNullDiscards_(),
+          *curPortStats.inDiscardsRaw_(),
+          // Egress Stats
+          *curPortStats.outBytes_(),
+          *curPortStats.outUnicastPkts_(),
+          *curPortStats.outMulticastPkts_(),
+          *curPortStats.outBroadcastPkts_(),
+          *curPortStats.outDiscards_(),
+          *curPortStats.outErrors_(),
+          *curPortStats.outPause_(),
+          *curPortStats.outCongestionDiscardPkts_(),
+          *curPortStats.wredDroppedPackets_(),
+          *curPortStats.outEcnCounter_(),
+          *curPortStats.fecCorrectableErrors(),
+          *curPortStats.fecUncorrectableErrors(),
+          *curPortStats.inLabelMissDiscards_(),
+      });
 
   // Update queue stats
-  auto updateQueueStat = [this](
-                             folly::StringPiece statKey,
-                             int queueId,
-                             const std::map<int16_t, int64_t>& queueStats) {
+  auto queueStat = [this](
+                       folly::StringPiece statKey,
+                       int queueId,
+                       const std::map<int16_t, int64_t>& queueStats) {
     auto qitr = queueStats.find(queueId);
     CHECK(qitr != queueStats.end())
         << "Missing stat: " << statKey
         << " for queue: :" << queueId2Name_[queueId];
-    updateStat(timeRetrieved_, statKey, queueId, qitr->second);
+    return qitr->second;
   };
-  for (const auto& queueIdAndName : queueId2Name_) {
-    updateQueueStat(
-        kOutCongestionDiscardsBytes(),
-        queueIdAndName.first,
-        *curPortStats.queueOutDiscardBytes_());
-    updateQueueStat(
-        kOutCongestionDiscards(),
-        queueIdAndName.first,
-        *curPortStats.queueOutDiscardPackets_());
-    updateQueueStat(
-        kOutBytes(), queueIdAndName.first, *curPortStats.queueOutBytes_());
-    updateQueueStat(
-        kOutPkts(), queueIdAndName.first, *curPortStats.queueOutPackets_());
-    if (curPortStats.queueWredDroppedPackets_()->size()) {
-      updateQueueStat(
-          kWredDroppedPackets(),
-          queueIdAndName.first,
-          *curPortStats.queueWredDroppedPackets_());
-    }
+  bool hasWredStats = curPortStats.queueWredDroppedPackets_()->size();
+  for (const auto& queue : queueStatHandles_) {
+    // Values in kQueueStatKeys() order, wred drops coming last
+    updateCounters<kNumQueueStats>(
+        timeRetrieved_,
+        queue.counters,
+        {
+            queueStat(
+                kOutCongestionDiscardsBytes(),
+                queue.queueId,
+                *curPortStats.queueOutDiscardBytes_()),
+            queueStat(
+                kOutCongestionDiscards(),
+                queue.queueId,
+                *curPortStats.queueOutDiscardPackets_()),
+            queueStat(
+                kOutBytes(), queue.queueId, *curPortStats.queueOutBytes_()),
+            queueStat(
+                kOutPkts(), queue.queueId, *curPortStats.queueOutPackets_()),
+            hasWredStats ? queueStat(
+                               kWredDroppedPackets(),
+                               queue.queueId,
+                               *curPortStats.queueWredDroppedPackets_())
+                         : 0,
+        },
+        hasWredStats ? kNumQueueStats : kNumQueueStats - 1);
   }
   if (curPortStats.queueWatermarkBytes_()->size()) {
     updateQueueWatermarkStats(*curPortStats.queueWatermarkBytes_());
@@ -281,101 +321,44 @@ void HwPortFb303Stats::updateStats(
   if (curPortStats.macsecStats()) {
     if (!macsecStatsInited_) {
       reinitMacsecStats(std::nullopt);
+      reinitStatHandles();
     }
-    auto updateMacsecPortStats = [this](auto& macsecPortStats, bool ingress) {
-      updateStat(
-          timeRetrieved_,
-          ingress ? kInPreMacsecDropPkts() : kOutPreMacsecDropPkts(),
-          *macsecPortStats.preMacsecDropPkts());
-      updateStat(
-          timeRetrieved_,
-          ingress ? kInMacsecDataPkts() : kOutMacsecDataPkts(),
-          *macsecPortStats.dataPkts());
-      updateStat(
-          timeRetrieved_,
-          ingress ? kInMacsecControlPkts() : kOutMacsecControlPkts(),
-          *macsecPortStats.controlPkts());
-      updateStat(
-          timeRetrieved_,
-          ingress ? kInMacsecDecryptedBytes() : kOutMacsecEncryptedBytes(),
-          *macsecPortStats.octetsEncrypted());
-      if (ingress) {
-        updateStat(
-            timeRetrieved_,
-            kInMacsecBadOrNoTagDroppedPkts(),
-            *macsecPortStats.inBadOrNoMacsecTagDroppedPkts());
-        updateStat(
-            timeRetrieved_,
-            kInMacsecNoSciDroppedPkts(),
-            *macsecPortStats.inNoSciDroppedPkts());
-        updateStat(
-            timeRetrieved_,
-            kInMacsecUnknownSciPkts(),
-            *macsecPortStats.inUnknownSciPkts());
-        updateStat(
-            timeRetrieved_,
-            kInMacsecOverrunDroppedPkts(),
-            *macsecPortStats.inOverrunDroppedPkts());
-        updateStat(
-            timeRetrieved_,
-            kInMacsecDelayedPkts(),
-            *macsecPortStats.inDelayedPkts());
-        updateStat(
-            timeRetrieved_,
-            kInMacsecLateDroppedPkts(),
-            *macsecPortStats.inLateDroppedPkts());
-        updateStat(
-            timeRetrieved_,
-            kInMacsecNotValidDroppedPkts(),
-            *macsecPortStats.inNotValidDroppedPkts());
-        updateStat(
-            timeRetrieved_,
-            kInMacsecInvalidPkts(),
-            *macsecPortStats.inInvalidPkts());
-        updateStat(
-            timeRetrieved_,
-            kInMacsecNoSADroppedPkts(),
-            *macsecPortStats.inNoSaDroppedPkts());
-        updateStat(
-            timeRetrieved_,
-            kInMacsecUnusedSAPkts(),
-            *macsecPortStats.inUnusedSaPkts());
-        updateStat(
-            timeRetrieved_,
-            kInMacsecUntaggedPkts(),
-            *macsecPortStats.noMacsecTagPkts());
-      } else {
-        updateStat(
-            timeRetrieved_,
-            kOutMacsecUntaggedPkts(),
-            *macsecPortStats.noMacsecTagPkts());
-        updateStat(
-            timeRetrieved_,
-            kOutMacsecTooLongDroppedPkts(),
-            *macsecPortStats.outTooLongDroppedPkts());
-      }
-    };
-    updateMacsecPortStats(
-        *curPortStats.macsecStats()->ingressPortStats(), true);
-    updateMacsecPortStats(
-        *curPortStats.macsecStats()->egressPortStats(), false);
+    const auto& ingress = *curPortStats.macsecStats()->ingressPortStats();
+    // Values in kInMacsecPortStatKeys() order
+    updateCounters<kNumInMacsecPortStats>(
+        timeRetrieved_,
+        inMacsecStatHandles_,
+        {
+            *ingress.preMacsecDropPkts(),
+            *ingress.controlPkts(),
+            *ingress.dataPkts(),
+            *ingress.octetsEncrypted(),
+            *ingress.inBadOrNoMacsecTagDroppedPkts(),
+            *ingress.inNoSciDroppedPkts(),
+            *ingress.inUnknownSciPkts(),
+            *ingress.inOverrunDroppedPkts(),
+            *ingress.inDelayedPkts(),
+            *ingress.inLateDroppedPkts(),
+            *ingress.inNotValidDroppedPkts(),
+            *ingress.inInvalidPkts(),
+            *ingress.inNoSaDroppedPkts(),
+            *ingress.inUnusedSaPkts(),
+            *ingress.noMacsecTagPkts(),
+        });
+    const auto& egress = *curPortStats.macsecStats()->egressPortStats();
+    // Values in kOutMacsecPortStatKeys() order
+    updateCounters<kNumOutMacsecPortStats>(
+        timeRetrieved_,
+        outMacsecStatHandles_,
+        {
+            *egress.preMacsecDropPkts(),
+            *egress.controlPkts(),
+            *egress.dataPkts(),
+            *egress.octetsEncrypted(),
+            *egress.outTooLongDroppedPkts(),
+            *egress.noMacsecTagPkts(),
+        });
   }
   portStats_ = curPortStats;
 }
-
-void HwPortFb303Stats::updateStat(
-    const std::chrono::seconds& now,
-    folly::StringPiece statKey,
-    int queueId,
-    int64_t val) {
-  portCounters_.updateStat(
-      now, statName(statKey, portName_, queueId, queueId2Name_[queueId]), val);
-}
-
-void HwPortFb303Stats::updateStat(
-    const std::chrono::seconds& now,
-    folly::StringPiece statKey,
-    int64_t val) {
-  portCounters_.updateStat(now, statName(statKey, portName_), val);
-}
 } // namespace facebook::fboss
@@ -15,8 +15,10 @@
 
 #include "folly/container/F14Map.h"
 
+#include <array>
 #include <optional>
 #include <string>
+#include <vector>
 
 namespace facebook::fboss {
 
@@ -70,10 +72,16 @@ class HwPortFb303Stats {
       int queueId,
       folly::StringPiece queueName);
 
-  static std::array<folly::StringPiece, 24> kPortStatKeys();
-  static std::array<folly::StringPiece, 5> kQueueStatKeys();
-  static std::array<folly::StringPiece, 15> kInMacsecPortStatKeys();
-  static std::array<folly::StringPiece, 6> kOutMacsecPortStatKeys();
+  static constexpr size_t kNumPortStats = 24;
+  static constexpr size_t kNumQueueStats = 5;
+  static constexpr size_t kNumInMacsecPortStats = 15;
+  static constexpr size_t kNumOutMacsecPortStats = 6;
+  static std::array<folly::StringPiece, kNumPortStats> kPortStatKeys();
+  static std::array<folly::StringPiece, kNumQueueStats> kQueueStatKeys();
+  static std::array<folly::StringPiece, kNumInMacsecPortStats>
+  kInMacsecPortStatKeys();
+  static std::array<folly::StringPiece, kNumOutMacsecPortStats>
+  kOutMacsecPortStatKeys();
   int64_t getCounterLastIncrement(folly::StringPiece statKey) const;
 
  private:
@@ -101,20 +109,10 @@ class HwPortFb303Stats {
       const std::string& statName,
       std::optional<std::string> oldStatName);
   /*
-   * update port stat
+   * Look up the counters updated every stats cycle, once they are
+   * (re)named, so updateStats need not build their names
    */
-  void updateStat(
-      const std::chrono::seconds& now,
-      folly::StringPiece statKey,
-      int64_t val);
-  /*
-   * update port queue stat
-   */
-  void updateStat(
-      const std::chrono::seconds& now,
-      folly::StringPiece statKey,
-      int queueId,
-      int64_t val);
+  void reinitStatHandles();
 
   void updateQueueWatermarkStats(
       const std::map<int16_t, int64_t>& queueWatermarkBytes) const;
@@ -124,6 +122,18 @@ class HwPortFb303Stats {
   QueueId2Name queueId2Name_;
   HwPortStats portStats_;
   bool macsecStatsInited_{false};
+
+  template <size_t N>
+  using StatHandles = std::array<stats::MonotonicCounter*, N>;
+  struct QueueStatHandles {
+    int queueId;
+    StatHandles<kNumQueueStats> counters;
+  };
+  // In the order of the corresponding stat keys
+  StatHandles<kNumPortStats> portStatHandles_{};
+  std::vector<QueueStatHandles> queueStatHandles_;
+  StatHandles<kNumInMacsecPortStats> inMacsecStatHandles_{};
+  StatHandles<kNumOutMacsecPortStats> outMacsecStatHandles_{};
 };
 
 } // namespace facebook::fboss
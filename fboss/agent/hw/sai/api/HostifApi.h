@@ -205,7 +205,7 @@ class HostifApi : public SaiApi<HostifApi> {
       const SaiTxPacketTraits::TxAttributes& attributes,
       sai_object_id_t switch_id,
       const SaiHostifApiPacket& txPacket) const {
-    std::vector<sai_attribute_t> saiAttributeTs = saiAttrs(attributes);
+    auto saiAttributeTs = saiAttrArray(attributes);
     return api_->send_hostif_packet(
         switch_id,
         txPacket.size,
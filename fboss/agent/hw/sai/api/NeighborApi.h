@@ -138,6 +138,56 @@ class NeighborApi : public SaiApi<NeighborApi> {
       const SaiNeighborTraits::NeighborEntry& neighborEntry) const {
     return api_->remove_neighbor_entry(neighborEntry.entry());
   }
+  sai_status_t _bulkCreate(
+      const SaiNeighborTraits::NeighborEntry* neighborEntrys,
+      size_t objectCount,
+      const uint32_t* attrCounts,
+      const sai_attribute_t** attrLists,
+      sai_status_t* retStatus) const {
+#if SAI_API_VERSION >= SAI_VERSION(1, 10, 0)
+    std::vector<sai_neighbor_entry_t> entries;
+    entries.reserve(objectCount);
+    for (auto idx = 0; idx < objectCount; idx++) {
+      entries.push_back(*neighborEntrys[idx].entry());
+    }
+    if (!api_->create_neighbor_entries) {
+      // let SaiApi fall back to per object calls
+      return SAI_STATUS_NOT_SUPPORTED;
+    }
+    return api_->create_neighbor_entries(
+        objectCount,
+        entries.data(),
+        attrCounts,
+        attrLists,
+        SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+        retStatus);
+#else
+    return SAI_STATUS_NOT_SUPPORTED;
+#endif
+  }
+  sai_status_t _bulkRemove(
+      const SaiNeighborTraits::NeighborEntry* neighborEntrys,
+      size_t objectCount,
+      sai_status_t* retStatus) const {
+#if SAI_API_VERSION >= SAI_VERSION(1, 10, 0)
+    std::vector<sai_neighbor_entry_t> entries;
+    entries.reserve(objectCount);
+    for (auto idx = 0; idx < objectCount; idx++) {
+      entries.push_back(*neighborEntrys[idx].entry());
+    }
+    if (!api_->remove_neighbor_entries) {
+      // let SaiApi fall back to per object calls
+      return SAI_STATUS_NOT_SUPPORTED;
+    }
+    return api_->remove_neighbor_entries(
+        objectCount,
+        entries.data(),
+        SAI_BULK_OP_ERROR_MODE_IGNORE_ERROR,
+        retStatus);
+#else
+    return SAI_STATUS_NOT_SUPPORTED;
+#endif
+  }
   sai_status_t _getAttribute(
       const SaiNeighborTraits::NeighborEntry& neighborEntry,
       sai_attribute_t* attr) const {
@@ -68,7 +68,7 @@ class SaiApi {
         std::is_same_v<typename SaiObjectTraits::SaiApiT, ApiT>,
         "invalid traits for the api");
     typename SaiObjectTraits::AdapterKey key;
-    std::vector<sai_attribute_t> saiAttributeTs = saiAttrs(createAttributes);
+    auto saiAttributeTs = saiAttrArray(createAttributes);
     if (UNLIKELY(failHwWrites() || skipHwWrites())) {
       // Fail hard on both skip and fail Hw write settings. For FAIL, its
       // obvious why we fail hard. For SKIP, we fail since the expectation here
@@ -86,11 +86,15 @@ class SaiApi {
       status = impl()._create(
           &key, switch_id, saiAttributeTs.size(), saiAttributeTs.data());
     }
-    saiApiCheckError(
-        status,
-        apiType(),
-        fmt::format(
-            "Failed to create sai entity {}: {}", key, createAttributes));
+    // Only format the error message on failure, formatting all the create
+    // attributes costs more than the create itself
+    if (UNLIKELY(status != SAI_STATUS_SUCCESS)) {
+      saiApiCheckError(
+          status,
+          apiType(),
+          fmt::format(
+              "Failed to create sai entity {}: {}", key, createAttributes));
+    }
     XLOGF(DBG5, "created SAI object: {}: {}", key, createAttributes);
     return key;
   }
@@ -108,7 +112,7 @@ class SaiApi {
     if (UNLIKELY(skipHwWrites())) {
       return;
     }
-    std::vector<sai_attribute_t> saiAttributeTs = saiAttrs(createAttributes);
+    auto saiAttributeTs = saiAttrArray(createAttributes);
     if (UNLIKELY(failHwWrites())) {
       XLOGF(
           FATAL,
@@ -122,11 +126,13 @@ class SaiApi {
       status =
           impl()._create(entry, saiAttributeTs.size(), saiAttributeTs.data());
     }
-    saiApiCheckError(
-        status,
-        apiType(),
-        fmt::format(
-            "Failed to create sai entity: {}: {}", entry, createAttributes));
+    if (UNLIKELY(status != SAI_STATUS_SUCCESS)) {
+      saiApiCheckError(
+          status,
+          apiType(),
+          fmt::format(
+              "Failed to create sai entity: {}: {}", entry, createAttributes));
+    }
     XLOGF(DBG5, "created SAI object: {}: {}", entry, createAttributes);
   }
 
@@ -147,13 +153,141 @@ class SaiApi {
       TIME_CALL;
       status = impl()._remove(key);
     }
-    saiApiCheckError(
-        status,
-        apiType(),
-        fmt::format("Failed to remove sai object : {}", key));
+    if (UNLIKELY(status != SAI_STATUS_SUCCESS)) {
+      saiApiCheckError(
+          status,
+          apiType(),
+          fmt::format("Failed to remove sai object : {}", key));
+    }
     XLOGF(DBG5, "removed SAI object: {}", key);
   }
 
+  /*
+   * Create or remove many entry struct objects with a single call into the
+   * adapter. Falls back to one call per object for adapters (or SAI
+   * versions) without bulk support for the object type.
+   */
+  template <typename SaiObjectTraits>
+  std::enable_if_t<AdapterKeyIsEntryStruct<SaiObjectTraits>::value, void>
+  bulkCreate(
+      const std::vector<typename SaiObjectTraits::AdapterKey>& entries,
+      const std::vector<typename SaiObjectTraits::CreateAttributes>&
+          createAttributes) const {
+    static_assert(
+        std::is_same_v<typename SaiObjectTraits::SaiApiT, ApiT>,
+        "invalid traits for the api");
+    XCHECK_EQ(entries.size(), createAttributes.size());
+    if (UNLIKELY(skipHwWrites()) || entries.empty()) {
+      return;
+    }
+    if (UNLIKELY(failHwWrites())) {
+      XLOG(
+          FATAL,
+          "Attempting bulk create SAI objs while hw writes are blocked");
+    }
+    std::vector<std::vector<sai_attribute_t>> saiAttributeTs;
+    std::vector<uint32_t> attrCounts;
+    std::vector<const sai_attribute_t*> attrLists;
+    saiAttributeTs.reserve(entries.size());
+    attrCounts.reserve(entries.size());
+    attrLists.reserve(entries.size());
+    for (const auto& attributes : createAttributes) {
+      saiAttributeTs.push_back(saiAttrArray(attributes));
+      attrCounts.push_back(saiAttributeTs.back().size());
+      attrLists.push_back(saiAttributeTs.back().data());
+    }
+    auto g{SaiApiLock::getInstance()->lock()};
+    sai_status_t status;
+    std::vector<sai_status_t> retStatus(entries.size(), SAI_STATUS_SUCCESS);
+    {
+      TIME_CALL;
+      status = impl()._bulkCreate(
+          entries.data(),
+          entries.size(),
+          attrCounts.data(),
+          attrLists.data(),
+          retStatus.data());
+    }
+    if (status == SAI_STATUS_NOT_SUPPORTED ||
+        status == SAI_STATUS_NOT_IMPLEMENTED) {
+      for (auto idx = 0; idx < entries.size(); idx++) {
+        TIME_CALL;
+        retStatus[idx] = impl()._create(
+            entries[idx], attrCounts[idx], saiAttributeTs[idx].data());
+      }
+    } else if (UNLIKELY(
+                   status != SAI_STATUS_SUCCESS &&
+                   status != SAI_STATUS_FAILURE)) {
+      // SAI_STATUS_FAILURE means some objects failed, as reported below
+      saiApiCheckError(status, apiType(), "Failed to bulk create");
+    }
+    for (auto idx = 0; idx < entries.size(); idx++) {
+      if (UNLIKELY(retStatus[idx] != SAI_STATUS_SUCCESS)) {
+        saiApiCheckError(
+            retStatus[idx],
+            apiType(),
+            fmt::format(
+                "Failed to create sai entity: {}: {}",
+                entries[idx],
+                createAttributes[idx]));
+      }
+      XLOGF(
+          DBG5,
+          "bulk created SAI object: {}: {}",
+          entries[idx],
+          createAttributes[idx]);
+    }
+  }
+
+  /*
+   * ignoreMissing skips objects the adapter no longer has, such as FDB
+   * entries which aged out.
+   */
+  template <typename AdapterKeyT>
+  void bulkRemove(
+      const std::vector<AdapterKeyT>& keys,
+      bool ignoreMissing = false) const {
+    if (UNLIKELY(skipHwWrites()) || keys.empty()) {
+      return;
+    }
+    if (UNLIKELY(failHwWrites())) {
+      XLOG(
+          FATAL,
+          "Attempting bulk remove SAI objs while hw writes are blocked");
+    }
+    auto g{SaiApiLock::getInstance()->lock()};
+    sai_status_t status;
+    std::vector<sai_status_t> retStatus(keys.size(), SAI_STATUS_SUCCESS);
+    {
+      TIME_CALL;
+      status = impl()._bulkRemove(keys.data(), keys.size(), retStatus.data());
+    }
+    if (status == SAI_STATUS_NOT_SUPPORTED ||
+        status == SAI_STATUS_NOT_IMPLEMENTED) {
+      for (auto idx = 0; idx < keys.size(); idx++) {
+        TIME_CALL;
+        retStatus[idx] = impl()._remove(keys[idx]);
+      }
+    } else if (UNLIKELY(
+                   status != SAI_STATUS_SUCCESS &&
+                   status != SAI_STATUS_FAILURE)) {
+      saiApiCheckError(status, apiType(), "Failed to bulk remove");
+    }
+    for (auto idx = 0; idx < keys.size(); idx++) {
+      if (ignoreMissing && retStatus[idx] == SAI_STATUS_ITEM_NOT_FOUND) {
+        XLOGF(DBG2, "SAI object already removed: {}", keys[idx]);
+        continue;
+      }
+      if (UNLIKELY(retStatus[idx] != SAI_STATUS_SUCCESS)) {
+        saiApiCheckError(
+            retStatus[idx],
+            apiType(),
+            fmt::format("Failed to remove sai object : {}", keys[idx]));
+      }
+      XLOGF(DBG5, "bulk removed SAI object: {}", keys[idx]);
+    }
+  }
+
   /*
    * We can do getAttribute on top of more complicated types than just
    * attributes. For example, if we overload on tuples and optionals, we
@@ -306,10 +440,12 @@ class SaiApi {
       TIME_CALL;
       status = impl()._setAttribute(key, saiAttr(attr));
     }
-    saiApiCheckError(
-        status,
-        apiType(),
-        fmt::format("Failed to set attribute {} to {}", key, attr));
+    if (UNLIKELY(status != SAI_STATUS_SUCCESS)) {
+      saiApiCheckError(
+          status,
+          apiType(),
+          fmt::format("Failed to set attribute {} to {}", key, attr));
+    }
     XLOGF(DBG5, "set SAI attribute of {} to {}", key, attr);
   }
   template <typename AdapterKeyT, typename AttrT>
@@ -14,6 +14,7 @@
 #include "fboss/lib/TupleUtils.h"
 
 #include <folly/logging/xlog.h>
+#include <array>
 #include <optional>
 
 #include <tuple>
@@ -58,4 +59,67 @@ std::vector<sai_attribute_t> saiAttrs(const std::tuple<AttrTs...>& tup) {
   return ret;
 }
 
+/*
+ * Fixed capacity array of sai_attribute_t, for marshaling an attribute tuple
+ * (e.g. SaiObjectTraits::CreateAttributes) without allocating. Its capacity
+ * is the size of the tuple, so it always fits every attribute that is set.
+ * List valued attributes are not copied, their sai_attribute_t point into the
+ * storage of the attribute, so the attributes must outlive the array.
+ */
+template <size_t N>
+class SaiAttributeArray {
+ public:
+  void push_back(const sai_attribute_t& attr) {
+    XDCHECK_LT(size_, N);
+    attrs_[size_++] = attr;
+  }
+
+  size_t size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  sai_attribute_t* data() {
+    return attrs_.data();
+  }
+
+  const sai_attribute_t* data() const {
+    return attrs_.data();
+  }
+
+  const sai_attribute_t& operator[](size_t i) const {
+    return attrs_[i];
+  }
+
+  const sai_attribute_t* begin() const {
+    return attrs_.data();
+  }
+
+  const sai_attribute_t* end() const {
+    return attrs_.data() + size_;
+  }
+
+ private:
+  std::array<sai_attribute_t, N> attrs_;
+  size_t size_{0};
+};
+
+template <typename... AttrTs>
+SaiAttributeArray<sizeof...(AttrTs)> saiAttrArray(
+    const std::tuple<AttrTs...>& tup) {
+  SaiAttributeArray<sizeof...(AttrTs)> ret;
+  tupleForEach(
+      [&ret](const auto& attr) {
+        const sai_attribute_t* attrp = saiAttr(attr);
+        if (attrp) {
+          ret.push_back(*attrp);
+        }
+      },
+      tup);
+  return ret;
+}
+
 } // namespace facebook::fboss
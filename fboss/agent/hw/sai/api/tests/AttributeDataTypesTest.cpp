@@ -37,6 +37,22 @@ TEST(AttributeDataTypes, attributeTupleGetSaiAttr) {
   EXPECT_EQ(attrV[2].value.objlist.count, 42);
 }
 
+TEST(AttributeDataTypes, attributeTupleGetSaiAttrArray) {
+  std::vector<sai_object_id_t> vec;
+  vec.resize(42);
+  std::tuple<B, AttrOptional, VecAttr, AttrOptional> at{
+      B{true}, std::nullopt, VecAttr{vec}, I{42}};
+  auto attrs = saiAttrArray(at);
+  EXPECT_EQ(attrs.size(), 3);
+  EXPECT_TRUE(attrs[0].value.booldata);
+  EXPECT_EQ(attrs[1].value.objlist.count, 42);
+  // Lists are not copied
+  EXPECT_EQ(
+      attrs[1].value.objlist.list,
+      saiAttr(std::get<2>(at))->value.objlist.list);
+  EXPECT_EQ(attrs[2].value.s32, 42);
+}
+
 TEST(AttributeDataTypes, attributeOptionalGetSaiAttr) {
   AttrOptional o(I{42});
   const sai_attribute_t* attr = saiAttr(o);
@@ -63,3 +63,23 @@ TEST_F(FdbApiTest, setGetMetadata) {
           makeFdbEntry(mac), SaiFdbTraits::Attributes::Metadata{}),
       42);
 }
+
+TEST_F(FdbApiTest, bulkCreateRemove) {
+  std::vector<SaiFdbTraits::FdbEntry> entries;
+  std::vector<SaiFdbTraits::CreateAttributes> attributes;
+  for (auto i = 0; i < 10; ++i) {
+    entries.push_back(makeFdbEntry(folly::MacAddress::fromHBO(0x424242 + i)));
+    attributes.push_back({SAI_FDB_ENTRY_TYPE_STATIC, 24, i});
+  }
+  auto numFdbEntries = fs->fdbManager.map().size();
+  fdbApi->bulkCreate<SaiFdbTraits>(entries, attributes);
+  EXPECT_EQ(fs->fdbManager.map().size(), numFdbEntries + entries.size());
+  for (auto i = 0; i < entries.size(); ++i) {
+    EXPECT_EQ(
+        fdbApi->getAttribute(entries[i], SaiFdbTraits::Attributes::Metadata{}),
+        i);
+  }
+
+  fdbApi->bulkRemove(entries);
+  EXPECT_EQ(fs->fdbManager.map().size(), numFdbEntries);
+}
@@ -275,3 +275,22 @@ TEST_F(NeighborApiTest, formatNeighborAttributes) {
   SaiNeighborTraits::Attributes::Metadata m(42);
   EXPECT_EQ(fmt::format("Metadata: 42"), fmt::format("{}", m));
 }
+
+TEST_F(NeighborApiTest, bulkCreateRemoveNeighbors) {
+  std::vector<SaiNeighborTraits::NeighborEntry> entries{
+      SaiNeighborTraits::NeighborEntry(0, 0, ip4),
+      SaiNeighborTraits::NeighborEntry(0, 0, ip6)};
+  std::vector<SaiNeighborTraits::CreateAttributes> attributes{
+      createAttrs(42), createAttrs(std::nullopt, 42)};
+  auto numNeighbors = fs->neighborManager.map().size();
+  neighborApi->bulkCreate<SaiNeighborTraits>(entries, attributes);
+  FakeNeighborEntry fn4 = std::make_tuple(0, 0, ip4);
+  FakeNeighborEntry fn6 = std::make_tuple(0, 0, ip6);
+  EXPECT_EQ(fs->neighborManager.get(fn4).metadata, 42);
+  EXPECT_TRUE(fs->neighborManager.get(fn4).isLocal);
+  EXPECT_EQ(fs->neighborManager.get(fn6).encapIndex, 42);
+  EXPECT_FALSE(fs->neighborManager.get(fn6).isLocal);
+
+  neighborApi->bulkRemove(entries);
+  EXPECT_EQ(fs->neighborManager.map().size(), numNeighbors);
+}
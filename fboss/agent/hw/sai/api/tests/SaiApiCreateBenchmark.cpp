@@ -0,0 +1,126 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/sai/api/NeighborApi.h"
+#include "fboss/agent/hw/sai/api/NextHopApi.h"
+#include "fboss/agent/hw/sai/api/RouteApi.h"
+#include "fboss/agent/hw/sai/fake/FakeSai.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddress.h>
+#include <folly/MacAddress.h>
+#include <folly/init/Init.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+/*
+ * Measures the cost of creating and removing routes, next hops and
+ * neighbors through the SAI api classes on top of FakeSai. Each iteration is
+ * a create/remove pair. Besides the time per iteration, reports the heap
+ * allocations made per iteration, including those FakeSai itself makes to
+ * store the object.
+ */
+
+namespace {
+std::atomic<uint64_t> numAllocations{0};
+} // namespace
+
+void* operator new(size_t size) {
+  numAllocations.fetch_add(1, std::memory_order_relaxed);
+  if (auto p = std::malloc(size ? size : 1)) {
+    return p;
+  }
+  throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, size_t /* size */) noexcept {
+  std::free(p);
+}
+
+using namespace facebook::fboss;
+
+namespace {
+template <typename CreateFn>
+void benchmarkCreate(
+    folly::UserCounters& counters,
+    unsigned iters,
+    CreateFn&& create) {
+  auto before = numAllocations.load(std::memory_order_relaxed);
+  for (unsigned i = 0; i < iters; ++i) {
+    create(i);
+  }
+  auto after = numAllocations.load(std::memory_order_relaxed);
+  counters["allocs_per_create"] =
+      static_cast<double>(after - before) / std::max(iters, 1u);
+}
+
+folly::IPAddress ipFor(unsigned i) {
+  auto bytes = folly::IPAddressV6("2401:db00::").toByteArray();
+  bytes[12] = (i >> 24) & 0xff;
+  bytes[13] = (i >> 16) & 0xff;
+  bytes[14] = (i >> 8) & 0xff;
+  bytes[15] = i & 0xff;
+  return folly::IPAddress(folly::IPAddressV6(bytes));
+}
+} // namespace
+
+BENCHMARK_COUNTERS(RouteCreate, counters, iters) {
+  RouteApi routeApi;
+  SaiRouteTraits::CreateAttributes attrs;
+  std::get<SaiRouteTraits::Attributes::PacketAction>(attrs) =
+      SAI_PACKET_ACTION_FORWARD;
+  std::get<std::optional<SaiRouteTraits::Attributes::NextHopId>>(attrs) =
+      SaiRouteTraits::Attributes::NextHopId(5);
+  benchmarkCreate(counters, iters, [&](unsigned i) {
+    SaiRouteTraits::RouteEntry entry(0, 0, folly::CIDRNetwork(ipFor(i), 128));
+    routeApi.create<SaiRouteTraits>(entry, attrs);
+    routeApi.remove(entry);
+  });
+}
+
+BENCHMARK_COUNTERS(NextHopCreate, counters, iters) {
+  NextHopApi nextHopApi;
+  benchmarkCreate(counters, iters, [&](unsigned i) {
+    SaiIpNextHopTraits::CreateAttributes attrs;
+    std::get<SaiIpNextHopTraits::Attributes::Type>(attrs) =
+        SAI_NEXT_HOP_TYPE_IP;
+    std::get<SaiIpNextHopTraits::Attributes::RouterInterfaceId>(attrs) =
+        SaiIpNextHopTraits::Attributes::RouterInterfaceId(0);
+    std::get<SaiIpNextHopTraits::Attributes::Ip>(attrs) = ipFor(i);
+    auto nextHopId = nextHopApi.create<SaiIpNextHopTraits>(attrs, 0);
+    nextHopApi.remove(nextHopId);
+  });
+}
+
+BENCHMARK_COUNTERS(NeighborCreate, counters, iters) {
+  NeighborApi neighborApi;
+  SaiNeighborTraits::CreateAttributes attrs;
+  std::get<SaiNeighborTraits::Attributes::DstMac>(attrs) =
+      folly::MacAddress("42:42:42:12:34:56");
+  benchmarkCreate(counters, iters, [&](unsigned i) {
+    SaiNeighborTraits::NeighborEntry entry(0, 0, ipFor(i));
+    neighborApi.create<SaiNeighborTraits>(entry, attrs);
+    neighborApi.remove(entry);
+  });
+}
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  auto fs = FakeSai::getInstance();
+  sai_api_initialize(0, nullptr);
+  folly::runBenchmarks();
+  return 0;
+}
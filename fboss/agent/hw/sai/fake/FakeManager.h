@@ -32,6 +32,7 @@ class FakeManager {
     sai_object_id_t id = static_cast<sai_object_id_t>(count_++);
     auto ins = map_.emplace(id, T{std::forward<Args>(args)...});
     ins.first->second.id = id;
+    ++numCreates_;
     return id;
   }
 
@@ -43,10 +44,13 @@ class FakeManager {
       throw std::runtime_error("Object already exists, create failed");
     }
     count_++;
+    ++numCreates_;
   }
 
   size_t remove(const K& k) {
-    return map_.erase(k);
+    auto removed = map_.erase(k);
+    numRemoves_ += removed;
+    return removed;
   }
 
   T& get(const K& k) {
@@ -66,6 +70,16 @@ class FakeManager {
   void clear() {
     count_ = count;
     map_.clear();
+    numCreates_ = 0;
+    numRemoves_ = 0;
+  }
+
+  // Number of objects created and removed, to count SAI calls in tests
+  size_t numCreates() const {
+    return numCreates_;
+  }
+  size_t numRemoves() const {
+    return numRemoves_;
   }
 
   bool exists(const K& k) {
@@ -75,6 +89,8 @@ class FakeManager {
  private:
   static size_t count_;
   std::unordered_map<K, T> map_;
+  size_t numCreates_{0};
+  size_t numRemoves_{0};
 };
 
 template <typename K, typename T, size_t count>
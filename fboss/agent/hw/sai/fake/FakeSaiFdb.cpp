@@ -102,6 +102,41 @@ sai_status_t get_fdb_entry_attribute_fn(
   return SAI_STATUS_SUCCESS;
 }
 
+#if SAI_API_VERSION >= SAI_VERSION(1, 10, 0)
+sai_status_t create_fdb_entries_fn(
+    uint32_t object_count,
+    const sai_fdb_entry_t* fdb_entry,
+    const uint32_t* attr_count,
+    const sai_attribute_t** attr_list,
+    sai_bulk_op_error_mode_t /* mode */,
+    sai_status_t* object_statuses) {
+  auto status = SAI_STATUS_SUCCESS;
+  for (int count = 0; count < object_count; count++) {
+    object_statuses[count] = create_fdb_entry_fn(
+        &fdb_entry[count], attr_count[count], attr_list[count]);
+    if (object_statuses[count] != SAI_STATUS_SUCCESS) {
+      status = SAI_STATUS_FAILURE;
+    }
+  }
+  return status;
+}
+
+sai_status_t remove_fdb_entries_fn(
+    uint32_t object_count,
+    const sai_fdb_entry_t* fdb_entry,
+    sai_bulk_op_error_mode_t /* mode */,
+    sai_status_t* object_statuses) {
+  auto status = SAI_STATUS_SUCCESS;
+  for (int count = 0; count < object_count; count++) {
+    object_statuses[count] = remove_fdb_entry_fn(&fdb_entry[count]);
+    if (object_statuses[count] != SAI_STATUS_SUCCESS) {
+      status = SAI_STATUS_FAILURE;
+    }
+  }
+  return status;
+}
+#endif
+
 namespace facebook::fboss {
 
 static sai_fdb_api_t _fdb_api;
@@ -111,6 +146,10 @@ void populate_fdb_api(sai_fdb_api_t** fdb_api) {
   _fdb_api.remove_fdb_entry = &remove_fdb_entry_fn;
   _fdb_api.set_fdb_entry_attribute = &set_fdb_entry_attribute_fn;
   _fdb_api.get_fdb_entry_attribute = &get_fdb_entry_attribute_fn;
+#if SAI_API_VERSION >= SAI_VERSION(1, 10, 0)
+  _fdb_api.create_fdb_entries = &create_fdb_entries_fn;
+  _fdb_api.remove_fdb_entries = &remove_fdb_entries_fn;
+#endif
   *fdb_api = &_fdb_api;
 }
 
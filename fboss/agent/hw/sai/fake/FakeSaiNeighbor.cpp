@@ -123,6 +123,41 @@ sai_status_t get_neighbor_entry_attribute_fn(
   return SAI_STATUS_SUCCESS;
 }
 
+#if SAI_API_VERSION >= SAI_VERSION(1, 10, 0)
+sai_status_t create_neighbor_entries_fn(
+    uint32_t object_count,
+    const sai_neighbor_entry_t* neighbor_entry,
+    const uint32_t* attr_count,
+    const sai_attribute_t** attr_list,
+    sai_bulk_op_error_mode_t /* mode */,
+    sai_status_t* object_statuses) {
+  auto status = SAI_STATUS_SUCCESS;
+  for (int count = 0; count < object_count; count++) {
+    object_statuses[count] = create_neighbor_entry_fn(
+        &neighbor_entry[count], attr_count[count], attr_list[count]);
+    if (object_statuses[count] != SAI_STATUS_SUCCESS) {
+      status = SAI_STATUS_FAILURE;
+    }
+  }
+  return status;
+}
+
+sai_status_t remove_neighbor_entries_fn(
+    uint32_t object_count,
+    const sai_neighbor_entry_t* neighbor_entry,
+    sai_bulk_op_error_mode_t /* mode */,
+    sai_status_t* object_statuses) {
+  auto status = SAI_STATUS_SUCCESS;
+  for (int count = 0; count < object_count; count++) {
+    object_statuses[count] = remove_neighbor_entry_fn(&neighbor_entry[count]);
+    if (object_statuses[count] != SAI_STATUS_SUCCESS) {
+      status = SAI_STATUS_FAILURE;
+    }
+  }
+  return status;
+}
+#endif
+
 namespace facebook::fboss {
 
 static sai_neighbor_api_t _neighbor_api;
@@ -132,6 +167,10 @@ void populate_neighbor_api(sai_neighbor_api_t** neighbor_api) {
   _neighbor_api.remove_neighbor_entry = &remove_neighbor_entry_fn;
   _neighbor_api.set_neighbor_entry_attribute = &set_neighbor_entry_attribute_fn;
   _neighbor_api.get_neighbor_entry_attribute = &get_neighbor_entry_attribute_fn;
+#if SAI_API_VERSION >= SAI_VERSION(1, 10, 0)
+  _neighbor_api.create_neighbor_entries = &create_neighbor_entries_fn;
+  _neighbor_api.remove_neighbor_entries = &remove_neighbor_entries_fn;
+#endif
   *neighbor_api = &_neighbor_api;
 }
 
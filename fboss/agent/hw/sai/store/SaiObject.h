@@ -18,7 +18,9 @@
 
 #include "fboss/agent/hw/sai/store/SaiObjectEventPublisher.h"
 
+#include <atomic>
 #include <variant>
+#include <vector>
 
 class SaiStoreTest;
 
@@ -27,6 +29,26 @@ namespace facebook::fboss {
 template <typename SaiObjectTraits>
 class SaiObjectStore;
 
+/*
+ * Entry struct objects whose creation or removal in hardware is held back
+ * while their SaiObjectStore batches SAI calls, see
+ * SaiObjectStore::startBulk(). Keys of objects which are destroyed before
+ * the batch is flushed are left in creates, the objects are looked up again
+ * when flushing.
+ *
+ * Owned by one SaiObjectStore and shared with the objects it created or
+ * loaded, so batching in one store never defers objects of another.
+ */
+template <typename SaiObjectTraits>
+struct SaiObjectBulkOps {
+  // Set between SaiObjectStore::startBulk() and endBulk()
+  bool active{false};
+  std::vector<typename SaiObjectTraits::AdapterKey> creates;
+  std::vector<typename SaiObjectTraits::AdapterKey> removes;
+  // Removes which tolerate the object being gone from hardware already
+  std::vector<typename SaiObjectTraits::AdapterKey> removesIgnoringMissing;
+};
+
 namespace detail {
 
 /*
@@ -236,8 +258,11 @@ class SaiObject {
   SaiObject(
       const typename SaiObjectTraits::AdapterHostKey& adapterHostKey,
       const typename SaiObjectTraits::CreateAttributes& attributes,
-      sai_object_id_t switchId)
-      : adapterHostKey_(adapterHostKey), attributes_(attributes) {
+      sai_object_id_t switchId,
+      std::shared_ptr<SaiObjectBulkOps<SaiObjectTraits>> bulkOps = nullptr)
+      : bulkOps_(std::move(bulkOps)),
+        adapterHostKey_(adapterHostKey),
+        attributes_(attributes) {
     adapterKey_ = createHelper(adapterHostKey, attributes, switchId);
     live_ = true;
   }
@@ -262,6 +287,8 @@ class SaiObject {
       adapterKey_ = other.adapterKey();
       adapterHostKey_ = other.adapterHostKey();
       attributes_ = other.attributes();
+      createDeferred_ = other.createDeferred_;
+      bulkOps_ = other.bulkOps_;
       live_ = true;
       other.live_ = false;
     } else {
@@ -283,12 +310,13 @@ class SaiObject {
     if (UNLIKELY(!live_)) {
       XLOG(FATAL) << "Attempted to setAttributes on non-live SaiObject";
     }
+    // Only attributes which differ from the last programmed value are
+    // written, and copied into attributes_
     tupleForEach(
         [this, skipHwWrite](const auto& attr) {
           checkAndSetAttribute(attr, skipHwWrite);
         },
         newAttributes);
-    attributes_ = newAttributes;
   }
 
   template <typename AttrT>
@@ -394,6 +422,16 @@ class SaiObject {
     auto& api =
         SaiApiTable::getInstance()->getApi<typename SaiObjectTraits::SaiApiT>();
     api.bulkSetAttributes(adapterKeys, attributes);
+    hwAttributeSets_.fetch_add(adapterKeys.size(), std::memory_order_relaxed);
+  }
+
+  /*
+   * Number of attribute values written to hardware for objects of this type,
+   * after creation. Lets tests check that unchanged attributes are not
+   * reprogrammed.
+   */
+  static uint64_t hwAttributeSets() {
+    return hwAttributeSets_.load(std::memory_order_relaxed);
   }
 
  protected:
@@ -407,7 +445,8 @@ class SaiObject {
         oldAttr,
         newAttr);
     if (oldAttr != newAttr) {
-      if (!skipHwWrite) {
+      // Objects yet to be created get the new value with the create
+      if (!skipHwWrite && !createDeferred_) {
         setAttributeInHardware(newAttr);
       }
       oldAttr = std::forward<AttrT>(newAttr);
@@ -415,12 +454,28 @@ class SaiObject {
   }
   void remove() {
     if constexpr (IsObjectPublisher<SaiObjectTraits>::value) {
-      notifyBeforeDestroy();
+      // Subscribers only learn of deferred creates once they are flushed
+      if (!createDeferred_) {
+        notifyBeforeDestroy();
+      }
     }
     if (isOwnedByAdapter()) {
       return;
     }
     if constexpr (not IsSaiObjectOwnedByAdapter<SaiObjectTraits>::value) {
+      if constexpr (AdapterKeyIsEntryStruct<SaiObjectTraits>::value) {
+        if (createDeferred_) {
+          // Never made it to hardware, flushing skips it
+          return;
+        }
+        if (bulkOps_ && bulkOps_->active) {
+          auto& removes = ignoreMissingInHwOnDelete_
+              ? bulkOps_->removesIgnoringMissing
+              : bulkOps_->removes;
+          removes.push_back(adapterKey_);
+          return;
+        }
+      }
       auto& api = SaiApiTable::getInstance()
                       ->getApi<typename SaiObjectTraits::SaiApiT>();
       try {
@@ -470,18 +525,30 @@ class SaiObject {
         std::is_same_v<typename T::AdapterHostKey, typename T::AdapterKey>,
         "SAI objects which use an entry struct must have "
         "AdapterKey == AdapterHostKey == entry struct");
+    if (bulkOps_ && bulkOps_->active) {
+      bulkOps_->creates.push_back(k);
+      createDeferred_ = true;
+      return k;
+    }
     auto& api =
         SaiApiTable::getInstance()->getApi<typename SaiObjectTraits::SaiApiT>();
     api.template create<T>(k, attributes);
     return k;
   }
 
+  // Batch of the SaiObjectStore holding this object, only set for entry
+  // structs
+  std::shared_ptr<SaiObjectBulkOps<SaiObjectTraits>> bulkOps_;
+  // Created in software, to be created in hardware when the batch is flushed
+  bool createDeferred_{false};
+
  private:
   template <typename AttrT>
   void setAttributeInHardware(const AttrT& newAttr) {
     auto& api =
         SaiApiTable::getInstance()->getApi<typename SaiObjectTraits::SaiApiT>();
     api.setAttribute(adapterKey(), newAttr);
+    hwAttributeSets_.fetch_add(1, std::memory_order_relaxed);
   }
   template <typename AttrT>
   void setAttributeInHardware(const std::optional<AttrT>& newAttrOpt) {
@@ -490,6 +557,7 @@ class SaiObject {
       setAttributeInHardware(newAttrOpt.value());
     }
   }
+  static inline std::atomic<uint64_t> hwAttributeSets_{0};
   bool live_{false};
   bool ownedByAdapter_{IsSaiObjectOwnedByAdapter<SaiObjectTraits>::value};
   // For some object types we can ignore missing in HW errors
@@ -33,8 +33,13 @@ class SaiObjectWithCounters : public SaiObject<SaiObjectTraits> {
   SaiObjectWithCounters(
       const typename SaiObjectTraits::AdapterHostKey& adapterHostKey,
       const typename SaiObjectTraits::CreateAttributes& attributes,
-      sai_object_id_t switchId)
-      : SaiObject<SaiObjectTraits>(adapterHostKey, attributes, switchId) {}
+      sai_object_id_t switchId,
+      std::shared_ptr<SaiObjectBulkOps<SaiObjectTraits>> bulkOps = nullptr)
+      : SaiObject<SaiObjectTraits>(
+            adapterHostKey,
+            attributes,
+            switchId,
+            std::move(bulkOps)) {}
 
   using StatsMap = folly::F14FastMap<sai_stat_id_t, uint64_t>;
 
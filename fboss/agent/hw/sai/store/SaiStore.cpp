@@ -132,4 +132,16 @@ void SaiStore::removeUnexpectedUnclaimedWarmbootHandles() {
       stores_);
 }
 
+void SaiStore::startBulkFdbAndNeighbors() {
+  get<SaiFdbTraits>().startBulk();
+  get<SaiNeighborTraits>().startBulk();
+}
+
+void SaiStore::endBulkFdbAndNeighbors() {
+  get<SaiNeighborTraits>().flushBulkRemoves();
+  // Publishing the new FDB entries creates the neighbors waiting on them
+  get<SaiFdbTraits>().endBulk();
+  get<SaiNeighborTraits>().endBulk();
+}
+
 } // namespace facebook::fboss
@@ -22,8 +22,10 @@
 #include "fboss/agent/hw/sai/store/SaiObject.h"
 #include "fboss/agent/hw/sai/store/SaiObjectWithCounters.h"
 #include "fboss/agent/hw/sai/store/Traits.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
 #include "fboss/lib/RefMap.h"
 
+#include <folly/Conv.h>
 #include <folly/dynamic.h>
 
 #include <memory>
@@ -77,6 +79,13 @@ class SaiObjectStore {
     return saiObjectTypeToString(SaiObjectTraits::ObjectType);
   }
 
+  // Profiling span name for programming an object, e.g. sai_store.set.PORT
+  static const char* setObjectSpanName() {
+    static const char* spanName = ProfilingSpan::internName(
+        folly::to<std::string>("sai_store.set.", objectTypeName()));
+    return spanName;
+  }
+
   /*
    * This routine will help load sai objects owned by the SAI Adapter.
    * For instance, sai queue objects are owned by the adapter and will not be
@@ -102,6 +111,7 @@ class SaiObjectStore {
       auto ins =
           objects_.refOrInsert(adapterHostKey, std::move(temporary), true);
       obj = ins.first;
+      obj->bulkOps_ = bulkOpsForObject();
     } else {
       // destroy temporary without removing underlying sai object
       temporary.release();
@@ -163,6 +173,7 @@ class SaiObjectStore {
                     << "]"
                     << " Unexpected duplicate adapterHostKey";
       }
+      ins.first->bulkOps_ = bulkOpsForObject();
       warmBootHandles_.emplace(adapterHostKey, ins.first);
     }
   }
@@ -176,8 +187,8 @@ class SaiObjectStore {
       const typename T::CreateAttributes& attributes) {
     auto itr = warmBootHandles_.find(adapterHostKey);
     CHECK(itr == warmBootHandles_.end());
-    auto object = std::make_shared<ObjectType>(
-        ObjectType(adapterHostKey, attributes, switchId_.value()));
+    auto object = std::make_shared<ObjectType>(ObjectType(
+        adapterHostKey, attributes, switchId_.value(), bulkOpsForObject()));
     warmBootHandles_.emplace(adapterHostKey, object);
   }
 
@@ -190,6 +201,7 @@ class SaiObjectStore {
           !IsPublisherKeyCustomType<SaiObjectTraits>::value,
           "method not available for objects with publisher attributes of custom types");
     }
+    PROFILE_SPAN(setObjectSpanName());
     XLOGF(
         DBG5,
         "SaiStore setting {} object {}",
@@ -198,7 +210,7 @@ class SaiObjectStore {
     auto [object, programmed] = program(adapterHostKey, attributes);
     if (notify && programmed) {
       if constexpr (IsObjectPublisher<SaiObjectTraits>::value) {
-        object->notifyAfterCreate(object);
+        notifyAfterCreate(object);
       }
     }
     XLOGF(DBG5, "SaiStore set object {}", *object);
@@ -213,6 +225,7 @@ class SaiObjectStore {
     static_assert(
         IsPublisherKeyCustomType<SaiObjectTraits>::value,
         "method available only for objects with publisher attributes of custom types");
+    PROFILE_SPAN(setObjectSpanName());
     XLOGF(
         DBG5,
         "SaiStore setting {} object {}",
@@ -222,7 +235,7 @@ class SaiObjectStore {
     if (notify && programmed) {
       if constexpr (IsObjectPublisher<SaiObjectTraits>::value) {
         object->setCustomPublisherKey(publisherKey);
-        object->notifyAfterCreate(object);
+        notifyAfterCreate(object);
       }
     }
     XLOGF(DBG5, "SaiStore set object {}", *object);
@@ -267,6 +280,81 @@ class SaiObjectStore {
     }
   }
 
+  /*
+   * Until endBulk(), objects are only created and removed in software:
+   * their creates and removes are then issued to the adapter with one bulk
+   * call each, removes first. Attribute changes of objects yet to be created
+   * are folded into their create. Subscribers learn of the new objects once
+   * they exist in hardware, after all of them are created.
+   */
+  template <typename T = SaiObjectTraits>
+  std::enable_if_t<AdapterKeyIsEntryStruct<T>::value, void> startBulk() {
+    if (bulkOps_->active) {
+      throw FbossError("Already batching ", objectTypeName(), " objects");
+    }
+    bulkOps_->active = true;
+  }
+
+  /*
+   * Issue the removes held back so far, for callers which need to remove
+   * dependent objects of other types before creating any.
+   */
+  template <typename T = SaiObjectTraits>
+  std::enable_if_t<AdapterKeyIsEntryStruct<T>::value, void>
+  flushBulkRemoves() {
+    if (!bulkOps_->active) {
+      throw FbossError("Not batching ", objectTypeName(), " objects");
+    }
+    auto& api =
+        SaiApiTable::getInstance()->getApi<typename SaiObjectTraits::SaiApiT>();
+    auto removes = std::move(bulkOps_->removes);
+    auto removesIgnoringMissing = std::move(bulkOps_->removesIgnoringMissing);
+    bulkOps_->removes.clear();
+    bulkOps_->removesIgnoringMissing.clear();
+    api.bulkRemove(removes);
+    api.bulkRemove(removesIgnoringMissing, true /* ignoreMissing */);
+  }
+
+  template <typename T = SaiObjectTraits>
+  std::enable_if_t<AdapterKeyIsEntryStruct<T>::value, void> endBulk() {
+    flushBulkRemoves();
+    std::vector<typename SaiObjectTraits::AdapterKey> adapterKeys;
+    std::vector<typename SaiObjectTraits::CreateAttributes> attributes;
+    adapterKeys.reserve(bulkOps_->creates.size());
+    attributes.reserve(bulkOps_->creates.size());
+    for (const auto& adapterKey : bulkOps_->creates) {
+      auto object = objects_.ref(adapterKey);
+      // Skip objects destroyed since, and duplicate keys of objects which
+      // were destroyed and created again
+      if (!object || !object->createDeferred_) {
+        continue;
+      }
+      object->createDeferred_ = false;
+      adapterKeys.push_back(adapterKey);
+      attributes.push_back(object->attributes());
+    }
+    bulkOps_->active = false;
+    bulkOps_->creates.clear();
+    auto& api =
+        SaiApiTable::getInstance()->getApi<typename SaiObjectTraits::SaiApiT>();
+    api.template bulkCreate<SaiObjectTraits>(adapterKeys, attributes);
+    XLOGF(
+        DBG2,
+        "SaiStore bulk created {} {} objects",
+        adapterKeys.size(),
+        objectTypeName());
+
+    auto pendingNotify = std::move(pendingNotify_);
+    pendingNotify_.clear();
+    if constexpr (IsObjectPublisher<SaiObjectTraits>::value) {
+      for (const auto& weakObject : pendingNotify) {
+        if (auto object = weakObject.lock()) {
+          object->notifyAfterCreate(object);
+        }
+      }
+    }
+  }
+
   std::shared_ptr<ObjectType> get(
       const typename SaiObjectTraits::AdapterHostKey& adapterHostKey) {
     XLOGF(DBG5, "SaiStore get object {}", adapterHostKey);
@@ -407,6 +495,23 @@ class SaiObjectStore {
   }
 
  private:
+  void notifyAfterCreate(const std::shared_ptr<ObjectType>& object) {
+    if (bulkOps_->active) {
+      pendingNotify_.push_back(object);
+    } else {
+      object->notifyAfterCreate(object);
+    }
+  }
+
+  // Only entry structs are batched, see startBulk()
+  std::shared_ptr<SaiObjectBulkOps<SaiObjectTraits>> bulkOpsForObject() const {
+    if constexpr (AdapterKeyIsEntryStruct<SaiObjectTraits>::value) {
+      return bulkOps_;
+    } else {
+      return nullptr;
+    }
+  }
+
   ObjectType getObject(
       typename ObjectTraits::AdapterKey key,
       const folly::dynamic* adapterKey2AdapterHostKey) {
@@ -442,7 +547,11 @@ class SaiObjectStore {
         ? std::make_pair(existingObj, false)
         : objects_.refOrInsert(
               adapterHostKey,
-              ObjectType(adapterHostKey, attributes, switchId_.value()),
+              ObjectType(
+                  adapterHostKey,
+                  attributes,
+                  switchId_.value(),
+                  bulkOpsForObject()),
               true /*force*/);
     if (!ins.second) {
       ins.first->setAttributes(attributes);
@@ -482,6 +591,9 @@ class SaiObjectStore {
       typename SaiObjectTraits::AdapterHostKey,
       std::shared_ptr<ObjectType>>
       warmBootHandles_;
+  std::shared_ptr<SaiObjectBulkOps<SaiObjectTraits>> bulkOps_{
+      std::make_shared<SaiObjectBulkOps<SaiObjectTraits>>()};
+  std::vector<std::weak_ptr<ObjectType>> pendingNotify_;
 };
 
 /*
@@ -546,6 +658,16 @@ class SaiStore {
 
   void printWarmbootHandles() const;
 
+  /*
+   * Batch programming FDB and neighbor entries, see
+   * SaiObjectStore::startBulk(). endBulkFdbAndNeighbors() orders the
+   * batches so that neighbors are removed before and created after the FDB
+   * entries they resolve to, and neighbors created when FDB entries are
+   * published join the neighbor batch.
+   */
+  void startBulkFdbAndNeighbors();
+  void endBulkFdbAndNeighbors();
+
  private:
   sai_object_id_t switchId_{};
   std::tuple<
@@ -166,3 +166,60 @@ TEST_F(SaiStoreTest, neighborPublisher) {
   EXPECT_TRUE(IsObjectPublisher<SaiNeighborTraits>::value);
   EXPECT_FALSE(IsObjectPublisher<SaiInSegTraits>::value);
 }
+
+TEST_F(SaiStoreTest, bulkNeighbors) {
+  SaiStore s(0);
+  auto& store = s.get<SaiNeighborTraits>();
+  folly::MacAddress dstMac{"42:42:42:42:42:42"};
+  SaiNeighborTraits::NeighborEntry removed(0, 0, folly::IPAddress("10.0.0.1"));
+  SaiNeighborTraits::NeighborEntry added(0, 0, folly::IPAddress("10.0.0.2"));
+  SaiNeighborTraits::NeighborEntry cancelled(
+      0, 0, folly::IPAddress("10.0.0.3"));
+  auto removedObj = store.setObject(removed, createAttrs(dstMac));
+  auto numCreates = fs->neighborManager.numCreates();
+  auto numRemoves = fs->neighborManager.numRemoves();
+
+  store.startBulk();
+  removedObj.reset();
+  auto addedObj = store.setObject(added, createAttrs(dstMac));
+  // Folded into the create
+  addedObj->setOptionalAttribute(SaiNeighborTraits::Attributes::Metadata{42});
+  auto cancelledObj = store.setObject(cancelled, createAttrs(dstMac));
+  cancelledObj.reset();
+  // Nothing reaches the adapter until the batch ends
+  EXPECT_EQ(fs->neighborManager.numCreates(), numCreates);
+  EXPECT_EQ(fs->neighborManager.numRemoves(), numRemoves);
+
+  store.endBulk();
+  EXPECT_EQ(fs->neighborManager.numCreates(), numCreates + 1);
+  EXPECT_EQ(fs->neighborManager.numRemoves(), numRemoves + 1);
+  auto& neighborApi = saiApiTable->neighborApi();
+  EXPECT_EQ(
+      neighborApi.getAttribute(
+          added, SaiNeighborTraits::Attributes::Metadata{}),
+      42);
+
+  // Back to programming each object as it changes
+  addedObj.reset();
+  EXPECT_EQ(fs->neighborManager.numRemoves(), numRemoves + 2);
+}
+
+TEST_F(SaiStoreTest, bulkNeighborsPerStore) {
+  SaiStore batching(0);
+  SaiStore other(0);
+  folly::MacAddress dstMac{"42:42:42:42:42:42"};
+  SaiNeighborTraits::NeighborEntry deferred(0, 0, folly::IPAddress("10.0.0.4"));
+  SaiNeighborTraits::NeighborEntry direct(0, 0, folly::IPAddress("10.0.0.5"));
+  auto numCreates = fs->neighborManager.numCreates();
+
+  batching.get<SaiNeighborTraits>().startBulk();
+  auto deferredObj = batching.get<SaiNeighborTraits>().setObject(
+      deferred, createAttrs(dstMac));
+  // Objects of another store are still programmed right away
+  auto directObj =
+      other.get<SaiNeighborTraits>().setObject(direct, createAttrs(dstMac));
+  EXPECT_EQ(fs->neighborManager.numCreates(), numCreates + 1);
+
+  batching.get<SaiNeighborTraits>().endBulk();
+  EXPECT_EQ(fs->neighborManager.numCreates(), numCreates + 2);
+}
@@ -0,0 +1,112 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/sai/api/FdbApi.h"
+#include "fboss/agent/hw/sai/api/NeighborApi.h"
+#include "fboss/agent/hw/sai/fake/FakeSai.h"
+#include "fboss/agent/hw/sai/store/SaiStore.h"
+
+#include <folly/Benchmark.h>
+#include <folly/IPAddress.h>
+#include <folly/MacAddress.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <tuple>
+#include <vector>
+
+DEFINE_int32(num_macs, 65536, "Number of FDB entries to program");
+DEFINE_int32(num_neighbors, 32768, "Number of neighbors to program");
+
+/*
+ * Programs and then removes FDB entries and neighbors through the SaiStore
+ * on top of FakeSai, one SAI call per object against bulk SAI calls.
+ */
+
+using namespace facebook::fboss;
+
+namespace {
+
+folly::IPAddress ipFor(unsigned i) {
+  auto bytes = folly::IPAddressV6("2401:db00::").toByteArray();
+  bytes[12] = (i >> 24) & 0xff;
+  bytes[13] = (i >> 16) & 0xff;
+  bytes[14] = (i >> 8) & 0xff;
+  bytes[15] = i & 0xff;
+  return folly::IPAddress(folly::IPAddressV6(bytes));
+}
+
+void programAndRemove(SaiStore& saiStore, bool bulk) {
+  auto& fdbStore = saiStore.get<SaiFdbTraits>();
+  auto& neighborStore = saiStore.get<SaiNeighborTraits>();
+  std::vector<std::shared_ptr<SaiObject<SaiFdbTraits>>> fdbEntries;
+  std::vector<std::shared_ptr<SaiObject<SaiNeighborTraits>>> neighbors;
+  fdbEntries.reserve(FLAGS_num_macs);
+  neighbors.reserve(FLAGS_num_neighbors);
+
+  if (bulk) {
+    saiStore.startBulkFdbAndNeighbors();
+  }
+  for (int i = 0; i < FLAGS_num_macs; ++i) {
+    auto mac = folly::MacAddress::fromHBO(0x020000000000 + i);
+    fdbEntries.push_back(fdbStore.setObject(
+        SaiFdbTraits::FdbEntry(0, 1000, mac),
+        {SAI_FDB_ENTRY_TYPE_STATIC, 24, std::nullopt},
+        std::make_tuple(InterfaceID(1000), mac)));
+  }
+  for (int i = 0; i < FLAGS_num_neighbors; ++i) {
+    neighbors.push_back(neighborStore.setObject(
+        SaiNeighborTraits::NeighborEntry(0, 0, ipFor(i)),
+        {folly::MacAddress::fromHBO(0x020000000000 + i),
+         std::nullopt,
+         std::nullopt,
+         std::nullopt}));
+  }
+  if (bulk) {
+    saiStore.endBulkFdbAndNeighbors();
+    saiStore.startBulkFdbAndNeighbors();
+  }
+  neighbors.clear();
+  fdbEntries.clear();
+  if (bulk) {
+    saiStore.endBulkFdbAndNeighbors();
+  }
+}
+
+} // namespace
+
+BENCHMARK(ProgramIndividually, numIters) {
+  std::unique_ptr<SaiStore> saiStore;
+  BENCHMARK_SUSPEND {
+    saiStore = std::make_unique<SaiStore>(0);
+  }
+  for (size_t n = 0; n < numIters; ++n) {
+    programAndRemove(*saiStore, false /* bulk */);
+  }
+}
+
+BENCHMARK_RELATIVE(ProgramInBulk, numIters) {
+  std::unique_ptr<SaiStore> saiStore;
+  BENCHMARK_SUSPEND {
+    saiStore = std::make_unique<SaiStore>(0);
+  }
+  for (size_t n = 0; n < numIters; ++n) {
+    programAndRemove(*saiStore, true /* bulk */);
+  }
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  auto fs = FakeSai::getInstance();
+  auto saiApiTable = SaiApiTable::getInstance();
+  saiApiTable->queryApis(nullptr, saiApiTable->getFullApiList());
+  folly::runBenchmarks();
+  return 0;
+}
@@ -27,6 +27,8 @@
 #include <folly/MacAddress.h>
 #include <chrono>
 #include <memory>
+#include <tuple>
+#include <utility>
 
 using namespace std::chrono;
 
@@ -505,9 +507,62 @@ SaiAclTableManager::addAclCounter(
   return std::make_pair(saiAclCounter, aclCounterTypeAndName);
 }
 
+namespace {
+template <typename AttrT>
+bool isAttributeUnset(
+    const std::optional<AttrT>& programmed,
+    const std::optional<AttrT>& desired) {
+  return programmed.has_value() && !desired.has_value();
+}
+
+template <typename AttrT>
+bool isAttributeUnset(const AttrT& /*programmed*/, const AttrT& /*desired*/) {
+  return false;
+}
+
+template <std::size_t... I>
+bool isAnyAttributeUnset(
+    const SaiAclEntryTraits::CreateAttributes& programmed,
+    const SaiAclEntryTraits::CreateAttributes& desired,
+    std::index_sequence<I...>) {
+  return (
+      ... || isAttributeUnset(std::get<I>(programmed), std::get<I>(desired)));
+}
+
+/*
+ * Whether the programmed entry can be moved to the desired attributes with
+ * set attribute calls. Optional attributes are only ever set, never cleared,
+ * so one going from set to unset (e.g. SetTC of a removed to cpu action, or
+ * the flow of a macsec action turning into forward/drop) would stay
+ * programmed. A changed packet action changes the type of action as well.
+ * Both need the entry to be re-created instead.
+ */
+bool canSetAclEntryAttributes(
+    const SaiAclEntryTraits::CreateAttributes& programmed,
+    const SaiAclEntryTraits::CreateAttributes& desired) {
+  using PacketAction =
+      std::optional<SaiAclEntryTraits::Attributes::ActionPacketAction>;
+  if (std::get<PacketAction>(programmed) != std::get<PacketAction>(desired)) {
+    return false;
+  }
+  return !isAnyAttributeUnset(
+      programmed,
+      desired,
+      std::make_index_sequence<
+          std::tuple_size_v<SaiAclEntryTraits::CreateAttributes>>{});
+}
+} // namespace
+
 AclEntrySaiId SaiAclTableManager::addAclEntry(
     const std::shared_ptr<AclEntry>& addedAclEntry,
     const std::string& aclTableName) {
+  return addAclEntryImpl(addedAclEntry, aclTableName, nullptr);
+}
+
+AclEntrySaiId SaiAclTableManager::addAclEntryImpl(
+    const std::shared_ptr<AclEntry>& addedAclEntry,
+    const std::string& aclTableName,
+    std::unique_ptr<SaiAclEntryHandle> programmedEntry) {
   // If we attempt to add entry to a table that does not exist, fail.
   auto aclTableHandle = getAclTableHandle(aclTableName);
   if (!aclTableHandle) {
@@ -988,6 +1043,13 @@ AclEntrySaiId SaiAclTableManager::addAclEntry(
       aclActionMacsecFlow,
   };
 
+  if (programmedEntry &&
+      !canSetAclEntryAttributes(
+          programmedEntry->aclEntry->attributes(), attributes)) {
+    // release the programmed entry, so the store re-creates it
+    XLOG(DBG2) << "re-creating acl entry " << addedAclEntry->getID();
+    programmedEntry.reset();
+  }
   auto saiAclEntry = aclEntryStore.setObject(adapterHostKey, attributes);
   auto entryHandle = std::make_unique<SaiAclEntryHandle>();
   entryHandle->aclEntry = saiAclEntry;
@@ -1050,17 +1112,47 @@ void SaiAclTableManager::removeAclCounter(
   }
 }
 
+namespace {
+/*
+ * Whether the programmed entry is a candidate for being updated with set
+ * attribute calls. The match fields can't be changed in place.
+ * addAclEntryImpl compares the programmed attributes against the new ones to
+ * decide whether it can actually be done.
+ */
+bool canUpdateAclEntryInPlace(
+    const AclEntry& oldAclEntry,
+    const AclEntry& newAclEntry) {
+  return oldAclEntry.getPriority() == newAclEntry.getPriority() &&
+      oldAclEntry.hasSameMatcher(newAclEntry);
+}
+} // namespace
+
 void SaiAclTableManager::changedAclEntry(
     const std::shared_ptr<AclEntry>& oldAclEntry,
     const std::shared_ptr<AclEntry>& newAclEntry,
     const std::string& aclTableName) {
   /*
-   * ASIC/SAI implementation typically does not allow modifying an ACL entry.
-   * Thus, remove and re-add.
+   * ASIC/SAI implementation typically does not allow modifying the match
+   * fields of an ACL entry. Thus, remove and re-add, unless only the actions
+   * changed. Then hold on to the programmed entry and counter while re-adding
+   * it: addAclEntryImpl finds them in the store and only sets the attributes
+   * that changed, unless some action can't be changed that way.
    */
-  XLOG(DBG2) << "changing acl entry " << oldAclEntry->getID();
+  std::unique_ptr<SaiAclEntryHandle> programmedEntry;
+  if (canUpdateAclEntryInPlace(*oldAclEntry, *newAclEntry)) {
+    auto aclTableHandle = getAclTableHandle(aclTableName);
+    if (aclTableHandle) {
+      auto itr =
+          aclTableHandle->aclTableMembers.find(oldAclEntry->getPriority());
+      if (itr != aclTableHandle->aclTableMembers.end()) {
+        programmedEntry = std::move(itr->second);
+      }
+    }
+  }
+  XLOG(DBG2) << "changing acl entry " << oldAclEntry->getID()
+             << (programmedEntry ? " keeping programmed entry" : "");
   removeAclEntry(oldAclEntry, aclTableName);
-  addAclEntry(newAclEntry, aclTableName);
+  addAclEntryImpl(newAclEntry, aclTableName, std::move(programmedEntry));
 }
 
 const SaiAclEntryHandle* FOLLY_NULLABLE SaiAclTableManager::getAclEntryHandle(
@@ -203,6 +203,16 @@ class SaiAclTableManager {
   SaiAclTableHandle* FOLLY_NULLABLE
   getAclTableHandleImpl(const std::string& aclTableName) const;
 
+  /*
+   * Add the entry. If programmedEntry is passed, it holds on to the entry
+   * already programmed at the same priority, which is then updated in place
+   * when possible.
+   */
+  AclEntrySaiId addAclEntryImpl(
+      const std::shared_ptr<AclEntry>& addedAclEntry,
+      const std::string& aclTableName,
+      std::unique_ptr<SaiAclEntryHandle> programmedEntry);
+
   std::pair<
       SaiAclTableTraits::AdapterHostKey,
       SaiAclTableTraits::CreateAttributes>
@@ -35,11 +35,18 @@ SaiNextHopGroupManager::SaiNextHopGroupManager(
 std::shared_ptr<SaiNextHopGroupHandle>
 SaiNextHopGroupManager::incRefOrAddNextHopGroup(
     const RouteNextHopEntry::NextHopSet& swNextHops) {
-  auto ins = handles_.refOrEmplace(swNextHops);
+  return incRefOrAddNextHopGroup(InternedNextHopSet::intern(swNextHops));
+}
+
+std::shared_ptr<SaiNextHopGroupHandle>
+SaiNextHopGroupManager::incRefOrAddNextHopGroup(
+    const InternedNextHopSetPtr& internedNextHops) {
+  auto ins = handles_.refOrEmplace(internedNextHops);
   std::shared_ptr<SaiNextHopGroupHandle> nextHopGroupHandle = ins.first;
   if (!ins.second) {
     return nextHopGroupHandle;
   }
+  const auto& swNextHops = internedNextHops->nextHops();
   SaiNextHopGroupTraits::AdapterHostKey nextHopGroupAdapterHostKey;
   // Populate the set of rifId, IP pairs for the NextHopGroup's
   // AdapterHostKey, and a set of next hop ids to create members for
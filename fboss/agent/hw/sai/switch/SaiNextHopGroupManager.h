@@ -175,6 +175,9 @@ class SaiNextHopGroupManager {
   std::shared_ptr<SaiNextHopGroupHandle> incRefOrAddNextHopGroup(
       const RouteNextHopEntry::NextHopSet& swNextHops);
 
+  std::shared_ptr<SaiNextHopGroupHandle> incRefOrAddNextHopGroup(
+      const InternedNextHopSetPtr& swNextHops);
+
   std::shared_ptr<SaiNextHopGroupMember> createSaiObject(
       const typename SaiNextHopGroupMemberTraits::AdapterHostKey& key,
       const typename SaiNextHopGroupMemberTraits::CreateAttributes& attributes);
@@ -196,7 +199,8 @@ class SaiNextHopGroupManager {
   // TODO(borisb): improve SaiObject/SaiStore to the point where they
   // support the next hop group use case correctly, rather than this
   // abomination of multiple levels of RefMaps :(
-  FlatRefMap<RouteNextHopEntry::NextHopSet, SaiNextHopGroupHandle> handles_;
+  // keyed by interned next hop set, so lookups compare pointers
+  FlatRefMap<InternedNextHopSetPtr, SaiNextHopGroupHandle> handles_;
   FlatRefMap<
       std::pair<typename SaiNextHopGroupTraits::AdapterKey, ResolvedNextHop>,
       NextHopGroupMember>
@@ -198,7 +198,7 @@ void SaiRouteManager::addOrUpdateRoute(
        */
       auto nextHopGroupHandle =
           managerTable_->nextHopGroupManager().incRefOrAddNextHopGroup(
-              fwd.normalizedNextHops());
+              fwd.internedNormalizedNextHops());
       NextHopGroupSaiId nextHopGroupId{
           nextHopGroupHandle->nextHopGroup->adapterKey()};
 #if SAI_API_VERSION >= SAI_VERSION(1, 10, 0)
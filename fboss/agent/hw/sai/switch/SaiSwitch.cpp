@@ -66,13 +66,16 @@
 #include "fboss/agent/hw/switch_asics/HwAsic.h"
 #include "folly/MacAddress.h"
 
+#include "fboss/lib/FunctionCallTimeReporter.h"
 #include "fboss/lib/phy/PhyUtils.h"
 #include "fboss/lib/phy/gen-cpp2/phy_types.h"
 
+#include <folly/Demangle.h>
 #include <folly/logging/xlog.h>
 
 #include <chrono>
 #include <optional>
+#include <typeinfo>
 
 extern "C" {
 #include <sai.h>
@@ -140,6 +143,23 @@ std::string fdbEventToString(sai_fdb_event_t event) {
 
 static std::set<facebook::fboss::cfg::PacketRxReason> kAllowedRxReasons = {
     facebook::fboss::cfg::PacketRxReason::TTL_1};
+
+// Profiling span name for processing a delta, e.g. process_delta.Port
+template <typename Delta>
+const char* deltaSpanName() {
+  static const char* spanName = [] {
+    const std::string kNamespace = "facebook::fboss::";
+    auto nodeName =
+        folly::demangle(typeid(typename Delta::Node)).toStdString();
+    for (auto pos = nodeName.find(kNamespace); pos != std::string::npos;
+         pos = nodeName.find(kNamespace)) {
+      nodeName.erase(pos, kNamespace.size());
+    }
+    return facebook::fboss::ProfilingSpan::internName(
+        folly::to<std::string>("process_delta.", nodeName));
+  }();
+  return spanName;
+}
 } // namespace
 
 namespace facebook::fboss {
@@ -506,6 +526,7 @@ template <typename LockPolicyT>
 std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
     const StateDelta& delta,
     const LockPolicyT& lockPolicy) {
+  PROFILE_SPAN("hw_state_changed");
   // update switch settings first
   processSwitchSettingsChanged(delta, lockPolicy);
 
@@ -608,30 +629,46 @@ std::shared_ptr<SwitchState> SaiSwitch::stateChangedImpl(
       &SaiRouterInterfaceManager::addRouterInterface,
       &SaiRouterInterfaceManager::removeRouterInterface);
 
-  for (const auto& vlanDelta : delta.getVlansDelta()) {
-    processDelta(
-        vlanDelta.getArpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::changeNeighbor<ArpEntry>,
-        &SaiNeighborManager::addNeighbor<ArpEntry>,
-        &SaiNeighborManager::removeNeighbor<ArpEntry>);
-
-    processDelta(
-        vlanDelta.getNdpDelta(),
-        managerTable_->neighborManager(),
-        lockPolicy,
-        &SaiNeighborManager::changeNeighbor<NdpEntry>,
-        &SaiNeighborManager::addNeighbor<NdpEntry>,
-        &SaiNeighborManager::removeNeighbor<NdpEntry>);
-
-    processDelta(
-        vlanDelta.getMacDelta(),
-        managerTable_->fdbManager(),
-        lockPolicy,
-        &SaiFdbManager::changeMac,
-        &SaiFdbManager::addMac,
-        &SaiFdbManager::removeMac);
+  // Program the neighbor and MAC changes of all VLANs with bulk SAI calls
+  {
+    [[maybe_unused]] const auto& lock = lockPolicy.lock();
+    saiStore_->startBulkFdbAndNeighbors();
+  }
+  try {
+    for (const auto& vlanDelta : delta.getVlansDelta()) {
+      processDelta(
+          vlanDelta.getArpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::changeNeighbor<ArpEntry>,
+          &SaiNeighborManager::addNeighbor<ArpEntry>,
+          &SaiNeighborManager::removeNeighbor<ArpEntry>);
+
+      processDelta(
+          vlanDelta.getNdpDelta(),
+          managerTable_->neighborManager(),
+          lockPolicy,
+          &SaiNeighborManager::changeNeighbor<NdpEntry>,
+          &SaiNeighborManager::addNeighbor<NdpEntry>,
+          &SaiNeighborManager::removeNeighbor<NdpEntry>);
+
+      processDelta(
+          vlanDelta.getMacDelta(),
+          managerTable_->fdbManager(),
+          lockPolicy,
+          &SaiFdbManager::changeMac,
+          &SaiFdbManager::addMac,
+          &SaiFdbManager::removeMac);
+    }
+  } catch (...) {
+    // Flush what was processed so far, so hardware matches the store
+    [[maybe_unused]] const auto& lock = lockPolicy.lock();
+    saiStore_->endBulkFdbAndNeighbors();
+    throw;
+  }
+  {
+    [[maybe_unused]] const auto& lock = lockPolicy.lock();
+    saiStore_->endBulkFdbAndNeighbors();
   }
 
   auto processV4RoutesDelta = [this, &lockPolicy](
@@ -2341,6 +2378,7 @@ void SaiSwitch::processDelta(
     AddedFunc addedFunc,
     RemovedFunc removedFunc,
     Args... args) {
+  PROFILE_SPAN(deltaSpanName<Delta>());
   DeltaFunctions::forEachChanged(
       delta,
       [&](const std::shared_ptr<typename Delta::Node>& removed,
@@ -2370,6 +2408,7 @@ void SaiSwitch::processChangedDelta(
     const LockPolicyT& lockPolicy,
     ChangeFunc changedFunc,
     Args... args) {
+  PROFILE_SPAN(deltaSpanName<Delta>());
   DeltaFunctions::forEachChanged(
       delta,
       [&](const std::shared_ptr<typename Delta::Node>& added,
@@ -2391,6 +2430,7 @@ void SaiSwitch::processAddedDelta(
     const LockPolicyT& lockPolicy,
     AddedFunc addedFunc,
     Args... args) {
+  PROFILE_SPAN(deltaSpanName<Delta>());
   DeltaFunctions::forEachAdded(
       delta, [&](const std::shared_ptr<typename Delta::Node>& added) {
         [[maybe_unused]] const auto& lock = lockPolicy.lock();
@@ -2410,6 +2450,7 @@ void SaiSwitch::processRemovedDelta(
     const LockPolicyT& lockPolicy,
     RemovedFunc removedFunc,
     Args... args) {
+  PROFILE_SPAN(deltaSpanName<Delta>());
   DeltaFunctions::forEachRemoved(
       delta, [&](const std::shared_ptr<typename Delta::Node>& removed) {
         [[maybe_unused]] const auto& lock = lockPolicy.lock();
@@ -7,13 +7,19 @@
  *  of patent rights can be found in the PATENTS file in the same directory.
  *
  */
+#include "fboss/agent/AclPriorityAllocator.h"
 #include "fboss/agent/hw/sai/switch/SaiAclTableGroupManager.h"
 #include "fboss/agent/hw/sai/switch/SaiAclTableManager.h"
 #include "fboss/agent/hw/sai/switch/SaiSwitch.h"
 #include "fboss/agent/hw/sai/switch/tests/ManagerTestBase.h"
 #include "fboss/agent/types.h"
 
+#include <folly/Conv.h>
+
+#include <map>
+#include <optional>
 #include <string>
+#include <vector>
 
 using namespace facebook::fboss;
 
@@ -46,6 +52,44 @@ class AclTableManagerTest : public ManagerTestBase {
   cfg::AclActionType kActionType() {
     return cfg::AclActionType::DENY;
   }
+
+  std::shared_ptr<AclEntry> makeAclEntry(int priority, uint16_t srcPort) {
+    auto aclEntry = std::make_shared<AclEntry>(
+        priority, folly::to<std::string>("AclEntry", srcPort));
+    aclEntry->setL4SrcPort(srcPort);
+    aclEntry->setActionType(kActionType());
+    return aclEntry;
+  }
+
+  // Program the change from oldEntries to newEntries the way the state delta
+  // does, by priority
+  void changeAclEntries(
+      const std::vector<std::shared_ptr<AclEntry>>& oldEntries,
+      const std::vector<std::shared_ptr<AclEntry>>& newEntries) {
+    std::map<int, std::shared_ptr<AclEntry>> oldByPriority;
+    std::map<int, std::shared_ptr<AclEntry>> newByPriority;
+    for (const auto& aclEntry : oldEntries) {
+      oldByPriority.emplace(aclEntry->getPriority(), aclEntry);
+    }
+    for (const auto& aclEntry : newEntries) {
+      newByPriority.emplace(aclEntry->getPriority(), aclEntry);
+    }
+    auto& aclTableManager = saiManagerTable->aclTableManager();
+    for (const auto& [priority, oldEntry] : oldByPriority) {
+      auto newEntry = newByPriority.find(priority);
+      if (newEntry == newByPriority.end()) {
+        aclTableManager.removeAclEntry(oldEntry, kAclTable1);
+      } else if (newEntry->second != oldEntry) {
+        aclTableManager.changedAclEntry(
+            oldEntry, newEntry->second, kAclTable1);
+      }
+    }
+    for (const auto& [priority, newEntry] : newByPriority) {
+      if (oldByPriority.find(priority) == oldByPriority.end()) {
+        aclTableManager.addAclEntry(newEntry, kAclTable1);
+      }
+    }
+  }
 };
 
 TEST_F(AclTableManagerTest, addAclTable) {
@@ -243,3 +287,196 @@ TEST_F(AclTableManagerTest, aclMirroring) {
       aclEntryId, SaiAclEntryTraits::Attributes::ActionMirrorIngress());
   EXPECT_EQ((gotMirrorSaiIdList.getData())[0], mirrorHandle->adapterKey());
 }
+
+TEST_F(AclTableManagerTest, changeAclEntryActionInPlace) {
+  auto aclEntry = std::make_shared<AclEntry>(kPriority(), "AclEntry1");
+  aclEntry->setDscp(kDscp());
+  aclEntry->setActionType(kActionType());
+  AclEntrySaiId aclEntryId =
+      saiManagerTable->aclTableManager().addAclEntry(aclEntry, kAclTable1);
+
+  auto newAclEntry = std::make_shared<AclEntry>(kPriority(), "AclEntry1");
+  newAclEntry->setDscp(kDscp());
+  newAclEntry->setActionType(kActionType());
+  MatchAction action = MatchAction();
+  auto setDscp = cfg::SetDscpMatchAction();
+  *setDscp.dscpValue() = kDscp2();
+  action.setSetDscp(setDscp);
+  newAclEntry->setAclAction(action);
+
+  auto& fakeAclEntries = fs->aclEntryManager;
+  auto numCreates = fakeAclEntries.numCreates();
+  auto numRemoves = fakeAclEntries.numRemoves();
+  saiManagerTable->aclTableManager().changedAclEntry(
+      aclEntry, newAclEntry, kAclTable1);
+
+  // Only the action changed, so the entry is updated in place
+  EXPECT_EQ(fakeAclEntries.numCreates(), numCreates);
+  EXPECT_EQ(fakeAclEntries.numRemoves(), numRemoves);
+  auto aclTableHandle =
+      saiManagerTable->aclTableManager().getAclTableHandle(kAclTable1);
+  auto aclEntryHandle = saiManagerTable->aclTableManager().getAclEntryHandle(
+      aclTableHandle, kPriority());
+  EXPECT_EQ(aclEntryHandle->aclEntry->adapterKey(), aclEntryId);
+  auto setDscpGot = saiApiTable->aclApi().getAttribute(
+      aclEntryId, SaiAclEntryTraits::Attributes::ActionSetDSCP());
+  EXPECT_EQ(setDscpGot.getData(), kDscp2());
+
+  // Removing the action again can't be done by setting attributes
+  saiManagerTable->aclTableManager().changedAclEntry(
+      newAclEntry, aclEntry, kAclTable1);
+  EXPECT_EQ(fakeAclEntries.numCreates(), numCreates + 1);
+  EXPECT_EQ(fakeAclEntries.numRemoves(), numRemoves + 1);
+}
+
+TEST_F(AclTableManagerTest, changeAclEntryRemoveToCpu) {
+  auto aclEntry = std::make_shared<AclEntry>(kPriority(), "AclEntry1");
+  aclEntry->setDscp(kDscp());
+  cfg::QueueMatchAction queueAction;
+  *queueAction.queueId() = 2;
+  MatchAction action = MatchAction();
+  action.setSendToQueue(std::make_pair(queueAction, true));
+  action.setToCpuAction(cfg::ToCpuAction::TRAP);
+  aclEntry->setAclAction(action);
+  AclEntrySaiId aclEntryId =
+      saiManagerTable->aclTableManager().addAclEntry(aclEntry, kAclTable1);
+  auto setTCGot = saiApiTable->aclApi().getAttribute(
+      aclEntryId, SaiAclEntryTraits::Attributes::ActionSetTC());
+  EXPECT_EQ(setTCGot.getData(), 2);
+
+  auto newAclEntry = std::make_shared<AclEntry>(kPriority(), "AclEntry1");
+  newAclEntry->setDscp(kDscp());
+
+  auto& fakeAclEntries = fs->aclEntryManager;
+  auto numCreates = fakeAclEntries.numCreates();
+  auto numRemoves = fakeAclEntries.numRemoves();
+  saiManagerTable->aclTableManager().changedAclEntry(
+      aclEntry, newAclEntry, kAclTable1);
+
+  // Trap and SetTC can't be cleared by setting attributes
+  EXPECT_EQ(fakeAclEntries.numCreates(), numCreates + 1);
+  EXPECT_EQ(fakeAclEntries.numRemoves(), numRemoves + 1);
+  auto aclTableHandle =
+      saiManagerTable->aclTableManager().getAclTableHandle(kAclTable1);
+  auto aclEntryHandle = saiManagerTable->aclTableManager().getAclEntryHandle(
+      aclTableHandle, kPriority());
+  EXPECT_FALSE(
+      std::get<std::optional<SaiAclEntryTraits::Attributes::ActionSetTC>>(
+          aclEntryHandle->aclEntry->attributes()));
+  auto packetActionGot = saiApiTable->aclApi().getAttribute(
+      aclEntryHandle->aclEntry->adapterKey(),
+      SaiAclEntryTraits::Attributes::ActionPacketAction());
+  EXPECT_EQ(packetActionGot.getData(), SAI_PACKET_ACTION_FORWARD);
+}
+
+TEST_F(AclTableManagerTest, changeAclEntryMacsecAction) {
+  auto makeMacsecAclEntry = [this](
+                                cfg::MacsecFlowPacketAction packetAction,
+                                uint64_t flowId) {
+    auto aclEntry = std::make_shared<AclEntry>(kPriority(), "AclEntry1");
+    aclEntry->setDscp(kDscp());
+    cfg::MacsecFlowAction macsecAction;
+    *macsecAction.action() = packetAction;
+    *macsecAction.flowId() = flowId;
+    MatchAction action = MatchAction();
+    action.setMacsecFlow(macsecAction);
+    aclEntry->setAclAction(action);
+    return aclEntry;
+  };
+  auto aclEntry =
+      makeMacsecAclEntry(cfg::MacsecFlowPacketAction::MACSEC_FLOW, 1);
+  AclEntrySaiId aclEntryId =
+      saiManagerTable->aclTableManager().addAclEntry(aclEntry, kAclTable1);
+
+  auto& fakeAclEntries = fs->aclEntryManager;
+  auto numCreates = fakeAclEntries.numCreates();
+  auto numRemoves = fakeAclEntries.numRemoves();
+
+  // A different flow is set in place
+  auto newFlowAclEntry =
+      makeMacsecAclEntry(cfg::MacsecFlowPacketAction::MACSEC_FLOW, 2);
+  saiManagerTable->aclTableManager().changedAclEntry(
+      aclEntry, newFlowAclEntry, kAclTable1);
+  EXPECT_EQ(fakeAclEntries.numCreates(), numCreates);
+  EXPECT_EQ(fakeAclEntries.numRemoves(), numRemoves);
+  auto flowGot = saiApiTable->aclApi().getAttribute(
+      aclEntryId, SaiAclEntryTraits::Attributes::ActionMacsecFlow());
+  EXPECT_EQ(flowGot.getData(), static_cast<sai_object_id_t>(2));
+
+  // Turning the flow into forward has to clear the flow
+  auto forwardAclEntry =
+      makeMacsecAclEntry(cfg::MacsecFlowPacketAction::FORWARD, 2);
+  saiManagerTable->aclTableManager().changedAclEntry(
+      newFlowAclEntry, forwardAclEntry, kAclTable1);
+  EXPECT_EQ(fakeAclEntries.numCreates(), numCreates + 1);
+  EXPECT_EQ(fakeAclEntries.numRemoves(), numRemoves + 1);
+
+  // As does changing the packet action
+  saiManagerTable->aclTableManager().changedAclEntry(
+      forwardAclEntry,
+      makeMacsecAclEntry(cfg::MacsecFlowPacketAction::DROP, 2),
+      kAclTable1);
+  EXPECT_EQ(fakeAclEntries.numCreates(), numCreates + 2);
+  EXPECT_EQ(fakeAclEntries.numRemoves(), numRemoves + 2);
+}
+
+TEST_F(AclTableManagerTest, changeAclEntryMatcher) {
+  auto aclEntry = makeAclEntry(kPriority(), 1);
+  saiManagerTable->aclTableManager().addAclEntry(aclEntry, kAclTable1);
+
+  auto& fakeAclEntries = fs->aclEntryManager;
+  auto numCreates = fakeAclEntries.numCreates();
+  auto numRemoves = fakeAclEntries.numRemoves();
+  saiManagerTable->aclTableManager().changedAclEntry(
+      aclEntry, makeAclEntry(kPriority(), 2), kAclTable1);
+  EXPECT_EQ(fakeAclEntries.numCreates(), numCreates + 1);
+  EXPECT_EQ(fakeAclEntries.numRemoves(), numRemoves + 1);
+}
+
+TEST_F(AclTableManagerTest, insertAclEntryAtHead) {
+  constexpr int kNumEntries = 2000;
+  auto& fakeAclEntries = fs->aclEntryManager;
+  auto insertAtHead = [&](const std::vector<int>& priorities,
+                          const std::vector<int>& newPriorities) {
+    std::vector<std::shared_ptr<AclEntry>> aclEntries;
+    for (int i = 0; i < kNumEntries; ++i) {
+      aclEntries.push_back(makeAclEntry(priorities[i], i + 1));
+    }
+    changeAclEntries({}, aclEntries);
+
+    std::vector<std::shared_ptr<AclEntry>> newAclEntries;
+    newAclEntries.push_back(makeAclEntry(newPriorities[0], kNumEntries + 1));
+    for (int i = 0; i < kNumEntries; ++i) {
+      newAclEntries.push_back(
+          newPriorities[i + 1] == priorities[i]
+              ? aclEntries[i]
+              : makeAclEntry(newPriorities[i + 1], i + 1));
+    }
+    auto numCreates = fakeAclEntries.numCreates();
+    auto numRemoves = fakeAclEntries.numRemoves();
+    changeAclEntries(aclEntries, newAclEntries);
+    auto numCalls = (fakeAclEntries.numCreates() - numCreates) +
+        (fakeAclEntries.numRemoves() - numRemoves);
+    changeAclEntries(newAclEntries, {});
+    return numCalls;
+  };
+
+  // Numbered one after the other, every entry moves
+  std::vector<int> densePriorities;
+  for (int i = 0; i <= kNumEntries; ++i) {
+    densePriorities.push_back(kPriority() + i);
+  }
+  EXPECT_EQ(
+      insertAtHead(
+          std::vector<int>(densePriorities.begin(), densePriorities.end() - 1),
+          densePriorities),
+      2 * kNumEntries + 1);
+
+  // With gaps, only the first entry moves to make room
+  AclPriorityAllocator allocator(kPriority(), 1000000, 16);
+  auto priorities = allocator.allocate(
+      std::vector<std::optional<int>>(kNumEntries, std::nullopt));
+  std::vector<std::optional<int>> previous = {std::nullopt};
+  previous.insert(previous.end(), priorities.begin(), priorities.end());
+  EXPECT_EQ(insertAtHead(priorities, allocator.allocate(previous)), 3);
+}
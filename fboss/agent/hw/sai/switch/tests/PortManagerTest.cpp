@@ -254,6 +254,29 @@ TEST_F(PortManagerTest, changePortNoChange) {
   checkPort(swPort->getID(), handle, true);
 }
 
+TEST_F(PortManagerTest, changePortDescriptionNoHwWrites) {
+  std::shared_ptr<Port> swPort = makePort(p0);
+  saiManagerTable->portManager().addPort(swPort);
+  auto portSets = SaiObject<SaiPortTraits>::hwAttributeSets();
+  auto queueSets = SaiObject<SaiQueueTraits>::hwAttributeSets();
+  auto schedulerSets = SaiObject<SaiSchedulerTraits>::hwAttributeSets();
+
+  auto newPort = swPort->clone();
+  newPort->setDescription("uplink");
+  saiManagerTable->portManager().changePort(swPort, newPort);
+  EXPECT_EQ(SaiObject<SaiPortTraits>::hwAttributeSets(), portSets);
+  EXPECT_EQ(SaiObject<SaiQueueTraits>::hwAttributeSets(), queueSets);
+  EXPECT_EQ(SaiObject<SaiSchedulerTraits>::hwAttributeSets(), schedulerSets);
+
+  // Only the changed attribute is written
+  auto mtuPort = newPort->clone();
+  mtuPort->setMaxFrameSize(9000);
+  saiManagerTable->portManager().changePort(newPort, mtuPort);
+  EXPECT_EQ(SaiObject<SaiPortTraits>::hwAttributeSets(), portSets + 1);
+  auto handle = saiManagerTable->portManager().getPortHandle(swPort->getID());
+  checkPort(swPort->getID(), handle, true, 9000);
+}
+
 TEST_F(PortManagerTest, changeNonExistentPort) {
   std::shared_ptr<Port> swPort = makePort(p0);
   std::shared_ptr<Port> swPort2 = makePort(p1);
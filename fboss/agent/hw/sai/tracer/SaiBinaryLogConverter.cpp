@@ -0,0 +1,73 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/sai/tracer/SaiBinaryTrace.h"
+#include "fboss/agent/hw/sai/tracer/SaiTracer.h"
+
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/Singleton.h>
+#include <folly/init/Init.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+
+DEFINE_string(
+    binary_log,
+    "/var/facebook/logs/fboss/sdk/sai_replayer.bin",
+    "Binary SAI Replayer log to convert");
+
+DEFINE_string(
+    output,
+    "/tmp/sai_replayer.log",
+    "File to write the C code to. If the binary log spans several boots, "
+    "boots after the first are written to <output>.<n>");
+
+using namespace facebook::fboss;
+
+/*
+ * Converts a log recorded with --enable_replayer_binary_log into the same C
+ * code the SAI Replayer would have produced with the text log. The code is
+ * produced by the regular SaiTracer, so this needs to be built against the
+ * same SAI headers as the agent that recorded the log.
+ */
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+
+  std::string log;
+  if (!folly::readFile(FLAGS_binary_log.c_str(), log)) {
+    XLOG(ERR) << "Failed to read " << FLAGS_binary_log;
+    return 1;
+  }
+  auto boots = parseSaiBinaryTrace(folly::ByteRange(folly::StringPiece(log)));
+
+  // Emit everything that was recorded
+  FLAGS_enable_replayer = true;
+  FLAGS_enable_replayer_binary_log = false;
+  FLAGS_enable_get_attr_log = true;
+  FLAGS_enable_packet_log = true;
+
+  for (size_t i = 0; i < boots.size(); ++i) {
+    FLAGS_sai_log =
+        i == 0 ? FLAGS_output : folly::to<std::string>(FLAGS_output, ".", i);
+    {
+      auto tracer = SaiTracer::getInstance();
+      tracer->appendToFile(boots[i].header);
+      for (const auto& record : boots[i].records) {
+        replaySaiBinaryTraceRecord(*tracer, record);
+      }
+    }
+    XLOG(INFO) << "Converted " << boots[i].records.size() << " records to "
+               << FLAGS_sai_log;
+    // Each boot gets a fresh tracer, which writes the footer when destroyed
+    folly::SingletonVault::singleton()->destroyInstances();
+    folly::SingletonVault::singleton()->reenableInstances();
+  }
+  return 0;
+}
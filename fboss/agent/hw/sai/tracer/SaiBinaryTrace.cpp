@@ -0,0 +1,596 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/hw/sai/tracer/SaiBinaryTrace.h"
+
+#include <algorithm>
+#include <limits>
+#include <type_traits>
+#include <unordered_map>
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/agent/hw/sai/tracer/SaiTracer.h"
+
+#include <folly/lang/Align.h>
+#include <folly/logging/xlog.h>
+
+namespace facebook::fboss {
+
+namespace {
+
+constexpr folly::StringPiece kBootHeaderStart = "// Start of a ";
+
+std::chrono::system_clock::time_point toTimePoint(uint64_t timestampUs) {
+  return std::chrono::system_clock::time_point(
+      std::chrono::duration_cast<std::chrono::system_clock::duration>(
+          std::chrono::microseconds(timestampUs)));
+}
+
+template <typename T>
+T keyAs(const SaiBinaryTraceRecord& record) {
+  if (record.key.size() != sizeof(T)) {
+    throw FbossError(
+        "Unexpected key size ",
+        record.key.size(),
+        " for object type ",
+        record.header.objectType,
+        " in binary SAI replayer log");
+  }
+  T key;
+  memcpy(&key, record.key.data(), sizeof(T));
+  return key;
+}
+
+} // namespace
+
+SaiAttrListType saiAttrListType(sai_object_type_t objectType, int32_t attrId) {
+  // These are formatted outside of the attribute type maps, see
+  // SET_SAI_STRING_ATTRIBUTES
+  if (objectType == SAI_OBJECT_TYPE_SWITCH &&
+      (attrId == SAI_SWITCH_ATTR_SWITCH_HARDWARE_INFO ||
+       attrId == SAI_SWITCH_ATTR_FIRMWARE_PATH_NAME)) {
+    return SaiAttrListType::S8;
+  }
+
+  auto setAttributes = SaiTracer::setAttributesFn(objectType);
+  auto typeMap =
+      setAttributes ? AttributeTypeMapRegistry::get(setAttributes) : nullptr;
+  if (!typeMap) {
+    return SaiAttrListType::NONE;
+  }
+  auto attr = typeMap->find(attrId);
+  if (attr == typeMap->end()) {
+    return SaiAttrListType::NONE;
+  }
+
+  // Mirrors SaiTracer::listFuncMap_
+  static const std::unordered_map<std::size_t, SaiAttrListType> kListTypes{
+      {TYPE_INDEX(std::vector<sai_object_id_t>), SaiAttrListType::OBJECT_ID},
+      {TYPE_INDEX(std::vector<sai_uint32_t>), SaiAttrListType::U32},
+      {TYPE_INDEX(std::vector<sai_int32_t>), SaiAttrListType::S32},
+      {TYPE_INDEX(std::vector<sai_qos_map_t>), SaiAttrListType::QOS_MAP},
+      {TYPE_INDEX(AclEntryActionSaiObjectIdList),
+       SaiAttrListType::ACL_ACTION_OBJECT_ID},
+  };
+  auto listType = kListTypes.find(attr->second.second);
+  return listType == kListTypes.end() ? SaiAttrListType::NONE
+                                      : listType->second;
+}
+
+/*
+ * Single producer, single consumer byte ring. The producer is the thread
+ * owning the ring, the consumer is whoever holds drainLock_.
+ */
+class SaiBinaryTraceRecorder::Ring {
+ public:
+  explicit Ring(uint32_t capacity) : buffer_(capacity) {}
+
+  /*
+   * Copies size bytes in, or returns false if there is not enough room.
+   * On success, used is set to the number of bytes in the ring.
+   */
+  bool tryWrite(const uint8_t* data, size_t size, size_t& used) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    auto head = head_.load(std::memory_order_acquire);
+    if (buffer_.size() - (tail - head) < size) {
+      return false;
+    }
+    auto offset = tail % buffer_.size();
+    auto first = std::min(size, buffer_.size() - offset);
+    memcpy(buffer_.data() + offset, data, first);
+    memcpy(buffer_.data(), data + first, size - first);
+    tail_.store(tail + size, std::memory_order_release);
+    used = tail + size - head;
+    return true;
+  }
+
+  // Hands all complete records to fn, in at most two contiguous pieces
+  template <typename Fn>
+  void drain(Fn&& fn) {
+    auto head = head_.load(std::memory_order_relaxed);
+    auto tail = tail_.load(std::memory_order_acquire);
+    if (head == tail) {
+      return;
+    }
+    auto offset = head % buffer_.size();
+    auto size = tail - head;
+    auto first = std::min<size_t>(size, buffer_.size() - offset);
+    fn(buffer_.data() + offset, first);
+    if (size > first) {
+      fn(buffer_.data(), size - first);
+    }
+    head_.store(tail, std::memory_order_release);
+  }
+
+ private:
+  std::vector<uint8_t> buffer_;
+  alignas(folly::hardware_destructive_interference_size)
+      std::atomic<uint64_t> head_{0};
+  alignas(folly::hardware_destructive_interference_size)
+      std::atomic<uint64_t> tail_{0};
+};
+
+SaiBinaryTraceRecorder::SaiBinaryTraceRecorder(
+    AsyncLogger* logger,
+    uint32_t ringSize,
+    std::chrono::milliseconds drainInterval)
+    : logger_(logger),
+      ringSize_(ringSize),
+      drainInterval_(drainInterval),
+      drainThread_([this] { drainLoop(); }) {}
+
+SaiBinaryTraceRecorder::~SaiBinaryTraceRecorder() {
+  {
+    std::lock_guard<std::mutex> lock(drainThreadLock_);
+    stop_ = true;
+  }
+  drainCv_.notify_one();
+  drainThread_.join();
+  drainAll();
+}
+
+SaiBinaryTraceRecorder::Producer& SaiBinaryTraceRecorder::producer() {
+  auto& producer = *producers_;
+  if (!producer.ring) {
+    producer.ring = std::make_shared<Ring>(ringSize_);
+    rings_.wlock()->push_back(producer.ring);
+  }
+  return producer;
+}
+
+void SaiBinaryTraceRecorder::record(
+    SaiBinaryTraceOp op,
+    sai_object_type_t objectType,
+    folly::StringPiece fnName,
+    sai_object_id_t objectId,
+    sai_object_id_t switchId,
+    sai_status_t rv,
+    uint32_t attrCount,
+    const sai_attribute_t* attrList,
+    folly::ByteRange key,
+    std::initializer_list<folly::ByteRange> data,
+    uint32_t count,
+    int32_t mode) {
+  auto& producer = this->producer();
+  auto& buffer = producer.scratch;
+  auto append = [&buffer](const void* bytes, size_t size) {
+    auto begin = static_cast<const uint8_t*>(bytes);
+    buffer.insert(buffer.end(), begin, begin + size);
+  };
+
+  SaiBinaryTraceHeader header{};
+  header.magic = SaiBinaryTraceHeader::kMagic;
+  header.seq = nextSeq_.fetch_add(1, std::memory_order_relaxed);
+  header.timestampUs =
+      std::chrono::duration_cast<std::chrono::microseconds>(
+          std::chrono::system_clock::now().time_since_epoch())
+          .count();
+  header.objectId = objectId;
+  header.switchId = switchId;
+  header.objectType = objectType;
+  header.rv = rv;
+  header.attrCount = attrCount;
+  header.count = count;
+  header.mode = mode;
+  header.keySize = key.size();
+  header.fnNameSize = std::min<size_t>(
+      fnName.size(), std::numeric_limits<decltype(header.fnNameSize)>::max());
+  header.op = op;
+
+  buffer.resize(sizeof(SaiBinaryTraceHeader));
+  append(fnName.data(), header.fnNameSize);
+  append(key.data(), key.size());
+  auto attrsOffset = buffer.size();
+  append(attrList, sizeof(sai_attribute_t) * attrCount);
+
+  // A failed get may report a list count larger than the buffer it was given
+  bool recordLists =
+      op != SaiBinaryTraceOp::GET_ATTR || rv == SAI_STATUS_SUCCESS;
+  for (uint32_t i = 0; i < attrCount; ++i) {
+    if (recordLists) {
+      visitSaiAttrList(objectType, attrList[i], [&](const auto& list) {
+        if (list.list) {
+          append(list.list, sizeof(*list.list) * list.count);
+        }
+      });
+      continue;
+    }
+    sai_attribute_t attr;
+    auto copied = buffer.data() + attrsOffset + sizeof(sai_attribute_t) * i;
+    memcpy(&attr, copied, sizeof(attr));
+    if (visitSaiAttrList(
+            objectType, attr, [](auto& list) { list.list = nullptr; })) {
+      memcpy(copied, &attr, sizeof(attr));
+    }
+  }
+  for (const auto& range : data) {
+    append(range.data(), range.size());
+  }
+
+  header.size = buffer.size();
+  memcpy(buffer.data(), &header, sizeof(header));
+  push(producer);
+}
+
+void SaiBinaryTraceRecorder::recordText(folly::StringPiece text) {
+  record(
+      SaiBinaryTraceOp::TEXT,
+      SAI_OBJECT_TYPE_NULL,
+      "",
+      SAI_NULL_OBJECT_ID,
+      SAI_NULL_OBJECT_ID,
+      SAI_STATUS_SUCCESS,
+      0,
+      nullptr,
+      {},
+      {folly::ByteRange(text)},
+      text.size());
+}
+
+void SaiBinaryTraceRecorder::push(Producer& producer) {
+  const auto& buffer = producer.scratch;
+  if (buffer.size() > ringSize_) {
+    droppedRecords_.fetch_add(1, std::memory_order_relaxed);
+    XLOG_EVERY_MS(ERR, 1000)
+        << "[Sai Replayer] Dropping " << buffer.size()
+        << " byte record larger than sai_binary_log_ring_size";
+    return;
+  }
+
+  auto requestDrain = [this] {
+    if (!drainRequested_.exchange(true)) {
+      {
+        // Pairs with the predicate check in drainLoop() so the wakeup
+        // can't be missed
+        std::lock_guard<std::mutex> lock(drainThreadLock_);
+      }
+      drainCv_.notify_one();
+    }
+  };
+
+  size_t used;
+  while (!producer.ring->tryWrite(buffer.data(), buffer.size(), used)) {
+    // Trace fidelity matters more than latency, so wait for the drain
+    // rather than dropping the record
+    requestDrain();
+    std::this_thread::yield();
+  }
+  if (used > ringSize_ / 2) {
+    requestDrain();
+  }
+}
+
+void SaiBinaryTraceRecorder::flush() {
+  drainAll();
+}
+
+void SaiBinaryTraceRecorder::drainLoop() {
+  std::unique_lock<std::mutex> lock(drainThreadLock_);
+  while (!stop_) {
+    drainCv_.wait_for(lock, drainInterval_, [this] {
+      return stop_ || drainRequested_.load();
+    });
+    drainRequested_ = false;
+    lock.unlock();
+    drainAll();
+    lock.lock();
+  }
+}
+
+void SaiBinaryTraceRecorder::drainAll() {
+  // AsyncLogger can't take a single append as large as its buffer
+  constexpr size_t kMaxAppend = AsyncLogger::kBufferSize / 4;
+
+  std::lock_guard<std::mutex> lock(drainLock_);
+  auto rings = *rings_.rlock();
+  for (auto& ring : rings) {
+    ring->drain([this](const uint8_t* data, size_t size) {
+      for (size_t offset = 0; offset < size; offset += kMaxAppend) {
+        logger_->appendLog(
+            reinterpret_cast<const char*>(data) + offset,
+            std::min(kMaxAppend, size - offset));
+      }
+    });
+  }
+}
+
+std::vector<SaiBinaryTraceBoot> parseSaiBinaryTrace(folly::ByteRange log) {
+  std::vector<SaiBinaryTraceBoot> boots;
+  auto currentBoot = [&boots]() -> SaiBinaryTraceBoot& {
+    if (boots.empty()) {
+      boots.emplace_back();
+    }
+    return boots.back();
+  };
+
+  size_t offset = 0;
+  while (offset < log.size()) {
+    auto remaining = log.subpiece(offset);
+
+    uint32_t magic = 0;
+    if (remaining.size() >= sizeof(magic)) {
+      memcpy(&magic, remaining.data(), sizeof(magic));
+    }
+    if (magic != SaiBinaryTraceHeader::kMagic) {
+      // Boot header lines from AsyncLogger
+      folly::StringPiece text(
+          reinterpret_cast<const char*>(remaining.data()), remaining.size());
+      if (!text.startsWith("//")) {
+        throw FbossError(
+            "Malformed binary SAI replayer log at offset ", offset);
+      }
+      auto lineEnd = text.find('\n');
+      auto line = lineEnd == folly::StringPiece::npos
+          ? text
+          : text.subpiece(0, lineEnd + 1);
+      if (line.startsWith(kBootHeaderStart)) {
+        boots.emplace_back();
+      }
+      currentBoot().header.append(line.data(), line.size());
+      offset += line.size();
+      continue;
+    }
+
+    SaiBinaryTraceHeader header;
+    if (remaining.size() < sizeof(header)) {
+      XLOG(WARN) << "Ignoring truncated record at offset " << offset;
+      break;
+    }
+    memcpy(&header, remaining.data(), sizeof(header));
+    if (header.size < sizeof(header)) {
+      throw FbossError(
+          "Malformed record size ", header.size, " at offset ", offset);
+    }
+    if (remaining.size() < header.size) {
+      XLOG(WARN) << "Ignoring truncated record at offset " << offset;
+      break;
+    }
+
+    auto body =
+        remaining.subpiece(sizeof(header), header.size - sizeof(header));
+    auto take = [&](size_t size) {
+      if (body.size() < size) {
+        throw FbossError("Malformed record at offset ", offset);
+      }
+      auto taken = body.subpiece(0, size);
+      body.advance(size);
+      return taken;
+    };
+
+    SaiBinaryTraceRecord record;
+    record.header = header;
+    auto fnName = take(header.fnNameSize);
+    record.fnName.assign(fnName.begin(), fnName.end());
+    auto key = take(header.keySize);
+    record.key.assign(key.begin(), key.end());
+    record.attrs.resize(header.attrCount);
+    auto attrs = take(sizeof(sai_attribute_t) * header.attrCount);
+    memcpy(record.attrs.data(), attrs.data(), attrs.size());
+
+    // List pointers are from the recording process. Point them at copies of
+    // the payloads recorded after the attributes.
+    auto objectType = static_cast<sai_object_type_t>(header.objectType);
+    for (auto& attr : record.attrs) {
+      visitSaiAttrList(objectType, attr, [&](auto& list) {
+        if (!list.list) {
+          return;
+        }
+        using ElemT = std::remove_pointer_t<decltype(list.list)>;
+        auto payload = take(sizeof(ElemT) * list.count);
+        auto& copy = record.lists.emplace_back(new uint8_t[payload.size()]);
+        memcpy(copy.get(), payload.data(), payload.size());
+        list.list = reinterpret_cast<ElemT*>(copy.get());
+      });
+    }
+    record.data.assign(body.begin(), body.end());
+
+    currentBoot().records.push_back(std::move(record));
+    offset += header.size;
+  }
+
+  for (auto& boot : boots) {
+    std::stable_sort(
+        boot.records.begin(),
+        boot.records.end(),
+        [](const auto& lhs, const auto& rhs) {
+          return lhs.header.seq < rhs.header.seq;
+        });
+  }
+  return boots;
+}
+
+void replaySaiBinaryTraceRecord(
+    SaiTracer& tracer,
+    const SaiBinaryTraceRecord& record) {
+  const auto& header = record.header;
+  auto objectType = static_cast<sai_object_type_t>(header.objectType);
+  auto rv = static_cast<sai_status_t>(header.rv);
+  auto attrs = record.attrs.data();
+  sai_object_id_t objectId = header.objectId;
+
+  tracer.setLogTime(toTimePoint(header.timestampUs));
+  switch (header.op) {
+    case SaiBinaryTraceOp::TEXT:
+      tracer.appendToFile(record.data);
+      break;
+    case SaiBinaryTraceOp::CREATE:
+      switch (objectType) {
+        case SAI_OBJECT_TYPE_SWITCH:
+          tracer.logSwitchCreateFn(&objectId, header.attrCount, attrs, rv);
+          break;
+        case SAI_OBJECT_TYPE_ROUTE_ENTRY: {
+          auto entry = keyAs<sai_route_entry_t>(record);
+          tracer.logRouteEntryCreateFn(&entry, header.attrCount, attrs, rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_NEIGHBOR_ENTRY: {
+          auto entry = keyAs<sai_neighbor_entry_t>(record);
+          tracer.logNeighborEntryCreateFn(
+              &entry, header.attrCount, attrs, rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_FDB_ENTRY: {
+          auto entry = keyAs<sai_fdb_entry_t>(record);
+          tracer.logFdbEntryCreateFn(&entry, header.attrCount, attrs, rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_INSEG_ENTRY: {
+          auto entry = keyAs<sai_inseg_entry_t>(record);
+          tracer.logInsegEntryCreateFn(&entry, header.attrCount, attrs, rv);
+          break;
+        }
+        default:
+          tracer.logCreateFn(
+              record.fnName,
+              &objectId,
+              header.switchId,
+              header.attrCount,
+              attrs,
+              objectType,
+              rv);
+      }
+      break;
+    case SaiBinaryTraceOp::REMOVE:
+      switch (objectType) {
+        case SAI_OBJECT_TYPE_ROUTE_ENTRY: {
+          auto entry = keyAs<sai_route_entry_t>(record);
+          tracer.logRouteEntryRemoveFn(&entry, rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_NEIGHBOR_ENTRY: {
+          auto entry = keyAs<sai_neighbor_entry_t>(record);
+          tracer.logNeighborEntryRemoveFn(&entry, rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_FDB_ENTRY: {
+          auto entry = keyAs<sai_fdb_entry_t>(record);
+          tracer.logFdbEntryRemoveFn(&entry, rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_INSEG_ENTRY: {
+          auto entry = keyAs<sai_inseg_entry_t>(record);
+          tracer.logInsegEntryRemoveFn(&entry, rv);
+          break;
+        }
+        default:
+          tracer.logRemoveFn(record.fnName, objectId, objectType, rv);
+      }
+      break;
+    case SaiBinaryTraceOp::SET_ATTR:
+      switch (objectType) {
+        case SAI_OBJECT_TYPE_ROUTE_ENTRY: {
+          auto entry = keyAs<sai_route_entry_t>(record);
+          tracer.logRouteEntrySetAttrFn(&entry, attrs, rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_NEIGHBOR_ENTRY: {
+          auto entry = keyAs<sai_neighbor_entry_t>(record);
+          tracer.logNeighborEntrySetAttrFn(&entry, attrs, rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_FDB_ENTRY: {
+          auto entry = keyAs<sai_fdb_entry_t>(record);
+          tracer.logFdbEntrySetAttrFn(&entry, attrs, rv);
+          break;
+        }
+        case SAI_OBJECT_TYPE_INSEG_ENTRY: {
+          auto entry = keyAs<sai_inseg_entry_t>(record);
+          tracer.logInsegEntrySetAttrFn(&entry, attrs, rv);
+          break;
+        }
+        default:
+          tracer.logSetAttrFn(record.fnName, objectId, attrs, objectType, rv);
+      }
+      break;
+    case SaiBinaryTraceOp::GET_ATTR:
+      tracer.logGetAttrFn(
+          record.fnName, objectId, header.attrCount, attrs, objectType, rv);
+      break;
+    case SaiBinaryTraceOp::BULK_SET_ATTR: {
+      auto objectIds = record.dataAs<sai_object_id_t>(0, header.count);
+      auto statuses = record.dataAs<sai_status_t>(
+          sizeof(sai_object_id_t) * header.count, header.count);
+      tracer.logBulkSetAttrFn(
+          record.fnName,
+          header.count,
+          objectIds.data(),
+          attrs,
+          static_cast<sai_bulk_op_error_mode_t>(header.mode),
+          statuses.data(),
+          objectType,
+          rv);
+      break;
+    }
+    case SaiBinaryTraceOp::SEND_HOSTIF_PACKET: {
+      auto packet = record.dataAs<uint8_t>(0, header.count);
+      tracer.logSendHostifPacketFn(
+          objectId, header.count, packet.data(), header.attrCount, attrs, rv);
+      break;
+    }
+    case SaiBinaryTraceOp::GET_STATS: {
+      auto counterIds = record.dataAs<sai_stat_id_t>(0, header.count);
+      auto counters = record.dataAs<uint64_t>(
+          sizeof(sai_stat_id_t) * header.count, header.count);
+      tracer.logGetStatsFn(
+          record.fnName,
+          objectId,
+          header.count,
+          counterIds.data(),
+          counters.data(),
+          objectType,
+          rv,
+          header.mode);
+      break;
+    }
+    case SaiBinaryTraceOp::CLEAR_STATS: {
+      auto counterIds = record.dataAs<sai_stat_id_t>(0, header.count);
+      tracer.logClearStatsFn(
+          record.fnName,
+          objectId,
+          header.count,
+          counterIds.data(),
+          objectType,
+          rv);
+      break;
+    }
+    case SaiBinaryTraceOp::GET_OBJECT_KEY: {
+      auto objectKeys = record.dataAs<sai_object_key_t>(0, header.count);
+      tracer.logGetObjectKeyFn(objectType, header.count, objectKeys.data());
+      break;
+    }
+    default:
+      throw FbossError(
+          "Unknown op ",
+          static_cast<int>(header.op),
+          " in binary SAI replayer log");
+  }
+  tracer.setLogTime(std::nullopt);
+}
+
+} // namespace facebook::fboss
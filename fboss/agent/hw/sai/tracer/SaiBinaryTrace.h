@@ -0,0 +1,271 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstring>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "fboss/agent/AsyncLogger.h"
+
+#include <folly/Range.h>
+#include <folly/Synchronized.h>
+#include <folly/ThreadLocal.h>
+
+extern "C" {
+#include <sai.h>
+}
+
+namespace facebook::fboss {
+
+class SaiTracer;
+
+/*
+ * Compact binary form of the SAI Replayer log.
+ *
+ * Formatting every SAI call as C code while the call is made is too
+ * expensive to leave on under route churn. With
+ * FLAGS_enable_replayer_binary_log, each call is instead recorded as a fixed
+ * size header followed by raw copies of its arguments. sai_binary_log_converter
+ * turns the records back into the regular replayer C code offline, by feeding
+ * them to the same SaiTracer log functions that produce the text log.
+ *
+ * Each record is laid out as:
+ *   SaiBinaryTraceHeader
+ *   function name      (fnNameSize bytes)
+ *   entry key          (keySize bytes, e.g. sai_route_entry_t)
+ *   attributes         (attrCount * sizeof(sai_attribute_t))
+ *   list payloads      (the list of every attribute that points to one, in
+ *                       attribute order)
+ *   op specific data   (see SaiBinaryTraceOp)
+ *
+ * Records are in native byte order, so the log has to be converted on the
+ * same architecture and against the same SAI headers it was recorded with.
+ * AsyncLogger writes a text boot header ("// Start of a coldboot ...") each
+ * time it starts, which may be interleaved between records.
+ */
+enum class SaiBinaryTraceOp : uint8_t {
+  // data: preformatted replayer code (api initialize, api query etc.)
+  TEXT,
+  CREATE,
+  REMOVE,
+  SET_ATTR,
+  GET_ATTR,
+  // data: count object ids followed by count object statuses
+  BULK_SET_ATTR,
+  // data: count bytes of packet
+  SEND_HOSTIF_PACKET,
+  // data: count counter ids followed by count counter values
+  GET_STATS,
+  // data: count counter ids
+  CLEAR_STATS,
+  // data: count object keys
+  GET_OBJECT_KEY,
+};
+
+struct SaiBinaryTraceHeader {
+  static constexpr uint32_t kMagic = 0x42494153; // "SAIB"
+
+  uint32_t magic;
+  // Size of the whole record, including this header
+  uint32_t size;
+  // Orders records across threads
+  uint64_t seq;
+  uint64_t timestampUs;
+  uint64_t objectId;
+  uint64_t switchId;
+  int32_t objectType;
+  int32_t rv;
+  uint32_t attrCount;
+  uint32_t count;
+  int32_t mode;
+  uint16_t keySize;
+  uint8_t fnNameSize;
+  SaiBinaryTraceOp op;
+};
+static_assert(sizeof(SaiBinaryTraceHeader) == 64);
+
+enum class SaiAttrListType {
+  NONE,
+  OBJECT_ID,
+  U32,
+  S32,
+  S8,
+  QOS_MAP,
+  ACL_ACTION_OBJECT_ID,
+};
+
+/*
+ * Returns which list, if any, the value of an attribute points to. Only
+ * lists that SaiTracer knows how to format are reported.
+ */
+SaiAttrListType saiAttrListType(sai_object_type_t objectType, int32_t attrId);
+
+/*
+ * Calls fn with the sai_*_list_t of attr if the value of attr is a list.
+ * Returns false if it is not.
+ */
+template <typename AttrT, typename Fn>
+bool visitSaiAttrList(sai_object_type_t objectType, AttrT& attr, Fn&& fn) {
+  switch (saiAttrListType(objectType, attr.id)) {
+    case SaiAttrListType::OBJECT_ID:
+      fn(attr.value.objlist);
+      return true;
+    case SaiAttrListType::U32:
+      fn(attr.value.u32list);
+      return true;
+    case SaiAttrListType::S32:
+      fn(attr.value.s32list);
+      return true;
+    case SaiAttrListType::S8:
+      fn(attr.value.s8list);
+      return true;
+    case SaiAttrListType::QOS_MAP:
+      fn(attr.value.qosmap);
+      return true;
+    case SaiAttrListType::ACL_ACTION_OBJECT_ID:
+      fn(attr.value.aclaction.parameter.objlist);
+      return true;
+    case SaiAttrListType::NONE:
+      break;
+  }
+  return false;
+}
+
+/*
+ * Records binary trace records into per thread single producer rings, which
+ * a background thread drains into an AsyncLogger. Recording a call copies
+ * its arguments twice (into a reusable per thread scratch buffer and into
+ * the ring) and never allocates once the thread has recorded its largest
+ * record. A producer only blocks when its ring is full.
+ */
+class SaiBinaryTraceRecorder {
+ public:
+  SaiBinaryTraceRecorder(
+      AsyncLogger* logger,
+      uint32_t ringSize,
+      std::chrono::milliseconds drainInterval);
+  // Drains all records into the logger
+  ~SaiBinaryTraceRecorder();
+
+  void record(
+      SaiBinaryTraceOp op,
+      sai_object_type_t objectType,
+      folly::StringPiece fnName,
+      sai_object_id_t objectId,
+      sai_object_id_t switchId,
+      sai_status_t rv,
+      uint32_t attrCount,
+      const sai_attribute_t* attrList,
+      folly::ByteRange key = {},
+      std::initializer_list<folly::ByteRange> data = {},
+      uint32_t count = 0,
+      int32_t mode = 0);
+
+  void recordText(folly::StringPiece text);
+
+  // Moves everything recorded so far into the logger
+  void flush();
+
+  uint64_t droppedRecords() const {
+    return droppedRecords_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  class Ring;
+  struct Producer {
+    std::shared_ptr<Ring> ring;
+    std::vector<uint8_t> scratch;
+  };
+
+  Producer& producer();
+  void push(Producer& producer);
+  void drainLoop();
+  void drainAll();
+
+  AsyncLogger* logger_;
+  const uint32_t ringSize_;
+  const std::chrono::milliseconds drainInterval_;
+
+  std::atomic<uint64_t> nextSeq_{0};
+  std::atomic<uint64_t> droppedRecords_{0};
+
+  folly::ThreadLocal<Producer> producers_;
+  // Rings outlive their threads so that records made just before a thread
+  // exits are still drained
+  folly::Synchronized<std::vector<std::shared_ptr<Ring>>> rings_;
+  // Rings are single consumer
+  std::mutex drainLock_;
+
+  std::mutex drainThreadLock_;
+  std::condition_variable drainCv_;
+  std::atomic<bool> drainRequested_{false};
+  bool stop_{false};
+  std::thread drainThread_;
+};
+
+/*
+ * A record parsed from a binary log. Attribute lists point into lists, so
+ * records can be moved but not copied.
+ */
+struct SaiBinaryTraceRecord {
+  SaiBinaryTraceRecord() = default;
+  SaiBinaryTraceRecord(SaiBinaryTraceRecord&&) = default;
+  SaiBinaryTraceRecord& operator=(SaiBinaryTraceRecord&&) = default;
+  SaiBinaryTraceRecord(const SaiBinaryTraceRecord&) = delete;
+  SaiBinaryTraceRecord& operator=(const SaiBinaryTraceRecord&) = delete;
+
+  // count elements of T starting offsetBytes into data
+  template <typename T>
+  std::vector<T> dataAs(size_t offsetBytes, size_t count) const {
+    if (offsetBytes + count * sizeof(T) > data.size()) {
+      throw std::out_of_range("binary SAI replayer record data too short");
+    }
+    std::vector<T> out(count);
+    memcpy(out.data(), data.data() + offsetBytes, count * sizeof(T));
+    return out;
+  }
+
+  SaiBinaryTraceHeader header;
+  std::string fnName;
+  std::string key;
+  std::vector<sai_attribute_t> attrs;
+  std::vector<std::unique_ptr<uint8_t[]>> lists;
+  std::string data;
+};
+
+struct SaiBinaryTraceBoot {
+  // Text AsyncLogger wrote when the boot started
+  std::string header;
+  // Ordered by seq
+  std::vector<SaiBinaryTraceRecord> records;
+};
+
+/*
+ * Splits a binary log into boots and parses their records. A truncated
+ * final record (e.g. from a crash) is dropped with a warning, any other
+ * malformed input throws FbossError.
+ */
+std::vector<SaiBinaryTraceBoot> parseSaiBinaryTrace(folly::ByteRange log);
+
+// Writes the C code for record through tracer
+void replaySaiBinaryTraceRecord(
+    SaiTracer& tracer,
+    const SaiBinaryTraceRecord& record);
+
+} // namespace facebook::fboss
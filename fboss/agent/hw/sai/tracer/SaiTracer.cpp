@@ -35,6 +35,7 @@
 #include "fboss/agent/hw/sai/tracer/QueueApiTracer.h"
 #include "fboss/agent/hw/sai/tracer/RouteApiTracer.h"
 #include "fboss/agent/hw/sai/tracer/RouterInterfaceApiTracer.h"
+#include "fboss/agent/hw/sai/tracer/SaiBinaryTrace.h"
 #include "fboss/agent/hw/sai/tracer/SaiTracer.h"
 #include "fboss/agent/hw/sai/tracer/SamplePacketApiTracer.h"
 #include "fboss/agent/hw/sai/tracer/SchedulerApiTracer.h"
@@ -78,6 +79,25 @@ DEFINE_string(
     "/var/facebook/logs/fboss/sdk/sai_replayer.log",
     "File path to the SAI Replayer logs");
 
+DEFINE_bool(
+    enable_replayer_binary_log,
+    false,
+    "Record SAI Replayer logs in a compact binary format instead of C code. "
+    "This is cheap enough to leave on at runtime. Use "
+    "sai_binary_log_converter to turn the log into the regular C output. "
+    "Has no effect unless enable_replayer is set");
+
+DEFINE_string(
+    sai_binary_log,
+    "/var/facebook/logs/fboss/sdk/sai_replayer.bin",
+    "File path to the binary SAI Replayer logs");
+
+DEFINE_int32(
+    sai_binary_log_ring_size,
+    1 << 20,
+    "Size in bytes of the per thread buffer that binary SAI Replayer "
+    "records are staged in before being handed to the logger");
+
 DEFINE_string(
     sai_replayer_sdk_log_level,
     "CRITICAL",
@@ -378,41 +398,8 @@ sai_status_t __wrap_sai_get_object_key(
     return rv;
   }
 
-  vector<string> getObjectKeyLines = {
-      to<string>("expected_object_count=", *object_count),
-      to<string>(
-          "sai_get_object_count(switch_0, (_sai_object_type_t)",
-          object_type,
-          ", &object_count)"),
-      "object_list.resize(object_count)",
-      to<string>(
-          "sai_get_object_key(switch_0, (_sai_object_type_t)",
-          object_type,
-          ", &object_count, object_list.data())"),
-      to<string>(
-          "if (object_count < expected_object_count) { printf(\"[WARNING] current switch reloaded %u ",
-          facebook::fboss::saiObjectTypeToString(object_type),
-          " objects, expected %u\\n\", expected_object_count, object_count); }"),
-  };
-
-  vector<string> declarationLines;
-  declarationLines.reserve(*object_count);
-  for (int i = 0; i < *object_count; ++i) {
-    sai_object_key_t object = object_list[i];
-    string declaration = std::get<0>(SaiTracer::getInstance()->declareVariable(
-        &object.key.object_id, object_type));
-    declarationLines.push_back(to<string>(
-        declaration,
-        "=assignObject(object_list.data(), object_count, ",
-        i,
-        ", ",
-        object.key.object_id,
-        ")"));
-  }
-  vector<string> lines;
-  lines.insert(lines.end(), getObjectKeyLines.begin(), getObjectKeyLines.end());
-  lines.insert(lines.end(), declarationLines.begin(), declarationLines.end());
-  SaiTracer::getInstance()->writeToFile(lines);
+  SaiTracer::getInstance()->logGetObjectKeyFn(
+      object_type, *object_count, object_list);
   return rv;
 }
 
@@ -422,12 +409,49 @@ namespace {
 
 folly::Singleton<facebook::fboss::SaiTracer> _saiTracer;
 
+template <typename EntryT>
+folly::ByteRange entryKey(const EntryT* entry) {
+  return folly::ByteRange(
+      reinterpret_cast<const uint8_t*>(entry), sizeof(EntryT));
+}
+
 } // namespace
 
 namespace facebook::fboss {
 
+AttributeTypeMapRegistry::AttributeTypeMapRegistry(
+    SetAttributesFunction setAttributes,
+    const AttributeTypeMap* typeMap) {
+  maps()[setAttributes] = typeMap;
+}
+
+const AttributeTypeMap* AttributeTypeMapRegistry::get(
+    SetAttributesFunction setAttributes) {
+  auto itr = maps().find(setAttributes);
+  return itr == maps().end() ? nullptr : itr->second;
+}
+
+std::unordered_map<SetAttributesFunction, const AttributeTypeMap*>&
+AttributeTypeMapRegistry::maps() {
+  // Registrations happen during static initialization of the *ApiTracer.cpp
+  // files, so this can't be a namespace scope static
+  static std::unordered_map<SetAttributesFunction, const AttributeTypeMap*>
+      registry;
+  return registry;
+}
+
 SaiTracer::SaiTracer() {
-  if (FLAGS_enable_replayer) {
+  if (FLAGS_enable_replayer && FLAGS_enable_replayer_binary_log) {
+    // Header, globals and variable names are all produced when the binary
+    // log is converted
+    asyncLogger_ = std::make_unique<AsyncLogger>(
+        FLAGS_sai_binary_log, FLAGS_log_timeout, AsyncLogger::SAI_REPLAYER);
+    asyncLogger_->startFlushThread();
+    binaryRecorder_ = std::make_unique<SaiBinaryTraceRecorder>(
+        asyncLogger_.get(),
+        FLAGS_sai_binary_log_ring_size,
+        std::chrono::milliseconds(FLAGS_log_timeout));
+  } else if (FLAGS_enable_replayer) {
     asyncLogger_ = std::make_unique<AsyncLogger>(
         FLAGS_sai_log, FLAGS_log_timeout, AsyncLogger::SAI_REPLAYER);
 
@@ -440,7 +464,12 @@ SaiTracer::SaiTracer() {
 }
 
 SaiTracer::~SaiTracer() {
-  if (FLAGS_enable_replayer) {
+  if (binaryRecorder_) {
+    // Drains everything recorded so far into the logger
+    binaryRecorder_.reset();
+    asyncLogger_->forceFlush();
+    asyncLogger_->stopFlushThread();
+  } else if (FLAGS_enable_replayer) {
     writeFooter();
     asyncLogger_->forceFlush();
     asyncLogger_->stopFlushThread();
@@ -464,7 +493,15 @@ void SaiTracer::writeToFile(const vector<string>& strVec) {
   auto constexpr lineEnd = ";\n";
   auto lines = folly::join(lineEnd, strVec) + lineEnd + "\n";
 
-  asyncLogger_->appendLog(lines.c_str(), lines.size());
+  appendToFile(lines);
+}
+
+void SaiTracer::appendToFile(folly::StringPiece text) {
+  if (binaryRecorder_) {
+    binaryRecorder_->recordText(text);
+    return;
+  }
+  asyncLogger_->appendLog(text.data(), text.size());
 }
 
 void SaiTracer::logApiInitialize(
@@ -536,6 +573,19 @@ void SaiTracer::logSwitchCreateFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::CREATE,
+        SAI_OBJECT_TYPE_SWITCH,
+        "create_switch",
+        *switch_id,
+        SAI_NULL_OBJECT_ID,
+        rv,
+        attr_count,
+        attr_list);
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_SWITCH);
@@ -578,6 +628,20 @@ void SaiTracer::logRouteEntryCreateFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::CREATE,
+        SAI_OBJECT_TYPE_ROUTE_ENTRY,
+        "create_route_entry",
+        SAI_NULL_OBJECT_ID,
+        route_entry->switch_id,
+        rv,
+        attr_count,
+        attr_list,
+        entryKey(route_entry));
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_ROUTE_ENTRY);
@@ -614,6 +678,20 @@ void SaiTracer::logNeighborEntryCreateFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::CREATE,
+        SAI_OBJECT_TYPE_NEIGHBOR_ENTRY,
+        "create_neighbor_entry",
+        SAI_NULL_OBJECT_ID,
+        neighbor_entry->switch_id,
+        rv,
+        attr_count,
+        attr_list,
+        entryKey(neighbor_entry));
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_NEIGHBOR_ENTRY);
@@ -650,6 +728,20 @@ void SaiTracer::logFdbEntryCreateFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::CREATE,
+        SAI_OBJECT_TYPE_FDB_ENTRY,
+        "create_fdb_entry",
+        SAI_NULL_OBJECT_ID,
+        fdb_entry->switch_id,
+        rv,
+        attr_count,
+        attr_list,
+        entryKey(fdb_entry));
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_FDB_ENTRY);
@@ -686,6 +778,20 @@ void SaiTracer::logInsegEntryCreateFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::CREATE,
+        SAI_OBJECT_TYPE_INSEG_ENTRY,
+        "create_inseg_entry",
+        SAI_NULL_OBJECT_ID,
+        inseg_entry->switch_id,
+        rv,
+        attr_count,
+        attr_list,
+        entryKey(inseg_entry));
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_INSEG_ENTRY);
@@ -725,6 +831,19 @@ void SaiTracer::logCreateFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::CREATE,
+        object_type,
+        fn_name,
+        *create_object_id,
+        switch_id,
+        rv,
+        attr_count,
+        attr_list);
+    return;
+  }
+
   // First fill in attribute list
   vector<string> lines = setAttrList(attr_list, attr_count, object_type);
 
@@ -754,6 +873,20 @@ void SaiTracer::logRouteEntryRemoveFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::REMOVE,
+        SAI_OBJECT_TYPE_ROUTE_ENTRY,
+        "remove_route_entry",
+        SAI_NULL_OBJECT_ID,
+        route_entry->switch_id,
+        rv,
+        0,
+        nullptr,
+        entryKey(route_entry));
+    return;
+  }
+
   vector<string> lines{};
   setRouteEntry(route_entry, lines);
 
@@ -781,6 +914,20 @@ void SaiTracer::logNeighborEntryRemoveFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::REMOVE,
+        SAI_OBJECT_TYPE_NEIGHBOR_ENTRY,
+        "remove_neighbor_entry",
+        SAI_NULL_OBJECT_ID,
+        neighbor_entry->switch_id,
+        rv,
+        0,
+        nullptr,
+        entryKey(neighbor_entry));
+    return;
+  }
+
   vector<string> lines{};
   setNeighborEntry(neighbor_entry, lines);
 
@@ -808,6 +955,20 @@ void SaiTracer::logFdbEntryRemoveFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::REMOVE,
+        SAI_OBJECT_TYPE_FDB_ENTRY,
+        "remove_fdb_entry",
+        SAI_NULL_OBJECT_ID,
+        fdb_entry->switch_id,
+        rv,
+        0,
+        nullptr,
+        entryKey(fdb_entry));
+    return;
+  }
+
   vector<string> lines{};
   setFdbEntry(fdb_entry, lines);
 
@@ -835,6 +996,20 @@ void SaiTracer::logInsegEntryRemoveFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::REMOVE,
+        SAI_OBJECT_TYPE_INSEG_ENTRY,
+        "remove_inseg_entry",
+        SAI_NULL_OBJECT_ID,
+        inseg_entry->switch_id,
+        rv,
+        0,
+        nullptr,
+        entryKey(inseg_entry));
+    return;
+  }
+
   vector<string> lines{};
   setInsegEntry(inseg_entry, lines);
 
@@ -864,6 +1039,19 @@ void SaiTracer::logRemoveFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::REMOVE,
+        object_type,
+        fn_name,
+        remove_object_id,
+        SAI_NULL_OBJECT_ID,
+        rv,
+        0,
+        nullptr);
+    return;
+  }
+
   vector<string> lines{};
 
   // Log current timestamp, object id and return value
@@ -896,6 +1084,20 @@ void SaiTracer::logRouteEntrySetAttrFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::SET_ATTR,
+        SAI_OBJECT_TYPE_ROUTE_ENTRY,
+        "set_route_entry_attribute",
+        SAI_NULL_OBJECT_ID,
+        route_entry->switch_id,
+        rv,
+        1,
+        attr,
+        entryKey(route_entry));
+    return;
+  }
+
   // Setup one attribute
   vector<string> lines = setAttrList(attr, 1, SAI_OBJECT_TYPE_ROUTE_ENTRY);
 
@@ -927,6 +1129,20 @@ void SaiTracer::logNeighborEntrySetAttrFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::SET_ATTR,
+        SAI_OBJECT_TYPE_NEIGHBOR_ENTRY,
+        "set_neighbor_entry_attribute",
+        SAI_NULL_OBJECT_ID,
+        neighbor_entry->switch_id,
+        rv,
+        1,
+        attr,
+        entryKey(neighbor_entry));
+    return;
+  }
+
   // Setup one attribute
   vector<string> lines = setAttrList(attr, 1, SAI_OBJECT_TYPE_NEIGHBOR_ENTRY);
 
@@ -958,6 +1174,20 @@ void SaiTracer::logFdbEntrySetAttrFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::SET_ATTR,
+        SAI_OBJECT_TYPE_FDB_ENTRY,
+        "set_fdb_entry_attribute",
+        SAI_NULL_OBJECT_ID,
+        fdb_entry->switch_id,
+        rv,
+        1,
+        attr,
+        entryKey(fdb_entry));
+    return;
+  }
+
   // Setup one attribute
   vector<string> lines = setAttrList(attr, 1, SAI_OBJECT_TYPE_FDB_ENTRY);
 
@@ -989,6 +1219,20 @@ void SaiTracer::logInsegEntrySetAttrFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::SET_ATTR,
+        SAI_OBJECT_TYPE_INSEG_ENTRY,
+        "set_inseg_entry_attribute",
+        SAI_NULL_OBJECT_ID,
+        inseg_entry->switch_id,
+        rv,
+        1,
+        attr,
+        entryKey(inseg_entry));
+    return;
+  }
+
   // Setup one attribute
   vector<string> lines = setAttrList(attr, 1, SAI_OBJECT_TYPE_INSEG_ENTRY);
 
@@ -1023,6 +1267,19 @@ void SaiTracer::logGetAttrFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::GET_ATTR,
+        object_type,
+        fn_name,
+        get_object_id,
+        SAI_NULL_OBJECT_ID,
+        rv,
+        attr_count,
+        attr);
+    return;
+  }
+
   vector<string> lines = setAttrList(attr, attr_count, object_type);
   lines.push_back(
       to<string>("memset(get_attribute,0,ATTR_SIZE*", maxAttrCount_, ")"));
@@ -1058,6 +1315,19 @@ void SaiTracer::logSetAttrFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::SET_ATTR,
+        object_type,
+        fn_name,
+        set_object_id,
+        SAI_NULL_OBJECT_ID,
+        rv,
+        1,
+        attr);
+    return;
+  }
+
   // Setup one attribute
   vector<string> lines = setAttrList(attr, 1, object_type);
 
@@ -1093,6 +1363,28 @@ void SaiTracer::logBulkSetAttrFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::BULK_SET_ATTR,
+        object_type,
+        fn_name,
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        rv,
+        object_count,
+        attr_list,
+        {},
+        {folly::ByteRange(
+             reinterpret_cast<const uint8_t*>(object_id),
+             sizeof(sai_object_id_t) * object_count),
+         folly::ByteRange(
+             reinterpret_cast<const uint8_t*>(object_statuses),
+             sizeof(sai_status_t) * object_count)},
+        object_count,
+        mode);
+    return;
+  }
+
   // Setup attributes
   vector<string> lines = setAttrList(attr_list, object_count, object_type);
 
@@ -1141,6 +1433,22 @@ void SaiTracer::logSendHostifPacketFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::SEND_HOSTIF_PACKET,
+        SAI_OBJECT_TYPE_HOSTIF_PACKET,
+        "send_hostif_packet",
+        hostif_id,
+        SAI_NULL_OBJECT_ID,
+        rv,
+        attr_count,
+        attr_list,
+        {},
+        {folly::ByteRange(buffer, buffer_size)},
+        buffer_size);
+    return;
+  }
+
   vector<string> lines =
       setAttrList(attr_list, attr_count, SAI_OBJECT_TYPE_HOSTIF_PACKET);
 
@@ -1196,6 +1504,28 @@ void SaiTracer::logGetStatsFn(
   if (!FLAGS_enable_replayer || !FLAGS_enable_get_attr_log) {
     return;
   }
+
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::GET_STATS,
+        object_type,
+        fn_name,
+        object_id,
+        SAI_NULL_OBJECT_ID,
+        rv,
+        0,
+        nullptr,
+        {},
+        {folly::ByteRange(
+             reinterpret_cast<const uint8_t*>(counter_ids),
+             sizeof(sai_stat_id_t) * number_of_counters),
+         folly::ByteRange(
+             reinterpret_cast<const uint8_t*>(counters),
+             sizeof(uint64_t) * number_of_counters)},
+        number_of_counters,
+        mode);
+    return;
+  }
   vector<string> lines = {
       to<string>("memset(counter_list,0,4*", maxAttrCount_, ")"),
       to<string>("memset(counter_vals,0,8*", maxAttrCount_, ")")};
@@ -1238,6 +1568,24 @@ void SaiTracer::logClearStatsFn(
     return;
   }
 
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::CLEAR_STATS,
+        object_type,
+        fn_name,
+        object_id,
+        SAI_NULL_OBJECT_ID,
+        rv,
+        0,
+        nullptr,
+        {},
+        {folly::ByteRange(
+             reinterpret_cast<const uint8_t*>(counter_ids),
+             sizeof(sai_stat_id_t) * number_of_counters)},
+        number_of_counters);
+    return;
+  }
+
   vector<string> lines = {
       to<string>("memset(counter_list,0,4*", maxAttrCount_, ")")};
   for (int i = 0; i < number_of_counters; ++i) {
@@ -1265,6 +1613,69 @@ void SaiTracer::logClearStatsFn(
   writeToFile(lines);
 }
 
+void SaiTracer::logGetObjectKeyFn(
+    sai_object_type_t object_type,
+    uint32_t object_count,
+    const sai_object_key_t* object_list) {
+  if (!FLAGS_enable_replayer) {
+    return;
+  }
+
+  if (binaryRecorder_) {
+    binaryRecorder_->record(
+        SaiBinaryTraceOp::GET_OBJECT_KEY,
+        object_type,
+        "",
+        SAI_NULL_OBJECT_ID,
+        SAI_NULL_OBJECT_ID,
+        SAI_STATUS_SUCCESS,
+        0,
+        nullptr,
+        {},
+        {folly::ByteRange(
+            reinterpret_cast<const uint8_t*>(object_list),
+            sizeof(sai_object_key_t) * object_count)},
+        object_count);
+    return;
+  }
+
+  vector<string> getObjectKeyLines = {
+      to<string>("expected_object_count=", object_count),
+      to<string>(
+          "sai_get_object_count(switch_0, (_sai_object_type_t)",
+          object_type,
+          ", &object_count)"),
+      "object_list.resize(object_count)",
+      to<string>(
+          "sai_get_object_key(switch_0, (_sai_object_type_t)",
+          object_type,
+          ", &object_count, object_list.data())"),
+      to<string>(
+          "if (object_count < expected_object_count) { printf(\"[WARNING] current switch reloaded %u ",
+          saiObjectTypeToString(object_type),
+          " objects, expected %u\\n\", expected_object_count, object_count); }"),
+  };
+
+  vector<string> declarationLines;
+  declarationLines.reserve(object_count);
+  for (int i = 0; i < object_count; ++i) {
+    sai_object_key_t object = object_list[i];
+    string declaration = std::get<0>(declareVariable(
+        &object.key.object_id, object_type));
+    declarationLines.push_back(to<string>(
+        declaration,
+        "=assignObject(object_list.data(), object_count, ",
+        i,
+        ", ",
+        object.key.object_id,
+        ")"));
+  }
+  vector<string> lines;
+  lines.insert(lines.end(), getObjectKeyLines.begin(), getObjectKeyLines.end());
+  lines.insert(lines.end(), declarationLines.begin(), declarationLines.end());
+  writeToFile(lines);
+}
+
 std::tuple<string, string> SaiTracer::declareVariable(
     sai_object_id_t* object_id,
     sai_object_type_t object_type) {
@@ -1324,164 +1735,122 @@ vector<string> SaiTracer::setAttrList(
 
   // Call functions defined in *ApiTracer.h to serialize attributes
   // that are specific to each Sai object type
+  if (auto setAttributes = setAttributesFn(object_type)) {
+    setAttributes(attr_list, attr_count, attrLines);
+  }
+
+  return attrLines;
+}
+
+SetAttributesFunction SaiTracer::setAttributesFn(
+    sai_object_type_t object_type) {
   switch (object_type) {
     case SAI_OBJECT_TYPE_ACL_COUNTER:
-      setAclCounterAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setAclCounterAttributes;
     case SAI_OBJECT_TYPE_ACL_ENTRY:
-      setAclEntryAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setAclEntryAttributes;
     case SAI_OBJECT_TYPE_ACL_TABLE:
-      setAclTableAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setAclTableAttributes;
     case SAI_OBJECT_TYPE_ACL_TABLE_GROUP:
-      setAclTableGroupAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setAclTableGroupAttributes;
     case SAI_OBJECT_TYPE_ACL_TABLE_GROUP_MEMBER:
-      setAclTableGroupMemberAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setAclTableGroupMemberAttributes;
     case SAI_OBJECT_TYPE_BRIDGE:
-      setBridgeAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setBridgeAttributes;
     case SAI_OBJECT_TYPE_BRIDGE_PORT:
-      setBridgePortAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setBridgePortAttributes;
     case SAI_OBJECT_TYPE_BUFFER_POOL:
-      setBufferPoolAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setBufferPoolAttributes;
     case SAI_OBJECT_TYPE_BUFFER_PROFILE:
-      setBufferProfileAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setBufferProfileAttributes;
     case SAI_OBJECT_TYPE_COUNTER:
-      setCounterAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setCounterAttributes;
     case SAI_OBJECT_TYPE_DEBUG_COUNTER:
-      setDebugCounterAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setDebugCounterAttributes;
     case SAI_OBJECT_TYPE_FDB_ENTRY:
-      setFdbEntryAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setFdbEntryAttributes;
     case SAI_OBJECT_TYPE_HASH:
-      setHashAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setHashAttributes;
     case SAI_OBJECT_TYPE_HOSTIF_PACKET:
-      setHostifPacketAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setHostifPacketAttributes;
     case SAI_OBJECT_TYPE_HOSTIF_TRAP:
-      setHostifTrapAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setHostifTrapAttributes;
     case SAI_OBJECT_TYPE_HOSTIF_TRAP_GROUP:
-      setHostifTrapGroupAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setHostifTrapGroupAttributes;
     case SAI_OBJECT_TYPE_INSEG_ENTRY:
-      setInsegEntryAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setInsegEntryAttributes;
     case SAI_OBJECT_TYPE_INGRESS_PRIORITY_GROUP:
-      setIngressPriorityGroupAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setIngressPriorityGroupAttributes;
     case SAI_OBJECT_TYPE_LAG:
-      setLagAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setLagAttributes;
     case SAI_OBJECT_TYPE_LAG_MEMBER:
-      setLagMemberAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setLagMemberAttributes;
     case SAI_OBJECT_TYPE_MACSEC:
-      setMacsecAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setMacsecAttributes;
     case SAI_OBJECT_TYPE_MACSEC_PORT:
-      setMacsecPortAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setMacsecPortAttributes;
     case SAI_OBJECT_TYPE_MACSEC_FLOW:
-      setMacsecFlowAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setMacsecFlowAttributes;
     case SAI_OBJECT_TYPE_MACSEC_SA:
-      setMacsecSAAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setMacsecSAAttributes;
     case SAI_OBJECT_TYPE_MACSEC_SC:
-      setMacsecSCAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setMacsecSCAttributes;
     case SAI_OBJECT_TYPE_MIRROR_SESSION:
-      setMirrorSessionAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setMirrorSessionAttributes;
     case SAI_OBJECT_TYPE_NEIGHBOR_ENTRY:
-      setNeighborEntryAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setNeighborEntryAttributes;
     case SAI_OBJECT_TYPE_NEXT_HOP:
-      setNextHopAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setNextHopAttributes;
     case SAI_OBJECT_TYPE_NEXT_HOP_GROUP:
-      setNextHopGroupAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setNextHopGroupAttributes;
     case SAI_OBJECT_TYPE_NEXT_HOP_GROUP_MEMBER:
-      setNextHopGroupMemberAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setNextHopGroupMemberAttributes;
     case SAI_OBJECT_TYPE_PORT:
-      setPortAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setPortAttributes;
     case SAI_OBJECT_TYPE_PORT_SERDES:
-      setPortSerdesAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setPortSerdesAttributes;
     case SAI_OBJECT_TYPE_PORT_CONNECTOR:
-      setPortConnectorAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setPortConnectorAttributes;
     case SAI_OBJECT_TYPE_QOS_MAP:
-      setQosMapAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setQosMapAttributes;
     case SAI_OBJECT_TYPE_QUEUE:
-      setQueueAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setQueueAttributes;
     case SAI_OBJECT_TYPE_ROUTE_ENTRY:
-      setRouteEntryAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setRouteEntryAttributes;
     case SAI_OBJECT_TYPE_ROUTER_INTERFACE:
-      setRouterInterfaceAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setRouterInterfaceAttributes;
     case SAI_OBJECT_TYPE_SAMPLEPACKET:
-      setSamplePacketAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setSamplePacketAttributes;
     case SAI_OBJECT_TYPE_SCHEDULER:
-      setSchedulerAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setSchedulerAttributes;
     case SAI_OBJECT_TYPE_SWITCH:
-      setSwitchAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setSwitchAttributes;
     case SAI_OBJECT_TYPE_TAM:
-      setTamAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setTamAttributes;
     case SAI_OBJECT_TYPE_TAM_EVENT:
-      setTamEventAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setTamEventAttributes;
     case SAI_OBJECT_TYPE_TAM_EVENT_ACTION:
-      setTamEventActionAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setTamEventActionAttributes;
     case SAI_OBJECT_TYPE_TAM_REPORT:
-      setTamReportAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setTamReportAttributes;
     case SAI_OBJECT_TYPE_TUNNEL:
-      setTunnelAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setTunnelAttributes;
     case SAI_OBJECT_TYPE_TUNNEL_TERM_TABLE_ENTRY:
-      setTunnelTermAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setTunnelTermAttributes;
     case SAI_OBJECT_TYPE_VIRTUAL_ROUTER:
-      setVirtualRouterAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setVirtualRouterAttributes;
     case SAI_OBJECT_TYPE_VLAN:
-      setVlanAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setVlanAttributes;
     case SAI_OBJECT_TYPE_VLAN_MEMBER:
-      setVlanMemberAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setVlanMemberAttributes;
     case SAI_OBJECT_TYPE_WRED:
-      setWredAttributes(attr_list, attr_count, attrLines);
-      break;
+      return &setWredAttributes;
     default:
       // TODO: For other APIs, create new API wrappers and invoke
       // setAttributes() function here
       break;
   }
-
-  return attrLines;
+  return nullptr;
 }
 
 string SaiTracer::createFnCall(
@@ -1608,7 +1977,7 @@ string SaiTracer::rvCheck(sai_status_t rv) {
 }
 
 string SaiTracer::logTimeAndRv(sai_status_t rv, sai_object_id_t object_id) {
-  auto now = std::chrono::system_clock::now();
+  auto now = logTime_ ? *logTime_ : std::chrono::system_clock::now();
   auto now_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
                     now.time_since_epoch()) %
       1000;
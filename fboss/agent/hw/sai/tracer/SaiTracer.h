@@ -9,10 +9,13 @@
  */
 #pragma once
 
+#include <chrono>
 #include <map>
 #include <memory>
+#include <optional>
 #include <tuple>
 #include <typeindex>
+#include <unordered_map>
 
 #include "fboss/agent/AsyncLogger.h"
 #include "fboss/agent/hw/sai/api/SaiVersion.h"
@@ -31,6 +34,9 @@ extern "C" {
 
 DECLARE_bool(enable_replayer);
 DECLARE_bool(enable_packet_log);
+DECLARE_bool(enable_get_attr_log);
+DECLARE_bool(enable_replayer_binary_log);
+DECLARE_string(sai_log);
 
 using PrimitiveFunction = std::string (*)(const sai_attribute_t*, int);
 using AttributeFunction =
@@ -38,10 +44,36 @@ using AttributeFunction =
 using ListFunction =
     void (*)(const sai_attribute_t*, int, uint32_t, std::vector<std::string>&);
 
+using SetAttributesFunction =
+    void (*)(const sai_attribute_t*, uint32_t, std::vector<std::string>&);
+using AttributeTypeMap =
+    std::map<int32_t, std::pair<std::string, std::size_t>>;
+
 #define TYPE_INDEX(type) std::type_index(typeid(type)).hash_code()
 
 namespace facebook::fboss {
 
+class SaiBinaryTraceRecorder;
+
+/*
+ * Each *ApiTracer.cpp registers its attribute name/type map against its
+ * set<Type>Attributes function (see SET_SAI_REGULAR_ATTRIBUTES). This lets
+ * the binary recorder find out which attributes point to lists without
+ * formatting them.
+ */
+class AttributeTypeMapRegistry {
+ public:
+  AttributeTypeMapRegistry(
+      SetAttributesFunction setAttributes,
+      const AttributeTypeMap* typeMap);
+
+  static const AttributeTypeMap* get(SetAttributesFunction setAttributes);
+
+ private:
+  static std::unordered_map<SetAttributesFunction, const AttributeTypeMap*>&
+  maps();
+};
+
 class SaiTracer {
  public:
   explicit SaiTracer();
@@ -190,12 +222,29 @@ class SaiTracer {
       sai_object_type_t object_type,
       sai_status_t rv);
 
+  void logGetObjectKeyFn(
+      sai_object_type_t object_type,
+      uint32_t object_count,
+      const sai_object_key_t* object_list);
+
   std::string getVariable(sai_object_id_t object_id);
 
+  // Returns the set<Type>Attributes function for object_type, or nullptr if
+  // attributes of this type are not logged
+  static SetAttributesFunction setAttributesFn(sai_object_type_t object_type);
+
+  // Used when converting a binary log, so that the generated code carries
+  // the time of the original call rather than the time of conversion
+  void setLogTime(
+      std::optional<std::chrono::system_clock::time_point> logTime) {
+    logTime_ = logTime;
+  }
+
   uint32_t
   checkListCount(uint32_t list_count, uint32_t elem_size, uint32_t elem_count);
 
   void writeToFile(const std::vector<std::string>& strVec);
+  void appendToFile(folly::StringPiece text);
 
   sai_acl_api_t* aclApi_;
   sai_bridge_api_t* bridgeApi_;
@@ -317,6 +366,10 @@ class SaiTracer {
   uint32_t maxListCount_;
   uint32_t numCalls_;
   std::unique_ptr<AsyncLogger> asyncLogger_;
+  // Set when FLAGS_enable_replayer_binary_log is on, in which case calls are
+  // recorded in binary and converted to C code offline
+  std::unique_ptr<SaiBinaryTraceRecorder> binaryRecorder_;
+  std::optional<std::chrono::system_clock::time_point> logTime_;
 
   // Variables mappings in generated C code
   // varCounts map from object type to the current counter
@@ -677,6 +730,8 @@ class SaiTracer {
   }
 
 #define SET_SAI_REGULAR_ATTRIBUTES(obj_type)                                 \
+  static const AttributeTypeMapRegistry _##obj_type##TypeMapRegistration(    \
+      &set##obj_type##Attributes, &_##obj_type##Map);                        \
   void set##obj_type##Attributes(                                            \
       const sai_attribute_t* attr_list,                                      \
       uint32_t attr_count,                                                   \
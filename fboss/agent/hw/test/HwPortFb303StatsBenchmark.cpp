@@ -0,0 +1,131 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/hw/HwFb303Stats.h"
+#include "fboss/agent/hw/HwPortFb303Stats.h"
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include <memory>
+#include <vector>
+
+DEFINE_int32(num_ports, 512, "Number of ports to update stats for");
+DEFINE_int32(num_queues, 8, "Number of queues per port");
+
+using namespace facebook::fboss;
+
+/*
+ * Compares a stats cycle through HwPortFb303Stats, which updates counters
+ * through handles, against updating the same counters by name.
+ */
+namespace {
+
+std::string portName(int port) {
+  return folly::to<std::string>("eth1/", port + 1, "/1");
+}
+
+HwPortFb303Stats::QueueId2Name queueNames() {
+  HwPortFb303Stats::QueueId2Name queueId2Name;
+  for (int queue = 0; queue < FLAGS_num_queues; ++queue) {
+    queueId2Name.emplace(queue, folly::to<std::string>("queue", queue));
+  }
+  return queueId2Name;
+}
+
+HwPortStats makePortStats(int64_t value) {
+  HwPortStats stats;
+  for (int queue = 0; queue < FLAGS_num_queues; ++queue) {
+    (*stats.queueOutDiscardBytes_())[queue] = value;
+    (*stats.queueOutDiscardPackets_())[queue] = value;
+    (*stats.queueOutBytes_())[queue] = value;
+    (*stats.queueOutPackets_())[queue] = value;
+    (*stats.queueWredDroppedPackets_())[queue] = value;
+  }
+  *stats.inBytes_() = value;
+  *stats.outBytes_() = value;
+  return stats;
+}
+
+} // namespace
+
+BENCHMARK(UpdateStatsByName, numIters) {
+  HwFb303Stats counters;
+  auto queueId2Name = queueNames();
+  // HwPortFb303Stats keeps a copy of the last stats of each port too
+  std::vector<HwPortStats> lastPortStats(FLAGS_num_ports);
+  HwPortStats portStats;
+  BENCHMARK_SUSPEND {
+    for (int port = 0; port < FLAGS_num_ports; ++port) {
+      for (auto statKey : HwPortFb303Stats::kPortStatKeys()) {
+        counters.reinitStat(
+            HwPortFb303Stats::statName(statKey, portName(port)),
+            std::nullopt);
+      }
+      for (const auto& [queueId, queueName] : queueId2Name) {
+        for (auto statKey : HwPortFb303Stats::kQueueStatKeys()) {
+          counters.reinitStat(
+              HwPortFb303Stats::statName(
+                  statKey, portName(port), queueId, queueName),
+              std::nullopt);
+        }
+      }
+    }
+  }
+  for (size_t n = 0; n < numIters; ++n) {
+    BENCHMARK_SUSPEND {
+      portStats = makePortStats(n);
+    }
+    std::chrono::seconds now(n);
+    for (int port = 0; port < FLAGS_num_ports; ++port) {
+      auto name = portName(port);
+      for (auto statKey : HwPortFb303Stats::kPortStatKeys()) {
+        counters.updateStat(now, HwPortFb303Stats::statName(statKey, name), n);
+      }
+      for (const auto& [queueId, queueName] : queueId2Name) {
+        for (auto statKey : HwPortFb303Stats::kQueueStatKeys()) {
+          counters.updateStat(
+              now,
+              HwPortFb303Stats::statName(statKey, name, queueId, queueName),
+              n);
+        }
+      }
+      lastPortStats[port] = portStats;
+    }
+  }
+}
+
+BENCHMARK_RELATIVE(UpdateStatsByHandle, numIters) {
+  std::vector<std::unique_ptr<HwPortFb303Stats>> ports;
+  HwPortStats portStats;
+  BENCHMARK_SUSPEND {
+    for (int port = 0; port < FLAGS_num_ports; ++port) {
+      ports.push_back(
+          std::make_unique<HwPortFb303Stats>(portName(port), queueNames()));
+    }
+  }
+  for (size_t n = 0; n < numIters; ++n) {
+    BENCHMARK_SUSPEND {
+      portStats = makePortStats(n);
+    }
+    std::chrono::seconds now(n);
+    for (auto& port : ports) {
+      port->updateStats(portStats, now);
+    }
+  }
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
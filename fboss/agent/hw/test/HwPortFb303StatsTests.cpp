@@ -416,3 +416,24 @@ TEST(HwPortFb303Stats, queueNameChangeResetsValue) {
     }
   }
 }
+
+TEST(HwPortFb303Stats, updateStatsAfterRename) {
+  HwPortFb303Stats portStats(kPortName, kQueue2Name);
+  auto kNewPortName = "fab1/1/1";
+  portStats.portNameChanged(kNewPortName);
+  portStats.queueChanged(1, "platinum");
+  updateStats(portStats);
+  // +1 because first initialization is to -1
+  EXPECT_EQ(
+      portStats.getCounterLastIncrement(
+          HwPortFb303Stats::statName(kInBytes(), kNewPortName)),
+      2);
+  EXPECT_EQ(
+      portStats.getCounterLastIncrement(
+          HwPortFb303Stats::statName(kOutBytes(), kNewPortName, 1, "platinum")),
+      3);
+  EXPECT_EQ(
+      portStats.getCounterLastIncrement(
+          HwPortFb303Stats::statName(kOutBytes(), kNewPortName, 2, "silver")),
+      3);
+}
@@ -424,8 +424,22 @@ struct RxCaptureFilter {
 # can put additional Rx filters here if need be
 }
 
+/*
+ * Header fields packets must match to be captured, in both directions.
+ * A packet matches if, for each non empty list, one of the list values
+ * matches. VLAN tags are skipped, IPv6 extension headers are not.
+ */
+struct PacketCaptureFilter {
+  1: list<i32> etherTypes;
+  // IPv4 protocol or IPv6 next header
+  2: list<i32> ipProtocols;
+  // TCP or UDP source or destination port
+  3: list<i32> l4Ports;
+}
+
 struct CaptureFilter {
   1: RxCaptureFilter rxCaptureFilter;
+  2: PacketCaptureFilter packetFilter;
 }
 
 struct CaptureInfo {
@@ -632,6 +646,20 @@ struct TeFlowDetails {
   6: optional ctrl.TeCounterID counterID;
 }
 
+/*
+ * Latency of a profiling span, recorded while --enable_profiling_spans is set
+ */
+struct ProfilingSpanStats {
+  // Names of the enclosing spans and this span, separated by '/'
+  1: string name;
+  2: i64 count;
+  3: i64 totalNsecs;
+  4: i64 p50Nsecs;
+  5: i64 p90Nsecs;
+  6: i64 p99Nsecs;
+  7: i64 maxNsecs;
+}
+
 service FbossCtrl extends phy.FbossCommonPhyCtrl {
   /*
    * Retrieve up-to-date counters from the hardware, and publish all
@@ -1247,6 +1275,22 @@ service FbossCtrl extends phy.FbossCommonPhyCtrl {
   list<TeFlowDetails> getTeFlowTableDetails() throws (
     1: fboss.FbossBaseError error,
   );
+
+  /*
+   * Latency percentiles of the profiling spans on agent hot paths. Spans are
+   * only recorded while --enable_profiling_spans is set.
+   */
+  list<ProfilingSpanStats> getProfilingSpanStats();
+
+  /*
+   * Write the most recent profiling spans of each thread to a file on the
+   * switch in Chrome trace event format, for chrome://tracing or Perfetto.
+   * fileName must be a bare file name, the file is created in the directory
+   * set by --profiling_span_dump_dir.
+   */
+  void dumpProfilingSpans(1: string fileName) throws (
+    1: fboss.FbossBaseError error,
+  );
 }
 
 service NeighborListenerClient extends fb303.FacebookService {
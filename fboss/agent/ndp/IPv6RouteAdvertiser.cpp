@@ -15,6 +15,7 @@
 #include <netinet/icmp6.h>
 #include "fboss/agent/FbossError.h"
 #include "fboss/agent/InterfaceStats.h"
+#include "fboss/agent/PeriodicTxScheduler.h"
 #include "fboss/agent/SwSwitch.h"
 #include "fboss/agent/TxPacket.h"
 #include "fboss/agent/packet/ICMPHdr.h"
@@ -71,10 +72,11 @@ namespace facebook::fboss {
 /*
  * IPv6RAImpl is the class that actually handles sending out the RA packets.
  *
- * This uses AsyncTimeout to receive timeout notifications in the SwSwitch's
- * background event thread, and send out RA packets every time the timer fires.
+ * The RA packet is built once, and sent every interval by the SwSwitch's
+ * PeriodicTxScheduler.  start() and stop() run in the SwSwitch's background
+ * thread, so the final RA sent by stop() always follows start().
  */
-class IPv6RAImpl : private folly::AsyncTimeout {
+class IPv6RAImpl {
  public:
   IPv6RAImpl(SwSwitch* sw, const SwitchState* state, const Interface* intf);
 
@@ -90,25 +92,20 @@ class IPv6RAImpl : private folly::AsyncTimeout {
   IPv6RAImpl(IPv6RAImpl const&) = delete;
   IPv6RAImpl& operator=(IPv6RAImpl const&) = delete;
 
-  void timeoutExpired() noexcept override {
-    sendRouteAdvertisement();
-    scheduleTimeout(interval_);
-  }
-
   void initPacket(const Interface* intf);
-  void sendRouteAdvertisement();
 
   std::chrono::milliseconds interval_;
-  folly::IOBuf buf_;
+  std::unique_ptr<folly::IOBuf> buf_;
   SwSwitch* sw_{nullptr};
   InterfaceID intfID_;
+  std::optional<PeriodicTxScheduler::FrameID> frameID_;
 };
 
 IPv6RAImpl::IPv6RAImpl(
     SwSwitch* sw,
     const SwitchState* /*state*/,
     const Interface* intf)
-    : AsyncTimeout(sw->getBackgroundEvb()), sw_(sw), intfID_(intf->getID()) {
+    : sw_(sw), intfID_(intf->getID()) {
   std::chrono::seconds raInterval(
       *intf->getNdpConfig().routerAdvertisementSeconds());
   interval_ = raInterval;
@@ -116,50 +113,41 @@ IPv6RAImpl::IPv6RAImpl(
 }
 
 void IPv6RAImpl::start(IPv6RAImpl* ra) {
-  ra->scheduleTimeout(ra->interval_);
+  XLOG(DBG5) << "starting route advertisements:\n"
+             << PktUtil::hexDump(Cursor(ra->buf_.get()));
+  auto sw = ra->sw_;
+  auto intfID = ra->intfID_;
+  ra->frameID_ = sw->getPeriodicTxScheduler()->addFrame(
+      std::move(ra->buf_),
+      ra->interval_,
+      ra->interval_,
+      std::nullopt,
+      [sw, intfID] { sw->interfaceStats(intfID)->sentRouterAdvertisement(); });
 }
 
 void IPv6RAImpl::stop(IPv6RAImpl* ra) {
-  /*
-   * Just before going down we send one last route
-   * advertisement to avoid RA's timing out while
-   * controller is restarted
-   */
-  ra->sendRouteAdvertisement();
+  if (ra->frameID_) {
+    auto scheduler = ra->sw_->getPeriodicTxScheduler();
+    /*
+     * Just before going down we send one last route
+     * advertisement to avoid RA's timing out while
+     * controller is restarted
+     */
+    scheduler->sendNow(*ra->frameID_);
+    scheduler->removeFrame(*ra->frameID_);
+  }
   delete ra;
 }
 
 void IPv6RAImpl::initPacket(const Interface* intf) {
   auto totalLength = IPv6RouteAdvertiser::getPacketSize(intf);
-  buf_ = IOBuf(IOBuf::CREATE, totalLength);
-  buf_.append(totalLength);
-  RWPrivateCursor cursor(&buf_);
+  buf_ = IOBuf::create(totalLength);
+  buf_->append(totalLength);
+  RWPrivateCursor cursor(buf_.get());
   IPv6RouteAdvertiser::createAdvertisementPacket(
       intf, &cursor, MacAddress("33:33:00:00:00:01"), IPAddressV6("ff02::1"));
 }
 
-void IPv6RAImpl::sendRouteAdvertisement() {
-  XLOG(DBG5) << "sending route advertisement:\n"
-             << PktUtil::hexDump(Cursor(&buf_));
-
-  // Allocate a new packet, and copy our data into it.
-  //
-  // Note that we unfortunately do need to perform a buffer copy here.
-  // The TxPacket is required to use DMA memory for its buffer, so we can't do
-  // a simple clone.
-  //
-  // TODO: In the future it would be nice to support allocating buf_ in a DMA
-  // buffer so that we really can just clone a reference to it here, rather
-  // than doing a copy.
-  uint32_t pktLen = buf_.length();
-  auto pkt = sw_->allocatePacket(pktLen);
-  RWPrivateCursor cursor(pkt->buf());
-  cursor.push(buf_.data(), buf_.length());
-
-  sw_->sendNetworkControlPacketAsync(std::move(pkt), std::nullopt);
-  sw_->interfaceStats(intfID_)->sentRouterAdvertisement();
-}
-
 IPv6RouteAdvertiser::IPv6RouteAdvertiser(
     SwSwitch* sw,
     const SwitchState* state,
@@ -21,7 +21,18 @@ namespace fboss {
 MultiPimPlatformMapping::MultiPimPlatformMapping(
     const std::string& jsonPlatformMappingStr)
     : PlatformMapping(jsonPlatformMappingStr) {
-  for (auto& port : platformPorts_) {
+  splitPims();
+}
+
+MultiPimPlatformMapping::MultiPimPlatformMapping(
+    folly::StringPiece precompiledName,
+    folly::StringPiece jsonPlatformMappingStr)
+    : PlatformMapping(precompiledName, jsonPlatformMappingStr) {
+  splitPims();
+}
+
+void MultiPimPlatformMapping::splitPims() {
+  for (auto& port : getPlatformPorts()) {
     int portPimID = getPimID(port.second);
 
     if (pims_.find(portPimID) == pims_.end()) {
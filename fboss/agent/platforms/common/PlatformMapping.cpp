@@ -16,10 +16,17 @@
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 
 #include "fboss/agent/FbossError.h"
+#include "fboss/agent/platforms/common/PrecompiledPlatformMappings.h"
 
 namespace {
 constexpr auto kFbossPortNameRegex = "eth(\\d+)/(\\d+)/(\\d+)";
 const re2::RE2 portNameRegex(kFbossPortNameRegex);
+
+facebook::fboss::cfg::PlatformPortEntry decodePlatformPort(
+    folly::ByteRange encoded) {
+  return apache::thrift::CompactSerializer::deserialize<
+      facebook::fboss::cfg::PlatformPortEntry>(encoded);
+}
 } // namespace
 
 namespace facebook {
@@ -152,20 +159,111 @@ PlatformMapping::PlatformMapping(const cfg::PlatformMapping& mapping) {
   init(mapping);
 }
 
-void PlatformMapping::init(const cfg::PlatformMapping& mapping) {
+PlatformMapping::PlatformMapping(
+    folly::StringPiece precompiledName,
+    folly::StringPiece jsonPlatformMappingStr) {
+  if (auto precompiled = findPrecompiledPlatformMapping(precompiledName)) {
+    init(*precompiled);
+  } else {
+    init(apache::thrift::SimpleJSONSerializer::deserialize<
+         cfg::PlatformMapping>(jsonPlatformMappingStr));
+  }
+}
+
+void PlatformMapping::init(const PrecompiledPlatformMapping& precompiled) {
+  init(apache::thrift::CompactSerializer::deserialize<cfg::PlatformMapping>(
+      folly::ByteRange(precompiled.data, precompiled.size)));
+  // Port names are stored next to the encoded ports, so the name index does
+  // not need them decoded
+  portNameToID_.reserve(precompiled.numPorts);
+  for (size_t i = 0; i < precompiled.numPorts; ++i) {
+    const auto& port = precompiled.ports[i];
+    encodedPorts_.emplace(port.id, folly::ByteRange(port.data, port.size));
+    portNameToID_.emplace(port.name, port.id);
+  }
+  hasEncodedPorts_.store(!encodedPorts_.empty(), std::memory_order_release);
+}
+
+const std::map<int32_t, cfg::PlatformPortEntry>&
+PlatformMapping::getPlatformPorts() const {
+  decodePlatformPorts();
+  return platformPorts_;
+}
+
+const cfg::PlatformPortEntry* FOLLY_NULLABLE
+PlatformMapping::findPlatformPort(int32_t portID) const {
+  std::unique_lock<std::mutex> guard;
+  if (hasEncodedPorts_.load(std::memory_order_acquire)) {
+    guard = std::unique_lock<std::mutex>(encodedPortsMutex_);
+    if (auto encoded = encodedPorts_.find(portID);
+        encoded != encodedPorts_.end()) {
+      platformPorts_.emplace(portID, decodePlatformPort(encoded->second));
+      encodedPorts_.erase(encoded);
+      if (encodedPorts_.empty()) {
+        hasEncodedPorts_.store(false, std::memory_order_release);
+      }
+    }
+  }
+  auto itPlatformPort = platformPorts_.find(portID);
+  return itPlatformPort == platformPorts_.end() ? nullptr
+                                                : &itPlatformPort->second;
+}
+
+void PlatformMapping::decodePlatformPorts() const {
+  if (!hasEncodedPorts_.load(std::memory_order_acquire)) {
+    return;
+  }
+  std::lock_guard<std::mutex> guard(encodedPortsMutex_);
+  for (const auto& [portID, encoded] : encodedPorts_) {
+    platformPorts_.emplace(portID, decodePlatformPort(encoded));
+  }
+  encodedPorts_.clear();
+  hasEncodedPorts_.store(false, std::memory_order_release);
+}
+
+void PlatformMapping::init(cfg::PlatformMapping mapping) {
   platformPorts_ = std::move(*mapping.ports());
   platformSupportedProfiles_ = std::move(*mapping.platformSupportedProfiles());
-  for (auto chip : *mapping.chips()) {
-    chips_[*chip.name()] = chip;
+  for (auto& chip : *mapping.chips()) {
+    auto name = *chip.name();
+    chips_[name] = std::move(chip);
   }
   if (auto portConfigOverrides = mapping.portConfigOverrides()) {
     portConfigOverrides_ = std::move(*portConfigOverrides);
   }
+
+  portNameToID_.reserve(platformPorts_.size());
+  for (const auto& port : platformPorts_) {
+    indexPort(port.second);
+  }
+  for (size_t i = 0; i < platformSupportedProfiles_.size(); ++i) {
+    indexSupportedProfile(i);
+  }
+}
+
+void PlatformMapping::indexPort(const cfg::PlatformPortEntry& port) {
+  portNameToID_.emplace(*port.mapping()->name(), *port.mapping()->id());
+}
+
+void PlatformMapping::indexSupportedProfile(size_t index) {
+  supportedProfileIndices_
+      [*platformSupportedProfiles_[index].factor()->profileID()]
+          .push_back(index);
+}
+
+void PlatformMapping::setPlatformPort(
+    int32_t portID,
+    cfg::PlatformPortEntry port) {
+  decodePlatformPorts();
+  auto inserted = platformPorts_.emplace(portID, std::move(port));
+  if (inserted.second) {
+    indexPort(inserted.first->second);
+  }
 }
 
 cfg::PlatformMapping PlatformMapping::toThrift() const {
   cfg::PlatformMapping newMapping;
-  newMapping.ports() = this->platformPorts_;
+  newMapping.ports() = getPlatformPorts();
   newMapping.platformSupportedProfiles() = this->platformSupportedProfiles_;
   for (auto nameChipPair : this->chips_) {
     newMapping.chips()->push_back(nameChipPair.second);
@@ -175,17 +273,19 @@ cfg::PlatformMapping PlatformMapping::toThrift() const {
 }
 
 void PlatformMapping::merge(PlatformMapping* mapping) {
-  for (auto port : mapping->platformPorts_) {
-    platformPorts_.emplace(port.first, std::move(port.second));
-    mergePortConfigOverrides(
-        port.first, mapping->getPortConfigOverrides(port.first));
+  for (auto port : mapping->getPlatformPorts()) {
+    auto portConfigOverrides = mapping->getPortConfigOverrides(port.first);
+    setPlatformPort(port.first, std::move(port.second));
+    mergePortConfigOverrides(port.first, std::move(portConfigOverrides));
   }
   mapping->platformPorts_.clear();
+  mapping->portNameToID_.clear();
 
   for (auto incomingProfile : mapping->platformSupportedProfiles_) {
     mergePlatformSupportedProfile(incomingProfile);
   }
   mapping->platformSupportedProfiles_.clear();
+  mapping->supportedProfileIndices_.clear();
 
   for (auto chip : mapping->chips_) {
     chips_.emplace(chip.first, std::move(chip.second));
@@ -195,7 +295,14 @@ void PlatformMapping::merge(PlatformMapping* mapping) {
 
 void PlatformMapping::mergePlatformSupportedProfile(
     cfg::PlatformPortProfileConfigEntry incomingProfile) {
-  for (auto& currentProfile : platformSupportedProfiles_) {
+  // Only entries with the same profileID can be merged with
+  static const std::vector<size_t> kNoIndices;
+  auto indices =
+      supportedProfileIndices_.find(*incomingProfile.factor()->profileID());
+  const auto& sameProfileIndices =
+      indices == supportedProfileIndices_.end() ? kNoIndices : indices->second;
+  for (auto index : sameProfileIndices) {
+    auto& currentProfile = platformSupportedProfiles_[index];
     auto currentFactor = currentProfile.factor();
     auto incomingFactor = incomingProfile.factor();
     // Merge factors if profileID and profile config are the same
@@ -233,23 +340,23 @@ void PlatformMapping::mergePlatformSupportedProfile(
     }
   }
   // Was not able to merge entry so create new one
-  platformSupportedProfiles_.push_back(incomingProfile);
+  platformSupportedProfiles_.push_back(std::move(incomingProfile));
+  indexSupportedProfile(platformSupportedProfiles_.size() - 1);
 }
 
 int PlatformMapping::getPimID(PortID portID) const {
-  auto itPlatformPort = platformPorts_.find(portID);
-  if (itPlatformPort == platformPorts_.end()) {
+  auto platformPort = findPlatformPort(portID);
+  if (!platformPort) {
     throw FbossError("Unrecoganized port:", portID);
   }
-  return getPimID(itPlatformPort->second);
+  return getPimID(*platformPort);
 }
 
 int PlatformMapping::getPimID(
     const cfg::PlatformPortEntry& platformPort) const {
   int pimID = 0;
   auto& portName = platformPort.get_mapping().get_name();
-  re2::RE2 portNameRe(kFbossPortNameRegex);
-  if (!re2::RE2::FullMatch(portName, portNameRe, &pimID)) {
+  if (!re2::RE2::FullMatch(portName, portNameRegex, &pimID)) {
     throw FbossError(
         "Invalid port name: ",
         portName,
@@ -261,23 +368,22 @@ int PlatformMapping::getPimID(
 
 const phy::DataPlanePhyChip& PlatformMapping::getPortIphyChip(
     PortID portID) const {
-  auto itPlatformPort = platformPorts_.find(portID);
-  if (itPlatformPort == platformPorts_.end()) {
+  auto platformPort = findPlatformPort(portID);
+  if (!platformPort) {
     throw FbossError("Unrecoganized port:", portID);
   }
-  const auto& coreName =
-      itPlatformPort->second.mapping()->pins()[0].a()->get_chip();
+  const auto& coreName = platformPort->mapping()->pins()[0].a()->get_chip();
   return chips_.at(coreName);
 }
 
 cfg::PortSpeed PlatformMapping::getPortMaxSpeed(PortID portID) const {
-  auto itPlatformPort = platformPorts_.find(portID);
-  if (itPlatformPort == platformPorts_.end()) {
+  auto platformPort = findPlatformPort(portID);
+  if (!platformPort) {
     throw FbossError("Unrecoganized port:", portID);
   }
 
   cfg::PortSpeed maxSpeed{cfg::PortSpeed::DEFAULT};
-  for (auto profile : *itPlatformPort->second.supportedProfiles()) {
+  for (auto profile : *platformPort->supportedProfiles()) {
     if (auto profileConfig = getPortProfileConfig(
             PlatformPortProfileConfigMatcher(profile.first, portID))) {
       if (static_cast<int>(maxSpeed) <
@@ -478,10 +584,15 @@ PlatformMapping::getPortProfileConfig(
       return *portConfigOverride.portProfileConfig();
     }
   }
-  for (auto& supportedProfile : platformSupportedProfiles_) {
-    if (profileMatcher.matchProfileWithFactor(
-            this, supportedProfile.get_factor())) {
-      return supportedProfile.get_profile();
+  if (auto indices =
+          supportedProfileIndices_.find(profileMatcher.getProfileID());
+      indices != supportedProfileIndices_.end()) {
+    for (auto index : indices->second) {
+      const auto& supportedProfile = platformSupportedProfiles_[index];
+      if (profileMatcher.matchProfileWithFactor(
+              this, supportedProfile.get_factor())) {
+        return supportedProfile.get_profile();
+      }
     }
   }
   XLOGF(
@@ -555,10 +666,9 @@ void PlatformMapping::mergePortConfigOverrides(
 }
 
 const PortID PlatformMapping::getPortID(const std::string& portName) const {
-  for (const auto& platPortEntry : platformPorts_) {
-    if (*platPortEntry.second.mapping()->name() == portName) {
-      return PortID(*platPortEntry.second.mapping()->id());
-    }
+  if (auto itPort = portNameToID_.find(portName);
+      itPort != portNameToID_.end()) {
+    return PortID(itPort->second);
   }
   throw FbossError("No PlatformPortEntry found for portName: ", portName);
 }
@@ -566,12 +676,12 @@ const PortID PlatformMapping::getPortID(const std::string& portName) const {
 const cfg::PlatformPortConfig& PlatformMapping::getPlatformPortConfig(
     PortID id,
     cfg::PortProfileID profileID) const {
-  auto itPlatformPort = platformPorts_.find(id);
-  if (itPlatformPort == platformPorts_.end()) {
+  auto platformPort = findPlatformPort(id);
+  if (!platformPort) {
     throw FbossError("No PlatformPortEntry found for port ", id);
   }
 
-  auto& supportedProfiles = *itPlatformPort->second.supportedProfiles();
+  auto& supportedProfiles = *platformPort->supportedProfiles();
   auto platformPortConfig = supportedProfiles.find(profileID);
   if (platformPortConfig == supportedProfiles.end()) {
     throw FbossError(
@@ -14,6 +14,13 @@
 #include "fboss/lib/phy/gen-cpp2/phy_types.h"
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
 
+#include <folly/CPortability.h>
+#include <folly/Range.h>
+#include <folly/container/F14Map.h>
+
+#include <atomic>
+#include <mutex>
+
 namespace facebook {
 namespace fboss {
 
@@ -67,18 +74,27 @@ class PlatformPortProfileConfigMatcher {
       portConfigOverrideFactor_;
 };
 
+struct PrecompiledPlatformMapping;
+
 class PlatformMapping {
  public:
   PlatformMapping() {}
   explicit PlatformMapping(const std::string& jsonPlatformMappingStr);
   explicit PlatformMapping(const cfg::PlatformMapping& mapping);
+  /*
+   * Use the mapping precompiled from the source named precompiledName, see
+   * PrecompiledPlatformMappings.h. jsonPlatformMappingStr is only parsed if
+   * it was not precompiled.
+   */
+  PlatformMapping(
+      folly::StringPiece precompiledName,
+      folly::StringPiece jsonPlatformMappingStr);
   virtual ~PlatformMapping() = default;
 
   cfg::PlatformMapping toThrift() const;
 
-  const std::map<int32_t, cfg::PlatformPortEntry>& getPlatformPorts() const {
-    return platformPorts_;
-  }
+  // Decodes all precompiled ports, prefer looking up single ports
+  const std::map<int32_t, cfg::PlatformPortEntry>& getPlatformPorts() const;
 
   const std::optional<phy::PortProfileConfig> getPortProfileConfig(
       PlatformPortProfileConfigMatcher matcher) const;
@@ -106,9 +122,7 @@ class PlatformMapping {
 
   const phy::DataPlanePhyChip& getPortIphyChip(PortID port) const;
 
-  void setPlatformPort(int32_t portID, cfg::PlatformPortEntry port) {
-    platformPorts_.emplace(portID, port);
-  }
+  void setPlatformPort(int32_t portID, cfg::PlatformPortEntry port);
 
   void setChip(const std::string& chipName, phy::DataPlanePhyChip chip) {
     chips_.emplace(chipName, chip);
@@ -143,7 +157,11 @@ class PlatformMapping {
       const {}
 
  protected:
-  std::map<int32_t, cfg::PlatformPortEntry> platformPorts_;
+  // Ports and supported profiles are indexed below, add them through
+  // setPlatformPort(), mergePlatformSupportedProfile() or merge(). Ports of
+  // a precompiled mapping are decoded on demand, read them through
+  // findPlatformPort() or getPlatformPorts().
+  mutable std::map<int32_t, cfg::PlatformPortEntry> platformPorts_;
   std::vector<cfg::PlatformPortProfileConfigEntry> platformSupportedProfiles_;
   std::map<std::string, phy::DataPlanePhyChip> chips_;
   std::vector<cfg::PlatformPortConfigOverride> portConfigOverrides_;
@@ -152,8 +170,29 @@ class PlatformMapping {
       PortID id,
       cfg::PortProfileID profileID) const;
 
+  const cfg::PlatformPortEntry* FOLLY_NULLABLE
+  findPlatformPort(int32_t portID) const;
+
  private:
-  void init(const cfg::PlatformMapping& mapping);
+  void init(cfg::PlatformMapping mapping);
+  void init(const PrecompiledPlatformMapping& precompiled);
+  void decodePlatformPorts() const;
+  void indexPort(const cfg::PlatformPortEntry& port);
+  void indexSupportedProfile(size_t index);
+
+  // port name -> port id
+  folly::F14FastMap<std::string, int32_t> portNameToID_;
+  // profile id -> indices of its entries in platformSupportedProfiles_, in
+  // order
+  folly::F14FastMap<cfg::PortProfileID, std::vector<size_t>>
+      supportedProfileIndices_;
+
+  // Precompiled ports which were not decoded into platformPorts_ yet
+  mutable std::map<int32_t, folly::ByteRange> encodedPorts_;
+  mutable std::mutex encodedPortsMutex_;
+  // Once false, platformPorts_ is complete and can be read without the lock
+  mutable std::atomic<bool> hasEncodedPorts_{false};
+
   // Forbidden copy constructor and assignment operator
   PlatformMapping(PlatformMapping const&) = delete;
   PlatformMapping& operator=(PlatformMapping const&) = delete;
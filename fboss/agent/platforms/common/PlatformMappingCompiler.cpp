@@ -0,0 +1,171 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/gen-cpp2/platform_config_types.h"
+#include "fboss/agent/platforms/common/PrecompiledPlatformMappings.h"
+
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/Format.h>
+#include <folly/String.h>
+#include <folly/init/Init.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include <cstring>
+#include <stdexcept>
+
+DEFINE_string(
+    output,
+    "PrecompiledPlatformMappings-gen.cpp",
+    "Source file to write the precompiled platform mappings to");
+
+using namespace facebook::fboss;
+
+namespace {
+constexpr auto kJsonBegin = "kJsonPlatformMappingStr = R\"(";
+constexpr auto kJsonEnd = ")\";";
+
+std::string extractJson(
+    const std::string& sourceFile,
+    const std::string& source) {
+  auto begin = source.find(kJsonBegin);
+  if (begin == std::string::npos) {
+    throw std::runtime_error(
+        folly::to<std::string>("No kJsonPlatformMappingStr in ", sourceFile));
+  }
+  begin += strlen(kJsonBegin);
+  auto end = source.find(kJsonEnd, begin);
+  if (end == std::string::npos) {
+    throw std::runtime_error(folly::to<std::string>(
+        "Unterminated kJsonPlatformMappingStr in ", sourceFile));
+  }
+  return source.substr(begin, end - begin);
+}
+
+// Mappings are looked up by the name of their source, without extension
+std::string mappingName(const std::string& sourceFile) {
+  auto begin = sourceFile.find_last_of('/');
+  begin = begin == std::string::npos ? 0 : begin + 1;
+  auto end = sourceFile.rfind('.');
+  if (end == std::string::npos || end < begin) {
+    end = sourceFile.size();
+  }
+  return sourceFile.substr(begin, end - begin);
+}
+
+void appendBytes(std::string& out, const std::string& bytes) {
+  constexpr size_t kBytesPerLine = 16;
+  for (size_t i = 0; i < bytes.size(); ++i) {
+    out += i % kBytesPerLine == 0 ? "\n    " : " ";
+    out += folly::sformat("0x{:02x},", static_cast<uint8_t>(bytes[i]));
+  }
+  out += "\n";
+}
+} // namespace
+
+/*
+ * Compiles the JSON platform mappings embedded in the given platform mapping
+ * sources into compact protocol blobs. See PrecompiledPlatformMappings.h.
+ *
+ * Usage: platform_mapping_compiler --output <file> <mapping source>...
+ */
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+
+  std::string mappings;
+  std::string entries;
+  for (int i = 1; i < argc; ++i) {
+    std::string source;
+    if (!folly::readFile(argv[i], source)) {
+      XLOG(ERR) << "Failed to read " << argv[i];
+      return 1;
+    }
+    auto json = extractJson(argv[i], source);
+    auto mapping = apache::thrift::SimpleJSONSerializer::deserialize<
+        cfg::PlatformMapping>(json);
+
+    // Ports are serialized separately, so they can be decoded one by one
+    auto ports = std::move(*mapping.ports());
+    mapping.ports()->clear();
+    auto compact =
+        apache::thrift::CompactSerializer::serialize<std::string>(mapping);
+    std::string portBytes;
+    std::string portEntries;
+    auto name = folly::to<std::string>("kPlatformMapping", i);
+    for (const auto& [portID, port] : ports) {
+      auto portCompact =
+          apache::thrift::CompactSerializer::serialize<std::string>(port);
+      portEntries += folly::sformat(
+          "    {{{}, \"{}\", {}Ports + {}, {}}},\n",
+          portID,
+          folly::cEscape<std::string>(*port.mapping()->name()),
+          name,
+          portBytes.size(),
+          portCompact.size());
+      portBytes += portCompact;
+    }
+
+    mappings += folly::sformat(
+        "// {}\nalignas(8) constexpr uint8_t {}[] = {{", argv[i], name);
+    appendBytes(mappings, compact);
+    mappings += "};\n\n";
+    std::string portEntriesName = "nullptr";
+    if (!ports.empty()) {
+      portEntriesName = name + "PortEntries";
+      mappings += folly::sformat(
+          "alignas(8) constexpr uint8_t {}Ports[] = {{", name);
+      appendBytes(mappings, portBytes);
+      mappings += "};\n\n";
+      mappings += folly::sformat(
+          "constexpr PrecompiledPlatformPort {}[] = {{\n{}}};\n\n",
+          portEntriesName,
+          portEntries);
+    }
+    entries += folly::sformat(
+        "    {{\"{}\", {}, sizeof({}), {}, {}}},\n",
+        folly::cEscape<std::string>(mappingName(argv[i])),
+        name,
+        name,
+        portEntriesName,
+        ports.size());
+    XLOG(INFO) << "Compiled " << argv[i] << ": " << json.size()
+               << " bytes of JSON to " << compact.size() + portBytes.size()
+               << " bytes";
+  }
+
+  std::string out =
+      "// @"
+      "generated by platform_mapping_compiler, do not edit\n\n"
+      "#include \"fboss/agent/platforms/common/PrecompiledPlatformMappings.h\"\n\n"
+      "namespace facebook::fboss {\n\n";
+  if (entries.empty()) {
+    out +=
+        "folly::Range<const PrecompiledPlatformMapping*> "
+        "precompiledPlatformMappings() {\n  return {};\n}\n\n";
+  } else {
+    out += "namespace {\n\n" + mappings +
+        "constexpr PrecompiledPlatformMapping kPlatformMappings[] = {\n" +
+        entries +
+        "};\n\n"
+        "} // namespace\n\n"
+        "folly::Range<const PrecompiledPlatformMapping*> "
+        "precompiledPlatformMappings() {\n"
+        "  return folly::range(kPlatformMappings);\n}\n\n";
+  }
+  out += "} // namespace facebook::fboss\n";
+
+  if (!folly::writeFile(out, FLAGS_output.c_str())) {
+    XLOG(ERR) << "Failed to write " << FLAGS_output;
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,25 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/platforms/common/PrecompiledPlatformMappings.h"
+
+namespace facebook::fboss {
+
+const PrecompiledPlatformMapping* FOLLY_NULLABLE
+findPrecompiledPlatformMapping(folly::StringPiece name) {
+  for (const auto& mapping : precompiledPlatformMappings()) {
+    if (name == mapping.name) {
+      return &mapping;
+    }
+  }
+  return nullptr;
+}
+
+} // namespace facebook::fboss
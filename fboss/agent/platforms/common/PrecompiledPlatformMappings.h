@@ -0,0 +1,56 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/CPortability.h>
+#include <folly/Range.h>
+
+#include <cstdint>
+
+namespace facebook::fboss {
+
+/*
+ * Parsing the JSON platform mappings embedded in the platform mapping
+ * sources takes a noticeable part of agent and qsfp_service startup on the
+ * larger platforms. platform_mapping_compiler turns each of them into
+ * compact protocol thrift at build time, which is much cheaper to
+ * deserialize.
+ *
+ * A precompiled mapping is keyed by the name of the source it was compiled
+ * from, e.g. "Wedge100PlatformMapping". Its ports are serialized one by one,
+ * so PlatformMapping only decodes a port entry once it is asked for.
+ * Mappings whose JSON is changed at runtime (e.g. galaxy cards) are not
+ * precompiled and parsed as JSON.
+ */
+struct PrecompiledPlatformPort {
+  int32_t id;
+  const char* name;
+  // cfg::PlatformPortEntry serialized with the compact protocol
+  const uint8_t* data;
+  size_t size;
+};
+
+struct PrecompiledPlatformMapping {
+  const char* name;
+  // cfg::PlatformMapping without its ports, serialized with the compact
+  // protocol
+  const uint8_t* data;
+  size_t size;
+  const PrecompiledPlatformPort* ports;
+  size_t numPorts;
+};
+
+// Defined by the source platform_mapping_compiler generates
+folly::Range<const PrecompiledPlatformMapping*> precompiledPlatformMappings();
+
+const PrecompiledPlatformMapping* FOLLY_NULLABLE
+findPrecompiledPlatformMapping(folly::StringPiece name);
+
+} // namespace facebook::fboss
@@ -28612,6 +28612,6 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook {
 namespace fboss {
 CloudRipperPlatformMapping::CloudRipperPlatformMapping()
-    : PlatformMapping(kJsonPlatformMappingStr) {}
+    : PlatformMapping("CloudRipperPlatformMapping", kJsonPlatformMappingStr) {}
 } // namespace fboss
 } // namespace facebook
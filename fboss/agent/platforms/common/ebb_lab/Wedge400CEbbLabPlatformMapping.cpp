@@ -16199,6 +16199,7 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook::fboss {
 
 Wedge400CEbbLabPlatformMapping::Wedge400CEbbLabPlatformMapping()
-    : PlatformMapping(kJsonPlatformMappingStr) {}
+    : PlatformMapping(
+          "Wedge400CEbbLabPlatformMapping", kJsonPlatformMappingStr) {}
 
 } // namespace facebook::fboss
@@ -47152,5 +47152,6 @@ constexpr auto kJsonPlatformMappingStr = R"(
 
 namespace facebook::fboss {
 Elbert16QPimPlatformMapping::Elbert16QPimPlatformMapping()
-    : MultiPimPlatformMapping(kJsonPlatformMappingStr) {}
+    : MultiPimPlatformMapping(
+          "Elbert16QPimPlatformMapping", kJsonPlatformMappingStr) {}
 } // namespace facebook::fboss
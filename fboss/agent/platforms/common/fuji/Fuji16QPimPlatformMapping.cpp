@@ -97649,6 +97649,7 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook {
 namespace fboss {
 Fuji16QPimPlatformMapping::Fuji16QPimPlatformMapping()
-    : MultiPimPlatformMapping(kJsonPlatformMappingStr) {}
+    : MultiPimPlatformMapping(
+          "Fuji16QPimPlatformMapping", kJsonPlatformMappingStr) {}
 } // namespace fboss
 } // namespace facebook
@@ -29161,6 +29161,6 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook {
 namespace fboss {
 LassenPlatformMapping::LassenPlatformMapping()
-    : PlatformMapping(kJsonPlatformMappingStr) {}
+    : PlatformMapping("LassenPlatformMapping", kJsonPlatformMappingStr) {}
 } // namespace fboss
 } // namespace facebook
@@ -39183,6 +39183,6 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook {
 namespace fboss {
 SandiaPlatformMapping::SandiaPlatformMapping()
-    : PlatformMapping(kJsonPlatformMappingStr) {}
+    : PlatformMapping("SandiaPlatformMapping", kJsonPlatformMappingStr) {}
 } // namespace fboss
 } // namespace facebook
@@ -41043,7 +41043,7 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook {
 namespace fboss {
 Wedge100PlatformMapping::Wedge100PlatformMapping()
-    : PlatformMapping(kJsonPlatformMappingStr) {}
+    : PlatformMapping("Wedge100PlatformMapping", kJsonPlatformMappingStr) {}
 
 void Wedge100PlatformMapping::customizePlatformPortConfigOverrideFactor(
     std::optional<cfg::PlatformPortConfigOverrideFactor>& factor) const {
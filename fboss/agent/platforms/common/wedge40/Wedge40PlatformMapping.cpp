@@ -8506,6 +8506,6 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook {
 namespace fboss {
 Wedge40PlatformMapping::Wedge40PlatformMapping()
-    : PlatformMapping(kJsonPlatformMappingStr) {}
+    : PlatformMapping("Wedge40PlatformMapping", kJsonPlatformMappingStr) {}
 } // namespace fboss
 } // namespace facebook
@@ -12630,7 +12630,8 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook {
 namespace fboss {
 Wedge400AcadiaPlatformMapping::Wedge400AcadiaPlatformMapping()
-    : PlatformMapping(kJsonPlatformMappingStr) {}
+    : PlatformMapping(
+          "Wedge400AcadiaPlatformMapping", kJsonPlatformMappingStr) {}
 
 } // namespace fboss
 } // namespace facebook
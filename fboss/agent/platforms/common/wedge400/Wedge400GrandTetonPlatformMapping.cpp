@@ -11518,7 +11518,8 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook {
 namespace fboss {
 Wedge400GrandTetonPlatformMapping::Wedge400GrandTetonPlatformMapping()
-    : PlatformMapping(kJsonPlatformMappingStr) {}
+    : PlatformMapping(
+          "Wedge400GrandTetonPlatformMapping", kJsonPlatformMappingStr) {}
 
 } // namespace fboss
 } // namespace facebook
@@ -41034,7 +41034,7 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook {
 namespace fboss {
 Wedge400PlatformMapping::Wedge400PlatformMapping()
-    : PlatformMapping(kJsonPlatformMappingStr) {}
+    : PlatformMapping("Wedge400PlatformMapping", kJsonPlatformMappingStr) {}
 
 } // namespace fboss
 } // namespace facebook
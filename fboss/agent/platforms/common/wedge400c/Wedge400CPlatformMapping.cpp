@@ -46361,6 +46361,6 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook {
 namespace fboss {
 Wedge400CPlatformMapping::Wedge400CPlatformMapping()
-    : PlatformMapping(kJsonPlatformMappingStr) {}
+    : PlatformMapping("Wedge400CPlatformMapping", kJsonPlatformMappingStr) {}
 } // namespace fboss
 } // namespace facebook
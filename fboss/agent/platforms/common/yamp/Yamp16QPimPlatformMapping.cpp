@@ -115284,6 +115284,7 @@ constexpr auto kJsonPlatformMappingStr = R"(
 namespace facebook {
 namespace fboss {
 Yamp16QPimPlatformMapping::Yamp16QPimPlatformMapping()
-    : MultiPimPlatformMapping(kJsonPlatformMappingStr) {}
+    : MultiPimPlatformMapping(
+          "Yamp16QPimPlatformMapping", kJsonPlatformMappingStr) {}
 } // namespace fboss
 } // namespace facebook
@@ -0,0 +1,89 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/platforms/common/cloud_ripper/CloudRipperPlatformMapping.h"
+#include "fboss/agent/platforms/common/elbert/Elbert16QPimPlatformMapping.h"
+#include "fboss/agent/platforms/common/fuji/Fuji16QPimPlatformMapping.h"
+#include "fboss/agent/platforms/common/galaxy/GalaxyFCPlatformMapping.h"
+#include "fboss/agent/platforms/common/galaxy/GalaxyLCPlatformMapping.h"
+#include "fboss/agent/platforms/common/kamet/KametPlatformMapping.h"
+#include "fboss/agent/platforms/common/lassen/LassenPlatformMapping.h"
+#include "fboss/agent/platforms/common/sandia/SandiaPlatformMapping.h"
+#include "fboss/agent/platforms/common/wedge100/Wedge100PlatformMapping.h"
+#include "fboss/agent/platforms/common/wedge40/Wedge40PlatformMapping.h"
+#include "fboss/agent/platforms/common/wedge400/Wedge400PlatformMapping.h"
+#include "fboss/agent/platforms/common/wedge400c/Wedge400CPlatformMapping.h"
+#include "fboss/agent/platforms/common/yamp/Yamp16QPimPlatformMapping.h"
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+using namespace facebook::fboss;
+
+/*
+ * Measures how long constructing each platform mapping takes at startup.
+ * The *Json variants parse the same mapping from JSON into a plain
+ * PlatformMapping, i.e. without the precompiled mapping and, for the multi
+ * pim platforms, without splitting it into pims.
+ */
+namespace {
+
+template <typename MappingT, typename... Args>
+void constructMapping(size_t iters, Args... args) {
+  for (size_t i = 0; i < iters; ++i) {
+    auto mapping = std::make_unique<MappingT>(args...);
+    folly::doNotOptimizeAway(mapping);
+  }
+}
+
+template <typename MappingT, typename... Args>
+void parseMappingJson(size_t iters, Args... args) {
+  std::string json;
+  BENCHMARK_SUSPEND {
+    json = apache::thrift::SimpleJSONSerializer::serialize<std::string>(
+        MappingT(args...).toThrift());
+  }
+  for (size_t i = 0; i < iters; ++i) {
+    auto mapping = std::make_unique<PlatformMapping>(json);
+    folly::doNotOptimizeAway(mapping);
+  }
+}
+
+} // namespace
+
+#define PLATFORM_MAPPING_BENCHMARK(name, MappingT, ...)        \
+  BENCHMARK(name, iters) {                                     \
+    constructMapping<MappingT>(iters, ##__VA_ARGS__);          \
+  }                                                            \
+  BENCHMARK_RELATIVE(name##Json, iters) {                      \
+    parseMappingJson<MappingT>(iters, ##__VA_ARGS__);          \
+  }                                                            \
+  BENCHMARK_DRAW_LINE();
+
+PLATFORM_MAPPING_BENCHMARK(Wedge40, Wedge40PlatformMapping)
+PLATFORM_MAPPING_BENCHMARK(Wedge100, Wedge100PlatformMapping)
+PLATFORM_MAPPING_BENCHMARK(Wedge400, Wedge400PlatformMapping)
+PLATFORM_MAPPING_BENCHMARK(Wedge400C, Wedge400CPlatformMapping)
+PLATFORM_MAPPING_BENCHMARK(GalaxyFC, GalaxyFCPlatformMapping, "fc003")
+PLATFORM_MAPPING_BENCHMARK(GalaxyLC, GalaxyLCPlatformMapping, "lc301")
+PLATFORM_MAPPING_BENCHMARK(Yamp16QPim, Yamp16QPimPlatformMapping)
+PLATFORM_MAPPING_BENCHMARK(Fuji16QPim, Fuji16QPimPlatformMapping)
+PLATFORM_MAPPING_BENCHMARK(Elbert16QPim, Elbert16QPimPlatformMapping)
+PLATFORM_MAPPING_BENCHMARK(CloudRipper, CloudRipperPlatformMapping)
+PLATFORM_MAPPING_BENCHMARK(Kamet, KametPlatformMapping)
+PLATFORM_MAPPING_BENCHMARK(Lassen, LassenPlatformMapping)
+PLATFORM_MAPPING_BENCHMARK(Sandia, SandiaPlatformMapping)
+
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
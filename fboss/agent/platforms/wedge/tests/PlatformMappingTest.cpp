@@ -15,6 +15,7 @@
 #include "fboss/agent/platforms/common/fuji/Fuji16QPimPlatformMapping.h"
 #include "fboss/agent/platforms/common/galaxy/GalaxyFCPlatformMapping.h"
 #include "fboss/agent/platforms/common/galaxy/GalaxyLCPlatformMapping.h"
+#include "fboss/agent/platforms/common/PrecompiledPlatformMappings.h"
 #include "fboss/agent/platforms/common/minipack/Minipack16QPimPlatformMapping.h"
 #include "fboss/agent/platforms/common/wedge100/Wedge100PlatformMapping.h"
 #include "fboss/agent/platforms/common/wedge40/Wedge40PlatformMapping.h"
@@ -27,6 +28,7 @@
 
 #include <gtest/gtest.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
 #include <optional>
 
 namespace facebook::fboss::test {
@@ -1306,4 +1308,43 @@ TEST_F(PlatformMappingTest, VerifyYampXphyLinePolaritySwap) {
   verifyXphyLinePolaritySwapByProfile(
       mapping.get(), mapping->getPlatformPorts(), expectedPolaritySwap);
 }
+
+TEST_F(PlatformMappingTest, VerifyPrecompiledPlatformMapping) {
+  // Mappings rewritten at runtime are not precompiled
+  EXPECT_EQ(findPrecompiledPlatformMapping("GalaxyFCPlatformMapping"), nullptr);
+  auto precompiled = findPrecompiledPlatformMapping("Wedge400PlatformMapping");
+  ASSERT_NE(precompiled, nullptr);
+  ASSERT_GT(precompiled->numPorts, 0u);
+
+  // Single ports are decoded on demand
+  auto mapping = std::make_unique<Wedge400PlatformMapping>();
+  const auto& port = precompiled->ports[precompiled->numPorts - 1];
+  EXPECT_EQ(mapping->getPortID(port.name), PortID(port.id));
+  const auto& chip = mapping->getPortIphyChip(PortID(port.id));
+  EXPECT_EQ(mapping->getChips().at(*chip.name()), chip);
+
+  const auto& ports = mapping->getPlatformPorts();
+  EXPECT_EQ(ports.size(), precompiled->numPorts);
+  for (size_t i = 0; i < precompiled->numPorts; ++i) {
+    const auto& entry = ports.at(precompiled->ports[i].id);
+    EXPECT_EQ(*entry.mapping()->name(), precompiled->ports[i].name);
+  }
+}
+
+TEST_F(PlatformMappingTest, VerifyPortIDLookupAfterMerge) {
+  auto mapping = std::make_unique<Yamp16QPimPlatformMapping>();
+  PlatformMapping merged;
+  for (const auto& port : mapping->getPlatformPorts()) {
+    EXPECT_EQ(
+        mapping->getPortID(*port.second.mapping()->name()), PortID(port.first));
+  }
+  auto numPorts = mapping->getPlatformPorts().size();
+  merged.merge(mapping.get());
+  EXPECT_EQ(merged.getPlatformPorts().size(), numPorts);
+  for (const auto& port : merged.getPlatformPorts()) {
+    EXPECT_EQ(
+        merged.getPortID(*port.second.mapping()->name()), PortID(port.first));
+  }
+  EXPECT_THROW(mapping->getPortID("eth1/1/1"), FbossError);
+}
 } // namespace facebook::fboss::test
@@ -26,6 +26,7 @@
 #include "fboss/agent/Utils.h"
 #include "fboss/agent/state/RouteNextHopEntry.h"
 #include "fboss/agent/state/RouteTypes.h"
+#include "fboss/lib/FunctionCallTimeReporter.h"
 #include "folly/IPAddressV4.h"
 
 using boost::container::flat_map;
@@ -563,7 +564,7 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
 
   bool hasToCpu{false};
   bool hasDrop{false};
-  RouteNextHopSet* fwd{nullptr};
+  InternedNextHopSetPtr fwd;
 
   auto bestPair = route->getBestEntry();
   const auto clientId = bestPair.first;
@@ -577,12 +578,13 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
   } else if (action == RouteForwardAction::TO_CPU) {
     hasToCpu = true;
   } else {
-    auto fwItr = unresolvedToResolvedNhops_.find(bestEntry->getNextHopSet());
+    auto unresolvedNhops = bestEntry->getInternedNextHopSet();
+    auto fwItr = unresolvedToResolvedNhops_.find(unresolvedNhops);
     if (fwItr == unresolvedToResolvedNhops_.end()) {
       NextHopForwardInfos nhToFwds;
       bool labelPopandLookup = false;
       // loop through all nexthops to find out the forward info
-      for (const auto& nh : bestEntry->getNextHopSet()) {
+      for (const auto& nh : unresolvedNhops->nextHops()) {
         const auto& addr = nh.addr();
         // There are two reasons why InterfaceID is specified in the next hop.
         // 1) The nexthop was generated for interface route.
@@ -603,7 +605,7 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
         if (nh.labelForwardingAction().has_value() &&
             nh.labelForwardingAction().value().type() ==
                 MplsActionCode::POP_AND_LOOKUP) {
-          if (bestEntry->getNextHopSet().size() > 1) {
+          if (unresolvedNhops->nextHops().size() > 1) {
             throw FbossError(
                 "MPLS pop and lookup forwarding action has more than one nexthop");
           }
@@ -637,15 +639,15 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
       // forward packet based on inner header result. This means
       // that label pop and lookup will not have a valid nhop ip
       // or interface and any merge operation has to be skipped.
-      RouteNextHopSet nhSet = labelPopandLookup
-          ? bestEntry->getNextHopSet()
-          : mergeForwardInfos(nhToFwds, route);
+      auto nhSet = labelPopandLookup
+          ? unresolvedNhops
+          : InternedNextHopSet::intern(mergeForwardInfos(nhToFwds, route));
 
       fwItr = unresolvedToResolvedNhops_
-                  .insert({bestEntry->getNextHopSet(), std::move(nhSet)})
+                  .emplace(std::move(unresolvedNhops), std::move(nhSet))
                   .first;
     }
-    fwd = &(fwItr->second);
+    fwd = fwItr->second;
   }
 
   std::shared_ptr<Route<AddressT>> updatedRoute;
@@ -667,14 +669,14 @@ std::shared_ptr<Route<AddressT>> RibRouteUpdater::resolveOne(
     XLOG(DBG3) << (updatedRoute->isResolved() ? "Resolved" : "Cannot resolve")
                << " route " << updatedRoute->str();
   };
-  if (fwd && !fwd->empty()) {
-    if (route->getForwardInfo().getNextHopSet() != *fwd ||
+  if (fwd && !fwd->nextHops().empty()) {
+    if (route->getForwardInfo().getInternedNextHopSet() != fwd ||
         route->getForwardInfo().getCounterID() != counterID ||
         route->getForwardInfo().getClassID() != classID) {
       updateRoute(
           ritr,
           RouteNextHopEntry(
-              *fwd, bestEntry->getAdminDistance(), counterID, classID));
+              fwd, bestEntry->getAdminDistance(), counterID, classID));
     }
   } else if (hasToCpu) {
     if (!route->isToCPU() ||
@@ -761,6 +763,7 @@ void RibRouteUpdater::updateDone() {
     needsResolution_.clear();
     unresolvedToResolvedNhops_.clear();
   };
+  PROFILE_SPAN("rib_resolve");
   resolve(v4Routes_);
   resolve(v6Routes_);
   if (mplsRoutes_) {
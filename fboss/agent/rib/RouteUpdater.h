@@ -15,6 +15,7 @@
 #include "fboss/agent/rib/NetworkToRouteMap.h"
 
 #include <folly/IPAddress.h>
+#include <folly/container/F14Map.h>
 
 namespace facebook::fboss {
 
@@ -170,7 +171,8 @@ class RibRouteUpdater {
    * its pretty common for the same next hops to repeat, so
    * cache resolution
    */
-  std::map<RouteNextHopSet, RouteNextHopSet> unresolvedToResolvedNhops_;
+  folly::F14FastMap<InternedNextHopSetPtr, InternedNextHopSetPtr>
+      unresolvedToResolvedNhops_;
 };
 
 } // namespace facebook::fboss
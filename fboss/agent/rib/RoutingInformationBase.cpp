@@ -335,13 +335,15 @@ std::vector<RouterID> RibRouteTables::getVrfList() const {
 
 void RibRouteTables::setClassID(
     RouterID rid,
-    const std::vector<folly::CIDRNetwork>& prefixes,
+    const std::vector<PrefixAndClassID>& prefixesAndClassIDs,
     FibUpdateFunction fibUpdateCallback,
-    std::optional<cfg::AclLookupClass> classId,
     void* cookie) {
   updateRib(rid, [&](auto& routeTable) {
     // Update rib
-    auto updateRoute = [&classId](auto& rib, auto ip, uint8_t mask) {
+    auto updateRoute = [](auto& rib,
+                          auto ip,
+                          uint8_t mask,
+                          std::optional<cfg::AclLookupClass> classId) {
       auto ritr = rib.exactMatch(ip, mask);
       if (ritr == rib.end() || ritr->value()->getClassID() == classId) {
         return;
@@ -352,11 +354,11 @@ void RibRouteTables::setClassID(
     };
     auto& v4Rib = routeTable.v4NetworkToRoute;
     auto& v6Rib = routeTable.v6NetworkToRoute;
-    for (auto& prefix : prefixes) {
+    for (const auto& [prefix, classId] : prefixesAndClassIDs) {
       if (prefix.first.isV4()) {
-        updateRoute(v4Rib, prefix.first.asV4(), prefix.second);
+        updateRoute(v4Rib, prefix.first.asV4(), prefix.second, classId);
       } else {
-        updateRoute(v6Rib, prefix.first.asV6(), prefix.second);
+        updateRoute(v6Rib, prefix.first.asV6(), prefix.second, classId);
       }
     }
   });
@@ -524,19 +526,33 @@ RoutingInformationBase::UpdateStatistics RoutingInformationBase::updateImpl(
   return stats;
 }
 
+std::vector<PrefixAndClassID> RoutingInformationBase::toPrefixesAndClassIDs(
+    const std::vector<folly::CIDRNetwork>& prefixes,
+    std::optional<cfg::AclLookupClass> classId) {
+  std::vector<PrefixAndClassID> prefixesAndClassIDs;
+  prefixesAndClassIDs.reserve(prefixes.size());
+  for (const auto& prefix : prefixes) {
+    prefixesAndClassIDs.emplace_back(prefix, classId);
+  }
+  return prefixesAndClassIDs;
+}
+
 void RoutingInformationBase::setClassIDImpl(
     RouterID rid,
-    const std::vector<folly::CIDRNetwork>& prefixes,
+    std::vector<PrefixAndClassID> prefixesAndClassIDs,
     FibUpdateFunction fibUpdateCallback,
-    std::optional<cfg::AclLookupClass> classId,
     void* cookie,
     bool async) {
   ensureRunning();
-  auto updateFn = [=]() {
-    ribTables_.setClassID(rid, prefixes, fibUpdateCallback, classId, cookie);
+  auto updateFn = [this,
+                   rid,
+                   prefixesAndClassIDs = std::move(prefixesAndClassIDs),
+                   fibUpdateCallback = std::move(fibUpdateCallback),
+                   cookie]() {
+    ribTables_.setClassID(rid, prefixesAndClassIDs, fibUpdateCallback, cookie);
   };
   if (async) {
-    ribUpdateEventBase_.runInEventBaseThread(updateFn);
+    ribUpdateEventBase_.runInEventBaseThread(std::move(updateFn));
   } else {
     ribUpdateEventBase_.runInEventBaseThreadAndWait(updateFn);
   }
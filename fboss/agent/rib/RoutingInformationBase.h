@@ -36,6 +36,9 @@ using FibUpdateFunction = std::function<std::shared_ptr<SwitchState>(
     const LabelToRouteMap& labelToRoute,
     void* cookie)>;
 
+using PrefixAndClassID =
+    std::pair<folly::CIDRNetwork, std::optional<cfg::AclLookupClass>>;
+
 /*
  * RibRouteTables provides a thread safe abstraction for maintaining Rib data
  * structures and programming them down to the FIB. Its designed to abstract
@@ -58,9 +61,8 @@ class RibRouteTables {
 
   void setClassID(
       RouterID rid,
-      const std::vector<folly::CIDRNetwork>& prefixes,
+      const std::vector<PrefixAndClassID>& prefixesAndClassIDs,
       FibUpdateFunction fibUpdateCallback,
-      std::optional<cfg::AclLookupClass> classId,
       void* cookie);
   /*
    * VrfAndNetworkToInterfaceRoute is conceptually a mapping from the pair
@@ -257,7 +259,12 @@ class RoutingInformationBase {
       FibUpdateFunction fibUpdateCallback,
       std::optional<cfg::AclLookupClass> classId,
       void* cookie) {
-    setClassIDImpl(rid, prefixes, fibUpdateCallback, classId, cookie, false);
+    setClassIDImpl(
+        rid,
+        toPrefixesAndClassIDs(prefixes, classId),
+        fibUpdateCallback,
+        cookie,
+        false);
   }
 
   void setClassIDAsync(
@@ -266,7 +273,34 @@ class RoutingInformationBase {
       FibUpdateFunction fibUpdateCallback,
       std::optional<cfg::AclLookupClass> classId,
       void* cookie) {
-    setClassIDImpl(rid, prefixes, fibUpdateCallback, classId, cookie, true);
+    setClassIDImpl(
+        rid,
+        toPrefixesAndClassIDs(prefixes, classId),
+        fibUpdateCallback,
+        cookie,
+        true);
+  }
+
+  /*
+   * Set possibly different classIDs on several prefixes of a VRF. All of
+   * them are programmed with a single FIB update.
+   */
+  void setClassID(
+      RouterID rid,
+      std::vector<PrefixAndClassID> prefixesAndClassIDs,
+      FibUpdateFunction fibUpdateCallback,
+      void* cookie) {
+    setClassIDImpl(
+        rid, std::move(prefixesAndClassIDs), fibUpdateCallback, cookie, false);
+  }
+
+  void setClassIDAsync(
+      RouterID rid,
+      std::vector<PrefixAndClassID> prefixesAndClassIDs,
+      FibUpdateFunction fibUpdateCallback,
+      void* cookie) {
+    setClassIDImpl(
+        rid, std::move(prefixesAndClassIDs), fibUpdateCallback, cookie, true);
   }
 
   folly::dynamic toFollyDynamic() const {
@@ -314,11 +348,13 @@ class RoutingInformationBase {
 
  private:
   void ensureRunning() const;
+  static std::vector<PrefixAndClassID> toPrefixesAndClassIDs(
+      const std::vector<folly::CIDRNetwork>& prefixes,
+      std::optional<cfg::AclLookupClass> classId);
   void setClassIDImpl(
       RouterID rid,
-      const std::vector<folly::CIDRNetwork>& prefixes,
+      std::vector<PrefixAndClassID> prefixesAndClassIDs,
       FibUpdateFunction fibUpdateCallback,
-      std::optional<cfg::AclLookupClass> classId,
       void* cookie,
       bool async);
 
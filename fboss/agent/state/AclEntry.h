@@ -123,6 +123,22 @@ struct AclEntryFields
         enabled == acl.enabled;
   }
 
+  // Whether both entries match the same packets, whatever their priority
+  // and actions
+  bool sameMatcher(const AclEntryFields& acl) const {
+    return srcIp == acl.srcIp && dstIp == acl.dstIp && proto == acl.proto &&
+        tcpFlagsBitMap == acl.tcpFlagsBitMap && srcPort == acl.srcPort &&
+        dstPort == acl.dstPort && ipFrag == acl.ipFrag &&
+        icmpType == acl.icmpType && icmpCode == acl.icmpCode &&
+        dscp == acl.dscp && dstMac == acl.dstMac && ipType == acl.ipType &&
+        ttl == acl.ttl && l4SrcPort == acl.l4SrcPort &&
+        l4DstPort == acl.l4DstPort && lookupClassL2 == acl.lookupClassL2 &&
+        lookupClassNeighbor == acl.lookupClassNeighbor &&
+        lookupClassRoute == acl.lookupClassRoute &&
+        packetLookupResult == acl.packetLookupResult &&
+        etherType == acl.etherType && vlanID == acl.vlanID;
+  }
+
   static void checkFollyDynamic(const folly::dynamic& json);
   int priority{0};
   std::string name{nullptr};
@@ -360,6 +376,10 @@ class AclEntry
     writableFields()->vlanID = vlanID;
   }
 
+  bool hasSameMatcher(const AclEntry& other) const {
+    return getFields()->sameMatcher(*other.getFields());
+  }
+
   bool hasMatcher() const {
     // at least one qualifier must be specified
     return getSrcIp().first || getDstIp().first || getProto() ||
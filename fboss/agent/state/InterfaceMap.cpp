@@ -9,7 +9,10 @@
  */
 #include "fboss/agent/state/InterfaceMap.h"
 #include <folly/Conv.h>
+#include <folly/container/F14Map.h>
+#include <algorithm>
 #include <string>
+#include "fboss/agent/FbossError.h"
 #include "fboss/agent/state/Interface.h"
 #include "fboss/agent/state/NodeMap-defs.h"
 
@@ -18,6 +21,22 @@ using std::string;
 
 namespace facebook::fboss {
 
+struct InterfaceMap::LookupIndex {
+  // (router, address) => interface the address is configured on
+  folly::F14FastMap<std::pair<RouterID, IPAddress>, std::shared_ptr<Interface>>
+      addresses;
+  // vlan => first interface in the vlan
+  folly::F14FastMap<VlanID, std::shared_ptr<Interface>> vlans;
+  // (router, masked subnet) => first interface with an address in it
+  folly::F14FastMap<
+      std::pair<RouterID, folly::CIDRNetwork>,
+      std::shared_ptr<Interface>>
+      subnets;
+  // (router, is v4) => mask lengths of the subnets in that router
+  folly::F14FastMap<std::pair<RouterID, bool>, std::vector<uint8_t>>
+      subnetMasks;
+};
+
 InterfaceMap::InterfaceMap() {}
 
 InterfaceMap::~InterfaceMap() {}
@@ -42,6 +61,10 @@ std::shared_ptr<InterfaceMap> InterfaceMap::fromThrift(
 std::shared_ptr<Interface> InterfaceMap::getInterfaceIf(
     RouterID router,
     const IPAddress& ip) const {
+  if (lookupIndex_) {
+    auto it = lookupIndex_->addresses.find(std::make_pair(router, ip));
+    return it == lookupIndex_->addresses.end() ? nullptr : it->second;
+  }
   for (auto itr = begin(); itr != end(); ++itr) {
     if ((*itr)->getRouterID() == router && (*itr)->hasAddress(ip)) {
       return *itr;
@@ -53,6 +76,13 @@ std::shared_ptr<Interface> InterfaceMap::getInterfaceIf(
 const std::shared_ptr<Interface>& InterfaceMap::getInterface(
     RouterID router,
     const IPAddress& ip) const {
+  if (lookupIndex_) {
+    auto it = lookupIndex_->addresses.find(std::make_pair(router, ip));
+    if (it == lookupIndex_->addresses.end()) {
+      throw FbossError("No interface with ip : ", ip);
+    }
+    return it->second;
+  }
   for (auto itr = begin(); itr != end(); ++itr) {
     if ((*itr)->getRouterID() == router && (*itr)->hasAddress(ip)) {
       return *itr;
@@ -63,6 +93,10 @@ const std::shared_ptr<Interface>& InterfaceMap::getInterface(
 
 std::shared_ptr<Interface> InterfaceMap::getInterfaceInVlanIf(
     VlanID vlan) const {
+  if (lookupIndex_) {
+    auto it = lookupIndex_->vlans.find(vlan);
+    return it == lookupIndex_->vlans.end() ? nullptr : it->second;
+  }
   for (auto itr = begin(); itr != end(); ++itr) {
     if ((*itr)->getVlanID() == vlan) {
       return *itr;
@@ -83,6 +117,24 @@ const std::shared_ptr<Interface> InterfaceMap::getInterfaceInVlan(
 const std::shared_ptr<Interface> InterfaceMap::getIntfToReach(
     RouterID router,
     const folly::IPAddress& dest) const {
+  if (lookupIndex_) {
+    auto masks =
+        lookupIndex_->subnetMasks.find(std::make_pair(router, dest.isV4()));
+    if (masks == lookupIndex_->subnetMasks.end()) {
+      return nullptr;
+    }
+    // Same as the walk below: the first interface that can reach dest
+    std::shared_ptr<Interface> found;
+    for (auto mask : masks->second) {
+      auto it = lookupIndex_->subnets.find(
+          std::make_pair(router, folly::CIDRNetwork(dest.mask(mask), mask)));
+      if (it != lookupIndex_->subnets.end() &&
+          (!found || it->second->getID() < found->getID())) {
+        found = it->second;
+      }
+    }
+    return found;
+  }
   for (const auto& intf : *this) {
     if (intf->getRouterID() == router && intf->canReachAddress(dest)) {
       return intf;
@@ -91,6 +143,36 @@ const std::shared_ptr<Interface> InterfaceMap::getIntfToReach(
   return nullptr;
 }
 
+void InterfaceMap::publish() {
+  NodeMapT::publish();
+  if (!lookupIndex_) {
+    lookupIndex_ = buildLookupIndex();
+  }
+}
+
+std::shared_ptr<const InterfaceMap::LookupIndex>
+InterfaceMap::buildLookupIndex() const {
+  auto index = std::make_shared<LookupIndex>();
+  // Interfaces are walked in ID order and only the first one for each key is
+  // kept, so lookups find the same interface a walk of the map would
+  for (const auto& intf : *this) {
+    auto router = intf->getRouterID();
+    index->vlans.emplace(intf->getVlanID(), intf);
+    for (const auto& [ip, mask] : intf->getAddresses()) {
+      index->addresses.emplace(std::make_pair(router, ip), intf);
+      auto inserted = index->subnets.emplace(
+          std::make_pair(router, folly::CIDRNetwork(ip.mask(mask), mask)),
+          intf);
+      auto& masks = index->subnetMasks[std::make_pair(router, ip.isV4())];
+      if (inserted.second &&
+          std::find(masks.begin(), masks.end(), mask) == masks.end()) {
+        masks.push_back(mask);
+      }
+    }
+  }
+  return index;
+}
+
 void InterfaceMap::addInterface(const std::shared_ptr<Interface>& interface) {
   addNode(interface);
 }
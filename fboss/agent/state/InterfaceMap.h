@@ -88,6 +88,16 @@ class InterfaceMap : public NodeMapT<InterfaceMap, InterfaceMapTraits> {
       RouterID router,
       const folly::IPAddress& dest) const;
 
+  /*
+   * Build the lookup index along with publishing the map.
+   *
+   * Once published the map can't change, so the address, VLAN and subnet
+   * lookups above are served from hash maps built here, instead of walking
+   * every interface. The index is shared by every SwitchState the map is
+   * part of.
+   */
+  void publish() override;
+
   /*
    * The following functions modify the static state.
    * These should only be called on unpublished objects which are only visible
@@ -112,9 +122,16 @@ class InterfaceMap : public NodeMapT<InterfaceMap, InterfaceMapTraits> {
   }
 
  private:
+  struct LookupIndex;
+
   // Inherit the constructors required for clone()
   using NodeMapT::NodeMapT;
   friend class CloneAllocator;
+
+  std::shared_ptr<const LookupIndex> buildLookupIndex() const;
+
+  // Only set once published, clones start without one
+  std::shared_ptr<const LookupIndex> lookupIndex_;
 };
 
 } // namespace facebook::fboss
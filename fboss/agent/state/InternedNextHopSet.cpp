@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/InternedNextHopSet.h"
+
+#include "fboss/agent/state/RouteNextHopEntry.h"
+
+#include <folly/Indestructible.h>
+#include <folly/container/F14Set.h>
+#include <folly/hash/Hash.h>
+#include <gflags/gflags.h>
+
+#include <array>
+
+DECLARE_bool(wide_ecmp);
+DECLARE_double(ucmp_max_error);
+
+namespace facebook::fboss {
+
+namespace {
+
+/*
+ * The intern table holds raw pointers and is keyed by set contents. It
+ * supports heterogeneous lookup by NextHopSet so that interning an
+ * existing set does not need to construct anything.
+ */
+struct InternedHash {
+  using is_transparent = void;
+  size_t operator()(const InternedNextHopSet* nhops) const {
+    return nhops->hash();
+  }
+  size_t operator()(const InternedNextHopSet::NextHopSet& nhops) const {
+    return InternedNextHopSet::hashNextHops(nhops);
+  }
+};
+
+struct InternedEqual {
+  using is_transparent = void;
+  static const InternedNextHopSet::NextHopSet& get(
+      const InternedNextHopSet* nhops) {
+    return nhops->nextHops();
+  }
+  static const InternedNextHopSet::NextHopSet& get(
+      const InternedNextHopSet::NextHopSet& nhops) {
+    return nhops;
+  }
+  template <typename A, typename B>
+  bool operator()(const A& a, const B& b) const {
+    return get(a) == get(b);
+  }
+};
+
+using InternTable =
+    folly::F14FastSet<const InternedNextHopSet*, InternedHash, InternedEqual>;
+
+/*
+ * RIB, thrift and SAI threads all intern sets, so the table is split in
+ * shards picked by hash, each with its own lock. Lookups of sets which are
+ * already interned, by far the common case, only take a read lock.
+ */
+constexpr size_t kNumInternShards = 64;
+
+using InternShards =
+    std::array<folly::Synchronized<InternTable>, kNumInternShards>;
+
+InternShards& internShards() {
+  static folly::Indestructible<InternShards> shards;
+  return *shards;
+}
+
+folly::Synchronized<InternTable>& internShard(size_t hash) {
+  // F14 uses the low bits of the hash to pick buckets, shard by the high ones
+  return internShards()[(hash >> 32) % kNumInternShards];
+}
+
+} // namespace
+
+size_t InternedNextHopSet::hashNextHops(const NextHopSet& nhops) {
+  size_t hash = nhops.size();
+  for (const auto& nhop : nhops) {
+    auto intf = nhop.intfID() ? static_cast<uint32_t>(*nhop.intfID()) : 0;
+    // label actions are rare and only compared on a hash collision
+    hash = folly::hash::hash_combine(
+        hash, nhop.addr().hash(), intf, nhop.weight());
+  }
+  return hash;
+}
+
+InternedNextHopSetPtr InternedNextHopSet::intern(const NextHopSet& nhops) {
+  auto hash = hashNextHops(nhops);
+  auto& shard = internShard(hash);
+  {
+    auto table = shard.rlock();
+    auto itr = table->find(nhops);
+    if (itr != table->end()) {
+      if (auto existing = (*itr)->weak_from_this().lock()) {
+        return existing;
+      }
+    }
+  }
+  auto table = shard.wlock();
+  auto itr = table->find(nhops);
+  if (itr != table->end()) {
+    if (auto existing = (*itr)->weak_from_this().lock()) {
+      return existing;
+    }
+    // The last reference is being dropped concurrently. Replace it, its
+    // release() will find this new entry and leave it alone.
+    table->erase(itr);
+  }
+  std::shared_ptr<const InternedNextHopSet> interned(
+      new InternedNextHopSet(nhops, hash), &InternedNextHopSet::release);
+  table->insert(interned.get());
+  return interned;
+}
+
+void InternedNextHopSet::release(InternedNextHopSet* nhops) {
+  {
+    auto table = internShard(nhops->hash()).wlock();
+    auto itr = table->find(nhops);
+    if (itr != table->end() && *itr == nhops) {
+      table->erase(itr);
+    }
+  }
+  delete nhops;
+}
+
+size_t InternedNextHopSet::numInterned() {
+  size_t numInterned = 0;
+  for (auto& shard : internShards()) {
+    numInterned += shard.rlock()->size();
+  }
+  return numInterned;
+}
+
+InternedNextHopSet::NormalizationParams
+InternedNextHopSet::NormalizationParams::current() {
+  return NormalizationParams{
+      FLAGS_ecmp_width,
+      FLAGS_optimized_ucmp,
+      FLAGS_wide_ecmp,
+      FLAGS_ucmp_max_error};
+}
+
+bool InternedNextHopSet::NormalizationParams::operator==(
+    const NormalizationParams& other) const {
+  return ecmpWidth == other.ecmpWidth &&
+      optimizedUcmp == other.optimizedUcmp && wideEcmp == other.wideEcmp &&
+      ucmpMaxError == other.ucmpMaxError;
+}
+
+InternedNextHopSetPtr InternedNextHopSet::normalized() const {
+  auto params = NormalizationParams::current();
+  {
+    // Memoized already, the common case
+    auto locked = normalized_.rlock();
+    if (locked->has_value() && (*locked)->params == params) {
+      if (!(*locked)->nextHops) {
+        return shared_from_this();
+      }
+      if (auto interned = (*locked)->interned.lock()) {
+        return interned;
+      }
+    }
+  }
+  auto locked = normalized_.wlock();
+  if (!locked->has_value() || !((*locked)->params == params)) {
+    auto normalizedNextHops = RouteNextHopEntry::normalizeNextHops(nextHops_);
+    locked->emplace(Normalized{params, std::nullopt, {}});
+    if (normalizedNextHops != nextHops_) {
+      (*locked)->nextHops = std::move(normalizedNextHops);
+    }
+  }
+  auto& normalizedEntry = locked->value();
+  if (!normalizedEntry.nextHops) {
+    return shared_from_this();
+  }
+  if (auto interned = normalizedEntry.interned.lock()) {
+    return interned;
+  }
+  auto interned = intern(*normalizedEntry.nextHops);
+  normalizedEntry.interned = interned;
+  return interned;
+}
+
+} // namespace facebook::fboss
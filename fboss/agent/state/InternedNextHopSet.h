@@ -0,0 +1,100 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <boost/container/flat_set.hpp>
+
+#include <folly/Synchronized.h>
+
+#include "fboss/agent/state/RouteNextHop.h"
+
+#include <memory>
+#include <optional>
+
+namespace facebook::fboss {
+
+class InternedNextHopSet;
+using InternedNextHopSetPtr = std::shared_ptr<const InternedNextHopSet>;
+
+/*
+ * InternedNextHopSet is an immutable next hop set that is shared by every
+ * user of the same set of next hops. With a large number of routes spread
+ * over comparatively few ECMP groups this lets us store, compare and
+ * normalize each distinct set once rather than once per route.
+ *
+ * Sets are hash-consed in a global, sharded table: intern() returns the
+ * existing instance for equal next hops, so two InternedNextHopSetPtr refer
+ * to equal sets if and only if they are the same pointer. Entries are
+ * dropped from the table when the last reference goes away.
+ *
+ * The UCMP normalized form of the set is computed lazily on first use and
+ * memoized. Since normalization depends on the ecmp width and UCMP flags,
+ * the memoized form is recomputed if those change.
+ */
+class InternedNextHopSet
+    : public std::enable_shared_from_this<InternedNextHopSet> {
+ public:
+  using NextHopSet = boost::container::flat_set<NextHop>;
+
+  static InternedNextHopSetPtr intern(const NextHopSet& nhops);
+
+  // Number of distinct sets currently interned
+  static size_t numInterned();
+
+  const NextHopSet& nextHops() const {
+    return nextHops_;
+  }
+
+  size_t hash() const {
+    return hash_;
+  }
+
+  /*
+   * Interned form of RouteNextHopEntry::normalizeNextHops() applied to
+   * this set. Returns this set if it is already normalized.
+   */
+  InternedNextHopSetPtr normalized() const;
+
+  static size_t hashNextHops(const NextHopSet& nhops);
+
+ private:
+  InternedNextHopSet(NextHopSet nhops, size_t hash)
+      : nextHops_(std::move(nhops)), hash_(hash) {}
+  // Not copyable or movable, identity is the whole point
+  InternedNextHopSet(const InternedNextHopSet&) = delete;
+  InternedNextHopSet& operator=(const InternedNextHopSet&) = delete;
+
+  static void release(InternedNextHopSet* nhops);
+
+  struct NormalizationParams {
+    uint32_t ecmpWidth;
+    bool optimizedUcmp;
+    bool wideEcmp;
+    double ucmpMaxError;
+
+    static NormalizationParams current();
+    bool operator==(const NormalizationParams& other) const;
+  };
+
+  struct Normalized {
+    NormalizationParams params;
+    // std::nullopt when normalization leaves the set unchanged
+    std::optional<NextHopSet> nextHops;
+    // Weak so that a set whose normalized form normalizes back to it does
+    // not keep itself alive
+    std::weak_ptr<const InternedNextHopSet> interned;
+  };
+
+  const NextHopSet nextHops_;
+  const size_t hash_;
+  mutable folly::Synchronized<std::optional<Normalized>> normalized_;
+};
+
+} // namespace facebook::fboss
@@ -109,6 +109,7 @@ RouteDetails RouteFields<AddrT>::toRouteDetails(
 template <typename AddrT>
 void RouteFields<AddrT>::update(ClientID clientId, RouteNextHopEntry entry) {
   this->writableData().fwd() = state::RouteNextHopEntry{};
+  fwdNextHops_.reset();
   RouteNextHopsMulti::update(
       clientId, *(this->writableData().nexthopsmulti()), entry.toThrift());
 }
@@ -252,10 +252,14 @@ struct RouteFields
   }
   void setResolved(RouteNextHopEntry f) {
     this->writableData().fwd() = f.toThrift();
+    fwdNextHops_ = f.getAction() == RouteForwardAction::NEXTHOPS
+        ? f.getInternedNextHopSet()
+        : nullptr;
     setFlagsResolved();
   }
   void setUnresolvable() {
     this->writableData().fwd() = state::RouteNextHopEntry{};
+    fwdNextHops_.reset();
     setFlagsUnresolvable();
   }
   void setConnected() {
@@ -263,6 +267,7 @@ struct RouteFields
   }
   void clearForward() {
     this->writableData().fwd() = state::RouteNextHopEntry{};
+    fwdNextHops_.reset();
     clearForwardInFlags();
   }
 
@@ -277,7 +282,7 @@ struct RouteFields
     return RouteNextHopsMulti::fromThrift(*(this->data().nexthopsmulti()));
   }
   RouteNextHopEntry fwd() const {
-    return RouteNextHopEntry(*(this->data().fwd()));
+    return RouteNextHopEntry(*(this->data().fwd()), fwdNextHops_);
   }
   uint32_t flags() const {
     return *(this->data().flags());
@@ -288,6 +293,14 @@ struct RouteFields
     }
     return std::nullopt;
   }
+
+ private:
+  /*
+   * Interned next hops of fwd, shared with every other route resolved to
+   * the same next hops. Not part of the thrift state, routes deserialized
+   * from thrift intern their next hops on demand.
+   */
+  InternedNextHopSetPtr fwdNextHops_;
 };
 
 /// Route<> Class
@@ -111,10 +111,39 @@ RouteNextHopEntry::RouteNextHopEntry(
   }
 }
 
+RouteNextHopEntry::RouteNextHopEntry(
+    InternedNextHopSetPtr nhopSet,
+    AdminDistance distance,
+    std::optional<RouteCounterID> counterID,
+    std::optional<AclLookupClass> classID)
+    : RouteNextHopEntry(
+          nhopSet->nextHops(),
+          distance,
+          std::move(counterID),
+          std::move(classID)) {
+  internedNextHops_ = std::move(nhopSet);
+}
+
 RouteNextHopEntry::RouteNextHopEntry(const state::RouteNextHopEntry& entry) {
   writableData() = entry;
 }
 
+RouteNextHopEntry::RouteNextHopEntry(
+    const state::RouteNextHopEntry& entry,
+    InternedNextHopSetPtr nhopSet)
+    : RouteNextHopEntry(entry) {
+  if (isAction(entry, Action::NEXTHOPS)) {
+    internedNextHops_ = std::move(nhopSet);
+  }
+}
+
+InternedNextHopSetPtr RouteNextHopEntry::getInternedNextHopSet() const {
+  if (internedNextHops_) {
+    return internedNextHops_;
+  }
+  return InternedNextHopSet::intern(getNextHopSet());
+}
+
 NextHopWeight RouteNextHopEntry::getTotalWeight() const {
   return totalWeight(getNextHopSet());
 }
@@ -150,9 +179,15 @@ std::string RouteNextHopEntry::str() const {
 }
 
 bool operator==(const RouteNextHopEntry& a, const RouteNextHopEntry& b) {
+  auto sameNextHops = [&a, &b]() {
+    // interned sets are equal iff they are the same set
+    if (a.internedNextHops_ && b.internedNextHops_) {
+      return a.internedNextHops_ == b.internedNextHops_;
+    }
+    return a.getNextHopSet() == b.getNextHopSet();
+  };
   return (
-      a.getAction() == b.getAction() and
-      a.getNextHopSet() == b.getNextHopSet() and
+      a.getAction() == b.getAction() and sameNextHops() and
       a.getAdminDistance() == b.getAdminDistance() and
       a.getCounterID() == b.getCounterID() and
       a.getClassID() == b.getClassID());
@@ -292,7 +327,7 @@ bool RouteNextHopEntry::isValid(bool forMplsRoute) const {
 
 void RouteNextHopEntry::normalize(
     std::vector<NextHopWeight>& scaledWeights,
-    NextHopWeight totalWeight) const {
+    NextHopWeight totalWeight) {
   // This is the weight distribution without constraints
   std::vector<double> idealWeights;
 
@@ -375,9 +410,18 @@ void RouteNextHopEntry::normalize(
 }
 
 RouteNextHopEntry::NextHopSet RouteNextHopEntry::normalizedNextHops() const {
+  return internedNormalizedNextHops()->nextHops();
+}
+
+InternedNextHopSetPtr RouteNextHopEntry::internedNormalizedNextHops() const {
+  return getInternedNextHopSet()->normalized();
+}
+
+RouteNextHopEntry::NextHopSet RouteNextHopEntry::normalizeNextHops(
+    const NextHopSet& nhopSet) {
   NextHopSet normalizedNextHops;
   // 1)
-  for (const auto& nhop : getNextHopSet()) {
+  for (const auto& nhop : nhopSet) {
     normalizedNextHops.insert(ResolvedNextHop(
         nhop.addr(),
         nhop.intf(),
@@ -474,7 +518,7 @@ RouteNextHopEntry::NextHopSet RouteNextHopEntry::normalizedNextHops() const {
         scaledTotalWeight = FLAGS_ecmp_width;
       }
     }
-    XLOG(DBG3) << "Scaled next hops from " << getNextHopSet() << " to "
+    XLOG(DBG3) << "Scaled next hops from " << nhopSet << " to "
                << scaledNextHops;
     normalizedNextHops = scaledNextHops;
   } else {
@@ -497,7 +541,7 @@ RouteNextHopEntry::NextHopSet RouteNextHopEntry::normalizedNextHops() const {
           nhopWeights.at(idx++),
           nhop.labelForwardingAction()));
     }
-    XLOG(DBG3) << "Scaled next hops from " << getNextHopSet() << " to "
+    XLOG(DBG3) << "Scaled next hops from " << nhopSet << " to "
                << normalizedToMaxPathNextHops;
     return normalizedToMaxPathNextHops;
   }
@@ -784,6 +828,9 @@ state::RouteNextHopEntry RouteNextHopEntry::getRouteNextHopEntryThrift(
 }
 
 RouteNextHopSet RouteNextHopEntry::getNextHopSet() const {
+  if (internedNextHops_) {
+    return internedNextHops_->nextHops();
+  }
   return util::toRouteNextHopSet(*data().nexthops(), true);
 }
 
@@ -15,6 +15,7 @@
 
 #include "fboss/agent/gen-cpp2/switch_config_types.h"
 #include "fboss/agent/gen-cpp2/switch_state_types.h"
+#include "fboss/agent/state/InternedNextHopSet.h"
 #include "fboss/agent/state/RouteNextHop.h"
 #include "fboss/agent/state/RouteTypes.h"
 #include "fboss/agent/state/Thrifty.h"
@@ -63,8 +64,22 @@ class RouteNextHopEntry
             counterID,
             classID)) {}
 
+  RouteNextHopEntry(
+      InternedNextHopSetPtr nhopSet,
+      AdminDistance distance,
+      std::optional<RouteCounterID> counterID = std::nullopt,
+      std::optional<AclLookupClass> classID = std::nullopt);
+
   explicit RouteNextHopEntry(const state::RouteNextHopEntry& entry);
 
+  /*
+   * Construct from thrift along with the interned form of its next hops,
+   * which must match entry.nexthops.
+   */
+  RouteNextHopEntry(
+      const state::RouteNextHopEntry& entry,
+      InternedNextHopSetPtr nhopSet);
+
   AdminDistance getAdminDistance() const {
     return *data().adminDistance();
   }
@@ -75,6 +90,12 @@ class RouteNextHopEntry
 
   NextHopSet getNextHopSet() const;
 
+  /*
+   * Shared, pointer comparable form of getNextHopSet(). Free if this entry
+   * was built from an interned set, otherwise this interns the next hops.
+   */
+  InternedNextHopSetPtr getInternedNextHopSet() const;
+
   const std::optional<RouteCounterID> getCounterID() const {
     if (auto counter = data().counterID()) {
       return *counter;
@@ -91,6 +112,13 @@ class RouteNextHopEntry
 
   NextHopSet normalizedNextHops() const;
 
+  /*
+   * Interned form of normalizedNextHops(). Normalization is memoized per
+   * distinct next hop set, so this is cheap for all but the first route
+   * using a given set.
+   */
+  InternedNextHopSetPtr internedNormalizedNextHops() const;
+
   // Get the sum of the weights of all the nexthops in the entry
   NextHopWeight getTotalWeight() const;
 
@@ -125,6 +153,7 @@ class RouteNextHopEntry
   // Reset the NextHopSet
   void reset() {
     writableData() = state::RouteNextHopEntry{};
+    internedNextHops_.reset();
   }
 
   bool isValid(bool forMplsRoute = false) const;
@@ -150,6 +179,8 @@ class RouteNextHopEntry
   static facebook::fboss::RouteNextHopEntry fromStaticMplsRoute(
       const cfg::StaticMplsRouteWithNextHops& route);
   static bool isUcmp(const NextHopSet& nhopSet);
+  // UCMP normalization of nhopSet for the current ecmp width and flags
+  static NextHopSet normalizeNextHops(const NextHopSet& nhopSet);
   static void normalizeNextHopWeightsToMaxPaths(
       std::vector<uint64_t>& nhWeights,
       uint64_t normalizedPathCount);
@@ -166,9 +197,16 @@ class RouteNextHopEntry
       NextHopSet nhopSet = NextHopSet(),
       std::optional<RouteCounterID> counterID = std::nullopt,
       std::optional<AclLookupClass> classID = std::nullopt);
-  void normalize(
+  static void normalize(
       std::vector<NextHopWeight>& scaledWeights,
-      NextHopWeight totalWeight) const;
+      NextHopWeight totalWeight);
+
+  friend bool operator==(
+      const RouteNextHopEntry& a,
+      const RouteNextHopEntry& b);
+
+  // Set when constructed from an interned next hop set
+  InternedNextHopSetPtr internedNextHops_;
 };
 
 /**
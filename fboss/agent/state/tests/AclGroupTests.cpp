@@ -28,6 +28,7 @@ using std::make_shared;
 using std::shared_ptr;
 
 DECLARE_bool(enable_acl_table_group);
+DECLARE_int32(acl_priority_gap);
 
 const int kAclStartPriority = 100000;
 
@@ -333,7 +334,8 @@ TEST(AclGroup, ApplyConfigColdbootMultipleAclTable) {
   // Config contains single acl table
   auto entry1a = make_shared<AclEntry>(priority1++, kAcl1a);
   entry1a->setActionType(cfg::AclActionType::DENY);
-  auto entry1b = make_shared<AclEntry>(priority1++, kAcl1b);
+  auto entry1b = make_shared<AclEntry>(
+      kAclStartPriority + FLAGS_acl_priority_gap, kAcl1b);
   entry1b->setAclAction(MatchAction());
   auto map1 = std::make_shared<AclMap>();
   map1->addEntry(entry1a);
@@ -607,7 +609,9 @@ TEST(AclGroup, ApplyConfigWarmbootMultipleAclTable) {
       *(stateV5->getAclTableGroups()->getAclTableGroup(kAclStage1)),
       *tableGroup);
 
-  auto entry2b = make_shared<AclEntry>(priority2++, kAcl2b);
+  // Appended after entry2a, leaving a gap
+  auto entry2b = make_shared<AclEntry>(
+      kAclStartPriority + FLAGS_acl_priority_gap, kAcl2b);
   entry2b->setActionType(cfg::AclActionType::DENY);
   tableGroup->getAclTableMap()
       ->getTable(table2->getID())
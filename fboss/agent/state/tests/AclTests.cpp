@@ -31,6 +31,7 @@ using std::make_shared;
 using std::shared_ptr;
 
 DECLARE_bool(enable_acl_table_group);
+DECLARE_int32(acl_priority_gap);
 
 namespace {
 // We offset the start point in ApplyThriftConfig
@@ -422,11 +423,16 @@ TEST(Acl, AclGeneration) {
   EXPECT_NE(acls->getEntryIf("acl3"), nullptr);
   EXPECT_NE(acls->getEntryIf("acl5"), nullptr);
 
+  auto gap = FLAGS_acl_priority_gap;
   EXPECT_EQ(acls->getEntryIf("acl1")->getPriority(), kAclStartPriority);
-  EXPECT_EQ(acls->getEntryIf("acl4")->getPriority(), kAclStartPriority + 1);
-  EXPECT_EQ(acls->getEntryIf("acl2")->getPriority(), kAclStartPriority + 2);
-  EXPECT_EQ(acls->getEntryIf("acl3")->getPriority(), kAclStartPriority + 3);
-  EXPECT_EQ(acls->getEntryIf("acl5")->getPriority(), kAclStartPriority + 4);
+  EXPECT_EQ(
+      acls->getEntryIf("acl4")->getPriority(), kAclStartPriority + 1 * gap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl2")->getPriority(), kAclStartPriority + 2 * gap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl3")->getPriority(), kAclStartPriority + 3 * gap);
+  EXPECT_EQ(
+      acls->getEntryIf("acl5")->getPriority(), kAclStartPriority + 4 * gap);
 
   // Ensure that the global actions in global traffic policy has been added to
   // the ACL entries
@@ -877,6 +883,47 @@ TEST(Acl, InvalidTrafficCounter) {
       publishAndApplyConfig(stateV0, &config, platform.get()), FbossError);
 }
 
+TEST(Acl, InsertKeepsPriorities) {
+  FLAGS_enable_acl_table_group = false;
+  auto platform = createMockPlatform();
+  auto stateV0 = make_shared<SwitchState>();
+
+  auto makeAcl = [](const std::string& name, int l4DstPort) {
+    cfg::AclEntry acl;
+    *acl.name() = name;
+    *acl.actionType() = cfg::AclActionType::DENY;
+    acl.l4DstPort() = l4DstPort;
+    return acl;
+  };
+  cfg::SwitchConfig config;
+  for (int i = 0; i < 100; ++i) {
+    config.acls()->push_back(makeAcl("acl" + std::to_string(i), i));
+  }
+  auto stateV1 = publishAndApplyConfig(stateV0, &config, platform.get());
+  ASSERT_NE(nullptr, stateV1);
+
+  // Insert one acl in the middle and one at the head
+  config.acls()->insert(config.acls()->begin() + 50, makeAcl("middle", 1000));
+  config.acls()->insert(config.acls()->begin(), makeAcl("head", 1001));
+  auto stateV2 = publishAndApplyConfig(stateV1, &config, platform.get());
+  ASSERT_NE(nullptr, stateV2);
+
+  int numMoved = 0;
+  int lastPriority = 0;
+  for (const auto& acl : *config.acls()) {
+    auto newAcl = stateV2->getAcl(*acl.name());
+    ASSERT_NE(nullptr, newAcl);
+    EXPECT_LT(lastPriority, newAcl->getPriority());
+    lastPriority = newAcl->getPriority();
+    auto oldAcl = stateV1->getAcl(*acl.name());
+    if (oldAcl && oldAcl->getPriority() != newAcl->getPriority()) {
+      ++numMoved;
+    }
+  }
+  // Only the old head moves, to make room for the new one
+  EXPECT_EQ(1, numMoved);
+}
+
 TEST(Acl, GetRequiredAclTableQualifiers) {
   cfg::SwitchConfig config;
   config.acls();
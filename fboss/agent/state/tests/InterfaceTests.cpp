@@ -511,3 +511,90 @@ TEST(InterfaceMap, applyConfig) {
   EXPECT_EQ(4, intfsV4->getGeneration());
   EXPECT_EQ(1337, intfsV4->getInterface(InterfaceID(3))->getMtu());
 }
+
+TEST(InterfaceMap, publishedLookups) {
+  auto makeIntf = [](int id,
+                     int router,
+                     int vlan,
+                     const Interface::Addresses& addrs) {
+    auto intf = make_shared<Interface>(
+        InterfaceID(id),
+        RouterID(router),
+        VlanID(vlan),
+        folly::to<std::string>("fboss", id),
+        MacAddress("00:02:00:00:00:01"),
+        9000,
+        false, /* is virtual */
+        false /* is state_sync disabled */);
+    intf->setAddresses(addrs);
+    return intf;
+  };
+  auto intfs = make_shared<InterfaceMap>();
+  intfs->addInterface(makeIntf(
+      1,
+      0,
+      1,
+      {{IPAddress("10.0.0.1"), 24}, {IPAddress("2401:db00::1"), 64}}));
+  // Overlaps intf 1's subnet with a shorter mask
+  intfs->addInterface(makeIntf(2, 0, 2, {{IPAddress("10.0.0.2"), 16}}));
+  // Same address and vlan as intf 1 in another router
+  intfs->addInterface(makeIntf(
+      3,
+      1,
+      1,
+      {{IPAddress("10.0.0.1"), 24}, {IPAddress("2401:db00::1"), 64}}));
+
+  // Unpublished maps walk the interfaces, published ones use the index
+  auto unpublished = intfs->clone();
+  intfs->publish();
+
+  for (int router : {0, 1, 2}) {
+    for (auto ip :
+         {"10.0.0.1",
+          "10.0.0.2",
+          "10.0.0.5",
+          "10.0.5.5",
+          "10.1.0.1",
+          "2401:db00::1",
+          "2401:db00::5",
+          "2401:db01::1"}) {
+      SCOPED_TRACE(folly::to<std::string>(router, " ", ip));
+      EXPECT_EQ(
+          unpublished->getInterfaceIf(RouterID(router), IPAddress(ip)),
+          intfs->getInterfaceIf(RouterID(router), IPAddress(ip)));
+      EXPECT_EQ(
+          unpublished->getIntfToReach(RouterID(router), IPAddress(ip)),
+          intfs->getIntfToReach(RouterID(router), IPAddress(ip)));
+    }
+  }
+  for (int vlan : {1, 2, 3}) {
+    EXPECT_EQ(
+        unpublished->getInterfaceInVlanIf(VlanID(vlan)),
+        intfs->getInterfaceInVlanIf(VlanID(vlan)));
+  }
+
+  EXPECT_EQ(
+      InterfaceID(1),
+      intfs->getIntfToReach(RouterID(0), IPAddress("10.0.0.5"))->getID());
+  EXPECT_EQ(
+      InterfaceID(2),
+      intfs->getIntfToReach(RouterID(0), IPAddress("10.0.5.5"))->getID());
+  EXPECT_EQ(
+      InterfaceID(3),
+      intfs->getInterface(RouterID(1), IPAddress("10.0.0.1"))->getID());
+  EXPECT_EQ(InterfaceID(1), intfs->getInterfaceInVlan(VlanID(1))->getID());
+  EXPECT_THROW(
+      intfs->getInterface(RouterID(0), IPAddress("10.0.0.5")), FbossError);
+
+  // A modified copy of a published map gets its own index
+  auto intfsV1 = intfs->clone();
+  intfsV1->addInterface(makeIntf(4, 0, 4, {{IPAddress("10.2.0.1"), 24}}));
+  intfsV1->publish();
+  EXPECT_EQ(
+      InterfaceID(4),
+      intfsV1->getInterface(RouterID(0), IPAddress("10.2.0.1"))->getID());
+  EXPECT_EQ(
+      InterfaceID(4),
+      intfsV1->getIntfToReach(RouterID(0), IPAddress("10.2.0.9"))->getID());
+  EXPECT_EQ(nullptr, intfs->getInterfaceIf(RouterID(0), IPAddress("10.2.0.1")));
+}
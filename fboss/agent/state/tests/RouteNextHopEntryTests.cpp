@@ -414,3 +414,53 @@ TEST(RouteNextHopEntry, Thrift) {
   validateThriftyMigration<RouteNextHopEntry, true>(nhops0);
   validateThriftyMigration<RouteNextHopEntry, true>(nhops1);
 }
+
+TEST(RouteNextHopEntry, InternedNextHopSet) {
+  RouteNextHopSet nhops;
+  nhops.emplace(ResolvedNextHop(nextHopAddr1, InterfaceID(1), 1));
+  nhops.emplace(ResolvedNextHop(nextHopAddr2, InterfaceID(2), 2));
+  auto otherNhops = nhops;
+  otherNhops.emplace(ResolvedNextHop(nextHopAddr3, InterfaceID(3), 3));
+
+  auto numInterned = InternedNextHopSet::numInterned();
+  auto interned = InternedNextHopSet::intern(nhops);
+  EXPECT_EQ(interned, InternedNextHopSet::intern(nhops));
+  EXPECT_NE(interned, InternedNextHopSet::intern(otherNhops));
+  EXPECT_EQ(interned->nextHops(), nhops);
+
+  // entries built from and serialized back to thrift share the same set
+  RouteNextHopEntry entry(interned, kDefaultAdminDistance);
+  RouteNextHopEntry fromThrift(entry.toThrift());
+  EXPECT_EQ(entry.getInternedNextHopSet(), interned);
+  EXPECT_EQ(fromThrift.getInternedNextHopSet(), interned);
+  EXPECT_EQ(entry, fromThrift);
+  EXPECT_EQ(InternedNextHopSet::numInterned(), numInterned + 1);
+
+  // sets are dropped from the table with their last reference
+  interned.reset();
+  entry.reset();
+  EXPECT_EQ(InternedNextHopSet::numInterned(), numInterned);
+}
+
+TEST(RouteNextHopEntry, InternedNormalizedNextHops) {
+  RouteNextHopSet nhops;
+  nhops.emplace(ResolvedNextHop(nextHopAddr1, InterfaceID(1), 50));
+  nhops.emplace(ResolvedNextHop(nextHopAddr2, InterfaceID(2), 100));
+
+  FLAGS_ecmp_width = 64;
+  FLAGS_wide_ecmp = false;
+  FLAGS_optimized_ucmp = false;
+  RouteNextHopEntry entry(nhops, kDefaultAdminDistance);
+  auto normalized = entry.internedNormalizedNextHops();
+  EXPECT_EQ(
+      normalized->nextHops(), RouteNextHopEntry::normalizeNextHops(nhops));
+  EXPECT_EQ(normalized, entry.internedNormalizedNextHops());
+  EXPECT_LE(totalWeight(normalized->nextHops()), FLAGS_ecmp_width);
+
+  // already normalized sets normalize to themselves
+  EXPECT_EQ(normalized->normalized(), normalized);
+
+  // changing the ecmp width invalidates the memoized form
+  FLAGS_ecmp_width = 512;
+  EXPECT_EQ(entry.normalizedNextHops(), nhops);
+}
@@ -0,0 +1,141 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/AclPriorityAllocator.h"
+#include "fboss/agent/FbossError.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <optional>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr int kStart = 100;
+constexpr int kEnd = 100000;
+constexpr int kGap = 16;
+
+std::vector<std::optional<int>> toPrevious(const std::vector<int>& priorities) {
+  return {priorities.begin(), priorities.end()};
+}
+
+void checkIncreasing(const std::vector<int>& priorities) {
+  for (size_t i = 0; i < priorities.size(); ++i) {
+    EXPECT_GE(priorities[i], kStart);
+    EXPECT_LT(priorities[i], kEnd);
+    if (i > 0) {
+      EXPECT_LT(priorities[i - 1], priorities[i]);
+    }
+  }
+}
+
+size_t numMoved(
+    const std::vector<std::optional<int>>& previous,
+    const std::vector<int>& priorities) {
+  size_t moved = 0;
+  for (size_t i = 0; i < previous.size(); ++i) {
+    if (previous[i] && *previous[i] != priorities[i]) {
+      ++moved;
+    }
+  }
+  return moved;
+}
+
+} // namespace
+
+TEST(AclPriorityAllocatorTest, Coldboot) {
+  AclPriorityAllocator allocator(kStart, kEnd, kGap);
+  EXPECT_EQ(
+      allocator.allocate({std::nullopt, std::nullopt, std::nullopt}),
+      std::vector<int>({kStart, kStart + kGap, kStart + 2 * kGap}));
+  EXPECT_TRUE(allocator.allocate({}).empty());
+}
+
+TEST(AclPriorityAllocatorTest, KeepExisting) {
+  AclPriorityAllocator allocator(kStart, kEnd, kGap);
+  // Including densely numbered entries from before gaps were used
+  std::vector<int> existing = {kStart, kStart + 1, kStart + 2, kStart + 40};
+  EXPECT_EQ(allocator.allocate(toPrevious(existing)), existing);
+}
+
+TEST(AclPriorityAllocatorTest, InsertInGap) {
+  AclPriorityAllocator allocator(kStart, kEnd, kGap);
+  auto previous = toPrevious(allocator.allocate(
+      std::vector<std::optional<int>>(2000, std::nullopt)));
+
+  // In the middle
+  auto middle = previous;
+  middle.insert(middle.begin() + 1000, std::nullopt);
+  auto priorities = allocator.allocate(middle);
+  checkIncreasing(priorities);
+  EXPECT_EQ(numMoved(middle, priorities), 0);
+
+  // At the head, only the first entry makes room
+  auto head = previous;
+  head.insert(head.begin(), std::nullopt);
+  priorities = allocator.allocate(head);
+  checkIncreasing(priorities);
+  EXPECT_EQ(numMoved(head, priorities), 1);
+
+  // At the tail
+  auto tail = previous;
+  tail.push_back(std::nullopt);
+  priorities = allocator.allocate(tail);
+  checkIncreasing(priorities);
+  EXPECT_EQ(numMoved(tail, priorities), 0);
+  EXPECT_EQ(priorities.back(), *previous.back() + kGap);
+}
+
+TEST(AclPriorityAllocatorTest, RebalanceLocally) {
+  AclPriorityAllocator allocator(kStart, kEnd, kGap);
+  auto previous = toPrevious(allocator.allocate(
+      std::vector<std::optional<int>>(100, std::nullopt)));
+  // Keep inserting at the same spot, after the gaps around it run out only
+  // the entries around it move
+  for (int i = 0; i < 40; ++i) {
+    previous.insert(previous.begin() + 50, std::nullopt);
+    auto priorities = allocator.allocate(previous);
+    checkIncreasing(priorities);
+    EXPECT_LT(numMoved(previous, priorities), previous.size() / 3);
+    previous = toPrevious(priorities);
+  }
+}
+
+TEST(AclPriorityAllocatorTest, Reorder) {
+  AclPriorityAllocator allocator(kStart, kEnd, kGap);
+  std::vector<std::optional<int>> previous = {
+      kStart, kStart + 16, kStart + 32, kStart + 48, kStart + 64};
+  // Move the last entry to the front
+  std::rotate(previous.begin(), previous.end() - 1, previous.end());
+  auto priorities = allocator.allocate(previous);
+  checkIncreasing(priorities);
+  EXPECT_EQ(numMoved(previous, priorities), 2);
+
+  // Previous priorities out of range are ignored
+  previous = {kStart - 1, kEnd, kStart + 16};
+  priorities = allocator.allocate(previous);
+  checkIncreasing(priorities);
+  EXPECT_EQ(priorities.back(), kStart + 16);
+}
+
+TEST(AclPriorityAllocatorTest, Full) {
+  AclPriorityAllocator allocator(kStart, kStart + 4, kGap);
+  auto priorities = allocator.allocate(
+      {std::nullopt, kStart + 1, std::nullopt, std::nullopt});
+  EXPECT_EQ(
+      priorities,
+      std::vector<int>({kStart, kStart + 1, kStart + 2, kStart + 3}));
+  EXPECT_THROW(
+      allocator.allocate(std::vector<std::optional<int>>(5, std::nullopt)),
+      FbossError);
+  EXPECT_THROW(AclPriorityAllocator(kStart, kEnd, 0), FbossError);
+}
@@ -146,6 +146,43 @@ TEST(AggregatePortStats, FlapTwice) {
   counters.checkDelta(flapsCounterName, 2);
 }
 
+TEST(AggregatePortStats, FlapOnceBatched) {
+  const AggregatePortID aggregatePortID = AggregatePortID(1);
+  const auto aggregatePortName = "Port-Channel1";
+  const auto flapsCounterName = "Port-Channel1.flaps.sum";
+  AggregatePort::PartnerState pState{};
+
+  auto config = createConfig(aggregatePortID, aggregatePortName);
+  auto handle = createTestHandle(&config);
+  auto sw = handle->getSw();
+
+  CounterCache counters(sw);
+
+  auto oldAggPort = getAggregatePort(sw, aggregatePortID);
+
+  // Both members come up in the same state update
+  ProgramForwardingAndPartnerState addPortsToAggregatePort(
+      {{PortID(1),
+        aggregatePortID,
+        AggregatePort::Forwarding::ENABLED,
+        pState},
+       {PortID(2),
+        aggregatePortID,
+        AggregatePort::Forwarding::ENABLED,
+        pState}});
+  sw->updateStateNoCoalescing(
+      "Adding both ports to AggregatePort", addPortsToAggregatePort);
+
+  waitForStateUpdates(sw);
+  auto newAggPort = getAggregatePort(sw, aggregatePortID);
+  EXPECT_EQ(newAggPort->forwardingSubportCount(), 2u);
+  LinkAggregationManager::recordStatistics(sw, oldAggPort, newAggPort);
+
+  counters.update();
+  EXPECT_TRUE(counters.checkExist(flapsCounterName));
+  counters.checkDelta(flapsCounterName, 1);
+}
+
 TEST(AggregatePortStats, UpdateAggregatePortName) {
   const AggregatePortID aggregatePortID = AggregatePortID(1);
 
@@ -0,0 +1,78 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/AsyncLogger.h"
+
+#include <folly/Benchmark.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+DEFINE_string(
+    benchmark_log,
+    "/dev/shm/async_logger_benchmark",
+    "File to log to, on tmpfs so the benchmark measures the logger itself");
+DEFINE_int32(num_producers, 8, "Number of threads appending log records");
+DEFINE_int32(record_size, 128, "Size of each log record in bytes");
+
+/*
+ * Appends log records from several threads at once, the way the SAI replayer
+ * logs from the agent's threads.
+ */
+
+using namespace facebook::fboss;
+
+namespace {
+
+void appendFromProducers(size_t numRecords) {
+  std::unique_ptr<AsyncLogger> logger;
+  std::string record;
+  BENCHMARK_SUSPEND {
+    logger = std::make_unique<AsyncLogger>(
+        FLAGS_benchmark_log, 100, AsyncLogger::SAI_REPLAYER);
+    logger->startFlushThread();
+    record = std::string(FLAGS_record_size - 1, '.') + "\n";
+  }
+
+  std::vector<std::thread> producers;
+  for (auto i = 0; i < FLAGS_num_producers; ++i) {
+    producers.emplace_back([&]() {
+      for (size_t n = 0; n < numRecords / FLAGS_num_producers; ++n) {
+        logger->appendLog(record.c_str(), record.size());
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  logger->forceFlush();
+
+  BENCHMARK_SUSPEND {
+    logger->stopFlushThread();
+    logger.reset();
+    std::remove(FLAGS_benchmark_log.c_str());
+  }
+}
+
+} // namespace
+
+BENCHMARK(AsyncLoggerConcurrentAppend, numIters) {
+  appendFromProducers(numIters);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
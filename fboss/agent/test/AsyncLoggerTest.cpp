@@ -11,9 +11,17 @@
 #include "fboss/agent/AsyncLogger.h"
 
 #include <folly/CPortability.h>
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
+#include <folly/String.h>
 #include <gtest/gtest.h>
 #include <stdio.h>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 #define TEST_LOG "/tmp/sai_logger_test"
 
 // Test string size that's larger than half of the buffer,
@@ -133,3 +141,52 @@ TEST_F(AsyncLoggerTest, concurrentWaitTest) {
   // Therefore, the flush count should be equal or greater than two.
   EXPECT_GE(asyncLogger->getFlushCount(), 2);
 }
+
+TEST_F(AsyncLoggerTest, oversizedRecordDropped) {
+  std::string str(AsyncLogger::kRingSize, '.');
+  asyncLogger->appendLog(str.c_str(), str.size());
+  EXPECT_EQ(asyncLogger->getDroppedCount(), 1);
+  EXPECT_EQ(asyncLogger->getDroppedBytes(), str.size());
+}
+
+TEST_F(AsyncLoggerTest, concurrentProducersTest) {
+  // Enough records to go around the ring several times
+  constexpr auto kNumThreads = 8;
+  constexpr auto kNumRecords = 2000;
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < kNumThreads; ++i) {
+    threads.emplace_back([&, i]() {
+      for (auto j = 0; j < kNumRecords; ++j) {
+        auto record = folly::to<std::string>(
+            "thread ", i, " record ", j, std::string(j % 512, '.'), "\n");
+        asyncLogger->appendLog(record.c_str(), record.size());
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  asyncLogger->forceFlush();
+  EXPECT_EQ(asyncLogger->getDroppedCount(), 0);
+
+  // Every record should be written out whole and in order per thread
+  std::string contents;
+  ASSERT_TRUE(folly::readFile(TEST_LOG, contents));
+  std::vector<folly::StringPiece> lines;
+  folly::split('\n', contents, lines);
+  std::vector<int> nextRecord(kNumThreads, 0);
+  for (auto line : lines) {
+    if (!line.startsWith("thread ")) {
+      continue;
+    }
+    int thread, record;
+    ASSERT_EQ(sscanf(line.data(), "thread %d record %d", &thread, &record), 2);
+    ASSERT_EQ(record, nextRecord[thread]++);
+    auto expected = folly::to<std::string>(
+        "thread ", thread, " record ", record, std::string(record % 512, '.'));
+    ASSERT_EQ(line, expected);
+  }
+  for (auto i = 0; i < kNumThreads; ++i) {
+    EXPECT_EQ(nextRecord[i], kNumRecords);
+  }
+}
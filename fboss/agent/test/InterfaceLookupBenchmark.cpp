@@ -0,0 +1,134 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/state/Interface.h"
+#include "fboss/agent/state/InterfaceMap.h"
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include <vector>
+
+DEFINE_int32(num_interfaces, 4000, "Number of interfaces in the switch");
+
+using namespace facebook::fboss;
+using folly::IPAddress;
+using folly::IPAddressV4;
+using folly::IPAddressV6;
+
+/*
+ * Compares the interface lookups the packet handlers do for each punted
+ * packet on a published InterfaceMap, which uses its lookup index, against
+ * the same map unpublished, which walks the interfaces.
+ */
+namespace {
+
+std::shared_ptr<InterfaceMap> published;
+std::shared_ptr<InterfaceMap> unpublished;
+// Addresses of packets punted to the CPU, spread over all the interfaces
+std::vector<IPAddress> v4Targets;
+std::vector<IPAddress> v6Targets;
+std::vector<VlanID> vlans;
+
+void init() {
+  published = std::make_shared<InterfaceMap>();
+  for (int i = 1; i <= FLAGS_num_interfaces; ++i) {
+    auto intf = std::make_shared<Interface>(
+        InterfaceID(i),
+        RouterID(0),
+        VlanID(i),
+        folly::to<std::string>("fboss", i),
+        folly::MacAddress("00:02:00:00:00:01"),
+        9000,
+        false, /* is virtual */
+        false /* is state_sync disabled */);
+    auto v4 = IPAddressV4::fromLongHBO((10 << 24) | (i << 8) | 1);
+    auto v6 = IPAddressV6(folly::to<std::string>("2401:db00:", i, "::1"));
+    Interface::Addresses addrs;
+    addrs.emplace(v4, 24);
+    addrs.emplace(v6, 64);
+    addrs.emplace(IPAddress("fe80::1"), 64);
+    intf->setAddresses(addrs);
+    published->addInterface(intf);
+  }
+  unpublished = published->clone();
+  published->publish();
+
+  for (int i = 1; i <= FLAGS_num_interfaces; i += 7) {
+    v4Targets.emplace_back(IPAddressV4::fromLongHBO((10 << 24) | (i << 8) | 1));
+    v4Targets.emplace_back(IPAddressV4::fromLongHBO((10 << 24) | (i << 8) | 9));
+    v6Targets.emplace_back(folly::to<std::string>("2401:db00:", i, "::1"));
+    v6Targets.emplace_back(folly::to<std::string>("2401:db00:", i, "::9"));
+    vlans.emplace_back(i);
+  }
+}
+
+// ARP and IPv4: is the target one of our addresses
+void localAddress(const InterfaceMap& intfs, size_t numIters) {
+  for (size_t n = 0; n < numIters; ++n) {
+    const auto& ip = v4Targets[n % v4Targets.size()];
+    folly::doNotOptimizeAway(intfs.getInterfaceIf(RouterID(0), ip));
+  }
+}
+
+// NDP: which interface can reach the solicited or neighbor address
+void reachAddress(const InterfaceMap& intfs, size_t numIters) {
+  for (size_t n = 0; n < numIters; ++n) {
+    const auto& ip = v6Targets[n % v6Targets.size()];
+    folly::doNotOptimizeAway(intfs.getIntfToReach(RouterID(0), ip));
+  }
+}
+
+// Link local traffic: the interface of the ingress vlan
+void ingressVlan(const InterfaceMap& intfs, size_t numIters) {
+  for (size_t n = 0; n < numIters; ++n) {
+    folly::doNotOptimizeAway(
+        intfs.getInterfaceInVlanIf(vlans[n % vlans.size()]));
+  }
+}
+
+} // namespace
+
+BENCHMARK(LocalAddressWalk, numIters) {
+  localAddress(*unpublished, numIters);
+}
+
+BENCHMARK_RELATIVE(LocalAddressIndexed, numIters) {
+  localAddress(*published, numIters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(ReachAddressWalk, numIters) {
+  reachAddress(*unpublished, numIters);
+}
+
+BENCHMARK_RELATIVE(ReachAddressIndexed, numIters) {
+  reachAddress(*published, numIters);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(IngressVlanWalk, numIters) {
+  ingressVlan(*unpublished, numIters);
+}
+
+BENCHMARK_RELATIVE(IngressVlanIndexed, numIters) {
+  ingressVlan(*published, numIters);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  // Building thousands of interfaces is too slow to do in BENCHMARK_SUSPEND
+  init();
+  folly::runBenchmarks();
+  return 0;
+}
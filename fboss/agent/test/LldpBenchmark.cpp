@@ -0,0 +1,133 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include <boost/cast.hpp>
+
+#include <folly/Benchmark.h>
+#include "fboss/agent/LldpManager.h"
+#include "fboss/agent/SwSwitch.h"
+#include "fboss/agent/TxPacket.h"
+#include "fboss/agent/hw/sim/SimPlatform.h"
+#include "fboss/agent/hw/sim/SimSwitch.h"
+#include "fboss/agent/state/Port.h"
+#include "fboss/agent/state/PortDescriptor.h"
+#include "fboss/agent/state/PortMap.h"
+#include "fboss/agent/state/SwitchState.h"
+
+using namespace facebook::fboss;
+using folly::MacAddress;
+using std::make_unique;
+using std::shared_ptr;
+using std::unique_ptr;
+
+/*
+ * Measures the CPU LLDP takes per LLDP interval on a switch with 512 ports
+ * up: building every frame from scratch and sending it, as LldpManager used
+ * to, against sending the prebuilt per port frames through the
+ * PeriodicTxScheduler.
+ */
+namespace {
+
+constexpr uint32_t kNumPorts = 512;
+
+// Global state used by the benchmarks
+unique_ptr<SwSwitch> sw;
+unique_ptr<LldpManager> lldpManager;
+
+unique_ptr<SwSwitch> setupSwitch() {
+  MacAddress localMac("02:00:01:00:00:01");
+  auto sw =
+      make_unique<SwSwitch>(make_unique<SimPlatform>(localMac, kNumPorts));
+  sw->init(nullptr /* No custom TunManager */);
+
+  auto updateFn = [&](const shared_ptr<SwitchState>& oldState) {
+    auto state = oldState->clone();
+    for (auto port : *oldState->getPorts()) {
+      auto newPort = port->modify(&state);
+      newPort->setAdminState(cfg::PortState::ENABLED);
+      newPort->setOperState(true);
+      newPort->setDescription("uplink to a neighbor switch");
+    }
+    return state;
+  };
+  sw->updateStateBlocking("setup", updateFn);
+  return sw;
+}
+
+void resetTxCount() {
+  SimSwitch* sim = boost::polymorphic_downcast<SimSwitch*>(sw->getHw());
+  sim->resetTxCount();
+}
+
+void checkTxCount(size_t numIters) {
+  // Make sure every port actually sent a frame each interval
+  SimSwitch* sim = boost::polymorphic_downcast<SimSwitch*>(sw->getHw());
+  CHECK_EQ(sim->getTxCount(), numIters * kNumPorts);
+}
+
+} // unnamed namespace
+
+BENCHMARK(LldpIntervalBuildFrames, numIters) {
+  BENCHMARK_SUSPEND {
+    resetTxCount();
+  }
+
+  for (size_t n = 0; n < numIters; ++n) {
+    std::array<char, 64> hostname;
+    gethostname(hostname.data(), hostname.size());
+    hostname[hostname.size() - 1] = '\0';
+    for (const auto& port : *sw->getState()->getPorts()) {
+      auto pkt = LldpManager::createLldpPkt(
+          sw.get(),
+          sw->getPlatform()->getLocalMac(),
+          port->getIngressVlan(),
+          std::string(hostname.data()),
+          port->getName(),
+          port->getDescription(),
+          LldpManager::TTL_TLV_VALUE,
+          LldpManager::SYSTEM_CAPABILITY_ROUTER);
+      sw->sendNetworkControlPacketAsync(
+          std::move(pkt), PortDescriptor(port->getID()));
+    }
+  }
+
+  BENCHMARK_SUSPEND {
+    checkTxCount(numIters);
+  }
+}
+
+BENCHMARK_RELATIVE(LldpIntervalPrebuiltFrames, numIters) {
+  BENCHMARK_SUSPEND {
+    // Build the frames outside of the measured loop
+    lldpManager->sendLldpOnAllPorts();
+    resetTxCount();
+  }
+
+  for (size_t n = 0; n < numIters; ++n) {
+    lldpManager->sendLldpOnAllPorts();
+  }
+
+  BENCHMARK_SUSPEND {
+    checkTxCount(numIters);
+  }
+}
+
+int main(int argc, char** argv) {
+  gflags::ParseCommandLineFlags(&argc, &argv, true);
+
+  // Setting up the switch is fairly expensive, do it once up front
+  sw = setupSwitch();
+  lldpManager = make_unique<LldpManager>(sw.get());
+
+  folly::runBenchmarks();
+
+  lldpManager.reset();
+  sw.reset();
+  return 0;
+}
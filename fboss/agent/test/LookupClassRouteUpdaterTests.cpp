@@ -22,8 +22,10 @@
 #include "fboss/agent/test/HwTestHandle.h"
 #include "fboss/agent/test/TestUtils.h"
 
+#include <folly/Format.h>
 #include <folly/IPAddressV4.h>
 #include <folly/IPAddressV6.h>
+#include <folly/logging/xlog.h>
 
 using folly::IPAddressV4;
 using folly::IPAddressV6;
@@ -274,6 +276,59 @@ class LookupClassRouteUpdaterTest : public ::testing::Test {
     addDelRouteImpl(routePrefix, {});
   }
 
+  // numRoutes distinct prefixes, outside of all the interface subnets
+  std::vector<RoutePrefix<AddrT>> makeRoutePrefixes(
+      uint8_t block,
+      uint16_t numRoutes) const {
+    std::vector<RoutePrefix<AddrT>> prefixes;
+    for (uint32_t i = 0; i < numRoutes; ++i) {
+      if constexpr (std::is_same_v<AddrT, folly::IPAddressV4>) {
+        prefixes.push_back(RoutePrefix<AddrT>{
+            folly::IPAddressV4::fromLongHBO(((100 + block) << 24) | (i << 8)),
+            24});
+      } else {
+        prefixes.push_back(RoutePrefix<AddrT>{
+            folly::IPAddressV6(folly::sformat(
+                "2803:6080:{:x}:{:x}::", static_cast<uint32_t>(block), i)),
+            64});
+      }
+    }
+    return prefixes;
+  }
+
+  // Add several routes with a single RIB update
+  void addRoutes(
+      const std::vector<RoutePrefix<AddrT>>& routePrefixes,
+      const std::vector<AddrT>& nextHops) {
+    CHECK(nextHops.size());
+    RouteNextHopSet nexthops;
+    for (const auto& nextHop : nextHops) {
+      nexthops.emplace(UnresolvedNextHop(nextHop, UCMP_DEFAULT_WEIGHT));
+    }
+    auto routeUpdater = sw_->getRouteUpdater();
+    for (const auto& routePrefix : routePrefixes) {
+      routeUpdater.addRoute(
+          this->kRid(),
+          routePrefix.network(),
+          routePrefix.mask(),
+          this->kClientID(),
+          RouteNextHopEntry(nexthops, AdminDistance::MAX_ADMIN_DISTANCE));
+    }
+    routeUpdater.program();
+    waitForStateUpdates(this->sw_);
+    waitForRibUpdates(sw_);
+    waitForStateUpdates(this->sw_);
+  }
+
+  size_t getNumRoutesReAdded() {
+    size_t numRoutesReAdded = 0;
+    this->verifyStateUpdateAfterNeighborCachePropagation([&]() {
+      numRoutesReAdded =
+          this->sw_->getLookupClassRouteUpdater()->getNumRoutesReAdded();
+    });
+    return numRoutesReAdded;
+  }
+
   void removeNeighbor(const AddrT& ip) {
     this->updateState(
         "Add new route", [=](const std::shared_ptr<SwitchState>& state) {
@@ -1512,4 +1567,33 @@ TYPED_TEST(
   this->blockMacThenIPResolveToSameMacHelper(std::nullopt);
 }
 
+TYPED_TEST(
+    LookupClassRouteUpdaterNoLookupClassTest,
+    ReAddOnlyRoutesInNewSubnetScale) {
+  constexpr uint16_t kNumRoutes = 4000;
+  auto prefixesA = this->makeRoutePrefixes(1, kNumRoutes);
+  auto prefixesD = this->makeRoutePrefixes(2, kNumRoutes);
+  this->addRoutes(prefixesA, {this->kIpAddressA()});
+  this->addRoutes(prefixesD, {this->kIpAddressD()});
+
+  // First subnet cached: routes were not tracked so far, all are walked
+  updateBlockedNeighbor(this->getSw(), {{this->kVlan(), this->kIpAddressA()}});
+  auto numReAddedFirstSubnet = this->getNumRoutesReAdded();
+  EXPECT_GE(numReAddedFirstSubnet, 2 * kNumRoutes);
+
+  // Second subnet cached: only routes with nexthops in it are re-added
+  updateBlockedNeighbor(
+      this->getSw(),
+      {{this->kVlan(), this->kIpAddressA()},
+       {this->kVlan2(), this->kIpAddressD()}});
+  auto numReAddedSecondSubnet =
+      this->getNumRoutesReAdded() - numReAddedFirstSubnet;
+  // Besides the routes via kIpAddressD, only the interface route for its
+  // subnet has a nexthop in it
+  EXPECT_GE(numReAddedSecondSubnet, kNumRoutes);
+  EXPECT_LT(numReAddedSecondSubnet, kNumRoutes + 4);
+
+  updateBlockedNeighbor(this->getSw(), {{}});
+}
+
 } // namespace facebook::fboss
@@ -10,6 +10,7 @@
 
 #include <folly/init/Init.h>
 #include <gtest/gtest.h>
+#include <chrono>
 #include <memory>
 #include "fboss/agent/AgentConfig.h"
 #include "fboss/agent/ApplyThriftConfig.h"
@@ -279,6 +280,46 @@ TEST_F(MultiNodeLacpTest, LinkDown) {
   verifyAcrossWarmBoots(verify);
 }
 
+TEST_F(MultiNodeLacpTest, AllMembersFlapConvergence) {
+  auto verify = [=]() {
+    // Flap every member of every aggregate port on the remote switch at
+    // once, as a peer reboot would, and measure how long it takes for all
+    // aggregate ports to come back up.
+    auto client = getRemoteThriftClient();
+    std::vector<int32_t> remotePorts;
+    for (const auto& aggPort : getAggPorts()) {
+      for (const auto& subPort : getSubPorts(aggPort)) {
+        remotePorts.push_back(getRemotePortID(aggPort, subPort.portID));
+      }
+    }
+
+    XLOG(DBG2) << "Disable all Agg member ports on remote switch";
+    for (auto remotePortID : remotePorts) {
+      client->sync_setPortState(remotePortID, false);
+    }
+    for (const auto& aggPort : getAggPorts()) {
+      waitForAggPortStatus(aggPort, false);
+    }
+
+    XLOG(DBG2) << "Enable all Agg member ports on remote switch";
+    auto begin = std::chrono::steady_clock::now();
+    for (auto remotePortID : remotePorts) {
+      client->sync_setPortState(remotePortID, true);
+    }
+    for (const auto& aggPort : getAggPorts()) {
+      waitForAggPortStatus(aggPort, true);
+    }
+    auto convergenceMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                             std::chrono::steady_clock::now() - begin)
+                             .count();
+    XLOG(INFO) << getAggPorts().size() << " aggregate ports with "
+               << remotePorts.size() << " members converged in "
+               << convergenceMs << "ms";
+    verifyLacpState();
+  };
+  verifyAcrossWarmBoots(verify);
+}
+
 TEST_F(MultiNodeLacpTest, LacpSlowFastInterop) {
   auto setup = [=]() {
     if (isDUT()) {
@@ -0,0 +1,98 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/PublishedSwitchState.h"
+#include "fboss/agent/state/SwitchState.h"
+
+#include <folly/synchronization/Hazptr.h>
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+
+TEST(PublishedSwitchState, EmptyUntilSet) {
+  PublishedSwitchState published;
+  EXPECT_EQ(published.get(), nullptr);
+  EXPECT_FALSE(published.snapshot());
+
+  auto state = std::make_shared<SwitchState>();
+  published.set(state);
+  EXPECT_EQ(published.get(), state);
+  EXPECT_EQ(published.snapshot().get(), state);
+}
+
+TEST(PublishedSwitchState, SnapshotPinsOldState) {
+  PublishedSwitchState published;
+  auto oldState = std::make_shared<SwitchState>();
+  std::weak_ptr<SwitchState> weakOldState = oldState;
+  published.set(std::move(oldState));
+
+  {
+    auto snapshot = published.snapshot();
+    published.set(std::make_shared<SwitchState>());
+    folly::hazptr_cleanup();
+    // Still pinned by the snapshot
+    EXPECT_FALSE(weakOldState.expired());
+    EXPECT_EQ(snapshot.get(), weakOldState.lock());
+    EXPECT_NE(published.get(), snapshot.get());
+  }
+  folly::hazptr_cleanup();
+  EXPECT_TRUE(weakOldState.expired());
+}
+
+TEST(PublishedSwitchState, SetReclaimsOldStates) {
+  PublishedSwitchState published;
+  auto oldState = std::make_shared<SwitchState>();
+  std::weak_ptr<SwitchState> weakOldState = oldState;
+  published.set(std::move(oldState));
+
+  published.set(std::make_shared<SwitchState>());
+  // Reclaimed by the domain rather than set(), hazptr_cleanup() reclaims
+  // everything no snapshot protects
+  folly::hazptr_cleanup();
+  EXPECT_TRUE(weakOldState.expired());
+}
+
+TEST(PublishedSwitchState, DestroyReclaimsStates) {
+  auto state = std::make_shared<SwitchState>();
+  std::weak_ptr<SwitchState> weakState = state;
+  {
+    PublishedSwitchState published;
+    published.set(std::move(state));
+  }
+  folly::hazptr_cleanup();
+  EXPECT_TRUE(weakState.expired());
+}
+
+TEST(PublishedSwitchState, ConcurrentReadsAndSets) {
+  PublishedSwitchState published;
+  published.set(std::make_shared<SwitchState>());
+  std::atomic<bool> done{false};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&] {
+      while (!done) {
+        auto snapshot = published.snapshot();
+        EXPECT_TRUE(snapshot);
+        EXPECT_EQ(snapshot->getGeneration(), 0);
+      }
+    });
+  }
+  for (int i = 0; i < 10000; ++i) {
+    published.set(std::make_shared<SwitchState>());
+  }
+  done = true;
+  for (auto& reader : readers) {
+    reader.join();
+  }
+}
@@ -14,10 +14,15 @@
 
 #include "fboss/agent/state/SwitchState.h"
 
+#include "folly/Conv.h"
 #include "folly/io/Cursor.h"
 
+#include <gflags/gflags.h>
 #include <gtest/gtest.h>
 
+#include <atomic>
+#include <chrono>
+
 namespace {
 using namespace facebook::fboss;
 using folly::IPAddressV4;
@@ -107,7 +112,30 @@ class ResolvedNexthopMonitorTest : public ::testing::Test {
     runInUpdateEventBaseAndWait([]() {});
   }
 
+  void useFakeClock() {
+    sw_->getResolvedNexthopProbeScheduler()->setClockForTesting([this]() {
+      return ResolvedNexthopProbeScheduler::Clock::time_point(
+          std::chrono::milliseconds(fakeNowMs_.load()));
+    });
+  }
+
+  void advanceFakeClockTo(std::chrono::milliseconds now) {
+    fakeNowMs_ = now.count();
+    sw_->getResolvedNexthopProbeScheduler()->runWheelForTesting();
+  }
+
+  RouteNextHopSet makeNexthops(int count) {
+    RouteNextHopSet nhops;
+    for (auto i = 0; i < count; i++) {
+      nhops.emplace(UnresolvedNextHop(
+          IPAddressV4(folly::to<std::string>("10.0.0.", 100 + i)), 1));
+    }
+    return nhops;
+  }
+
  protected:
+  // declared ahead of switch as its probe scheduler reads fake clock
+  std::atomic<int64_t> fakeNowMs_{0};
   std::unique_ptr<HwTestHandle> handle_;
   SwSwitch* sw_;
 };
@@ -608,4 +636,106 @@ TEST_F(ResolvedNexthopMonitorTest, ProbeTriggeredOnEntryRemoveV6) {
   EXPECT_EQ(entry->isPending(), true);
 }
 
+TEST_F(ResolvedNexthopMonitorTest, ProbesSpreadOverWindow) {
+  using std::chrono::milliseconds;
+  useFakeClock();
+  auto scheduler = sw_->getResolvedNexthopProbeScheduler();
+  auto tick = milliseconds(FLAGS_resolved_nexthop_probe_tick_ms);
+  uint64_t windowTicks =
+      FLAGS_resolved_nexthop_probe_window_ms / tick.count(); // 10 by default
+
+  addRoute(kPrefixV4, makeNexthops(windowTicks));
+  schedulePendingStateUpdates();
+  // one probe per tick, first one goes out right away
+  EXPECT_EQ(scheduler->getProbesSent(), 1);
+  for (uint64_t i = 1; i < windowTicks; i++) {
+    advanceFakeClockTo(i * tick);
+    EXPECT_EQ(scheduler->getProbesSent(), i + 1);
+  }
+  EXPECT_EQ(scheduler->getProbesDeferred(), 0);
+
+  waitForBackgroundAndNeighborCacheThreads();
+  schedulePendingStateUpdates();
+  // every probe created a pending entry, neighbor cache probes from now on
+  EXPECT_EQ(scheduler->getProbesSuppressed(), windowTicks);
+  advanceFakeClockTo(milliseconds(60000));
+  EXPECT_EQ(scheduler->getProbesSent(), windowTicks);
+}
+
+TEST_F(ResolvedNexthopMonitorTest, ProbeBackoff) {
+  using std::chrono::milliseconds;
+  useFakeClock();
+  auto scheduler = sw_->getResolvedNexthopProbeScheduler();
+  auto tick = milliseconds(FLAGS_resolved_nexthop_probe_tick_ms);
+  RouteNextHopSet nhops{UnresolvedNextHop(folly::IPAddressV4("10.0.0.22"), 1)};
+  addRoute(kPrefixV4, nhops);
+  schedulePendingStateUpdates();
+  waitForBackgroundAndNeighborCacheThreads();
+  schedulePendingStateUpdates();
+  EXPECT_EQ(scheduler->getProbesSent(), 1);
+  EXPECT_EQ(scheduler->getProbesSuppressed(), 1);
+
+  // no probes while pending entry exists
+  advanceFakeClockTo(milliseconds(5000));
+  EXPECT_EQ(scheduler->getProbesSent(), 1);
+
+  // neighbor cache keeps its pending entry, so probes that follow do not
+  // create another one and next hop stays unresolved
+  updateState("remove neighbor", [](const std::shared_ptr<SwitchState> state) {
+    auto newState = state->clone();
+    auto vlan = state->getVlans()->getVlan(VlanID(1));
+    auto arpTable = vlan->getArpTable()->modify(VlanID(1), &newState);
+    arpTable->removeEntry(folly::IPAddressV4("10.0.0.22"));
+    return newState;
+  });
+  schedulePendingStateUpdates();
+  // resumed probe was due a second after first one
+  EXPECT_EQ(scheduler->getProbesSent(), 2);
+
+  // backoff doubles after every probe until it reaches ten seconds
+  auto now = milliseconds(5000);
+  uint64_t sent = 2;
+  for (auto backoff : {2000, 4000, 8000, 10000, 10000}) {
+    now += milliseconds(backoff);
+    advanceFakeClockTo(now - tick);
+    EXPECT_EQ(scheduler->getProbesSent(), sent);
+    advanceFakeClockTo(now);
+    EXPECT_EQ(scheduler->getProbesSent(), ++sent);
+  }
+  EXPECT_EQ(scheduler->getProbesSuppressed(), 1);
+}
+
+class ResolvedNexthopProbeBurstTest : public ResolvedNexthopMonitorTest {
+ public:
+  void SetUp() override {
+    // start all probes in the same tick and send only a few per tick
+    FLAGS_resolved_nexthop_probe_window_ms = 0;
+    FLAGS_resolved_nexthop_probes_per_tick = 4;
+    ResolvedNexthopMonitorTest::SetUp();
+  }
+
+ private:
+  gflags::FlagSaver flagSaver_;
+};
+
+TEST_F(ResolvedNexthopProbeBurstTest, ProbesDeferred) {
+  using std::chrono::milliseconds;
+  useFakeClock();
+  auto scheduler = sw_->getResolvedNexthopProbeScheduler();
+  auto tick = milliseconds(FLAGS_resolved_nexthop_probe_tick_ms);
+
+  addRoute(kPrefixV4, makeNexthops(10));
+  schedulePendingStateUpdates();
+  EXPECT_EQ(scheduler->getProbesSent(), 4);
+  EXPECT_EQ(scheduler->getProbesDeferred(), 0);
+
+  advanceFakeClockTo(tick);
+  EXPECT_EQ(scheduler->getProbesSent(), 8);
+  EXPECT_EQ(scheduler->getProbesDeferred(), 6);
+
+  advanceFakeClockTo(2 * tick);
+  EXPECT_EQ(scheduler->getProbesSent(), 10);
+  EXPECT_EQ(scheduler->getProbesDeferred(), 8);
+}
+
 } // namespace facebook::fboss
@@ -9,8 +9,15 @@
  */
 #include <folly/Benchmark.h>
 #include <folly/Random.h>
+#include <folly/memory/MallctlHelper.h>
+#include <folly/memory/Malloc.h>
+#include "fboss/agent/Utils.h"
+#include "fboss/agent/rib/FibUpdateHelpers.h"
+#include "fboss/agent/rib/RoutingInformationBase.h"
 #include "fboss/agent/state/RouteNextHopEntry.h"
 
+#include <malloc.h>
+
 using namespace facebook::fboss;
 using folly::IPAddress;
 
@@ -23,6 +30,38 @@ static constexpr int kRSWNumPaths = 8;
 static constexpr int kFSWNumPaths = 36;
 static constexpr int kRSWNumRoutes = 10000;
 static constexpr int kFSWNumRoutes = 30000;
+
+// bytes currently allocated by this process, as reported by the allocator
+size_t allocatedBytes() {
+  if (folly::usingJEMalloc()) {
+    // refresh jemalloc's cached stats
+    folly::mallctlWrite<uint64_t>("epoch", 1);
+    size_t allocated = 0;
+    folly::mallctlRead("stats.allocated", &allocated);
+    return allocated;
+  }
+  return mallinfo2().uordblks;
+}
+
+int64_t allocatedKbSince(size_t before) {
+  return (static_cast<int64_t>(allocatedBytes()) -
+          static_cast<int64_t>(before)) /
+      1024;
+}
+
+RouteNextHopSet makeNextHopGroup(bool linkLocal) {
+  RouteNextHopSet nhops;
+  for (auto pathIndex = 10; pathIndex < 10 + kFSWNumPaths; ++pathIndex) {
+    std::string nhAddrStr = linkLocal
+        ? fmt::format("fe80::{}", pathIndex)
+        : fmt::format("2401:db{}:e112:9103:1028::01", pathIndex);
+    nhops.emplace(ResolvedNextHop(
+        folly::IPAddress(nhAddrStr),
+        InterfaceID(pathIndex),
+        1 + folly::Random::rand32() % kNumSSWs));
+  }
+  return nhops;
+}
 } // namespace
 
 void RouteNextHopEntryScaleOptimized(
@@ -66,11 +105,139 @@ void RouteNextHopEntryScaleOptimizedFSW(uint32_t /* iters */, bool optimized) {
       optimized, kFSWEcmpWidth, kFSWNumPaths, kFSWNumRoutes);
 }
 
+/*
+ * Routes spread over a small number of distinct next hop sets, normalized
+ * the way FIB sync and SAI programming do it, keeping the result per route
+ * as forwarding state does. With interning each route carries a pointer to
+ * its shared set, as Route::getForwardInfo() does, and normalization runs
+ * once per distinct set. Without it every route rebuilds its set from thrift
+ * and keeps its own normalized copy.
+ */
+void RouteNextHopEntrySharedSets(
+    folly::UserCounters& counters,
+    bool interned,
+    int numRoutes,
+    int numGroups) {
+  std::vector<std::pair<state::RouteNextHopEntry, InternedNextHopSetPtr>>
+      routes;
+  std::vector<InternedNextHopSetPtr> internedNormalized;
+  std::vector<RouteNextHopSet> normalized;
+  size_t allocatedBefore = 0;
+  FLAGS_optimized_ucmp = true;
+  FLAGS_ecmp_width = kFSWEcmpWidth;
+  BENCHMARK_SUSPEND {
+    std::vector<InternedNextHopSetPtr> groups;
+    for (auto group = 0; group < numGroups; ++group) {
+      groups.push_back(InternedNextHopSet::intern(makeNextHopGroup(false)));
+    }
+    for (auto routeIndex = 0; routeIndex < numRoutes; ++routeIndex) {
+      auto& group = groups[routeIndex % numGroups];
+      routes.emplace_back(
+          RouteNextHopEntry(group, kDefaultAdminDistance).toThrift(),
+          interned ? group : nullptr);
+    }
+    internedNormalized.reserve(numRoutes);
+    normalized.reserve(numRoutes);
+    allocatedBefore = allocatedBytes();
+  }
+
+  for (const auto& [thrift, group] : routes) {
+    RouteNextHopEntry entry(thrift, group);
+    if (interned) {
+      internedNormalized.push_back(entry.internedNormalizedNextHops());
+    } else {
+      normalized.push_back(
+          RouteNextHopEntry::normalizeNextHops(entry.getNextHopSet()));
+    }
+  }
+
+  BENCHMARK_SUSPEND {
+    // memory retained by the normalized next hops of all routes
+    counters["normalized_nhops_kb"] = allocatedKbSince(allocatedBefore);
+    counters["interned_sets"] = InternedNextHopSet::numInterned();
+    routes.clear();
+    internedNormalized.clear();
+    normalized.clear();
+  }
+}
+
+/*
+ * Program routes spread over a small number of distinct next hop sets into
+ * the RIB, covering route insertion and next hop resolution. Link local next
+ * hops resolve through their interface, so no interface routes are needed.
+ */
+void RibUpdateSharedSets(
+    folly::UserCounters& counters,
+    int numRoutes,
+    int numGroups) {
+  std::unique_ptr<RoutingInformationBase> rib;
+  std::vector<UnicastRoute> routes;
+  size_t allocatedBefore = 0;
+  FLAGS_optimized_ucmp = true;
+  FLAGS_ecmp_width = kFSWEcmpWidth;
+  BENCHMARK_SUSPEND {
+    std::vector<std::vector<NextHopThrift>> groups;
+    for (auto group = 0; group < numGroups; ++group) {
+      auto& nhops = groups.emplace_back();
+      for (const auto& nhop : makeNextHopGroup(true)) {
+        nhops.push_back(nhop.toThrift());
+      }
+    }
+    for (auto routeIndex = 0; routeIndex < numRoutes; ++routeIndex) {
+      UnicastRoute route;
+      route.dest() = toIpPrefix(
+          {folly::IPAddress(fmt::format(
+               "2401:db00:{:x}:{:x}::",
+               routeIndex / 0x10000,
+               routeIndex % 0x10000)),
+           64});
+      route.nextHops() = groups[routeIndex % numGroups];
+      routes.push_back(std::move(route));
+    }
+    rib = std::make_unique<RoutingInformationBase>();
+    rib->ensureVrf(RouterID(0));
+    allocatedBefore = allocatedBytes();
+  }
+
+  rib->update(
+      RouterID(0),
+      ClientID::BGPD,
+      kDefaultAdminDistance,
+      routes,
+      {},
+      false,
+      "benchmark",
+      noopFibUpdate,
+      nullptr);
+
+  BENCHMARK_SUSPEND {
+    // memory held by the RIB for the routes and their resolved next hops
+    counters["rib_kb"] = allocatedKbSince(allocatedBefore);
+    counters["interned_sets"] = InternedNextHopSet::numInterned();
+    rib.reset();
+    routes.clear();
+  }
+}
+
 BENCHMARK_PARAM(RouteNextHopEntryScaleOptimizedRSW, true);
 BENCHMARK_PARAM(RouteNextHopEntryScaleOptimizedRSW, false);
 BENCHMARK_PARAM(RouteNextHopEntryScaleOptimizedFSW, true);
 BENCHMARK_PARAM(RouteNextHopEntryScaleOptimizedFSW, false);
 
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_COUNTERS(RouteNextHopEntrySharedSetsNormalize, counters) {
+  RouteNextHopEntrySharedSets(counters, false, kFSWNumRoutes, kNumSSWs);
+}
+
+BENCHMARK_COUNTERS(RouteNextHopEntrySharedSetsInterned, counters) {
+  RouteNextHopEntrySharedSets(counters, true, kFSWNumRoutes, kNumSSWs);
+}
+
+BENCHMARK_COUNTERS(RibUpdateSharedSets, counters) {
+  RibUpdateSharedSets(counters, kFSWNumRoutes, kNumSSWs);
+}
+
 int main(int argc, char** argv) {
   gflags::ParseCommandLineFlags(&argc, &argv, true);
   folly::runBenchmarks();
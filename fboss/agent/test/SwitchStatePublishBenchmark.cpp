@@ -0,0 +1,152 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#include "fboss/agent/PublishedSwitchState.h"
+#include "fboss/agent/state/SwitchState.h"
+
+#include <folly/Benchmark.h>
+#include <folly/SpinLock.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+DEFINE_int32(
+    num_reader_threads,
+    8,
+    "Number of threads reading the switch state concurrently");
+
+using namespace facebook::fboss;
+
+/*
+ * Compares reading and publishing the applied switch state through
+ * PublishedSwitchState against the spinlock protected shared_ptr SwSwitch
+ * used to keep it in.
+ */
+namespace {
+
+class SpinLockSwitchState {
+ public:
+  std::shared_ptr<SwitchState> get() const {
+    std::unique_lock guard(lock_);
+    return state_;
+  }
+  void set(std::shared_ptr<SwitchState> state) {
+    std::unique_lock guard(lock_);
+    state_.swap(state);
+  }
+
+ private:
+  mutable folly::SpinLock lock_;
+  std::shared_ptr<SwitchState> state_;
+};
+
+std::shared_ptr<SwitchState> makeState() {
+  auto state = std::make_shared<SwitchState>();
+  state->publish();
+  return state;
+}
+
+// What a packet handler does with the state, minus the actual lookups
+void readLocked(const SpinLockSwitchState& holder) {
+  auto state = holder.get();
+  folly::doNotOptimizeAway(state->getGeneration());
+}
+
+void readCopy(const PublishedSwitchState& holder) {
+  auto state = holder.get();
+  folly::doNotOptimizeAway(state->getGeneration());
+}
+
+void readSnapshot(const PublishedSwitchState& holder) {
+  auto snapshot = holder.snapshot();
+  folly::doNotOptimizeAway(snapshot->getGeneration());
+}
+
+template <typename Holder, typename ReadFn>
+void concurrentReads(size_t numIters, ReadFn read) {
+  Holder holder;
+  BENCHMARK_SUSPEND {
+    holder.set(makeState());
+  }
+  std::vector<std::thread> readers;
+  auto readsPerThread = numIters / FLAGS_num_reader_threads + 1;
+  for (int i = 0; i < FLAGS_num_reader_threads; ++i) {
+    readers.emplace_back([&holder, &read, readsPerThread] {
+      for (size_t n = 0; n < readsPerThread; ++n) {
+        read(holder);
+      }
+    });
+  }
+  for (auto& reader : readers) {
+    reader.join();
+  }
+}
+
+template <typename Holder, typename ReadFn>
+void publishUnderReads(size_t numIters, ReadFn read) {
+  Holder holder;
+  std::vector<std::shared_ptr<SwitchState>> states;
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  BENCHMARK_SUSPEND {
+    states = {makeState(), makeState()};
+    holder.set(states[0]);
+    for (int i = 0; i < FLAGS_num_reader_threads; ++i) {
+      readers.emplace_back([&holder, &read, &done] {
+        while (!done.load(std::memory_order_relaxed)) {
+          read(holder);
+        }
+      });
+    }
+  }
+
+  for (size_t n = 0; n < numIters; ++n) {
+    holder.set(states[n & 1]);
+  }
+
+  BENCHMARK_SUSPEND {
+    done = true;
+    for (auto& reader : readers) {
+      reader.join();
+    }
+  }
+}
+
+} // namespace
+
+BENCHMARK(ReadSpinLock, numIters) {
+  concurrentReads<SpinLockSwitchState>(numIters, readLocked);
+}
+
+BENCHMARK_RELATIVE(ReadPublishedCopy, numIters) {
+  concurrentReads<PublishedSwitchState>(numIters, readCopy);
+}
+
+BENCHMARK_RELATIVE(ReadPublishedSnapshot, numIters) {
+  concurrentReads<PublishedSwitchState>(numIters, readSnapshot);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK(PublishSpinLock, numIters) {
+  publishUnderReads<SpinLockSwitchState>(numIters, readLocked);
+}
+
+BENCHMARK_RELATIVE(PublishPublishedSnapshot, numIters) {
+  publishUnderReads<PublishedSwitchState>(numIters, readSnapshot);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,262 @@
+// Copyright 2004-present Facebook. All Rights Reserved.
+
+#pragma once
+
+#include "fboss/fsdb/client/FsdbDeltaSubscriber.h"
+#include "fboss/fsdb/client/FsdbStateSubscriber.h"
+#include "fboss/fsdb/if/gen-cpp2/fsdb_oper_types.h"
+#include "fboss/thrift_cow/visitors/DeltaVisitor.h"
+#include "fboss/thrift_storage/CowStorage.h"
+
+#include <folly/Synchronized.h>
+#include <folly/concurrency/AtomicSharedPtr.h>
+#include <folly/logging/xlog.h>
+
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss::fsdb {
+
+/*
+ * FsdbStorageReplica keeps a local CowStorage<Root> copy of the state under
+ * a subscribed path, instead of handing raw OperDelta/OperState updates to
+ * the subscriber.
+ *
+ * Deltas are applied with CowStorage::patch on top of the last published
+ * root, so unchanged subtrees are shared between consecutive snapshots and
+ * readers never have to deserialize the full state. The current snapshot
+ * is published through an atomic shared_ptr: getSnapshot() is lock free and
+ * the returned root stays valid (and immutable) for as long as the caller
+ * holds on to it.
+ *
+ * Consumers that only care about parts of the tree can register change
+ * callbacks filtered by path. After each update, the old and new roots are
+ * compared with thrift_cow::DeltaVisitor, which only descends into subtrees
+ * that actually changed, and callbacks whose path overlaps a changed path
+ * are fired with both snapshots.
+ *
+ * Usage:
+ *   FsdbStorageReplica<state::SwitchState> replica({"agent", "switchState"});
+ *   pubSubMgr->addStateDeltaSubscription(
+ *       replica.basePath(), stateChangeCb, replica.operDeltaCb());
+ *
+ * The replica handles both raw and compact unit paths.
+ *
+ * Updates are expected to come from a single subscriber stream, callbacks
+ * are invoked on that stream's thread.
+ */
+template <typename Root>
+class FsdbStorageReplica {
+ public:
+  using ReplicaStorage = CowStorage<Root>;
+  using StorageImpl = typename ReplicaStorage::StorageImpl;
+  using Snapshot = std::shared_ptr<const StorageImpl>;
+  using ChangeCb = std::function<void(
+      const std::vector<std::vector<std::string>>& changedPaths,
+      const Snapshot& oldRoot,
+      const Snapshot& newRoot)>;
+  using CallbackHandle = uint64_t;
+
+  explicit FsdbStorageReplica(std::vector<std::string> basePath)
+      : basePath_(std::move(basePath)) {
+    auto root = std::make_shared<StorageImpl>();
+    root->publish();
+    root_.store(std::move(root));
+  }
+
+  const std::vector<std::string>& basePath() const {
+    return basePath_;
+  }
+
+  Snapshot getSnapshot() const {
+    return root_.load();
+  }
+
+  /*
+   * Fire cb whenever something at, above or below path changes. An empty
+   * path matches every change.
+   */
+  CallbackHandle addChangeCallback(std::vector<std::string> path, ChangeCb cb) {
+    auto handle = nextCallbackHandle_++;
+    callbacks_.wlock()->emplace(
+        handle,
+        std::make_shared<const PathCallback>(
+            PathCallback{std::move(path), std::move(cb)}));
+    return handle;
+  }
+
+  void removeChangeCallback(CallbackHandle handle) {
+    callbacks_.wlock()->erase(handle);
+  }
+
+  FsdbDeltaSubscriber::FsdbOperDeltaUpdateCb operDeltaCb() {
+    return [this](OperDelta&& delta) { applyDelta(std::move(delta)); };
+  }
+
+  FsdbStateSubscriber::FsdbOperStateUpdateCb operStateCb() {
+    return [this](OperState&& state) { applyState(std::move(state)); };
+  }
+
+  /*
+   * Apply a delta whose unit paths are rooted at the fsdb root, as sent to
+   * delta subscribers. Units outside of basePath() are ignored. If any unit
+   * fails to apply, the whole delta is dropped and the replica keeps serving
+   * the previous snapshot.
+   */
+  void applyDelta(OperDelta&& delta) {
+    auto oldRoot = root_.load();
+    ReplicaStorage storage(oldRoot);
+    std::vector<OperDeltaUnit> units;
+    units.reserve(delta.changes()->size());
+    for (auto& unit : *delta.changes()) {
+      if (unit.compactPath()) {
+        // already relative to basePath(), see CompactPathCodec
+        units.push_back(std::move(unit));
+        continue;
+      }
+      auto& rawPath = *unit.path()->raw();
+      if (!stripBasePath(rawPath)) {
+        XLOG(DBG2) << "Ignoring delta outside of replica path: "
+                   << folly::join('/', rawPath);
+        ++numIgnoredUnits_;
+        continue;
+      }
+      units.push_back(std::move(unit));
+    }
+    delta.changes() = std::move(units);
+    if (auto error = storage.patch(delta)) {
+      XLOG(ERR) << "Failed to apply delta to replica of "
+                << folly::join('/', basePath_) << ": "
+                << static_cast<int>(*error);
+      ++numErrors_;
+      return;
+    }
+    publish(std::move(oldRoot), storage);
+  }
+
+  /*
+   * Replace the replica with a full state at basePath(), as sent to path
+   * subscribers.
+   */
+  void applyState(OperState&& state) {
+    auto oldRoot = root_.load();
+    ReplicaStorage storage(oldRoot);
+    if (!state.contents()) {
+      storage = ReplicaStorage(std::make_shared<StorageImpl>());
+    } else if (
+        auto error = storage.set_encoded(std::vector<std::string>{}, state)) {
+      XLOG(ERR) << "Failed to apply state to replica of "
+                << folly::join('/', basePath_) << ": "
+                << static_cast<int>(*error);
+      ++numErrors_;
+      return;
+    }
+    publish(std::move(oldRoot), storage);
+  }
+
+  uint64_t numUpdates() const {
+    return numUpdates_;
+  }
+  uint64_t numErrors() const {
+    return numErrors_;
+  }
+  uint64_t numIgnoredUnits() const {
+    return numIgnoredUnits_;
+  }
+
+ private:
+  struct PathCallback {
+    std::vector<std::string> path;
+    ChangeCb cb;
+  };
+
+  bool stripBasePath(std::vector<std::string>& path) const {
+    if (path.size() < basePath_.size() ||
+        !std::equal(basePath_.begin(), basePath_.end(), path.begin())) {
+      return false;
+    }
+    path.erase(path.begin(), path.begin() + basePath_.size());
+    return true;
+  }
+
+  static bool pathsOverlap(
+      const std::vector<std::string>& a,
+      const std::vector<std::string>& b) {
+    auto len = std::min(a.size(), b.size());
+    return std::equal(a.begin(), a.begin() + len, b.begin());
+  }
+
+  void publish(
+      std::shared_ptr<StorageImpl> oldRoot,
+      ReplicaStorage& storage) {
+    storage.publish();
+    auto newRoot = storage.root();
+    root_.store(newRoot);
+    ++numUpdates_;
+    if (newRoot != oldRoot) {
+      notifyChanges(oldRoot, newRoot);
+    }
+  }
+
+  void notifyChanges(
+      const std::shared_ptr<StorageImpl>& oldRoot,
+      const std::shared_ptr<StorageImpl>& newRoot) {
+    std::vector<std::shared_ptr<const PathCallback>> callbacks;
+    {
+      auto locked = callbacks_.rlock();
+      if (locked->empty()) {
+        return;
+      }
+      for (const auto& [handle, callback] : *locked) {
+        callbacks.push_back(callback);
+      }
+    }
+
+    std::vector<std::vector<std::string>> changedPaths;
+    thrift_cow::RootDeltaVisitor::visit(
+        oldRoot,
+        newRoot,
+        thrift_cow::DeltaVisitMode::MINIMAL,
+        [&](const std::vector<std::string>& path,
+            auto&& /* oldNode */,
+            auto&& /* newNode */,
+            thrift_cow::DeltaElemTag /* tag */) {
+          changedPaths.push_back(path);
+        });
+    if (changedPaths.empty()) {
+      return;
+    }
+
+    Snapshot oldSnapshot = oldRoot;
+    Snapshot newSnapshot = newRoot;
+    std::vector<std::vector<std::string>> matchedPaths;
+    for (const auto& callback : callbacks) {
+      matchedPaths.clear();
+      for (const auto& changedPath : changedPaths) {
+        if (pathsOverlap(changedPath, callback->path)) {
+          matchedPaths.push_back(changedPath);
+        }
+      }
+      if (!matchedPaths.empty()) {
+        callback->cb(matchedPaths, oldSnapshot, newSnapshot);
+      }
+    }
+  }
+
+  const std::vector<std::string> basePath_;
+  folly::atomic_shared_ptr<StorageImpl> root_;
+  folly::Synchronized<
+      std::map<CallbackHandle, std::shared_ptr<const PathCallback>>>
+      callbacks_;
+  std::atomic<CallbackHandle> nextCallbackHandle_{0};
+  std::atomic<uint64_t> numUpdates_{0};
+  std::atomic<uint64_t> numErrors_{0};
+  std::atomic<uint64_t> numIgnoredUnits_{0};
+};
+
+} // namespace facebook::fboss::fsdb
@@ -0,0 +1,171 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "fboss/fsdb/client/FsdbStorageReplica.h"
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_fatal_types.h"
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_types.h"
+#include "fboss/thrift_cow/nodes/Serializer.h"
+
+DEFINE_int32(
+    replica_map_size,
+    10000,
+    "Number of entries in the map published by the stand-in publisher");
+DEFINE_int32(
+    replica_changes_per_delta,
+    10,
+    "Number of map entries changed by each published delta");
+
+using namespace facebook::fboss;
+using namespace facebook::fboss::fsdb;
+
+namespace {
+
+using StructTC = apache::thrift::type_class::structure;
+
+const std::vector<std::string> kBasePath = {"agent", "test"};
+
+/*
+ * Stand-in for a publisher: owns the authoritative state and produces the
+ * updates fsdb would stream to delta and path subscribers.
+ */
+class StandInPublisher {
+ public:
+  StandInPublisher() {
+    for (int i = 0; i < FLAGS_replica_map_size; ++i) {
+      state_.structMap()->emplace(i, makeSimple(i));
+    }
+  }
+
+  OperDelta fullSyncDelta() const {
+    OperDeltaUnit unit;
+    unit.path()->raw() = kBasePath;
+    unit.newState() =
+        thrift_cow::serialize<StructTC>(OperProtocol::BINARY, state_);
+    return makeDelta({std::move(unit)});
+  }
+
+  // change a few random map entries and return the corresponding delta
+  OperDelta nextDelta() {
+    std::vector<OperDeltaUnit> units;
+    for (int i = 0; i < FLAGS_replica_changes_per_delta; ++i) {
+      auto key = folly::Random::rand32(FLAGS_replica_map_size);
+      auto value = makeSimple(++generation_);
+      (*state_.structMap())[key] = value;
+      OperDeltaUnit unit;
+      unit.path()->raw() = kBasePath;
+      unit.path()->raw()->emplace_back("structMap");
+      unit.path()->raw()->emplace_back(folly::to<std::string>(key));
+      unit.newState() =
+          thrift_cow::serialize<StructTC>(OperProtocol::BINARY, value);
+      units.push_back(std::move(unit));
+    }
+    return makeDelta(std::move(units));
+  }
+
+  // what a path subscriber receives for the same update
+  OperState currentState() const {
+    OperState state;
+    state.contents() =
+        thrift_cow::serialize<StructTC>(OperProtocol::BINARY, state_);
+    state.protocol() = OperProtocol::BINARY;
+    return state;
+  }
+
+ private:
+  static TestStructSimple makeSimple(int val) {
+    TestStructSimple simple;
+    simple.min() = val;
+    simple.max() = val;
+    return simple;
+  }
+
+  static OperDelta makeDelta(std::vector<OperDeltaUnit> units) {
+    OperDelta delta;
+    delta.changes() = std::move(units);
+    delta.protocol() = OperProtocol::BINARY;
+    return delta;
+  }
+
+  TestStruct state_;
+  int generation_{0};
+};
+
+void applyDeltas(uint32_t iters, int numCallbacks) {
+  std::optional<StandInPublisher> publisher;
+  std::optional<FsdbStorageReplica<TestStruct>> replica;
+  std::vector<OperDelta> deltas;
+  size_t numChanges = 0;
+  BENCHMARK_SUSPEND {
+    publisher.emplace();
+    replica.emplace(kBasePath);
+    replica->applyDelta(publisher->fullSyncDelta());
+    for (int i = 0; i < numCallbacks; ++i) {
+      replica->addChangeCallback(
+          {"structMap", folly::to<std::string>(i)},
+          [&](const auto& paths, const auto&, const auto&) {
+            numChanges += paths.size();
+          });
+    }
+    deltas.reserve(iters);
+    for (uint32_t i = 0; i < iters; ++i) {
+      deltas.push_back(publisher->nextDelta());
+    }
+  }
+  for (auto& delta : deltas) {
+    replica->applyDelta(std::move(delta));
+  }
+  folly::doNotOptimizeAway(numChanges);
+  BENCHMARK_SUSPEND {
+    replica.reset();
+    publisher.reset();
+    deltas.clear();
+  }
+}
+
+// baseline: path subscriber deserializing the full state on every update
+void deserializeFullState(uint32_t iters) {
+  std::optional<StandInPublisher> publisher;
+  std::vector<OperState> states;
+  BENCHMARK_SUSPEND {
+    publisher.emplace();
+    states.reserve(iters);
+    for (uint32_t i = 0; i < iters; ++i) {
+      publisher->nextDelta();
+      states.push_back(publisher->currentState());
+    }
+  }
+  for (const auto& state : states) {
+    auto root = thrift_cow::deserialize<StructTC, TestStruct>(
+        *state.protocol(), *state.contents());
+    folly::doNotOptimizeAway(root);
+  }
+  BENCHMARK_SUSPEND {
+    publisher.reset();
+    states.clear();
+  }
+}
+
+} // namespace
+
+BENCHMARK(DeserializeFullState, iters) {
+  deserializeFullState(iters);
+}
+
+BENCHMARK_RELATIVE(ReplicaApplyDelta, iters) {
+  applyDeltas(iters, 0);
+}
+
+BENCHMARK_RELATIVE(ReplicaApplyDelta100Callbacks, iters) {
+  applyDeltas(iters, 100);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,152 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#include "fboss/fsdb/client/FsdbStorageReplica.h"
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_fatal_types.h"
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_types.h"
+#include "fboss/thrift_cow/nodes/Serializer.h"
+
+#include <gtest/gtest.h>
+
+namespace facebook::fboss::fsdb::test {
+
+namespace {
+
+const std::vector<std::string> kBasePath = {"agent", "test"};
+
+template <typename TC, typename TType>
+OperDeltaUnit makeUnit(
+    const std::vector<std::string>& path,
+    const std::optional<TType>& newState) {
+  OperDeltaUnit unit;
+  std::vector<std::string> fullPath = kBasePath;
+  fullPath.insert(fullPath.end(), path.begin(), path.end());
+  unit.path()->raw() = fullPath;
+  if (newState) {
+    unit.newState() =
+        thrift_cow::serialize<TC>(OperProtocol::BINARY, *newState);
+  }
+  return unit;
+}
+
+OperDelta makeDelta(std::vector<OperDeltaUnit> units) {
+  OperDelta delta;
+  delta.changes() = std::move(units);
+  delta.protocol() = OperProtocol::BINARY;
+  return delta;
+}
+
+TestStructSimple makeSimple(int min, int max) {
+  TestStructSimple simple;
+  simple.min() = min;
+  simple.max() = max;
+  return simple;
+}
+
+using StructTC = apache::thrift::type_class::structure;
+using StringTC = apache::thrift::type_class::string;
+
+} // namespace
+
+TEST(FsdbStorageReplicaTest, applyDelta) {
+  FsdbStorageReplica<TestStruct> replica(kBasePath);
+  auto initial = replica.getSnapshot();
+
+  replica.applyDelta(makeDelta(
+      {makeUnit<StructTC>(
+           {"structMap", "3"}, std::optional(makeSimple(1, 2))),
+       makeUnit<StringTC>({"name"}, std::optional<std::string>("foo"))}));
+
+  auto snapshot = replica.getSnapshot();
+  EXPECT_NE(snapshot, initial);
+  EXPECT_TRUE(snapshot->isPublished());
+  EXPECT_EQ(*snapshot->toThrift().name(), "foo");
+  EXPECT_EQ(snapshot->toThrift().structMap()->at(3), makeSimple(1, 2));
+  // previous snapshot is untouched
+  EXPECT_TRUE(initial->toThrift().structMap()->empty());
+
+  replica.applyDelta(makeDelta({makeUnit<StructTC, TestStructSimple>(
+      {"structMap", "3"}, std::nullopt)}));
+  EXPECT_TRUE(replica.getSnapshot()->toThrift().structMap()->empty());
+  EXPECT_EQ(replica.numUpdates(), 2);
+  EXPECT_EQ(replica.numErrors(), 0);
+}
+
+TEST(FsdbStorageReplicaTest, invalidDeltaIsDropped) {
+  FsdbStorageReplica<TestStruct> replica(kBasePath);
+  replica.applyDelta(makeDelta(
+      {makeUnit<StringTC>({"name"}, std::optional<std::string>("foo"))}));
+  auto before = replica.getSnapshot();
+
+  replica.applyDelta(makeDelta(
+      {makeUnit<StringTC>({"name"}, std::optional<std::string>("bar")),
+       makeUnit<StringTC>({"doesNotExist"}, std::optional<std::string>(""))}));
+  EXPECT_EQ(replica.getSnapshot(), before);
+  EXPECT_EQ(replica.numErrors(), 1);
+
+  // units outside of the replicated path are ignored
+  auto outside = makeUnit<StringTC>({"name"}, std::optional<std::string>("x"));
+  outside.path()->raw() = {"agent", "other", "name"};
+  replica.applyDelta(makeDelta({outside}));
+  EXPECT_EQ(replica.numIgnoredUnits(), 1);
+  EXPECT_EQ(*replica.getSnapshot()->toThrift().name(), "foo");
+}
+
+TEST(FsdbStorageReplicaTest, applyState) {
+  FsdbStorageReplica<TestStruct> replica(kBasePath);
+  TestStruct state;
+  state.name() = "full";
+  state.structMap()->emplace(1, makeSimple(3, 4));
+  OperState operState;
+  operState.contents() =
+      thrift_cow::serialize<StructTC>(OperProtocol::BINARY, state);
+  operState.protocol() = OperProtocol::BINARY;
+
+  replica.applyState(std::move(operState));
+  EXPECT_EQ(replica.getSnapshot()->toThrift(), state);
+}
+
+TEST(FsdbStorageReplicaTest, pathFilteredCallbacks) {
+  FsdbStorageReplica<TestStruct> replica(kBasePath);
+  std::vector<std::vector<std::string>> structMapChanges;
+  int nameChanges = 0;
+  int allChanges = 0;
+  replica.addChangeCallback(
+      {"structMap"}, [&](const auto& paths, const auto&, const auto&) {
+        structMapChanges.insert(
+            structMapChanges.end(), paths.begin(), paths.end());
+      });
+  auto nameHandle = replica.addChangeCallback(
+      {"name"}, [&](const auto&, const auto& oldRoot, const auto& newRoot) {
+        EXPECT_NE(*oldRoot->toThrift().name(), *newRoot->toThrift().name());
+        ++nameChanges;
+      });
+  replica.addChangeCallback(
+      {}, [&](const auto&, const auto&, const auto&) { ++allChanges; });
+
+  replica.applyDelta(makeDelta({makeUnit<StructTC>(
+      {"structMap", "5"}, std::optional(makeSimple(1, 2)))}));
+  ASSERT_EQ(structMapChanges.size(), 1);
+  EXPECT_EQ(
+      structMapChanges[0], std::vector<std::string>({"structMap", "5"}));
+  EXPECT_EQ(nameChanges, 0);
+  EXPECT_EQ(allChanges, 1);
+
+  replica.applyDelta(makeDelta(
+      {makeUnit<StringTC>({"name"}, std::optional<std::string>("foo"))}));
+  EXPECT_EQ(structMapChanges.size(), 1);
+  EXPECT_EQ(nameChanges, 1);
+  EXPECT_EQ(allChanges, 2);
+
+  // setting the same value again is not a change
+  replica.applyDelta(makeDelta(
+      {makeUnit<StringTC>({"name"}, std::optional<std::string>("foo"))}));
+  EXPECT_EQ(allChanges, 2);
+
+  replica.removeChangeCallback(nameHandle);
+  replica.applyDelta(makeDelta(
+      {makeUnit<StringTC>({"name"}, std::optional<std::string>("bar"))}));
+  EXPECT_EQ(nameChanges, 1);
+  EXPECT_EQ(allChanges, 3);
+}
+
+} // namespace facebook::fboss::fsdb::test
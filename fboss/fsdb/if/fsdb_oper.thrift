@@ -57,6 +57,9 @@ struct OperDeltaUnit {
   1: OperPath path;
   2: optional fbbinary oldState;
   3: optional fbbinary newState;
+  // field id based encoding of path, relative to the stream path. When set,
+  // path is left empty, see CompactPathCodec
+  4: optional fbbinary compactPath;
 }
 
 struct OperDelta {
@@ -12,18 +12,223 @@
 
 #include <folly/logging/xlog.h>
 
+#include <folly/Conv.h>
+#include <folly/FileUtil.h>
 #include <folly/Format.h>
 #include <folly/Singleton.h>
+#include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
+#include <folly/json.h>
+#include <folly/system/ThreadId.h>
 #include <folly/system/ThreadName.h>
 #include <gflags/gflags.h>
+#include <unistd.h>
+#include <algorithm>
+#include <array>
+#include <map>
+#include <mutex>
 #include <sstream>
 #include <thread>
+#include <unordered_set>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
 
 DEFINE_bool(enable_call_timing, false, "Enable call time reporting");
 
+DEFINE_bool(
+    enable_profiling_spans,
+    false,
+    "Record latency of profiling spans on agent hot paths");
+
+DEFINE_int32(
+    profiling_span_trace_events,
+    65536,
+    "Number of most recent profiling spans kept per thread for trace dumps");
+
 namespace {
 
 struct singleton_tag_type {};
+
+uint64_t nowNsecs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+uint64_t readTicks() {
+#if defined(__x86_64__)
+  return __rdtsc();
+#else
+  return nowNsecs();
+#endif
+}
+
+/*
+ * Converts TSC ticks to nanoseconds, by comparing the ticks and the
+ * steady_clock time elapsed since startup.
+ */
+class TickClock {
+ public:
+  TickClock() : startTicks_(readTicks()), startNsecs_(nowNsecs()) {}
+
+  double nsecsPerTick() const {
+    auto ticks = readTicks() - startTicks_;
+    return ticks ? double(nowNsecs() - startNsecs_) / ticks : 1.0;
+  }
+
+  uint64_t startTicks() const {
+    return startTicks_;
+  }
+
+ private:
+  uint64_t startTicks_;
+  uint64_t startNsecs_;
+};
+
+const TickClock tickClock;
+
+/*
+ * Log linear histogram of span durations in ticks, with 4 buckets per power
+ * of two.
+ */
+constexpr int kSubBucketBits = 2;
+constexpr size_t kNumBuckets = 64 << kSubBucketBits;
+
+size_t bucketFor(uint64_t ticks) {
+  if (ticks < (1 << kSubBucketBits)) {
+    return ticks;
+  }
+  int msb = 63 - __builtin_clzll(ticks);
+  auto subBucket =
+      (ticks >> (msb - kSubBucketBits)) & ((1 << kSubBucketBits) - 1);
+  return ((msb - kSubBucketBits + 1) << kSubBucketBits) + subBucket;
+}
+
+uint64_t bucketStart(size_t bucket) {
+  if (bucket < (1 << kSubBucketBits)) {
+    return bucket;
+  }
+  auto shift = (bucket >> kSubBucketBits) - 1;
+  auto subBucket = bucket & ((1 << kSubBucketBits) - 1);
+  return ((1ULL << kSubBucketBits) + subBucket) << shift;
+}
+
+struct SpanTimes {
+  void add(const SpanTimes& other) {
+    count += other.count;
+    totalTicks += other.totalTicks;
+    maxTicks = std::max(maxTicks, other.maxTicks);
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      buckets[i] += other.buckets[i];
+    }
+  }
+
+  uint64_t percentile(double pct) const {
+    uint64_t target = std::max<uint64_t>(1, count * pct / 100);
+    uint64_t seen = 0;
+    for (size_t i = 0; i < kNumBuckets; ++i) {
+      seen += buckets[i];
+      if (seen >= target) {
+        return std::min(bucketStart(i), maxTicks);
+      }
+    }
+    return maxTicks;
+  }
+
+  uint64_t count{0};
+  uint64_t totalTicks{0};
+  uint64_t maxTicks{0};
+  std::array<uint64_t, kNumBuckets> buckets{};
+};
+
+struct SpanNode {
+  SpanNode(const char* name, int32_t parent) : name(name), parent(parent) {}
+
+  const char* name;
+  int32_t parent;
+  SpanTimes times;
+};
+
+struct TraceEvent {
+  int32_t node;
+  uint64_t startTicks;
+  uint64_t durationTicks;
+};
+
+struct ThreadSpans {
+  ThreadSpans()
+      : threadId(folly::getOSThreadID()),
+        threadName(folly::getCurrentThreadName().value_or("")) {}
+
+  // Only used by the thread recording the spans
+  std::vector<std::pair<int32_t, uint64_t>> openSpans;
+  folly::F14FastMap<std::pair<int32_t, const char*>, int32_t> children;
+
+  // Guards the recorded spans, which are read by other threads
+  std::mutex lock;
+  std::vector<SpanNode> nodes;
+  std::vector<TraceEvent> events;
+  size_t numEvents{0};
+
+  uint64_t threadId;
+  std::string threadName;
+};
+
+std::string spanPath(const std::vector<SpanNode>& nodes, size_t node) {
+  std::string path = nodes[node].name;
+  for (auto parent = nodes[node].parent; parent >= 0;
+       parent = nodes[parent].parent) {
+    path = folly::to<std::string>(nodes[parent].name, "/", path);
+  }
+  return path;
+}
+
+struct AllThreadSpans {
+  std::vector<std::shared_ptr<ThreadSpans>> threads;
+  // Span times of threads that have exited, by span path. Their trace
+  // events are dropped.
+  std::map<std::string, SpanTimes> exitedTimes;
+};
+
+folly::Synchronized<AllThreadSpans> allThreadSpans;
+
+// Registers the spans of a thread, and folds them into exitedTimes when the
+// thread exits
+class ThreadSpansRegistration {
+ public:
+  ThreadSpansRegistration() : spans_(std::make_shared<ThreadSpans>()) {
+    allThreadSpans.wlock()->threads.push_back(spans_);
+  }
+
+  ~ThreadSpansRegistration() {
+    auto all = allThreadSpans.wlock();
+    all->threads.erase(
+        std::remove(all->threads.begin(), all->threads.end(), spans_),
+        all->threads.end());
+    std::lock_guard<std::mutex> g(spans_->lock);
+    for (size_t node = 0; node < spans_->nodes.size(); ++node) {
+      if (spans_->nodes[node].times.count) {
+        all->exitedTimes[spanPath(spans_->nodes, node)].add(
+            spans_->nodes[node].times);
+      }
+    }
+  }
+
+  ThreadSpans& spans() {
+    return *spans_;
+  }
+
+ private:
+  std::shared_ptr<ThreadSpans> spans_;
+};
+
+ThreadSpans& threadSpans() {
+  static thread_local ThreadSpansRegistration registration;
+  return registration.spans();
+}
+
 } // namespace
 
 using facebook::fboss::FunctionCallTimeReporter;
@@ -81,4 +286,155 @@ ScopedCallTimer::~ScopedCallTimer() {
   }
 }
 
+void ProfilingSpan::begin(const char* name) {
+  auto& spans = threadSpans();
+  int32_t parent = spans.openSpans.empty() ? -1 : spans.openSpans.back().first;
+  auto child = spans.children.find(std::make_pair(parent, name));
+  int32_t node;
+  if (child != spans.children.end()) {
+    node = child->second;
+  } else {
+    std::lock_guard<std::mutex> g(spans.lock);
+    node = spans.nodes.size();
+    spans.nodes.emplace_back(name, parent);
+    spans.children.emplace(std::make_pair(parent, name), node);
+  }
+  started_ = true;
+  spans.openSpans.emplace_back(node, readTicks());
+}
+
+void ProfilingSpan::end() {
+  auto endTicks = readTicks();
+  auto& spans = threadSpans();
+  auto [node, startTicks] = spans.openSpans.back();
+  spans.openSpans.pop_back();
+  auto ticks = endTicks - startTicks;
+
+  std::lock_guard<std::mutex> g(spans.lock);
+  auto& times = spans.nodes[node].times;
+  times.count++;
+  times.totalTicks += ticks;
+  times.maxTicks = std::max(times.maxTicks, ticks);
+  times.buckets[bucketFor(ticks)]++;
+
+  size_t maxEvents = std::max(FLAGS_profiling_span_trace_events, 0);
+  if (maxEvents == 0) {
+    return;
+  }
+  TraceEvent event{node, startTicks, ticks};
+  if (spans.events.size() < maxEvents) {
+    spans.events.push_back(event);
+  } else {
+    spans.events[spans.numEvents % spans.events.size()] = event;
+  }
+  spans.numEvents++;
+}
+
+std::vector<ProfilingSpan::Stats> ProfilingSpan::getStats() {
+  std::map<std::string, SpanTimes> pathTimes;
+  std::vector<std::shared_ptr<ThreadSpans>> threads;
+  {
+    // Threads exiting after this are still read through threads
+    auto all = allThreadSpans.rlock();
+    pathTimes = all->exitedTimes;
+    threads = all->threads;
+  }
+  for (auto& spans : threads) {
+    std::lock_guard<std::mutex> g(spans->lock);
+    for (size_t node = 0; node < spans->nodes.size(); ++node) {
+      if (spans->nodes[node].times.count) {
+        pathTimes[spanPath(spans->nodes, node)].add(
+            spans->nodes[node].times);
+      }
+    }
+  }
+
+  auto nsecsPerTick = tickClock.nsecsPerTick();
+  auto toNsecs = [nsecsPerTick](uint64_t ticks) -> uint64_t {
+    return ticks * nsecsPerTick;
+  };
+  std::vector<Stats> stats;
+  for (const auto& [path, times] : pathTimes) {
+    Stats spanStats;
+    spanStats.name = path;
+    spanStats.count = times.count;
+    spanStats.totalNsecs = toNsecs(times.totalTicks);
+    spanStats.p50Nsecs = toNsecs(times.percentile(50));
+    spanStats.p90Nsecs = toNsecs(times.percentile(90));
+    spanStats.p99Nsecs = toNsecs(times.percentile(99));
+    spanStats.maxNsecs = toNsecs(times.maxTicks);
+    stats.push_back(std::move(spanStats));
+  }
+  return stats;
+}
+
+bool ProfilingSpan::dumpChromeTrace(const std::string& fileName) {
+  struct ThreadTrace {
+    std::shared_ptr<ThreadSpans> spans;
+    std::vector<const char*> nodeNames;
+    std::vector<TraceEvent> events;
+  };
+  // Copy the events out, so recording threads are only blocked for the copy
+  // and not while the trace is built
+  std::vector<ThreadTrace> threadTraces;
+  auto threads = allThreadSpans.rlock()->threads;
+  for (auto& spans : threads) {
+    ThreadTrace threadTrace{spans, {}, {}};
+    std::lock_guard<std::mutex> g(spans->lock);
+    threadTrace.nodeNames.reserve(spans->nodes.size());
+    for (const auto& node : spans->nodes) {
+      threadTrace.nodeNames.push_back(node.name);
+    }
+    threadTrace.events = spans->events;
+    threadTraces.push_back(std::move(threadTrace));
+  }
+
+  auto nsecsPerTick = tickClock.nsecsPerTick();
+  auto toUsecs = [nsecsPerTick](uint64_t ticks) {
+    return ticks * nsecsPerTick / 1000;
+  };
+  auto pid = getpid();
+  auto traceEvents = folly::dynamic::array();
+  for (const auto& threadTrace : threadTraces) {
+    // Thread id and name are set on construction, no need for the lock
+    auto tid = int64_t(threadTrace.spans->threadId);
+    traceEvents.push_back(folly::dynamic::object("name", "thread_name")(
+        "ph", "M")("pid", pid)("tid", tid)(
+        "args",
+        folly::dynamic::object("name", threadTrace.spans->threadName)));
+    for (const auto& event : threadTrace.events) {
+      traceEvents.push_back(folly::dynamic::object(
+          "name", threadTrace.nodeNames[event.node])("ph", "X")("pid", pid)(
+          "tid", tid)("ts", toUsecs(event.startTicks - tickClock.startTicks()))(
+          "dur", toUsecs(event.durationTicks)));
+    }
+  }
+  auto trace = folly::toJson(folly::dynamic::object(
+      "traceEvents", std::move(traceEvents))("displayTimeUnit", "ns"));
+  return folly::writeFile(trace, fileName.c_str());
+}
+
+void ProfilingSpan::reset() {
+  std::vector<std::shared_ptr<ThreadSpans>> threads;
+  {
+    auto all = allThreadSpans.wlock();
+    all->exitedTimes.clear();
+    threads = all->threads;
+  }
+  for (auto& spans : threads) {
+    std::lock_guard<std::mutex> g(spans->lock);
+    for (auto& node : spans->nodes) {
+      node.times = SpanTimes();
+    }
+    spans->events.clear();
+    spans->numEvents = 0;
+  }
+}
+
+const char* ProfilingSpan::internName(folly::StringPiece name) {
+  static folly::Synchronized<std::unordered_set<std::string>> names;
+  auto lockedNames = names.wlock();
+  return lockedNames->emplace(name.str()).first->c_str();
+}
+
 } // namespace facebook::fboss
@@ -12,10 +12,18 @@
 
 #include <memory>
 
+#include <folly/Likely.h>
+#include <folly/Preprocessor.h>
+#include <folly/Range.h>
 #include <folly/ScopeGuard.h>
 #include <folly/Singleton.h>
+#include <gflags/gflags.h>
 
 #include <chrono>
+#include <string>
+#include <vector>
+
+DECLARE_bool(enable_profiling_spans);
 
 namespace facebook::fboss {
 
@@ -79,4 +87,67 @@ class ScopedCallTimer {
   ScopedCallTimer(const ScopedCallTimer&) = delete;
   ScopedCallTimer& operator=(const ScopedCallTimer&) = delete;
 };
+
+/*
+ * Times the enclosing scope when --enable_profiling_spans is set. Spans nest:
+ * a span is tracked under the span enclosing it on the same thread, so the
+ * same span name is tracked separately for each caller.
+ *
+ * When spans are disabled, a span costs a flag check. When enabled, spans
+ * are timed with the TSC and recorded in per thread tables, which are
+ * aggregated when stats are read or a trace is dumped. When a thread exits,
+ * its times are folded into a per span aggregate and its table is dropped.
+ *
+ * Span names are not copied and must outlive the process, e.g. string
+ * literals or names returned by internName().
+ */
+class ProfilingSpan {
+ public:
+  struct Stats {
+    // Names of the enclosing spans and this span, separated by '/'
+    std::string name;
+    uint64_t count{0};
+    uint64_t totalNsecs{0};
+    uint64_t p50Nsecs{0};
+    uint64_t p90Nsecs{0};
+    uint64_t p99Nsecs{0};
+    uint64_t maxNsecs{0};
+  };
+
+  explicit ProfilingSpan(const char* name) {
+    if (UNLIKELY(FLAGS_enable_profiling_spans)) {
+      begin(name);
+    }
+  }
+  ~ProfilingSpan() {
+    if (UNLIKELY(started_)) {
+      end();
+    }
+  }
+  ProfilingSpan(const ProfilingSpan&) = delete;
+  ProfilingSpan& operator=(const ProfilingSpan&) = delete;
+
+  // Latency of each span, aggregated over all threads
+  static std::vector<Stats> getStats();
+  /*
+   * Write the most recent spans of each running thread to fileName in
+   * Chrome trace event format, for chrome://tracing or Perfetto. Returns
+   * false if the file could not be written.
+   */
+  static bool dumpChromeTrace(const std::string& fileName);
+  // Clear recorded spans
+  static void reset();
+
+  // Span name for names built at runtime
+  static const char* internName(folly::StringPiece name);
+
+ private:
+  void begin(const char* name);
+  void end();
+
+  bool started_{false};
+};
+
+#define PROFILE_SPAN(name) \
+  ::facebook::fboss::ProfilingSpan FB_ANONYMOUS_VARIABLE(profilingSpan)(name)
 } // namespace facebook::fboss
@@ -9,12 +9,101 @@
  */
 // Copyright 2014-present Facebook. All Rights Reserved.
 #include "fboss/lib/ThreadHeartbeat.h"
+#include <folly/experimental/symbolizer/StackTrace.h>
+#include <folly/experimental/symbolizer/Symbolizer.h>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+#include <signal.h>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+DEFINE_bool(
+    thread_callback_stack_sampling,
+    false,
+    "Sample the stack of event base threads whose callback runs past its "
+    "budget. Sampling signals the thread with SIGRTMIN+1: this installs a "
+    "process wide handler for it, and can make blocking system calls of the "
+    "sampled thread fail with EINTR if they are not restarted. Sampling is "
+    "skipped if another handler for that signal is already installed.");
 
 using namespace std::chrono;
 
+namespace {
+
+// Heartbeat whose thread is having its stack sampled, one at a time
+std::atomic<facebook::fboss::ThreadHeartbeat*> sampledHeartbeat{nullptr};
+std::mutex samplingLock;
+std::once_flag installSamplingHandler;
+bool samplingHandlerInstalled{false};
+
+int stackSampleSignal() {
+  return SIGRTMIN + 1;
+}
+
+int64_t nowNsecs() {
+  return duration_cast<nanoseconds>(steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void updateMax(std::atomic<int64_t>& max, int64_t value) {
+  auto current = max.load(std::memory_order_relaxed);
+  while (value > current &&
+         !max.compare_exchange_weak(
+             current, value, std::memory_order_relaxed)) {
+  }
+}
+
+} // namespace
+
 namespace facebook::fboss {
 
+ThreadHeartbeat::~ThreadHeartbeat() {
+  evb_->runImmediatelyOrRunInEventBaseThreadAndWait([this]() {
+    cancelTimeout();
+    if (callbackObserver_) {
+      if (evb_->getExecutionObserver() == callbackObserver_.get()) {
+        evb_->setExecutionObserver(nullptr);
+      }
+      callbackObserver_->heartbeat_ = nullptr;
+      evb_->runInLoop([observer = std::move(callbackObserver_)]() {});
+    }
+    queueDelay_.reset();
+    callbackDuration_.reset();
+  });
+}
+
+void ThreadHeartbeat::scheduleFirstHeartbeat() {
+  CHECK(evb_->inRunningEventBaseThread());
+  thread_ = pthread_self();
+  auto statsMap = fb303::ThreadCachedServiceData::get()->getThreadStats();
+  queueDelay_ = std::make_unique<TLHistogram>(
+      statsMap,
+      threadName_ + ".queue_delay.us",
+      10000,
+      0,
+      1000000,
+      fb303::AVG,
+      50,
+      99,
+      100);
+  callbackDuration_ = std::make_unique<TLHistogram>(
+      statsMap,
+      threadName_ + ".callback_duration.us",
+      1000,
+      0,
+      100000,
+      fb303::AVG,
+      50,
+      99,
+      100);
+  callbackObserver_ = std::make_unique<CallbackObserver>(this);
+  evb_->setExecutionObserver(callbackObserver_.get());
+
+  lastTime_ = steady_clock::now();
+  scheduleTimeout(intervalMsecs_);
+}
+
 void ThreadHeartbeat::timeoutExpired() noexcept {
   CHECK(evb_->inRunningEventBaseThread());
   auto now = steady_clock::now();
@@ -31,6 +120,126 @@ void ThreadHeartbeat::timeoutExpired() noexcept {
   }
   lastTime_ = now;
   scheduleTimeout(intervalMsecs_);
+
+  // Measure how long work queued to the thread waits to run
+  evb_->runInEventBaseThread([this, now]() { recordQueueDelay(now); });
+}
+
+void ThreadHeartbeat::recordQueueDelay(steady_clock::time_point queuedAt) {
+  auto delay =
+      duration_cast<microseconds>(steady_clock::now() - queuedAt).count();
+  queueDelay_->addValue(delay);
+  updateMax(maxQueueDelayUsecs_, delay);
+}
+
+void ThreadHeartbeat::CallbackObserver::starting(uintptr_t /*id*/) noexcept {
+  if (heartbeat_) {
+    heartbeat_->callbackStarting();
+  }
+}
+
+void ThreadHeartbeat::CallbackObserver::stopped(uintptr_t /*id*/) noexcept {
+  if (heartbeat_) {
+    heartbeat_->callbackStopped();
+  }
+}
+
+void ThreadHeartbeat::callbackStarting() noexcept {
+  // Only time the outermost callback if callbacks nest
+  if (callbackDepth_++ == 0) {
+    stackDepth_ = 0;
+    stackSampled_ = false;
+    callbackStartNsecs_ = nowNsecs();
+  }
+}
+
+void ThreadHeartbeat::callbackStopped() noexcept {
+  if (callbackDepth_ == 0 || --callbackDepth_ > 0) {
+    return;
+  }
+  auto elapsed = nanoseconds(nowNsecs() - callbackStartNsecs_.exchange(0));
+  auto duration = duration_cast<microseconds>(elapsed).count();
+  callbackDuration_->addValue(duration);
+  updateMax(maxCallbackDurationUsecs_, duration);
+
+  if (callbackBudget_.count() == 0 || elapsed <= callbackBudget_) {
+    return;
+  }
+  slowCallbackCount_++;
+  auto depth = stackDepth_.exchange(0, std::memory_order_acquire);
+  if (depth == 0) {
+    XLOG_EVERY_MS(WARN, 10000)
+        << threadName_ << ": callback took " << duration
+        << " us, over budget of " << callbackBudget_.count() << " ms";
+    return;
+  }
+
+  // Symbolize the stack sampled while the callback was running
+  std::vector<folly::symbolizer::SymbolizedFrame> frames(depth);
+  folly::symbolizer::Symbolizer symbolizer;
+  symbolizer.symbolize(stack_.data(), frames.data(), depth);
+  folly::symbolizer::StringSymbolizePrinter printer;
+  printer.println(frames.data(), depth);
+  auto stack = printer.str();
+  XLOG(WARN) << threadName_ << ": callback took " << duration
+             << " us, over budget of " << callbackBudget_.count()
+             << " ms, sampled stack:\n"
+             << stack;
+  *lastSlowCallbackStack_.wlock() = std::move(stack);
+}
+
+void ThreadHeartbeat::captureStack(int /*signal*/) {
+  // Runs in a signal handler on the sampled thread
+  auto heartbeat = sampledHeartbeat.load();
+  if (!heartbeat || !pthread_equal(pthread_self(), heartbeat->thread_)) {
+    return;
+  }
+  auto depth = folly::symbolizer::getStackTraceSafe(
+      heartbeat->stack_.data(), heartbeat->stack_.size());
+  heartbeat->stackDepth_.store(
+      depth > 0 ? depth : 0, std::memory_order_release);
+}
+
+void ThreadHeartbeat::sampleSlowCallback() {
+  if (callbackBudget_.count() == 0 || !FLAGS_thread_callback_stack_sampling) {
+    return;
+  }
+  auto start = callbackStartNsecs_.load();
+  if (start == 0 || nanoseconds(nowNsecs() - start) <= callbackBudget_ ||
+      stackSampled_.exchange(true)) {
+    return;
+  }
+
+  std::call_once(installSamplingHandler, []() {
+    // Never replace a handler someone else owns
+    struct sigaction old = {};
+    if (sigaction(stackSampleSignal(), nullptr, &old) != 0 ||
+        (old.sa_flags & SA_SIGINFO) || old.sa_handler != SIG_DFL) {
+      XLOG(WARN) << "signal " << stackSampleSignal()
+                 << " already handled, not sampling slow callback stacks";
+      return;
+    }
+    struct sigaction sa = {};
+    sa.sa_handler = &ThreadHeartbeat::captureStack;
+    // Restart system calls interrupted on the sampled thread
+    sa.sa_flags = SA_RESTART;
+    sigemptyset(&sa.sa_mask);
+    samplingHandlerInstalled =
+        sigaction(stackSampleSignal(), &sa, nullptr) == 0;
+  });
+  if (!samplingHandlerInstalled) {
+    return;
+  }
+
+  std::lock_guard<std::mutex> g(samplingLock);
+  sampledHeartbeat = this;
+  if (pthread_kill(thread_, stackSampleSignal()) == 0) {
+    // Give the thread a little while to take the signal
+    for (int i = 0; i < 100 && stackDepth_ == 0; ++i) {
+      std::this_thread::sleep_for(microseconds(100));
+    }
+  }
+  sampledHeartbeat = nullptr;
 }
 
 void ThreadHeartbeatWatchdog::watchdogLoop() {
@@ -44,6 +253,7 @@ void ThreadHeartbeatWatchdog::watchdogLoop() {
         heartbeatMissFunc_();
       }
       heartbeats_.assign(heartbeat.first, timestamp);
+      heartbeat.first->sampleSlowCallback();
     }
     std::unique_lock<std::mutex> l(m_);
     cv_.wait_for(l, intervalMsecs_, [this]() { return !running_; });
@@ -9,11 +9,20 @@
  */
 // Copyright 2014-present Facebook. All Rights Reserved.
 #pragma once
+#include <fb303/ThreadCachedServiceData.h>
+#include <folly/Synchronized.h>
 #include <folly/concurrency/ConcurrentHashMap.h>
 #include <folly/io/async/AsyncTimeout.h>
 #include <folly/io/async/EventBase.h>
+#include <folly/io/async/ExecutionObserver.h>
 #include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+#include <pthread.h>
+#include <array>
 #include <chrono>
+#include <memory>
+
+DECLARE_bool(thread_callback_stack_sampling);
 
 namespace facebook::fboss {
 
@@ -22,26 +31,32 @@ class ThreadHeartbeat : private folly::AsyncTimeout {
    * Send heartbeat at regular interval to thread.  Measure delay between
    * time we expect heartbeat to be processed vs. time actually processed,
    * and record it to ods.
+   *
+   * Also record to ods how long work queued to the thread waits before it
+   * runs, and how long each callback run by the thread takes. If a non zero
+   * callback budget is given, callbacks running past it are counted and
+   * logged. With --thread_callback_stack_sampling, ThreadHeartbeatWatchdog
+   * also samples the stack of the thread while such a callback is still
+   * running, by signaling the thread.
    */
  public:
   ThreadHeartbeat(
       folly::EventBase* evb,
       std::string threadName,
       int intervalMsecs,
-      std::function<void(int, int)> heartbeatStatsFunc)
+      std::function<void(int, int)> heartbeatStatsFunc,
+      std::chrono::milliseconds callbackBudget = std::chrono::milliseconds(0))
       : AsyncTimeout(evb),
         evb_(evb),
         threadName_(threadName),
         intervalMsecs_(intervalMsecs),
-        heartbeatStatsFunc_(heartbeatStatsFunc) {
+        heartbeatStatsFunc_(heartbeatStatsFunc),
+        callbackBudget_(callbackBudget) {
     XLOG(DBG2) << "ThreadHeartbeat intervalMsecs:" << intervalMsecs_.count();
     evb_->runInEventBaseThread([this]() { scheduleFirstHeartbeat(); });
   }
 
-  ~ThreadHeartbeat() override {
-    evb_->runImmediatelyOrRunInEventBaseThreadAndWait(
-        [this]() { cancelTimeout(); });
-  }
+  ~ThreadHeartbeat() override;
 
   std::chrono::time_point<std::chrono::steady_clock> getTimestamp() {
     return lastTime_.load(std::memory_order_relaxed);
@@ -51,14 +66,56 @@ class ThreadHeartbeat : private folly::AsyncTimeout {
     return threadName_;
   }
 
+  /*
+   * Capture the stack of the thread if stack sampling is enabled, a callback
+   * has been running past the callback budget, and its stack was not
+   * captured yet. The stack is logged
+   * once the callback finishes. Called from the watchdog thread.
+   */
+  void sampleSlowCallback();
+
+  // Expose these for testing purpose
+  std::chrono::microseconds getMaxQueueDelay() const {
+    return std::chrono::microseconds(maxQueueDelayUsecs_.load());
+  }
+  std::chrono::microseconds getMaxCallbackDuration() const {
+    return std::chrono::microseconds(maxCallbackDurationUsecs_.load());
+  }
+  uint64_t getSlowCallbackCount() const {
+    return slowCallbackCount_.load();
+  }
+  std::string getLastSlowCallbackStack() const {
+    return *lastSlowCallbackStack_.rlock();
+  }
+
  private:
+  using TLHistogram = fb303::ThreadCachedServiceData::TLHistogram;
+
+  static constexpr size_t kMaxStackDepth = 64;
+
+  /*
+   * Called by evb_ around each callback it runs. It is handed over to evb_
+   * when the ThreadHeartbeat is destroyed, since evb_ still calls stopped()
+   * once the callback destroying the ThreadHeartbeat returns.
+   */
+  class CallbackObserver : public folly::ExecutionObserver {
+   public:
+    explicit CallbackObserver(ThreadHeartbeat* heartbeat)
+        : heartbeat_(heartbeat) {}
+
+    void starting(uintptr_t id) noexcept override;
+    void stopped(uintptr_t id) noexcept override;
+
+    ThreadHeartbeat* heartbeat_;
+  };
+
   void timeoutExpired() noexcept override;
 
-  void scheduleFirstHeartbeat() {
-    CHECK(evb_->inRunningEventBaseThread());
-    lastTime_ = std::chrono::steady_clock::now();
-    scheduleTimeout(intervalMsecs_);
-  }
+  void scheduleFirstHeartbeat();
+  void callbackStarting() noexcept;
+  void callbackStopped() noexcept;
+  void recordQueueDelay(std::chrono::steady_clock::time_point queuedAt);
+  static void captureStack(int signal);
 
   folly::EventBase* evb_;
   std::string threadName_;
@@ -69,6 +126,26 @@ class ThreadHeartbeat : private folly::AsyncTimeout {
   // XXX: these thresholds could be made configurable if needed
   int delayThresholdMsecs_ = 1000;
   int backlogThreshold_ = 10;
+
+  // Latency histograms, created and updated in the evb_ thread
+  std::unique_ptr<TLHistogram> queueDelay_;
+  std::unique_ptr<TLHistogram> callbackDuration_;
+  std::unique_ptr<CallbackObserver> callbackObserver_;
+
+  std::chrono::milliseconds callbackBudget_;
+  pthread_t thread_;
+  // Start of the callback running in the evb_ thread, 0 when idle
+  std::atomic<int64_t> callbackStartNsecs_{0};
+  int callbackDepth_{0};
+  // Stack sampled by the watchdog while the current callback was running
+  std::atomic_bool stackSampled_{false};
+  std::atomic<size_t> stackDepth_{0};
+  std::array<uintptr_t, kMaxStackDepth> stack_;
+
+  std::atomic<int64_t> maxQueueDelayUsecs_{0};
+  std::atomic<int64_t> maxCallbackDurationUsecs_{0};
+  std::atomic<uint64_t> slowCallbackCount_{0};
+  folly::Synchronized<std::string> lastSlowCallbackStack_;
 };
 
 // monitor thread heartbeats, and alarm if heartbeat timestamp
@@ -16,10 +16,14 @@ namespace facebook::fboss {
 
 template <typename T, size_t length>
 void RingBuffer<T, length>::write(T val) {
-  if (buf.size() == length) {
-    buf.pop_front();
+  if (buf.size() < length) {
+    // A copied buffer only has capacity for the elements it holds
+    buf.reserve(length);
+    buf.push_back(std::move(val));
+    return;
   }
-  buf.push_back(val);
+  buf[head] = std::move(val);
+  head = (head + 1) % length;
 }
 
 template <typename T, size_t length>
@@ -27,7 +31,7 @@ const T RingBuffer<T, length>::last() const {
   if (buf.empty()) {
     throw FbossError("Attempted to read from empty RingBuffer");
   }
-  return buf.back();
+  return buf[(head + buf.size() - 1) % length];
 }
 
 template <typename T, size_t length>
@@ -37,24 +41,24 @@ bool RingBuffer<T, length>::empty() const {
 
 template <typename T, size_t length>
 typename RingBuffer<T, length>::iterator RingBuffer<T, length>::begin() {
-  return buf.begin();
+  return iterator(buf.data(), head, 0);
 }
 
 template <typename T, size_t length>
 typename RingBuffer<T, length>::iterator RingBuffer<T, length>::end() {
-  return buf.end();
+  return iterator(buf.data(), head, buf.size());
 }
 
 template <typename T, size_t length>
 typename RingBuffer<T, length>::const_iterator RingBuffer<T, length>::begin()
     const {
-  return buf.begin();
+  return const_iterator(buf.data(), head, 0);
 }
 
 template <typename T, size_t length>
 typename RingBuffer<T, length>::const_iterator RingBuffer<T, length>::end()
     const {
-  return buf.end();
+  return const_iterator(buf.data(), head, buf.size());
 }
 
 template <typename T, size_t length>
@@ -10,14 +10,68 @@
 #pragma once
 
 #include <stddef.h>
-#include <list>
+#include <iterator>
+#include <type_traits>
+#include <vector>
 
 namespace facebook::fboss {
+
+/*
+ * Fixed capacity ring buffer. Storage for all the elements is reserved up
+ * front, and once the buffer is full each write overwrites the oldest element
+ * in place, so writes don't allocate.
+ *
+ * Iteration goes from the oldest to the newest element.
+ */
 template <typename T, size_t length>
 class RingBuffer {
+  template <typename ValueT>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::remove_const_t<ValueT>;
+    using difference_type = std::ptrdiff_t;
+    using pointer = ValueT*;
+    using reference = ValueT&;
+
+    Iterator(ValueT* data, size_t head, size_t pos)
+        : data_(data), head_(head), pos_(pos) {}
+
+    reference operator*() const {
+      return data_[(head_ + pos_) % length];
+    }
+    pointer operator->() const {
+      return &**this;
+    }
+    Iterator& operator++() {
+      ++pos_;
+      return *this;
+    }
+    Iterator operator++(int) {
+      auto tmp = *this;
+      ++pos_;
+      return tmp;
+    }
+    bool operator==(const Iterator& other) const {
+      return data_ == other.data_ && pos_ == other.pos_;
+    }
+    bool operator!=(const Iterator& other) const {
+      return !(*this == other);
+    }
+
+   private:
+    ValueT* data_;
+    size_t head_;
+    size_t pos_;
+  };
+
  public:
-  using iterator = typename std::list<T>::iterator;
-  using const_iterator = typename std::list<T>::const_iterator;
+  using iterator = Iterator<T>;
+  using const_iterator = Iterator<const T>;
+
+  RingBuffer() {
+    buf.reserve(length);
+  }
 
   void write(T val);
   const T last() const;
@@ -30,7 +84,9 @@ class RingBuffer {
   size_t maxSize() const;
 
  private:
-  std::list<T> buf;
+  std::vector<T> buf;
+  // Index of the oldest element, only moves once the buffer is full
+  size_t head{0};
 };
 
 } // namespace facebook::fboss
@@ -18,20 +18,25 @@ using namespace std::chrono;
 template <size_t intervalSeconds, size_t timespanSeconds>
 SnapshotManager<intervalSeconds, timespanSeconds>::SnapshotManager(
     std::set<std::string> portNames)
-    : portNames_(portNames) {}
+    : portNames_(portNames),
+      recorder_(getLinkSnapshotRecorder()),
+      recorderKey_(folly::join(",", portNames_)) {}
 
 template <size_t intervalSeconds, size_t timespanSeconds>
 void SnapshotManager<intervalSeconds, timespanSeconds>::addSnapshot(
     LinkSnapshot val) {
-  auto snapshot = SnapshotWrapper(val);
-  buf_.write(snapshot);
+  uint64_t seq = 0;
+  if (recorder_) {
+    seq = recorder_->write(recorderKey_, val);
+  }
+  auto snapshot = SnapshotWrapper(std::move(val));
 
   if (numSnapshotsToPublish_ > 0) {
     snapshot.publish(portNames_);
-  }
-  if (numSnapshotsToPublish_ > 0) {
+    lastPublishedSeq_ = std::max(lastPublishedSeq_, seq);
     numSnapshotsToPublish_--;
   }
+  buf_.write(std::move(snapshot));
 }
 
 template <size_t intervalSeconds, size_t timespanSeconds>
@@ -44,6 +49,18 @@ SnapshotManager<intervalSeconds, timespanSeconds>::getSnapshots() const {
 
 template <size_t intervalSeconds, size_t timespanSeconds>
 void SnapshotManager<intervalSeconds, timespanSeconds>::publishAllSnapshots() {
+  if (recorder_) {
+    auto records = recorder_->read(recorderKey_, lastPublishedSeq_);
+    // Like the in memory buffer, only cover the last timespanSeconds
+    auto cutoff = system_clock::now() - seconds(timespanSeconds);
+    for (const auto& record : records) {
+      if (record.timestamp >= cutoff) {
+        publishLinkSnapshot(record.snapshot, portNames_);
+      }
+      lastPublishedSeq_ = record.seq;
+    }
+    return;
+  }
   for (auto& snapshot : buf_) {
     snapshot.publish(portNames_);
   }
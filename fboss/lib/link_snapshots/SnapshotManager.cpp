@@ -16,16 +16,22 @@ using namespace std::chrono;
 
 namespace facebook::fboss {
 
-void SnapshotWrapper::publish(const std::set<std::string>& portNames) {
+void publishLinkSnapshot(
+    const LinkSnapshot& snapshot,
+    const std::set<std::string>& portNames) {
   auto serializedSnapshot =
-      apache::thrift::SimpleJSONSerializer::serialize<std::string>(snapshot_);
+      apache::thrift::SimpleJSONSerializer::serialize<std::string>(snapshot);
+  std::stringstream log;
+  log << LinkSnapshotAlert() << "Collected snapshot for ports ";
+  for (const auto& port : portNames) {
+    log << PortParam(port);
+  }
+  XLOG(DBG2) << log.str() << " " << LinkSnapshotParam(serializedSnapshot);
+}
+
+void SnapshotWrapper::publish(const std::set<std::string>& portNames) {
   if (!published_) {
-    std::stringstream log;
-    log << LinkSnapshotAlert() << "Collected snapshot for ports ";
-    for (const auto& port : portNames) {
-      log << PortParam(port);
-    }
-    XLOG(DBG2) << log.str() << " " << LinkSnapshotParam(serializedSnapshot);
+    publishLinkSnapshot(snapshot_, portNames);
     published_ = true;
   }
 }
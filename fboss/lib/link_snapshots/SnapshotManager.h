@@ -9,11 +9,13 @@
  */
 #pragma once
 
+#include <folly/String.h>
 #include <stddef.h>
 #include <thrift/lib/cpp2/protocol/Serializer.h>
 #include <chrono>
 #include <list>
 #include "fboss/lib/link_snapshots/RingBuffer-defs.h"
+#include "fboss/lib/link_snapshots/SnapshotRecorder.h"
 #include "fboss/lib/phy/gen-cpp2/phy_types.h"
 #include "folly/logging/xlog.h"
 
@@ -24,6 +26,11 @@ namespace facebook::fboss {
 
 using namespace fboss::phy;
 
+// Log a snapshot for portNames to the alert log
+void publishLinkSnapshot(
+    const LinkSnapshot& snapshot,
+    const std::set<std::string>& portNames);
+
 class SnapshotWrapper {
  public:
   explicit SnapshotWrapper(LinkSnapshot snapshot) : snapshot_(snapshot) {}
@@ -38,6 +45,9 @@ class SnapshotWrapper {
  * timespanSeconds is the total cached time stored in the snapshotManager
  * We will store timespan//interval + 1 snapshots in memory
  *
+ * If the link snapshot flight recorder is enabled, snapshots are also written
+ * to it and published from it, so snapshots taken before the process
+ * restarted are published too, as long as they are within timespanSeconds.
  */
 // TODO(ccpowers): We may want to move from std::array to std:vector so we
 // can use FLAGS_refresh_interval/FLAGS_gearbox_stats_interval instead of
@@ -64,6 +74,11 @@ class SnapshotManager {
   RingBuffer<SnapshotWrapper, length> buf_;
   int numSnapshotsToPublish_{0};
   std::set<std::string> portNames_;
+  std::shared_ptr<SnapshotRecorder> recorder_;
+  // Our records in the flight recorder are tagged with this
+  std::string recorderKey_;
+  // Sequence number of the last flight recorder record we published
+  uint64_t lastPublishedSeq_{0};
 };
 
 } // namespace facebook::fboss
@@ -0,0 +1,319 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/link_snapshots/SnapshotRecorder.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <folly/Exception.h>
+#include <folly/hash/Checksum.h>
+#include <folly/io/Cursor.h>
+#include <folly/io/IOBufQueue.h>
+#include <folly/logging/xlog.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include "fboss/agent/FbossError.h"
+
+DEFINE_string(
+    link_snapshot_recorder_file,
+    "",
+    "File to keep a flight recorder of link snapshots in, so they survive "
+    "the process restarting. Empty disables the flight recorder");
+DEFINE_uint32(
+    link_snapshot_recorder_slots,
+    2048,
+    "Number of link snapshots the flight recorder holds");
+DEFINE_uint32(
+    link_snapshot_recorder_slot_size,
+    16384,
+    "Size in bytes of each flight recorder slot. Larger snapshots are dropped");
+
+namespace {
+constexpr uint64_t kMagic = 0x46425353'4e415053; // "FBSSNAPS"
+constexpr uint32_t kVersion = 1;
+} // namespace
+
+namespace facebook::fboss {
+
+struct SnapshotRecorder::FileHeader {
+  uint64_t magic;
+  uint32_t version;
+  uint32_t numSlots;
+  uint32_t slotSize;
+  uint32_t reserved[11];
+};
+
+struct SnapshotRecorder::SlotHeader {
+  // 0 while the slot is empty or being written
+  std::atomic<uint64_t> seq;
+  uint64_t timestampMs;
+  uint32_t namesLength;
+  uint32_t payloadLength;
+  uint32_t checksum;
+  uint32_t reserved;
+
+  uint32_t computeChecksum(const uint8_t* data) const {
+    auto crc = folly::crc32c(
+        reinterpret_cast<const uint8_t*>(&timestampMs),
+        sizeof(timestampMs) + sizeof(namesLength) + sizeof(payloadLength));
+    return folly::crc32c(data, namesLength + payloadLength, crc);
+  }
+};
+
+SnapshotRecorder::SnapshotRecorder(
+    const std::string& path,
+    uint32_t numSlots,
+    uint32_t slotSize)
+    : path_(path),
+      numSlots_(numSlots),
+      // keep slot headers 8 byte aligned
+      slotSize_((slotSize + 7) & ~7u) {
+  // The layout of the file must not depend on the build
+  static_assert(sizeof(FileHeader) == 64);
+  static_assert(sizeof(SlotHeader) == 32);
+  static_assert(std::atomic<uint64_t>::is_always_lock_free);
+
+  if (numSlots_ == 0 || slotSize_ <= sizeof(SlotHeader)) {
+    throw FbossError(
+        "invalid link snapshot recorder geometry: ",
+        numSlots,
+        " slots of ",
+        slotSize,
+        " bytes");
+  }
+  file_ = folly::File(path_.c_str(), O_RDWR | O_CREAT, 0644);
+  auto size = sizeof(FileHeader) + uint64_t(numSlots_) * slotSize_;
+
+  struct stat st;
+  folly::checkUnixError(
+      fstat(file_.fd(), &st), "error sizing link snapshot recorder ", path_);
+  bool sameSize = st.st_size == static_cast<off_t>(size);
+  if (!sameSize) {
+    // Truncating first zeroes the whole file
+    folly::checkUnixError(
+        ftruncate(file_.fd(), 0),
+        "error truncating link snapshot recorder ",
+        path_);
+    folly::checkUnixError(
+        ftruncate(file_.fd(), size),
+        "error sizing link snapshot recorder ",
+        path_);
+  }
+  map(size, false /* readOnly */);
+
+  if (sameSize && validHeader(numSlots_, slotSize_)) {
+    nextSeq_ = recoverNextSeq();
+    XLOG(INFO) << "Recovered link snapshot recorder " << path_
+               << ", next record " << nextSeq_.load();
+    return;
+  }
+  if (sameSize) {
+    memset(base_, 0, size_);
+  }
+  auto header = reinterpret_cast<FileHeader*>(base_);
+  header->magic = kMagic;
+  header->version = kVersion;
+  header->numSlots = numSlots_;
+  header->slotSize = slotSize_;
+}
+
+SnapshotRecorder::SnapshotRecorder(const std::string& path, bool readOnly)
+    : path_(path) {
+  CHECK(readOnly);
+  file_ = folly::File(path_.c_str(), O_RDONLY);
+  struct stat st;
+  folly::checkUnixError(
+      fstat(file_.fd(), &st), "error sizing link snapshot recorder ", path_);
+  if (st.st_size < static_cast<off_t>(sizeof(FileHeader))) {
+    throw FbossError("link snapshot recorder ", path_, " is too short");
+  }
+  map(st.st_size, true /* readOnly */);
+
+  auto header = reinterpret_cast<const FileHeader*>(base_);
+  if (!validHeader(header->numSlots, header->slotSize) ||
+      size_ != sizeof(FileHeader) + uint64_t(header->numSlots) *
+              header->slotSize) {
+    throw FbossError(path_, " is not a link snapshot recorder");
+  }
+  numSlots_ = header->numSlots;
+  slotSize_ = header->slotSize;
+}
+
+SnapshotRecorder::~SnapshotRecorder() {
+  if (base_) {
+    munmap(base_, size_);
+  }
+}
+
+std::unique_ptr<SnapshotRecorder> SnapshotRecorder::openReadOnly(
+    const std::string& path) {
+  return std::unique_ptr<SnapshotRecorder>(
+      new SnapshotRecorder(path, true /* readOnly */));
+}
+
+void SnapshotRecorder::map(size_t size, bool readOnly) {
+  auto map = mmap(
+      nullptr,
+      size,
+      readOnly ? PROT_READ : PROT_READ | PROT_WRITE,
+      MAP_SHARED,
+      file_.fd(),
+      0);
+  if (map == MAP_FAILED) {
+    folly::throwSystemError("error mapping link snapshot recorder ", path_);
+  }
+  base_ = static_cast<uint8_t*>(map);
+  size_ = size;
+}
+
+bool SnapshotRecorder::validHeader(uint32_t numSlots, uint32_t slotSize)
+    const {
+  auto header = reinterpret_cast<const FileHeader*>(base_);
+  return header->magic == kMagic && header->version == kVersion &&
+      header->numSlots == numSlots && header->slotSize == slotSize &&
+      slotSize > sizeof(SlotHeader) && slotSize % 8 == 0;
+}
+
+SnapshotRecorder::SlotHeader* SnapshotRecorder::slot(uint64_t index) const {
+  return reinterpret_cast<SlotHeader*>(
+      base_ + sizeof(FileHeader) + (index % numSlots_) * slotSize_);
+}
+
+uint64_t SnapshotRecorder::recoverNextSeq() const {
+  uint64_t maxSeq = 0;
+  for (uint32_t i = 0; i < numSlots_; ++i) {
+    maxSeq = std::max(maxSeq, slot(i)->seq.load(std::memory_order_relaxed));
+  }
+  return maxSeq + 1;
+}
+
+uint64_t SnapshotRecorder::write(
+    folly::StringPiece portNames,
+    const phy::LinkSnapshot& val) {
+  // Reuse the serialization buffer, so steady state writes don't allocate
+  static thread_local folly::IOBufQueue queue(
+      folly::IOBufQueue::cacheChainLength());
+  queue.clearAndTryReuseLargestBuffer();
+  apache::thrift::CompactSerializer::serialize(val, &queue);
+
+  auto payloadLength = queue.chainLength();
+  if (sizeof(SlotHeader) + portNames.size() + payloadLength > slotSize_) {
+    numDropped_.fetch_add(1, std::memory_order_relaxed);
+    return 0;
+  }
+
+  auto seq = nextSeq_.fetch_add(1, std::memory_order_relaxed);
+  auto hdr = slot(seq - 1);
+  hdr->seq.store(0, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  auto data = reinterpret_cast<uint8_t*>(hdr + 1);
+  hdr->timestampMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+  hdr->namesLength = portNames.size();
+  hdr->payloadLength = payloadLength;
+  memcpy(data, portNames.data(), portNames.size());
+  folly::io::Cursor(queue.front()).pull(data + portNames.size(), payloadLength);
+  hdr->checksum = hdr->computeChecksum(data);
+
+  hdr->seq.store(seq, std::memory_order_release);
+  return seq;
+}
+
+std::vector<SnapshotRecorder::Record> SnapshotRecorder::read(
+    std::optional<folly::StringPiece> portNames,
+    uint64_t afterSeq) const {
+  std::vector<Record> records;
+  std::string data;
+  for (uint32_t i = 0; i < numSlots_; ++i) {
+    const auto hdr = slot(i);
+    auto seq = hdr->seq.load(std::memory_order_acquire);
+    if (seq == 0 || seq <= afterSeq) {
+      continue;
+    }
+    SlotHeader copy;
+    copy.timestampMs = hdr->timestampMs;
+    copy.namesLength = hdr->namesLength;
+    copy.payloadLength = hdr->payloadLength;
+    copy.checksum = hdr->checksum;
+    if (sizeof(SlotHeader) + uint64_t(copy.namesLength) + copy.payloadLength >
+        slotSize_) {
+      continue;
+    }
+    // Filter on the names in place, only records we return get copied. A
+    // slot rewritten meanwhile is caught by the checksum below
+    if (portNames.has_value() &&
+        (copy.namesLength != portNames->size() ||
+         memcmp(hdr + 1, portNames->data(), portNames->size()) != 0)) {
+      continue;
+    }
+    data.assign(
+        reinterpret_cast<const char*>(hdr + 1),
+        copy.namesLength + copy.payloadLength);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (hdr->seq.load(std::memory_order_relaxed) != seq ||
+        copy.computeChecksum(reinterpret_cast<const uint8_t*>(data.data())) !=
+            copy.checksum) {
+      // Rewritten while we read it, or torn by a crash
+      continue;
+    }
+
+    folly::StringPiece names(data.data(), copy.namesLength);
+    Record record;
+    record.seq = seq;
+    record.timestamp = std::chrono::system_clock::time_point(
+        std::chrono::milliseconds(copy.timestampMs));
+    record.portNames = names.str();
+    try {
+      record.snapshot =
+          apache::thrift::CompactSerializer::deserialize<phy::LinkSnapshot>(
+              folly::StringPiece(
+                  data.data() + copy.namesLength, copy.payloadLength));
+    } catch (const std::exception& ex) {
+      XLOG(ERR) << "Skipping undecodable link snapshot record " << seq
+                << " in " << path_ << ": " << folly::exceptionStr(ex);
+      continue;
+    }
+    records.push_back(std::move(record));
+  }
+  std::sort(records.begin(), records.end(), [](const auto& a, const auto& b) {
+    return a.seq < b.seq;
+  });
+  return records;
+}
+
+std::shared_ptr<SnapshotRecorder> getLinkSnapshotRecorder() {
+  static auto recorder = []() -> std::shared_ptr<SnapshotRecorder> {
+    if (FLAGS_link_snapshot_recorder_file.empty()) {
+      return nullptr;
+    }
+    try {
+      return std::make_shared<SnapshotRecorder>(
+          FLAGS_link_snapshot_recorder_file,
+          FLAGS_link_snapshot_recorder_slots,
+          FLAGS_link_snapshot_recorder_slot_size);
+    } catch (const std::exception& ex) {
+      // Link snapshots are diagnostics, keep going without the recorder
+      XLOG(ERR) << "Failed to open link snapshot recorder "
+                << FLAGS_link_snapshot_recorder_file << ": "
+                << folly::exceptionStr(ex);
+      return nullptr;
+    }
+  }();
+  return recorder;
+}
+
+} // namespace facebook::fboss
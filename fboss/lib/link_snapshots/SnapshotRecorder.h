@@ -0,0 +1,122 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+#pragma once
+
+#include <folly/File.h>
+#include <folly/Range.h>
+#include <gflags/gflags.h>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "fboss/lib/phy/gen-cpp2/phy_types.h"
+
+DECLARE_string(link_snapshot_recorder_file);
+DECLARE_uint32(link_snapshot_recorder_slots);
+DECLARE_uint32(link_snapshot_recorder_slot_size);
+
+namespace facebook::fboss {
+
+/*
+ * SnapshotRecorder is a flight recorder for link snapshots: a fixed number of
+ * fixed size slots in a memory mapped file, written round robin.
+ *
+ * Each record holds the names of the ports the snapshot is for and the
+ * snapshot in compact thrift. Records are written straight into the shared
+ * mapping, so they survive the process crashing and are found again when the
+ * file is reopened with the same geometry.
+ *
+ * Slots are written seqlock style: the slot's sequence number is cleared,
+ * the record written and checksummed, and the sequence number set last.
+ * Readers skip slots whose sequence number changed under them or whose
+ * checksum doesn't match, e.g. a record torn by a crash.
+ *
+ * write() may be called from several threads. Records too large for a slot
+ * are dropped.
+ */
+class SnapshotRecorder {
+ public:
+  struct Record {
+    uint64_t seq;
+    std::chrono::system_clock::time_point timestamp;
+    std::string portNames;
+    phy::LinkSnapshot snapshot;
+  };
+
+  SnapshotRecorder(
+      const std::string& path,
+      uint32_t numSlots,
+      uint32_t slotSize);
+  ~SnapshotRecorder();
+
+  // Open an existing recorder file without modifying it, e.g. from a tool
+  static std::unique_ptr<SnapshotRecorder> openReadOnly(
+      const std::string& path);
+
+  /*
+   * Record a snapshot for portNames. Returns the sequence number of the
+   * record, or 0 if the snapshot didn't fit in a slot.
+   */
+  uint64_t write(folly::StringPiece portNames, const phy::LinkSnapshot& val);
+
+  /*
+   * Records still in the ring with a sequence number greater than afterSeq,
+   * oldest first. If portNames is given, only the records for those ports.
+   */
+  std::vector<Record> read(
+      std::optional<folly::StringPiece> portNames = std::nullopt,
+      uint64_t afterSeq = 0) const;
+
+  uint32_t numSlots() const {
+    return numSlots_;
+  }
+  uint32_t slotSize() const {
+    return slotSize_;
+  }
+  uint64_t numDropped() const {
+    return numDropped_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  struct FileHeader;
+  struct SlotHeader;
+
+  SnapshotRecorder(const std::string& path, bool readOnly);
+
+  // Forbidden copy constructor and assignment operator
+  SnapshotRecorder(SnapshotRecorder const&) = delete;
+  SnapshotRecorder& operator=(SnapshotRecorder const&) = delete;
+
+  void map(size_t size, bool readOnly);
+  bool validHeader(uint32_t numSlots, uint32_t slotSize) const;
+  SlotHeader* slot(uint64_t index) const;
+  uint64_t recoverNextSeq() const;
+
+  const std::string path_;
+  folly::File file_;
+  uint8_t* base_{nullptr};
+  size_t size_{0};
+  uint32_t numSlots_{0};
+  uint32_t slotSize_{0};
+  std::atomic<uint64_t> nextSeq_{1};
+  std::atomic<uint64_t> numDropped_{0};
+};
+
+/*
+ * The recorder link snapshots of this process go to, nullptr unless
+ * --link_snapshot_recorder_file is set.
+ */
+std::shared_ptr<SnapshotRecorder> getLinkSnapshotRecorder();
+
+} // namespace facebook::fboss
@@ -0,0 +1,71 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/link_snapshots/SnapshotRecorder.h"
+
+#include <folly/init/Init.h>
+#include <folly/logging/xlog.h>
+#include <gflags/gflags.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include <iostream>
+
+DEFINE_string(
+    ports,
+    "",
+    "Only print the snapshots for these ports, comma separated as they are "
+    "recorded, e.g. eth1/1/1,eth1/1/2");
+DEFINE_uint64(
+    after_seq,
+    0,
+    "Only print the snapshots recorded after this sequence number");
+
+using namespace facebook::fboss;
+
+/*
+ * Dumps the link snapshots kept in the flight recorder file given with
+ * --link_snapshot_recorder_file, oldest first. The file is opened read only,
+ * so this can be run while the agent or qsfp_service is writing to it.
+ */
+int main(int argc, char* argv[]) {
+  folly::init(&argc, &argv, true);
+
+  if (FLAGS_link_snapshot_recorder_file.empty()) {
+    XLOG(ERR) << "--link_snapshot_recorder_file is required";
+    return 1;
+  }
+  std::unique_ptr<SnapshotRecorder> recorder;
+  try {
+    recorder =
+        SnapshotRecorder::openReadOnly(FLAGS_link_snapshot_recorder_file);
+  } catch (const std::exception& ex) {
+    XLOG(ERR) << "Failed to open " << FLAGS_link_snapshot_recorder_file << ": "
+              << folly::exceptionStr(ex);
+    return 1;
+  }
+
+  std::optional<folly::StringPiece> ports;
+  if (!FLAGS_ports.empty()) {
+    ports = FLAGS_ports;
+  }
+  auto records = recorder->read(ports, FLAGS_after_seq);
+  for (const auto& record : records) {
+    auto timestamp = std::chrono::system_clock::to_time_t(record.timestamp);
+    std::cout << record.seq << " " << timestamp << " " << record.portNames
+              << " "
+              << apache::thrift::SimpleJSONSerializer::serialize<std::string>(
+                     record.snapshot)
+              << std::endl;
+  }
+  XLOG(INFO) << "Read " << records.size() << " snapshots from "
+             << recorder->numSlots() << " slots of " << recorder->slotSize()
+             << " bytes";
+  return 0;
+}
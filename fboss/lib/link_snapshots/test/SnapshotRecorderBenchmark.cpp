@@ -0,0 +1,80 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/link_snapshots/SnapshotManager-defs.h"
+#include "fboss/lib/link_snapshots/SnapshotRecorder.h"
+
+#include <folly/Benchmark.h>
+#include <folly/experimental/TestUtil.h>
+#include <folly/init/Init.h>
+
+using namespace facebook::fboss;
+
+/*
+ * Cost of recording a PHY snapshot: keeping it in memory only, against also
+ * writing it to the flight recorder.
+ */
+namespace {
+
+constexpr size_t kIntervalSeconds = 10;
+
+phy::LinkSnapshot makeSnapshot() {
+  phy::PhyInfo phyInfo;
+  phyInfo.name_ref() = "eth1/1/1";
+  phyInfo.linkState_ref() = true;
+  phyInfo.linkFlapCount_ref() = 3;
+  phy::LinkSnapshot snapshot;
+  snapshot.phyInfo_ref() = phyInfo;
+  return snapshot;
+}
+
+} // namespace
+
+BENCHMARK(InMemorySnapshot, numIters) {
+  RingBuffer<SnapshotWrapper, kDefaultTimespanSeconds / kIntervalSeconds + 1>
+      buf;
+  phy::LinkSnapshot snapshot;
+  BENCHMARK_SUSPEND {
+    snapshot = makeSnapshot();
+  }
+  for (size_t n = 0; n < numIters; ++n) {
+    buf.write(SnapshotWrapper(snapshot));
+  }
+}
+
+BENCHMARK_RELATIVE(FlightRecorderSnapshot, numIters) {
+  folly::test::TemporaryDirectory tmpDir;
+  std::unique_ptr<SnapshotRecorder> recorder;
+  phy::LinkSnapshot snapshot;
+  BENCHMARK_SUSPEND {
+    recorder = std::make_unique<SnapshotRecorder>(
+        (tmpDir.path() / "link_snapshots").string(),
+        FLAGS_link_snapshot_recorder_slots,
+        FLAGS_link_snapshot_recorder_slot_size);
+    snapshot = makeSnapshot();
+    // Fault in the mapping and the serialization buffer up front
+    for (uint32_t i = 0; i < recorder->numSlots(); ++i) {
+      recorder->write("eth1/1/1", snapshot);
+    }
+  }
+  for (size_t n = 0; n < numIters; ++n) {
+    recorder->write("eth1/1/1", snapshot);
+  }
+  BENCHMARK_SUSPEND {
+    CHECK_EQ(recorder->numDropped(), 0);
+    recorder.reset();
+  }
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,175 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/agent/FbossError.h"
+#include "fboss/lib/link_snapshots/RingBuffer-defs.h"
+#include "fboss/lib/link_snapshots/SnapshotRecorder.h"
+
+#include <fcntl.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <folly/File.h>
+#include <folly/FileUtil.h>
+#include <folly/experimental/TestUtil.h>
+#include <gtest/gtest.h>
+
+using namespace facebook::fboss;
+
+namespace {
+
+constexpr uint32_t kNumSlots = 8;
+constexpr uint32_t kSlotSize = 512;
+
+phy::LinkSnapshot makeSnapshot(const std::string& name, int64_t flaps) {
+  phy::PhyInfo phyInfo;
+  phyInfo.name_ref() = name;
+  phyInfo.linkFlapCount_ref() = flaps;
+  phy::LinkSnapshot snapshot;
+  snapshot.phyInfo_ref() = phyInfo;
+  return snapshot;
+}
+
+int64_t flaps(const SnapshotRecorder::Record& record) {
+  return *record.snapshot.phyInfo_ref()->linkFlapCount_ref();
+}
+
+class SnapshotRecorderTest : public ::testing::Test {
+ protected:
+  std::unique_ptr<SnapshotRecorder> open(
+      uint32_t numSlots = kNumSlots,
+      uint32_t slotSize = kSlotSize) {
+    return std::make_unique<SnapshotRecorder>(path_, numSlots, slotSize);
+  }
+
+  folly::test::TemporaryDirectory tmpDir_;
+  std::string path_{(tmpDir_.path() / "link_snapshots").string()};
+};
+
+} // namespace
+
+TEST_F(SnapshotRecorderTest, WriteRead) {
+  auto recorder = open();
+  EXPECT_EQ(recorder->write("eth1/1/1", makeSnapshot("eth1/1/1", 1)), 1);
+  EXPECT_EQ(recorder->write("eth1/2/1", makeSnapshot("eth1/2/1", 2)), 2);
+  EXPECT_EQ(recorder->write("eth1/1/1", makeSnapshot("eth1/1/1", 3)), 3);
+
+  auto records = recorder->read();
+  ASSERT_EQ(records.size(), 3);
+  for (uint64_t i = 0; i < 3; ++i) {
+    EXPECT_EQ(records[i].seq, i + 1);
+    EXPECT_EQ(flaps(records[i]), i + 1);
+  }
+
+  records = recorder->read(folly::StringPiece("eth1/1/1"));
+  ASSERT_EQ(records.size(), 2);
+  EXPECT_EQ(records[0].portNames, "eth1/1/1");
+  EXPECT_EQ(flaps(records[0]), 1);
+  EXPECT_EQ(flaps(records[1]), 3);
+
+  records = recorder->read(folly::StringPiece("eth1/1/1"), 1);
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].seq, 3);
+
+  // names must match exactly, not by prefix
+  EXPECT_TRUE(recorder->read(folly::StringPiece("eth1/1")).empty());
+}
+
+TEST_F(SnapshotRecorderTest, Wraparound) {
+  auto recorder = open();
+  for (uint32_t i = 1; i <= 3 * kNumSlots; ++i) {
+    recorder->write("eth1/1/1", makeSnapshot("eth1/1/1", i));
+  }
+  auto records = recorder->read();
+  ASSERT_EQ(records.size(), kNumSlots);
+  for (uint32_t i = 0; i < kNumSlots; ++i) {
+    EXPECT_EQ(records[i].seq, 2 * kNumSlots + i + 1);
+    EXPECT_EQ(flaps(records[i]), 2 * kNumSlots + i + 1);
+  }
+}
+
+TEST_F(SnapshotRecorderTest, DropsOversizedSnapshots) {
+  auto recorder = open();
+  std::string longName(kSlotSize, 'x');
+  EXPECT_EQ(recorder->write(longName, makeSnapshot("eth1/1/1", 1)), 0);
+  EXPECT_EQ(recorder->numDropped(), 1);
+  EXPECT_TRUE(recorder->read().empty());
+}
+
+TEST_F(SnapshotRecorderTest, RecoverAfterCrash) {
+  auto pid = fork();
+  ASSERT_NE(pid, -1);
+  if (pid == 0) {
+    // Write and die without unmapping or closing anything
+    auto recorder = new SnapshotRecorder(path_, kNumSlots, kSlotSize);
+    for (uint32_t i = 1; i <= kNumSlots + 2; ++i) {
+      recorder->write("eth1/1/1", makeSnapshot("eth1/1/1", i));
+    }
+    _exit(0);
+  }
+  int status;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+
+  auto reader = SnapshotRecorder::openReadOnly(path_);
+  auto records = reader->read();
+  ASSERT_EQ(records.size(), kNumSlots);
+  EXPECT_EQ(records.front().seq, 3);
+  EXPECT_EQ(records.back().seq, kNumSlots + 2);
+
+  // New records carry on after the recovered ones
+  auto recorder = open();
+  EXPECT_EQ(
+      recorder->write("eth1/1/1", makeSnapshot("eth1/1/1", 0)), kNumSlots + 3);
+  EXPECT_EQ(recorder->read().size(), kNumSlots);
+}
+
+TEST_F(SnapshotRecorderTest, SkipTornRecord) {
+  {
+    auto recorder = open();
+    recorder->write("eth1/1/1", makeSnapshot("eth1/1/1", 1));
+    recorder->write("eth1/1/1", makeSnapshot("eth1/1/1", 2));
+  }
+  // Corrupt the payload of the first slot, as a crash mid write would
+  {
+    folly::File file(path_, O_RDWR);
+    auto offset = 64 + 32 + strlen("eth1/1/1") + 2;
+    ASSERT_EQ(folly::pwriteFull(file.fd(), "\xff\xff", 2, offset), 2);
+  }
+  auto records = open()->read();
+  ASSERT_EQ(records.size(), 1);
+  EXPECT_EQ(records[0].seq, 2);
+}
+
+TEST_F(SnapshotRecorderTest, GeometryChangeResets) {
+  open()->write("eth1/1/1", makeSnapshot("eth1/1/1", 1));
+  EXPECT_EQ(open()->read().size(), 1);
+
+  auto recorder = open(2 * kNumSlots);
+  EXPECT_TRUE(recorder->read().empty());
+  EXPECT_EQ(recorder->write("eth1/1/1", makeSnapshot("eth1/1/1", 1)), 1);
+}
+
+TEST_F(SnapshotRecorderTest, ReadOnlyRejectsOtherFiles) {
+  folly::writeFile(std::string(1024, 'x'), path_.c_str());
+  EXPECT_THROW(SnapshotRecorder::openReadOnly(path_), FbossError);
+}
+
+TEST(RingBufferTest, OldestFirstAfterWrap) {
+  RingBuffer<int, 3> buf;
+  EXPECT_TRUE(buf.empty());
+  for (int i = 1; i <= 5; ++i) {
+    buf.write(i);
+  }
+  EXPECT_EQ(buf.size(), 3);
+  EXPECT_EQ(buf.last(), 5);
+  std::vector<int> values(buf.begin(), buf.end());
+  EXPECT_EQ(values, std::vector<int>({3, 4, 5}));
+}
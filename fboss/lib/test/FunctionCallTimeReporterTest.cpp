@@ -0,0 +1,142 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/lib/FunctionCallTimeReporter.h"
+
+#include <folly/FileUtil.h>
+#include <folly/experimental/TestUtil.h>
+#include <folly/json.h>
+#include <gtest/gtest.h>
+
+#include <optional>
+#include <thread>
+#include <vector>
+
+using namespace facebook::fboss;
+
+namespace {
+
+void innerWork() {
+  PROFILE_SPAN("inner");
+  std::this_thread::sleep_for(std::chrono::milliseconds(1));
+}
+
+void outerWork() {
+  PROFILE_SPAN("outer");
+  innerWork();
+}
+
+std::optional<ProfilingSpan::Stats> findStats(const std::string& name) {
+  for (const auto& stats : ProfilingSpan::getStats()) {
+    if (stats.name == name) {
+      return stats;
+    }
+  }
+  return std::nullopt;
+}
+
+folly::dynamic dumpChromeTrace() {
+  folly::test::TemporaryFile traceFile;
+  EXPECT_TRUE(ProfilingSpan::dumpChromeTrace(traceFile.path().string()));
+  std::string contents;
+  EXPECT_TRUE(folly::readFile(traceFile.path().string().c_str(), contents));
+  return folly::parseJson(contents);
+}
+
+} // namespace
+
+class ProfilingSpanTest : public ::testing::Test {
+ public:
+  void SetUp() override {
+    ProfilingSpan::reset();
+    FLAGS_enable_profiling_spans = true;
+  }
+
+  void TearDown() override {
+    FLAGS_enable_profiling_spans = false;
+  }
+};
+
+TEST_F(ProfilingSpanTest, disabled) {
+  FLAGS_enable_profiling_spans = false;
+  outerWork();
+  EXPECT_FALSE(findStats("outer").has_value());
+}
+
+TEST_F(ProfilingSpanTest, nestedSpans) {
+  for (auto i = 0; i < 10; ++i) {
+    outerWork();
+  }
+  // Same span under a different parent is tracked separately
+  innerWork();
+
+  auto outer = findStats("outer");
+  auto inner = findStats("outer/inner");
+  auto topLevelInner = findStats("inner");
+  ASSERT_TRUE(outer.has_value());
+  ASSERT_TRUE(inner.has_value());
+  ASSERT_TRUE(topLevelInner.has_value());
+  EXPECT_EQ(outer->count, 10);
+  EXPECT_EQ(inner->count, 10);
+  EXPECT_EQ(topLevelInner->count, 1);
+
+  EXPECT_GE(outer->totalNsecs, inner->totalNsecs);
+  EXPECT_LE(inner->p50Nsecs, inner->p99Nsecs);
+  EXPECT_LE(inner->p99Nsecs, inner->maxNsecs);
+  // Allow for some error converting TSC ticks to time
+  EXPECT_GE(inner->maxNsecs, 900'000);
+}
+
+TEST_F(ProfilingSpanTest, spansAcrossThreads) {
+  std::vector<std::thread> threads;
+  for (auto i = 0; i < 4; ++i) {
+    threads.emplace_back([]() { outerWork(); });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  auto outer = findStats("outer");
+  ASSERT_TRUE(outer.has_value());
+  EXPECT_EQ(outer->count, 4);
+}
+
+TEST_F(ProfilingSpanTest, exitedThreads) {
+  std::thread([]() { outerWork(); }).join();
+
+  // Times of an exited thread are kept, its trace events are dropped
+  auto outer = findStats("outer");
+  ASSERT_TRUE(outer.has_value());
+  EXPECT_EQ(outer->count, 1);
+  for (const auto& event : dumpChromeTrace()["traceEvents"]) {
+    EXPECT_NE(event["ph"], "X");
+  }
+
+  ProfilingSpan::reset();
+  EXPECT_FALSE(findStats("outer").has_value());
+}
+
+TEST_F(ProfilingSpanTest, chromeTrace) {
+  outerWork();
+  auto trace = dumpChromeTrace();
+  int outerEvents = 0, innerEvents = 0;
+  for (const auto& event : trace["traceEvents"]) {
+    if (event["ph"] != "X") {
+      continue;
+    }
+    EXPECT_GE(event["dur"].asDouble(), 0);
+    if (event["name"] == "outer") {
+      outerEvents++;
+    } else if (event["name"] == "inner") {
+      innerEvents++;
+    }
+  }
+  EXPECT_EQ(outerEvents, 1);
+  EXPECT_EQ(innerEvents, 1);
+}
@@ -9,6 +9,7 @@
  */
 
 #include "fboss/lib/ThreadHeartbeat.h"
+#include <folly/synchronization/Baton.h>
 #include <folly/system/ThreadName.h>
 #include <gtest/gtest.h>
 
@@ -60,3 +61,51 @@ TEST(ThreadHeartbeatTest, WatchDogTest) {
   testEvb.runInEventBaseThread([&testEvb] { testEvb.terminateLoopSoon(); });
   testThread.join();
 }
+
+TEST(ThreadHeartbeatTest, SlowCallbackTest) {
+  gflags::FlagSaver flagSaver;
+  FLAGS_thread_callback_stack_sampling = true;
+  folly::EventBase testEvb;
+  std::thread testThread([&testEvb]() {
+    folly::setThreadName("testThread");
+    testEvb.loopForever();
+  });
+  // sample stacks of callbacks running over 50ms
+  std::shared_ptr<ThreadHeartbeat> testHb = std::make_shared<ThreadHeartbeat>(
+      &testEvb,
+      "testThread",
+      heartbeatInterval,
+      [](int /*delay*/, int /*backLog*/) {},
+      std::chrono::milliseconds(heartbeatInterval * 5));
+  ThreadHeartbeatWatchdog testWd(
+      std::chrono::milliseconds(heartbeatInterval), []() {});
+  testWd.startMonitoringHeartbeat(testHb);
+  testWd.start();
+
+  // let the heartbeat start timing callbacks
+  testEvb.runInEventBaseThreadAndWait([]() {});
+  EXPECT_EQ(testHb->getSlowCallbackCount(), 0);
+
+  // inject a slow callback, and expect its stack to be sampled
+  folly::Baton<> done;
+  testEvb.runInEventBaseThread([&testEvb, &done]() {
+    testEvb.runInLoop([&done]() {
+      std::this_thread::sleep_for(
+          std::chrono::milliseconds(heartbeatInterval * 20));
+      done.post();
+    });
+  });
+  done.wait();
+  testEvb.runInEventBaseThreadAndWait([]() {});
+
+  EXPECT_GE(testHb->getSlowCallbackCount(), 1);
+  EXPECT_GE(
+      testHb->getMaxCallbackDuration(),
+      std::chrono::milliseconds(heartbeatInterval * 20));
+  EXPECT_FALSE(testHb->getLastSlowCallbackStack().empty());
+
+  testWd.stop();
+  testHb.reset();
+  testEvb.runInEventBaseThread([&testEvb] { testEvb.terminateLoopSoon(); });
+  testThread.join();
+}
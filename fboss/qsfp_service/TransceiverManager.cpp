@@ -69,6 +69,7 @@ TransceiverManager::TransceiverManager(
 }
 
 TransceiverManager::~TransceiverManager() {
+  drainTransceiverRefresh();
   // Make sure if gracefulExit() is not called, we will still stop the threads
   if (!isExiting_) {
     isExiting_ = true;
@@ -149,8 +150,10 @@ void TransceiverManager::restoreAgentConfigAppliedInfo() {
 void TransceiverManager::gracefulExit() {
   steady_clock::time_point begin = steady_clock::now();
   XLOG(INFO) << "[Exit] Starting TransceiverManager graceful exit";
-  // Stop all the threads before shutdown
+  // Stop all the threads before shutdown, stragglers still refreshing may
+  // need the state machine threads
   isExiting_ = true;
+  drainTransceiverRefresh();
   stopThreads();
   steady_clock::time_point stopThreadsDone = steady_clock::now();
   XLOG(INFO) << "[Exit] Stopped all state machine threads. Stop time: "
@@ -1691,26 +1694,89 @@ Transceiver* FOLLY_NULLABLE TransceiverManager::overrideTransceiverForTesting(
 std::vector<TransceiverID> TransceiverManager::refreshTransceivers(
     const std::unordered_set<TransceiverID>& transceivers) {
   std::vector<TransceiverID> transceiverIds;
-  std::vector<folly::Future<folly::Unit>> futs;
+  std::vector<TransceiverRefreshScheduler::Module> modules;
+  {
+    auto lockedTransceivers = transceivers_.rlock();
+    auto nTransceivers =
+        transceivers.empty() ? lockedTransceivers->size() : transceivers.size();
+    XLOG(INFO) << "Start refreshing " << nTransceivers << " transceivers...";
+
+    for (const auto& transceiver : *lockedTransceivers) {
+      TransceiverID id = TransceiverID(transceiver.second->getID());
+      if (!transceivers.empty() &&
+          transceivers.find(id) == transceivers.end()) {
+        continue;
+      }
+      XLOG(DBG3) << "Fired to refresh TransceiverID=" << id;
+      transceiverIds.push_back(id);
+      modules.push_back(
+          {id,
+           transceiver.second->getI2cEventBase(),
+           isBringingUp(id),
+           [this, id, tcvr = transceiver.second]() {
+             // Skip modules replaced since this cycle started. Replacing a
+             // module pauses its bus, so this can't race the replacement.
+             {
+               auto current = transceivers_.rlock();
+               auto it = current->find(id);
+               if (it == current->end() || it->second != tcvr) {
+                 return;
+               }
+             }
+             tcvr->refresh();
+           }});
+    }
+  }
 
-  auto lockedTransceivers = transceivers_.rlock();
-  auto nTransceivers =
-      transceivers.empty() ? lockedTransceivers->size() : transceivers.size();
-  XLOG(INFO) << "Start refreshing " << nTransceivers << " transceivers...";
+  // Don't hold the lock while refreshing, the refreshes of stragglers keep
+  // their transceiver alive
+  auto stats = refreshScheduler_.refresh(std::move(modules));
+  XLOG(INFO) << "Finished refreshing " << stats.numRefreshed
+             << " transceivers in "
+             << duration_cast<milliseconds>(stats.cycleTime).count()
+             << "ms, " << stats.numStragglers << " still refreshing, "
+             << stats.numSkipped << " skipped as their bus is busy";
+  *lastRefreshStats_.wlock() = std::move(stats);
+  return transceiverIds;
+}
 
-  for (const auto& transceiver : *lockedTransceivers) {
-    TransceiverID id = TransceiverID(transceiver.second->getID());
-    if (!transceivers.empty() && transceivers.find(id) == transceivers.end()) {
-      continue;
+TransceiverRefreshScheduler::BusPause
+TransceiverManager::pauseTransceiverRefresh(
+    const std::unordered_set<TransceiverID>& transceivers) {
+  return pauseTransceiverRefresh(
+      transceivers, milliseconds(FLAGS_transceiver_refresh_timeout_ms));
+}
+
+TransceiverRefreshScheduler::BusPause
+TransceiverManager::pauseTransceiverRefresh(
+    const std::unordered_set<TransceiverID>& transceivers,
+    milliseconds timeout) {
+  std::vector<folly::EventBase*> buses;
+  {
+    auto lockedTransceivers = transceivers_.rlock();
+    for (const auto& [id, tcvr] : *lockedTransceivers) {
+      if (transceivers.empty() || transceivers.count(id)) {
+        buses.push_back(tcvr->getI2cEventBase());
+      }
     }
-    XLOG(DBG3) << "Fired to refresh TransceiverID=" << id;
-    transceiverIds.push_back(id);
-    futs.push_back(transceiver.second->futureRefresh());
   }
+  return refreshScheduler_.pauseBuses(buses, timeout);
+}
 
-  folly::collectAll(futs.begin(), futs.end()).wait();
-  XLOG(INFO) << "Finished refreshing " << nTransceivers << " transceivers";
-  return transceiverIds;
+bool TransceiverManager::isBringingUp(TransceiverID id) const {
+  if (stateMachines_.find(id) == stateMachines_.end()) {
+    return false;
+  }
+  switch (getCurrentState(id)) {
+    case TransceiverStateMachineState::PRESENT:
+    case TransceiverStateMachineState::DISCOVERED:
+    case TransceiverStateMachineState::IPHY_PORTS_PROGRAMMED:
+    case TransceiverStateMachineState::XPHY_PORTS_PROGRAMMED:
+    case TransceiverStateMachineState::TRANSCEIVER_PROGRAMMED:
+      return true;
+    default:
+      return false;
+  }
 }
 
 void TransceiverManager::resetTransceiver(
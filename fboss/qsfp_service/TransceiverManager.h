@@ -23,6 +23,7 @@
 #include "fboss/lib/platforms/PlatformMode.h"
 #include "fboss/lib/usb/TransceiverPlatformApi.h"
 #include "fboss/qsfp_service/QsfpConfig.h"
+#include "fboss/qsfp_service/TransceiverRefreshScheduler.h"
 #include "fboss/qsfp_service/TransceiverStateMachineUpdate.h"
 #include "fboss/qsfp_service/module/Transceiver.h"
 
@@ -86,10 +87,17 @@ class TransceiverManager {
   virtual std::vector<TransceiverID> refreshTransceivers() = 0;
   // Refresh specified Transceivers
   // If `transceivers` is empty, we'll refresh all existing transceivers
+  // Transceivers whose I2C bus doesn't finish the refresh within
+  // --transceiver_refresh_timeout_ms are left refreshing in the background.
   // Return: The refreshed transceiver ids
   std::vector<TransceiverID> refreshTransceivers(
       const std::unordered_set<TransceiverID>& transceivers);
 
+  // Timing of the last refreshTransceivers() call, per I2C bus
+  TransceiverRefreshScheduler::CycleStats getLastRefreshStats() const {
+    return *lastRefreshStats_.rlock();
+  }
+
   virtual int scanTransceiverPresence(
       std::unique_ptr<std::vector<int32_t>> ids) = 0;
 
@@ -405,8 +413,13 @@ class TransceiverManager {
 
   OverrideTcvrToPortAndProfile overrideTcvrToPortAndProfileForTest_;
 
-  folly::Synchronized<std::map<TransceiverID, std::unique_ptr<Transceiver>>>
+  // Transceivers are shared with the refreshes still running on their I2C
+  // bus, which may outlive the refresh cycle that started them
+  folly::Synchronized<std::map<TransceiverID, std::shared_ptr<Transceiver>>>
       transceivers_;
+  TransceiverRefreshScheduler refreshScheduler_;
+  folly::Synchronized<TransceiverRefreshScheduler::CycleStats>
+      lastRefreshStats_;
   /* This variable stores the TransceiverPlatformApi object for controlling
    * the QSFP devies on board. This handle is populated from this class
    * constructor
@@ -448,6 +461,9 @@ class TransceiverManager {
   void waitForAllBlockingStateUpdateDone(
       const BlockingStateUpdateResultList& results);
 
+  // Whether the transceiver's state machine is still bringing its ports up
+  bool isBringingUp(TransceiverID id) const;
+
   /*
    * This is the private class to capture all information a
    * TransceiverStateMachine needs
@@ -501,6 +517,28 @@ class TransceiverManager {
   void stopThreads();
   void threadLoop(folly::StringPiece name, folly::EventBase* eventBase);
 
+  // Keep refresh cycles off the I2C buses of the given transceivers (all if
+  // empty), so that they can be reset or replaced. Waits up to timeout,
+  // --transceiver_refresh_timeout_ms by default, for refreshes already
+  // running on them.
+  TransceiverRefreshScheduler::BusPause pauseTransceiverRefresh(
+      const std::unordered_set<TransceiverID>& transceivers);
+  TransceiverRefreshScheduler::BusPause pauseTransceiverRefresh(
+      const std::unordered_set<TransceiverID>& transceivers,
+      std::chrono::milliseconds timeout);
+
+  // Whether an I2C bus is still busy refreshing, see
+  // TransceiverRefreshScheduler::isBusy()
+  bool isTransceiverRefreshBusy(folly::EventBase* bus) {
+    return refreshScheduler_.isBusy(bus);
+  }
+
+  // Wait for refreshes still running in the background. Transceivers hold a
+  // raw pointer to their manager, so this must happen before it goes away.
+  void drainTransceiverRefresh() {
+    refreshScheduler_.drain();
+  }
+
   /**
    * Schedule an update to the switch state.
    *
@@ -0,0 +1,243 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/qsfp_service/TransceiverRefreshScheduler.h"
+
+#include <folly/ScopeGuard.h>
+#include <folly/String.h>
+#include <folly/futures/Future.h>
+#include <folly/logging/xlog.h>
+
+#include <algorithm>
+#include <map>
+
+DEFINE_int32(
+    transceiver_refresh_timeout_ms,
+    10000,
+    "How long a transceiver refresh cycle waits for the I2C buses. Buses "
+    "still refreshing after this finish in the background, and are skipped by "
+    "later cycles until they do");
+
+using namespace std::chrono;
+
+namespace facebook::fboss {
+
+TransceiverRefreshScheduler::CycleStats TransceiverRefreshScheduler::refresh(
+    std::vector<Module> modules) {
+  auto start = Clock::now();
+  CycleStats stats;
+
+  // Keep the order of the modules within each priority
+  std::stable_partition(
+      modules.begin(), modules.end(), [](const auto& module) {
+        return module.highPriority;
+      });
+  std::map<folly::EventBase*, std::vector<Module>> queues;
+  for (auto& module : modules) {
+    queues[module.bus].push_back(std::move(module));
+  }
+
+  struct PendingBus {
+    size_t index;
+    std::vector<int32_t> ids;
+    folly::Future<microseconds> done;
+  };
+  std::vector<PendingBus> pending;
+  const std::vector<Module>* callerQueue{nullptr};
+  std::shared_ptr<BusState> callerBusy;
+
+  for (auto& [bus, queue] : queues) {
+    BusStats busStats;
+    busStats.bus = bus;
+    busStats.numModules = queue.size();
+    stats.buses.push_back(busStats);
+
+    auto busy = getBusState(bus);
+    if (!busy->tryAcquire()) {
+      stats.buses.back().skipped = true;
+      stats.numSkipped += queue.size();
+      continue;
+    }
+    if (!bus) {
+      // Refreshed below, once all the other buses are busy
+      callerQueue = &queue;
+      callerBusy = std::move(busy);
+      continue;
+    }
+
+    std::vector<int32_t> ids;
+    for (const auto& module : queue) {
+      ids.push_back(static_cast<int32_t>(module.id));
+    }
+    auto done = folly::via(bus).thenValue(
+        [queue = std::move(queue), busy](auto&&) {
+          SCOPE_EXIT {
+            busy->release();
+          };
+          return refreshQueue(queue);
+        });
+    pending.push_back(
+        {stats.buses.size() - 1, std::move(ids), std::move(done)});
+  }
+
+  if (callerQueue) {
+    auto it = std::find_if(
+        stats.buses.begin(), stats.buses.end(), [](const auto& busStats) {
+          return busStats.bus == nullptr;
+        });
+    SCOPE_EXIT {
+      callerBusy->release();
+    };
+    it->busyTime = refreshQueue(*callerQueue);
+    stats.numRefreshed += it->numModules;
+  }
+
+  auto deadline = start + timeout_;
+  for (auto& bus : pending) {
+    auto now = Clock::now();
+    if (now < deadline) {
+      bus.done.wait(deadline - now);
+    }
+    auto& busStats = stats.buses[bus.index];
+    if (bus.done.hasValue()) {
+      busStats.busyTime = bus.done.value();
+      stats.numRefreshed += busStats.numModules;
+    } else {
+      XLOG(WARN) << "Transceivers " << folly::join(",", bus.ids)
+                 << " are still refreshing after " << timeout_.count()
+                 << "ms, not waiting for them";
+      busStats.straggler = true;
+      stats.numStragglers += busStats.numModules;
+    }
+  }
+
+  stats.cycleTime = duration_cast<microseconds>(Clock::now() - start);
+  for (auto& busStats : stats.buses) {
+    if (busStats.straggler) {
+      busStats.busyTime = stats.cycleTime;
+    }
+  }
+  return stats;
+}
+
+TransceiverRefreshScheduler::BusPause TransceiverRefreshScheduler::pauseBuses(
+    const std::vector<folly::EventBase*>& buses,
+    milliseconds timeout) {
+  auto deadline = Clock::now() + timeout;
+  BusPause pause;
+  for (auto bus : buses) {
+    if (pause.isPaused(bus)) {
+      continue;
+    }
+    auto busy = getBusState(bus);
+    if (busy->acquireUntil(deadline)) {
+      pause.paused_.emplace_back(bus, std::move(busy));
+    } else {
+      XLOG(WARN) << "I2C bus " << bus << " is still refreshing after "
+                 << timeout.count() << "ms, not pausing it";
+    }
+  }
+  return pause;
+}
+
+void TransceiverRefreshScheduler::drain() {
+  std::vector<std::shared_ptr<BusState>> buses;
+  {
+    std::lock_guard<std::mutex> g(busyMutex_);
+    for (const auto& entry : busy_) {
+      buses.push_back(entry.second);
+    }
+  }
+  for (auto& busy : buses) {
+    busy->acquire();
+    busy->release();
+  }
+}
+
+bool TransceiverRefreshScheduler::isBusy(folly::EventBase* bus) {
+  return getBusState(bus)->isBusy();
+}
+
+std::shared_ptr<TransceiverRefreshScheduler::BusState>
+TransceiverRefreshScheduler::getBusState(folly::EventBase* bus) {
+  std::lock_guard<std::mutex> g(busyMutex_);
+  auto& entry = busy_[bus];
+  if (!entry) {
+    entry = std::make_shared<BusState>();
+  }
+  return entry;
+}
+
+TransceiverRefreshScheduler::BusPause::~BusPause() {
+  for (auto& [bus, busy] : paused_) {
+    busy->release();
+  }
+}
+
+bool TransceiverRefreshScheduler::BusPause::isPaused(
+    folly::EventBase* bus) const {
+  return std::any_of(paused_.begin(), paused_.end(), [bus](const auto& entry) {
+    return entry.first == bus;
+  });
+}
+
+bool TransceiverRefreshScheduler::BusState::tryAcquire() {
+  std::lock_guard<std::mutex> g(mutex_);
+  if (busy_) {
+    return false;
+  }
+  busy_ = true;
+  return true;
+}
+
+bool TransceiverRefreshScheduler::BusState::acquireUntil(
+    Clock::time_point deadline) {
+  std::unique_lock<std::mutex> lk(mutex_);
+  if (!idle_.wait_until(lk, deadline, [this] { return !busy_; })) {
+    return false;
+  }
+  busy_ = true;
+  return true;
+}
+
+void TransceiverRefreshScheduler::BusState::acquire() {
+  std::unique_lock<std::mutex> lk(mutex_);
+  idle_.wait(lk, [this] { return !busy_; });
+  busy_ = true;
+}
+
+void TransceiverRefreshScheduler::BusState::release() {
+  {
+    std::lock_guard<std::mutex> g(mutex_);
+    busy_ = false;
+  }
+  idle_.notify_all();
+}
+
+bool TransceiverRefreshScheduler::BusState::isBusy() {
+  std::lock_guard<std::mutex> g(mutex_);
+  return busy_;
+}
+
+microseconds TransceiverRefreshScheduler::refreshQueue(
+    const std::vector<Module>& queue) {
+  auto start = Clock::now();
+  for (const auto& module : queue) {
+    try {
+      module.refresh();
+    } catch (const std::exception& ex) {
+      XLOG(DBG2) << "Error refreshing TransceiverID=" << module.id << ": "
+                 << folly::exceptionStr(ex);
+    }
+  }
+  return duration_cast<microseconds>(Clock::now() - start);
+}
+
+} // namespace facebook::fboss
@@ -0,0 +1,166 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include "fboss/agent/types.h"
+
+#include <folly/container/F14Map.h>
+#include <folly/io/async/EventBase.h>
+#include <gflags/gflags.h>
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+DECLARE_int32(transceiver_refresh_timeout_ms);
+
+namespace facebook::fboss {
+
+/*
+ * TransceiverRefreshScheduler runs a refresh cycle over a set of transceiver
+ * modules, treating every I2C bus (one per event base, e.g. one per FPGA I2C
+ * controller) as its own queue:
+ *
+ * - Buses are refreshed in parallel, modules on the same bus one at a time,
+ *   modules bringing up links before the ones that are only polled for DOM.
+ * - Modules without an I2C event base share one bus, refreshed in the
+ *   calling thread.
+ * - A cycle waits at most the timeout for the buses. Buses still busy after
+ *   that finish in the background, and later cycles skip them until they do,
+ *   so one slow or hung module only holds up its own bus.
+ *
+ * refresh() may be called from several threads, though buses still busy
+ * with one call are skipped by the others.
+ *
+ * Modules must only be reset, replaced or destroyed once their bus is done
+ * with them: pauseBuses() waits for the refreshes running on a bus and keeps
+ * later cycles off it, drain() waits for every refresh still running.
+ */
+class TransceiverRefreshScheduler {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  struct Module {
+    TransceiverID id;
+    // nullptr if the module's I2C transactions run in the caller's thread
+    folly::EventBase* bus{nullptr};
+    // Modules bringing up links are refreshed first on their bus
+    bool highPriority{false};
+    // Must keep whatever it refreshes alive, it may outlive the cycle
+    std::function<void()> refresh;
+  };
+
+  struct BusStats {
+    folly::EventBase* bus{nullptr};
+    size_t numModules{0};
+    // Time spent refreshing, the whole cycle if the bus straggled
+    std::chrono::microseconds busyTime{0};
+    // Still refreshing when the cycle finished
+    bool straggler{false};
+    // Not refreshed, as it was still busy with an earlier cycle
+    bool skipped{false};
+  };
+
+  struct CycleStats {
+    std::chrono::microseconds cycleTime{0};
+    size_t numRefreshed{0};
+    size_t numStragglers{0};
+    size_t numSkipped{0};
+    std::vector<BusStats> buses;
+  };
+
+  TransceiverRefreshScheduler()
+      : TransceiverRefreshScheduler(
+            std::chrono::milliseconds(FLAGS_transceiver_refresh_timeout_ms)) {}
+  explicit TransceiverRefreshScheduler(std::chrono::milliseconds timeout)
+      : timeout_(timeout) {}
+
+  CycleStats refresh(std::vector<Module> modules);
+
+ private:
+  class BusState;
+
+ public:
+  /*
+   * Keeps refresh cycles off a set of buses until destroyed. Buses whose
+   * refreshes didn't finish in time are not paused, see isPaused().
+   */
+  class BusPause {
+   public:
+    BusPause() = default;
+    ~BusPause();
+    BusPause(BusPause&&) = default;
+    BusPause& operator=(BusPause&&) = delete;
+
+    bool isPaused(folly::EventBase* bus) const;
+
+   private:
+    friend class TransceiverRefreshScheduler;
+    std::vector<std::pair<folly::EventBase*, std::shared_ptr<BusState>>>
+        paused_;
+  };
+
+  /*
+   * Wait up to timeout for the refreshes running on buses to finish, then
+   * pause them. Modules on a paused bus can be reset or replaced without
+   * racing their refresh.
+   */
+  BusPause pauseBuses(
+      const std::vector<folly::EventBase*>& buses,
+      std::chrono::milliseconds timeout);
+
+  // Wait for every refresh still running, including stragglers
+  void drain();
+
+  /*
+   * Whether bus is refreshing or paused right now. Outside of a refresh
+   * cycle, a busy bus is one still straggling from an earlier cycle.
+   */
+  bool isBusy(folly::EventBase* bus);
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  TransceiverRefreshScheduler(TransceiverRefreshScheduler const&) = delete;
+  TransceiverRefreshScheduler& operator=(TransceiverRefreshScheduler const&) =
+      delete;
+
+  // Busy while a bus is refreshing or paused. Shared with the refresh
+  // running on the bus, which may outlive the cycle that started it.
+  class BusState {
+   public:
+    bool tryAcquire();
+    // Returns false if still busy at deadline
+    bool acquireUntil(Clock::time_point deadline);
+    void acquire();
+    void release();
+    bool isBusy();
+
+   private:
+    std::mutex mutex_;
+    std::condition_variable idle_;
+    bool busy_{false};
+  };
+
+  std::shared_ptr<BusState> getBusState(folly::EventBase* bus);
+
+  static std::chrono::microseconds refreshQueue(
+      const std::vector<Module>& queue);
+
+  const std::chrono::milliseconds timeout_;
+
+  std::mutex busyMutex_;
+  folly::F14FastMap<folly::EventBase*, std::shared_ptr<BusState>> busy_;
+};
+
+} // namespace facebook::fboss
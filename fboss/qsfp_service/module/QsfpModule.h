@@ -90,6 +90,9 @@ class QsfpModule : public Transceiver {
 
   virtual void refresh() override;
   folly::Future<folly::Unit> futureRefresh() override;
+  folly::EventBase* getI2cEventBase() override {
+    return qsfpImpl_->getI2cEventBase();
+  }
 
   /*
    * Customize QSPF fields as necessary
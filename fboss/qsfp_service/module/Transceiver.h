@@ -17,6 +17,7 @@
 #include "fboss/qsfp_service/if/gen-cpp2/transceiver_types.h"
 
 #include <folly/futures/Future.h>
+#include <folly/io/async/EventBase.h>
 
 namespace facebook {
 namespace fboss {
@@ -76,6 +77,12 @@ class Transceiver {
   virtual void refresh() = 0;
   virtual folly::Future<folly::Unit> futureRefresh() = 0;
 
+  /*
+   * The event base running the I2C transactions of the bus this transceiver
+   * is on, or nullptr if they run in the caller's thread.
+   */
+  virtual folly::EventBase* getI2cEventBase() = 0;
+
   /*
    * Return all of the transceiver information
    */
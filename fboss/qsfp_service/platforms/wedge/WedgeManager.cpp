@@ -23,6 +23,7 @@
 #include <folly/logging/xlog.h>
 #include <thrift/lib/cpp/util/EnumUtils.h>
 #include <chrono>
+#include <optional>
 
 DEFINE_bool(
     override_program_iphy_ports_for_test,
@@ -41,7 +42,7 @@ static const std::unordered_set<TransceiverID> kEmptryTransceiverIDs = {};
 } // namespace
 
 using LockedTransceiversPtr = folly::Synchronized<
-    std::map<TransceiverID, std::unique_ptr<Transceiver>>>::WLockedPtr;
+    std::map<TransceiverID, std::shared_ptr<Transceiver>>>::WLockedPtr;
 
 WedgeManager::WedgeManager(
     std::unique_ptr<TransceiverPlatformApi> api,
@@ -388,7 +389,15 @@ void WedgeManager::clearAllTransceiverReset() {
 }
 
 void WedgeManager::triggerQsfpHardReset(int idx) {
+  // Don't reset the module in the middle of a refresh
+  auto pause = pauseTransceiverRefresh({TransceiverID(idx)});
   auto lockedTransceivers = transceivers_.wlock();
+  if (auto it = lockedTransceivers->find(TransceiverID(idx));
+      it != lockedTransceivers->end() &&
+      !pause.isPaused(it->second->getI2cEventBase())) {
+    throw FbossError(
+        "TransceiverID=", idx, " is still refreshing, not hard resetting it");
+  }
   triggerQsfpHardResetLocked(idx, lockedTransceivers);
 }
 
@@ -410,24 +419,59 @@ std::unique_ptr<TransceiverI2CApi> WedgeManager::getI2CBus() {
 }
 
 void WedgeManager::updateTransceiverMap() {
-  std::vector<folly::Future<TransceiverManagementInterface>> futInterfaces;
+  // Detection runs on the same I2C event bases as the refreshes, don't queue
+  // it behind a bus still straggling from an earlier cycle
+  std::vector<std::optional<folly::Future<TransceiverManagementInterface>>>
+      futInterfaces;
   std::vector<std::unique_ptr<WedgeQsfp>> qsfpImpls;
   for (int idx = 0; idx < getNumQsfpModules(); idx++) {
     qsfpImpls.push_back(std::make_unique<WedgeQsfp>(idx, wedgeI2cBus_.get()));
-    futInterfaces.push_back(
+    auto i2cEvb = qsfpImpls[idx]->getI2cEventBase();
+    if (i2cEvb && isTransceiverRefreshBusy(i2cEvb)) {
+      XLOG(WARN) << "TransceiverID=" << idx << " is still refreshing, "
+                 << "not detecting its management interface";
+      futInterfaces.emplace_back();
+      continue;
+    }
+    futInterfaces.emplace_back(
         qsfpImpls[idx]->futureGetTransceiverManagementInterface());
   }
-  folly::collectAllUnsafe(futInterfaces.begin(), futInterfaces.end()).wait();
+  // Bound the wait like a refresh cycle, a bus may hang on this too
+  auto deadline = std::chrono::steady_clock::now() +
+      std::chrono::milliseconds(FLAGS_transceiver_refresh_timeout_ms);
+  for (int idx = 0; idx < futInterfaces.size(); idx++) {
+    auto& futInterface = futInterfaces[idx];
+    if (!futInterface) {
+      continue;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now < deadline) {
+      futInterface->wait(deadline - now);
+    }
+    if (!futInterface->isReady()) {
+      // Keep the WedgeQsfp alive until its detection finishes, dropping
+      // the future doesn't cancel it
+      auto detached = std::move(*futInterface)
+                          .ensure([qsfpImpl = std::shared_ptr<WedgeQsfp>(
+                                       std::move(qsfpImpls[idx]))]() {});
+      futInterface.reset();
+    }
+  }
+  // Modules may only be replaced or reset once their bus is done refreshing
+  // them, keep refreshes off the buses until we're done. Buses still busy
+  // now are straggling, don't wait for them.
+  auto pause = pauseTransceiverRefresh({}, std::chrono::milliseconds(0));
   // After we have collected all transceivers, get the write lock on
   // transceivers_ before updating it
   auto lockedTransceivers = transceivers_.wlock();
   for (int idx = 0; idx < qsfpImpls.size(); idx++) {
-    if (!futInterfaces[idx].isReady()) {
+    if (!futInterfaces[idx]) {
       XLOG(ERR)
           << "Failed getting TransceiverManagementInterface for TransceiverID="
           << idx;
       continue;
     }
+    auto managementInterface = futInterfaces[idx]->value();
     // Check whether all ports are down before the rest logic tries to erase
     // the old QsfpModule. So even after we erase this QsfpModule, we can still
     // try to hard reset to remediate it as long as all the ports are down.
@@ -436,9 +480,13 @@ void WedgeManager::updateTransceiverMap() {
     if (it != lockedTransceivers->end()) {
       // In the case where we already have a transceiver recorded, try to check
       // whether they match the transceiver type.
-      if (it->second->managementInterface() == futInterfaces[idx].value()) {
+      if (it->second->managementInterface() == managementInterface) {
         // The management interface matches. Nothing needs to be done.
         continue;
+      } else if (!pause.isPaused(it->second->getI2cEventBase())) {
+        XLOG(WARN) << "TransceiverID=" << idx << " is still refreshing, "
+                   << "will replace it once its refresh is done";
+        continue;
       } else {
         // The management changes. Need to Delete the old module to make place
         // for the new one.
@@ -448,26 +496,26 @@ void WedgeManager::updateTransceiverMap() {
 
     // Either we don't have a transceiver here before or we had a new one since
     // the management interface changed, we want to create a new module here.
-    if (futInterfaces[idx].value() == TransceiverManagementInterface::CMIS) {
+    if (managementInterface == TransceiverManagementInterface::CMIS) {
       XLOG(INFO) << "Making CMIS QSFP for TransceiverID=" << idx;
       lockedTransceivers->emplace(
           TransceiverID(idx),
           std::make_unique<CmisModule>(this, std::move(qsfpImpls[idx])));
     } else if (
-        futInterfaces[idx].value() == TransceiverManagementInterface::SFF) {
+        managementInterface == TransceiverManagementInterface::SFF) {
       XLOG(INFO) << "Making Sff QSFP for TransceiverID=" << idx;
       lockedTransceivers->emplace(
           TransceiverID(idx),
           std::make_unique<SffModule>(this, std::move(qsfpImpls[idx])));
     } else if (
-        futInterfaces[idx].value() == TransceiverManagementInterface::SFF8472) {
+        managementInterface == TransceiverManagementInterface::SFF8472) {
       XLOG(INFO) << "Making Sff8472 module for TransceiverID=" << idx;
       lockedTransceivers->emplace(
           TransceiverID(idx),
           std::make_unique<Sff8472Module>(this, std::move(qsfpImpls[idx])));
     } else {
       XLOG(ERR) << "Unknown Transceiver interface: "
-                << static_cast<int>(futInterfaces[idx].value())
+                << static_cast<int>(managementInterface)
                 << " for TransceiverID=" << idx;
 
       try {
@@ -28,7 +28,10 @@ class WedgeManager : public TransceiverManager {
       std::unique_ptr<TransceiverPlatformApi> api,
       std::unique_ptr<PlatformMapping> platformMapping,
       PlatformMode mode);
-  ~WedgeManager() override {}
+  ~WedgeManager() override {
+    // Stragglers may still be using the I2C bus owned by this class
+    drainTransceiverRefresh();
+  }
 
   void getTransceiversInfo(
       TransceiverMap& info,
@@ -166,7 +169,9 @@ class WedgeManager : public TransceiverManager {
   void loadConfig() override;
 
   using LockedTransceiversPtr = folly::Synchronized<
-      std::map<TransceiverID, std::unique_ptr<Transceiver>>>::WLockedPtr;
+      std::map<TransceiverID, std::shared_ptr<Transceiver>>>::WLockedPtr;
+  // Refreshes of the module's bus must be paused, see
+  // pauseTransceiverRefresh()
   void triggerQsfpHardResetLocked(
       int idx,
       LockedTransceiversPtr& lockedTransceivers);
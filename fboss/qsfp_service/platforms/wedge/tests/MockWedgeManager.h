@@ -65,7 +65,7 @@ class MockWedgeManager : public WedgeManager {
     return currentModules;
   }
 
-  folly::Synchronized<std::map<TransceiverID, std::unique_ptr<Transceiver>>>&
+  folly::Synchronized<std::map<TransceiverID, std::shared_ptr<Transceiver>>>&
   getSynchronizedTransceivers() {
     return transceivers_;
   }
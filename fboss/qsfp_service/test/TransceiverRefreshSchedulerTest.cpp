@@ -0,0 +1,207 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include "fboss/qsfp_service/TransceiverRefreshScheduler.h"
+
+#include <folly/io/async/ScopedEventBaseThread.h>
+#include <folly/synchronization/Baton.h>
+#include <gtest/gtest.h>
+
+#include <thread>
+
+using namespace facebook::fboss;
+using namespace std::chrono;
+
+namespace {
+
+using Module = TransceiverRefreshScheduler::Module;
+
+Module makeModule(
+    int id,
+    folly::EventBase* bus,
+    bool highPriority,
+    std::function<void()> refresh) {
+  return {TransceiverID(id), bus, highPriority, std::move(refresh)};
+}
+
+} // namespace
+
+TEST(TransceiverRefreshSchedulerTest, BusesRefreshInParallel) {
+  folly::ScopedEventBaseThread bus1, bus2;
+  TransceiverRefreshScheduler scheduler(seconds(10));
+  std::atomic<int> numRefreshed{0};
+  auto slowRefresh = [&numRefreshed]() {
+    /* sleep override */
+    std::this_thread::sleep_for(milliseconds(200));
+    numRefreshed++;
+  };
+
+  std::vector<Module> modules;
+  modules.push_back(makeModule(0, bus1.getEventBase(), false, slowRefresh));
+  modules.push_back(makeModule(1, bus2.getEventBase(), false, slowRefresh));
+  modules.push_back(makeModule(2, nullptr, false, slowRefresh));
+  auto stats = scheduler.refresh(std::move(modules));
+
+  EXPECT_EQ(numRefreshed, 3);
+  EXPECT_EQ(stats.numRefreshed, 3);
+  EXPECT_EQ(stats.numStragglers, 0);
+  EXPECT_EQ(stats.buses.size(), 3);
+  // Much less than refreshing the three modules one after the other
+  EXPECT_LT(stats.cycleTime, milliseconds(500));
+  for (const auto& bus : stats.buses) {
+    EXPECT_EQ(bus.numModules, 1);
+    EXPECT_GE(bus.busyTime, milliseconds(200));
+  }
+}
+
+TEST(TransceiverRefreshSchedulerTest, BringupModulesFirst) {
+  folly::ScopedEventBaseThread bus;
+  TransceiverRefreshScheduler scheduler(seconds(10));
+  std::vector<int> order;
+  auto record = [&order](int id) {
+    return [&order, id]() { order.push_back(id); };
+  };
+
+  std::vector<Module> modules;
+  modules.push_back(makeModule(0, bus.getEventBase(), false, record(0)));
+  modules.push_back(makeModule(1, bus.getEventBase(), true, record(1)));
+  modules.push_back(makeModule(2, bus.getEventBase(), false, record(2)));
+  modules.push_back(makeModule(3, bus.getEventBase(), true, record(3)));
+  scheduler.refresh(std::move(modules));
+
+  EXPECT_EQ(order, std::vector<int>({1, 3, 0, 2}));
+}
+
+TEST(TransceiverRefreshSchedulerTest, DontWaitForStragglers) {
+  folly::ScopedEventBaseThread slowBus, fastBus;
+  TransceiverRefreshScheduler scheduler(milliseconds(100));
+  folly::Baton<> unblock;
+  std::atomic<int> numSlowRefreshed{0}, numFastRefreshed{0};
+
+  auto makeModules = [&]() {
+    std::vector<Module> modules;
+    modules.push_back(makeModule(0, slowBus.getEventBase(), false, [&]() {
+      unblock.wait();
+      numSlowRefreshed++;
+    }));
+    modules.push_back(makeModule(
+        1, fastBus.getEventBase(), false, [&]() { numFastRefreshed++; }));
+    return modules;
+  };
+
+  auto stats = scheduler.refresh(makeModules());
+  EXPECT_EQ(stats.numRefreshed, 1);
+  EXPECT_EQ(stats.numStragglers, 1);
+  EXPECT_LT(stats.cycleTime, seconds(5));
+  EXPECT_EQ(numFastRefreshed, 1);
+
+  // The slow bus is still busy, so the next cycle leaves it alone
+  stats = scheduler.refresh(makeModules());
+  EXPECT_EQ(stats.numRefreshed, 1);
+  EXPECT_EQ(stats.numSkipped, 1);
+  EXPECT_EQ(numFastRefreshed, 2);
+
+  unblock.post();
+  slowBus.getEventBase()->runInEventBaseThreadAndWait([] {});
+  EXPECT_EQ(numSlowRefreshed, 1);
+
+  unblock.reset();
+  unblock.post();
+  stats = scheduler.refresh(makeModules());
+  EXPECT_EQ(stats.numRefreshed, 2);
+  EXPECT_EQ(stats.numStragglers, 0);
+  EXPECT_EQ(stats.numSkipped, 0);
+  EXPECT_EQ(numSlowRefreshed, 2);
+}
+
+TEST(TransceiverRefreshSchedulerTest, RefreshErrorsDontStopTheBus) {
+  folly::ScopedEventBaseThread bus;
+  TransceiverRefreshScheduler scheduler(seconds(10));
+  bool refreshed = false;
+
+  std::vector<Module> modules;
+  modules.push_back(makeModule(0, bus.getEventBase(), false, []() {
+    throw std::runtime_error("i2c read failed");
+  }));
+  modules.push_back(
+      makeModule(1, bus.getEventBase(), false, [&]() { refreshed = true; }));
+  auto stats = scheduler.refresh(std::move(modules));
+
+  EXPECT_TRUE(refreshed);
+  EXPECT_EQ(stats.numRefreshed, 2);
+}
+
+TEST(TransceiverRefreshSchedulerTest, PauseWaitsForRefresh) {
+  folly::ScopedEventBaseThread bus;
+  TransceiverRefreshScheduler scheduler(milliseconds(100));
+  folly::Baton<> unblock;
+  std::atomic<int> numRefreshed{0};
+
+  auto makeModules = [&]() {
+    std::vector<Module> modules;
+    modules.push_back(makeModule(0, bus.getEventBase(), false, [&]() {
+      unblock.wait();
+      numRefreshed++;
+    }));
+    return modules;
+  };
+
+  EXPECT_FALSE(scheduler.isBusy(bus.getEventBase()));
+  auto stats = scheduler.refresh(makeModules());
+  EXPECT_EQ(stats.numStragglers, 1);
+  EXPECT_TRUE(scheduler.isBusy(bus.getEventBase()));
+
+  {
+    // The straggler is still refreshing, so the bus can't be paused
+    auto pause = scheduler.pauseBuses({bus.getEventBase()}, milliseconds(10));
+    EXPECT_FALSE(pause.isPaused(bus.getEventBase()));
+    auto noWait = scheduler.pauseBuses({bus.getEventBase()}, milliseconds(0));
+    EXPECT_FALSE(noWait.isPaused(bus.getEventBase()));
+  }
+
+  std::thread unblocker([&]() {
+    /* sleep override */
+    std::this_thread::sleep_for(milliseconds(50));
+    unblock.post();
+  });
+  {
+    auto pause = scheduler.pauseBuses({bus.getEventBase()}, seconds(10));
+    EXPECT_TRUE(pause.isPaused(bus.getEventBase()));
+    EXPECT_EQ(numRefreshed, 1);
+
+    // Cycles stay off a paused bus
+    stats = scheduler.refresh(makeModules());
+    EXPECT_EQ(stats.numSkipped, 1);
+    EXPECT_EQ(numRefreshed, 1);
+  }
+  unblocker.join();
+
+  stats = scheduler.refresh(makeModules());
+  EXPECT_EQ(stats.numRefreshed, 1);
+  EXPECT_EQ(numRefreshed, 2);
+}
+
+TEST(TransceiverRefreshSchedulerTest, DrainWaitsForStragglers) {
+  folly::ScopedEventBaseThread bus;
+  TransceiverRefreshScheduler scheduler(milliseconds(10));
+  std::atomic<bool> refreshed{false};
+
+  std::vector<Module> modules;
+  modules.push_back(makeModule(0, bus.getEventBase(), false, [&]() {
+    /* sleep override */
+    std::this_thread::sleep_for(milliseconds(200));
+    refreshed = true;
+  }));
+  auto stats = scheduler.refresh(std::move(modules));
+  EXPECT_EQ(stats.numStragglers, 1);
+
+  scheduler.drain();
+  EXPECT_TRUE(refreshed);
+}
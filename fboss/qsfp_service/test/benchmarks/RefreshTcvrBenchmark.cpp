@@ -8,6 +8,9 @@
  *
  */
 #include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <chrono>
+#include <map>
 #include <unordered_set>
 
 #include "fboss/qsfp_service/platforms/wedge/WedgeManager.h"
@@ -42,6 +45,45 @@ std::size_t refreshTcvrs(MediaInterfaceCode mediaType) {
   return iters;
 }
 
+// Refresh all the transceivers in one cycle, the way the state machine
+// thread does, and report how long the cycle took and how busy each I2C bus
+// was during it. Buses that straggled past the refresh timeout count as busy
+// for the whole cycle.
+void refreshAllTcvrs(folly::UserCounters& counters, unsigned iters) {
+  folly::BenchmarkSuspender suspender;
+  auto wedgeMgr = setupForColdboot();
+  wedgeMgr->init();
+
+  std::chrono::microseconds totalCycleTime{0};
+  std::map<size_t, std::chrono::microseconds> busyTimes;
+  size_t numStragglers = 0;
+  for (unsigned i = 0; i < iters; i++) {
+    suspender.dismiss();
+    wedgeMgr->TransceiverManager::refreshTransceivers({});
+    suspender.rehire();
+
+    auto stats = wedgeMgr->getLastRefreshStats();
+    totalCycleTime += stats.cycleTime;
+    numStragglers += stats.numStragglers;
+    for (size_t bus = 0; bus < stats.buses.size(); bus++) {
+      busyTimes[bus] += stats.buses[bus].busyTime;
+    }
+  }
+
+  if (iters > 0 && totalCycleTime.count() > 0) {
+    counters["cycle_ms"] = totalCycleTime.count() / iters / 1000;
+    counters["stragglers"] = numStragglers;
+    for (const auto& [bus, busyTime] : busyTimes) {
+      counters[folly::to<std::string>("bus", bus, "_util_pct")] =
+          busyTime.count() * 100 / totalCycleTime.count();
+    }
+  }
+}
+
+BENCHMARK_COUNTERS(RefreshAllTransceivers, counters, iters) {
+  refreshAllTcvrs(counters, iters);
+}
+
 BENCHMARK_MULTI(RefreshTransceiver_CR4_100G) {
   return refreshTcvrs(MediaInterfaceCode::CR4_100G);
 }
@@ -0,0 +1,91 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <unordered_map>
+#include <unordered_set>
+
+#include <folly/container/F14Map.h>
+#include <folly/container/F14Set.h>
+#include "fboss/thrift_cow/nodes/PersistentHashMap.h"
+
+namespace facebook::fboss::thrift_cow {
+
+/*
+ * Storage backends for ThriftMapNode and ThriftSetNode.
+ *
+ * UNORDERED: std::unordered_{map,set}, the default.
+ * F14_VECTOR: folly::F14Vector{Map,Set}. Entries are stored contiguously,
+ *   which makes clones and iteration of small containers cheaper.
+ * PERSISTENT: PersistentHashMap (maps only). Clones share structure with
+ *   the original, so cloning a large map to change a single entry is
+ *   O(log n) and DeltaVisitor skips subtrees shared by old and new state.
+ */
+enum class ContainerStorage {
+  UNORDERED,
+  F14_VECTOR,
+  PERSISTENT,
+};
+
+/*
+ * Selects the storage backend for the thrift_cow node holding thrift type
+ * TType. Specialize this for a thrift container type to change its backend,
+ * e.g.
+ *
+ *   template <>
+ *   struct ContainerStorageSelector<std::map<int32_t, PortStats>> {
+ *     static constexpr auto value = ContainerStorage::PERSISTENT;
+ *   };
+ */
+template <typename TType>
+struct ContainerStorageSelector {
+  static constexpr auto value = ContainerStorage::UNORDERED;
+};
+
+template <ContainerStorage Storage, typename K, typename V>
+struct MapStorage;
+
+template <typename K, typename V>
+struct MapStorage<ContainerStorage::UNORDERED, K, V> {
+  using type = std::unordered_map<K, V>;
+  static constexpr bool kStructurallyShared = false;
+};
+
+template <typename K, typename V>
+struct MapStorage<ContainerStorage::F14_VECTOR, K, V> {
+  using type = folly::F14VectorMap<K, V>;
+  static constexpr bool kStructurallyShared = false;
+};
+
+template <typename K, typename V>
+struct MapStorage<ContainerStorage::PERSISTENT, K, V> {
+  using type = PersistentHashMap<K, V>;
+  static constexpr bool kStructurallyShared = true;
+};
+
+template <ContainerStorage Storage, typename V>
+struct SetStorage {
+  static_assert(
+      Storage != ContainerStorage::PERSISTENT,
+      "Persistent storage is only supported for maps");
+};
+
+template <typename V>
+struct SetStorage<ContainerStorage::UNORDERED, V> {
+  using type = std::unordered_set<V>;
+};
+
+template <typename V>
+struct SetStorage<ContainerStorage::F14_VECTOR, V> {
+  using type = folly::F14VectorSet<V, std::hash<V>>;
+};
+
+} // namespace facebook::fboss::thrift_cow
@@ -0,0 +1,111 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <type_traits>
+
+#include <folly/FBString.h>
+#include <folly/Traits.h>
+#include "fboss/fsdb/if/gen-cpp2/fsdb_oper_types.h"
+
+namespace facebook::fboss::thrift_cow {
+
+/*
+ * EncodedCache memoizes the serialized form of a node, one slot per
+ * fsdb::OperProtocol.
+ *
+ * Published nodes are immutable, so once a published node has been encoded
+ * the same bytes can be handed out on every subsequent read. The cache is
+ * owned by the node object itself and is never copied: clone() constructs a
+ * new node with an empty cache, so a copy-on-write modification can never
+ * observe stale bytes.
+ *
+ * Slots are populated lazily and lock free. Concurrent readers racing to fill
+ * the same slot will both encode, one of them wins and the other discards its
+ * copy.
+ */
+class EncodedCache {
+ public:
+  EncodedCache() = default;
+
+  ~EncodedCache() {
+    for (auto& slot : slots_) {
+      delete slot.load(std::memory_order_relaxed);
+    }
+  }
+
+  template <typename EncodeFn>
+  folly::fbstring getOrEncode(fsdb::OperProtocol proto, EncodeFn&& encodeFn)
+      const {
+    auto& slot = slots_.at(slotIndex(proto));
+    if (auto cached = slot.load(std::memory_order_acquire)) {
+      return *cached;
+    }
+    auto encoded = std::make_unique<folly::fbstring>(encodeFn());
+    const folly::fbstring* expected{nullptr};
+    if (slot.compare_exchange_strong(
+            expected,
+            encoded.get(),
+            std::memory_order_acq_rel,
+            std::memory_order_acquire)) {
+      return *encoded.release();
+    }
+    return *expected;
+  }
+
+  bool isCached(fsdb::OperProtocol proto) const {
+    return slots_.at(slotIndex(proto)).load(std::memory_order_acquire) !=
+        nullptr;
+  }
+
+ private:
+  // Forbidden copy constructor and assignment operator
+  EncodedCache(EncodedCache const&) = delete;
+  EncodedCache& operator=(EncodedCache const&) = delete;
+
+  static constexpr size_t kNumSlots = 3;
+
+  static size_t slotIndex(fsdb::OperProtocol proto) {
+    // OperProtocol values start at 1
+    return static_cast<size_t>(proto) - 1;
+  }
+
+  mutable std::array<std::atomic<const folly::fbstring*>, kNumSlots> slots_{};
+};
+
+template <typename Node, typename = void>
+struct SupportsEncodedCache : std::false_type {};
+
+template <typename Node>
+struct SupportsEncodedCache<
+    Node,
+    std::void_t<decltype(std::declval<const Node&>().encodeCached(
+        fsdb::OperProtocol::BINARY))>> : std::true_type {};
+
+/*
+ * Encode any node, going through the node's EncodedCache if it has one and
+ * the caller opted in.
+ */
+template <typename Node>
+folly::fbstring
+encodeNode(const Node& node, fsdb::OperProtocol proto, bool useCache) {
+  if constexpr (SupportsEncodedCache<folly::remove_cvref_t<Node>>::value) {
+    if (useCache) {
+      return node.encodeCached(proto);
+    }
+  }
+  return node.encode(proto);
+}
+
+} // namespace facebook::fboss::thrift_cow
@@ -0,0 +1,545 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <folly/lang/Bits.h>
+
+namespace facebook::fboss::thrift_cow {
+
+/*
+ * PersistentHashMap is a hash array mapped trie (HAMT) whose nodes are
+ * shared between copies of the map.
+ *
+ * Copying a map is O(1): both copies point at the same trie. Any mutation
+ * first makes the nodes along the path to the changed key unique (copying
+ * them if they are still shared), so changing one entry in a copy of a large
+ * map is O(log n) and leaves the original untouched. Nodes that are not
+ * shared with anyone else are mutated in place.
+ *
+ * This mirrors how the thrift_cow nodes themselves behave: a map that is
+ * reachable from a published node must never be mutated, only copied.
+ * Mutable accessors (non-const find(), begin()) are therefore only safe to
+ * use on a map owned by an unpublished node.
+ *
+ * forEachDifference() walks two maps and skips every subtree the two maps
+ * still share, which makes diffing a clone against its origin proportional
+ * to the number of changed entries rather than to the size of the map.
+ */
+template <
+    typename K,
+    typename V,
+    typename Hash = std::hash<K>,
+    typename KeyEqual = std::equal_to<K>>
+class PersistentHashMap {
+ public:
+  using key_type = K;
+  using mapped_type = V;
+  // entries are stored as mutable pairs so leaves can be erased from
+  // in place, callers must not modify the key through an iterator.
+  using value_type = std::pair<K, V>;
+  using size_type = std::size_t;
+  using hasher = Hash;
+  using key_equal = KeyEqual;
+
+ private:
+  static constexpr unsigned kBitsPerLevel = 5;
+  static constexpr uint32_t kLevelMask = (1u << kBitsPerLevel) - 1;
+
+  struct Node {
+    bool leaf{false};
+    // branch nodes: one child per set bit in bitmap, in bit order
+    uint32_t bitmap{0};
+    std::vector<std::shared_ptr<Node>> children;
+    // leaf nodes: all entries share the same full hash
+    size_t hash{0};
+    std::vector<value_type> entries;
+  };
+
+  template <bool IsConst>
+  class Iterator {
+   public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename PersistentHashMap::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference =
+        std::conditional_t<IsConst, const value_type&, value_type&>;
+    using pointer = std::conditional_t<IsConst, const value_type*, value_type*>;
+
+    Iterator() = default;
+
+    template <bool C = IsConst, typename = std::enable_if_t<C>>
+    /* implicit */ Iterator(const Iterator<false>& other)
+        : stack_(other.stack_), leaf_(other.leaf_), entry_(other.entry_) {}
+
+    reference operator*() const {
+      return const_cast<reference>(leaf_->entries[entry_]);
+    }
+
+    pointer operator->() const {
+      return &**this;
+    }
+
+    Iterator& operator++() {
+      if (++entry_ < leaf_->entries.size()) {
+        return *this;
+      }
+      nextLeaf();
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    friend bool operator==(const Iterator& lhs, const Iterator& rhs) {
+      return lhs.leaf_ == rhs.leaf_ && lhs.entry_ == rhs.entry_;
+    }
+
+    friend bool operator!=(const Iterator& lhs, const Iterator& rhs) {
+      return !(lhs == rhs);
+    }
+
+   private:
+    friend class PersistentHashMap;
+    template <bool>
+    friend class Iterator;
+
+    void descend(const Node* node) {
+      // only the root branch may be empty and we never descend into it
+      while (!node->leaf) {
+        stack_.emplace_back(node, 0);
+        node = node->children.front().get();
+      }
+      leaf_ = node;
+      entry_ = 0;
+    }
+
+    void nextLeaf() {
+      leaf_ = nullptr;
+      entry_ = 0;
+      while (!stack_.empty()) {
+        auto& [node, pos] = stack_.back();
+        if (++pos < node->children.size()) {
+          descend(node->children[pos].get());
+          return;
+        }
+        stack_.pop_back();
+      }
+    }
+
+    std::vector<std::pair<const Node*, size_t>> stack_;
+    const Node* leaf_{nullptr};
+    size_t entry_{0};
+  };
+
+ public:
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  PersistentHashMap() : root_(std::make_shared<Node>()) {}
+
+  // copies share the whole trie
+  PersistentHashMap(const PersistentHashMap& other) = default;
+  PersistentHashMap& operator=(const PersistentHashMap& other) = default;
+
+  size_type size() const {
+    return size_;
+  }
+
+  bool empty() const {
+    return size_ == 0;
+  }
+
+  void clear() {
+    root_ = std::make_shared<Node>();
+    size_ = 0;
+  }
+
+  const_iterator begin() const {
+    const_iterator it;
+    if (size_) {
+      it.descend(root_.get());
+    }
+    return it;
+  }
+
+  const_iterator end() const {
+    return const_iterator();
+  }
+
+  const_iterator cbegin() const {
+    return begin();
+  }
+
+  const_iterator cend() const {
+    return end();
+  }
+
+  /*
+   * Mutable iteration has to unshare every node of the trie, prefer the
+   * const overloads whenever possible.
+   */
+  iterator begin() {
+    makeAllUnique(root_);
+    return toMutable(std::as_const(*this).begin());
+  }
+
+  iterator end() {
+    return iterator();
+  }
+
+  const_iterator find(const K& key) const {
+    const_iterator it;
+    auto hash = hasher_(key);
+    const Node* node = root_.get();
+    unsigned shift = 0;
+    while (!node->leaf) {
+      auto bit = bitFor(hash, shift);
+      if (!(node->bitmap & bit)) {
+        return end();
+      }
+      auto pos = position(node->bitmap, bit);
+      it.stack_.emplace_back(node, pos);
+      node = node->children[pos].get();
+      shift += kBitsPerLevel;
+    }
+    if (node->hash != hash) {
+      return end();
+    }
+    for (size_t i = 0; i < node->entries.size(); ++i) {
+      if (keyEqual_(node->entries[i].first, key)) {
+        it.leaf_ = node;
+        it.entry_ = i;
+        return it;
+      }
+    }
+    return end();
+  }
+
+  /*
+   * Returns a mutable iterator, unsharing the nodes on the path to key.
+   */
+  iterator find(const K& key) {
+    if (std::as_const(*this).find(key) == cend()) {
+      return end();
+    }
+    makePathUnique(hasher_(key));
+    return toMutable(std::as_const(*this).find(key));
+  }
+
+  size_type count(const K& key) const {
+    return find(key) == end() ? 0 : 1;
+  }
+
+  const V& at(const K& key) const {
+    auto it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("PersistentHashMap::at: key not found");
+    }
+    return it->second;
+  }
+
+  V& at(const K& key) {
+    auto it = find(key);
+    if (it == end()) {
+      throw std::out_of_range("PersistentHashMap::at: key not found");
+    }
+    return it->second;
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(const K& key, Args&&... args) {
+    if (std::as_const(*this).find(key) != cend()) {
+      return {find(key), false};
+    }
+    auto hash = hasher_(key);
+    ensureUnique(root_);
+    insertImpl(root_.get(), hash, key, std::forward<Args>(args)...);
+    ++size_;
+    return {toMutable(std::as_const(*this).find(key)), true};
+  }
+
+  size_type erase(const K& key) {
+    if (std::as_const(*this).find(key) == cend()) {
+      return 0;
+    }
+    ensureUnique(root_);
+    eraseImpl(root_.get(), hasher_(key), 0, key);
+    --size_;
+    return 1;
+  }
+
+  /*
+   * Visit all differences between this (old) map and other (new) map.
+   *
+   * onChanged(key, oldValue, newValue) is called for keys present in both
+   * maps whose values compare unequal, onRemoved(key, oldValue) for keys only
+   * present in this map and onAdded(key, newValue) for keys only present in
+   * other. Subtrees shared between the two maps are skipped entirely.
+   */
+  template <typename OnChanged, typename OnRemoved, typename OnAdded>
+  void forEachDifference(
+      const PersistentHashMap& other,
+      OnChanged&& onChanged,
+      OnRemoved&& onRemoved,
+      OnAdded&& onAdded) const {
+    diffNodes(
+        root_.get(), other.root_.get(), 0, onChanged, onRemoved, onAdded);
+  }
+
+  /*
+   * Whether both maps still point at the same trie, i.e. neither has been
+   * modified since one was copied from the other.
+   */
+  bool sharesStorageWith(const PersistentHashMap& other) const {
+    return root_ == other.root_;
+  }
+
+ private:
+  static uint32_t bitFor(size_t hash, unsigned shift) {
+    return 1u << ((hash >> shift) & kLevelMask);
+  }
+
+  static size_t position(uint32_t bitmap, uint32_t bit) {
+    return folly::popcount(bitmap & (bit - 1));
+  }
+
+  static void ensureUnique(std::shared_ptr<Node>& node) {
+    if (node.use_count() != 1) {
+      node = std::make_shared<Node>(*node);
+    }
+  }
+
+  static void makeAllUnique(std::shared_ptr<Node>& node) {
+    ensureUnique(node);
+    for (auto& child : node->children) {
+      makeAllUnique(child);
+    }
+  }
+
+  void makePathUnique(size_t hash) {
+    ensureUnique(root_);
+    Node* node = root_.get();
+    unsigned shift = 0;
+    while (!node->leaf) {
+      auto& child =
+          node->children[position(node->bitmap, bitFor(hash, shift))];
+      ensureUnique(child);
+      node = child.get();
+      shift += kBitsPerLevel;
+    }
+  }
+
+  static iterator toMutable(const_iterator it) {
+    iterator out;
+    out.stack_ = std::move(it.stack_);
+    out.leaf_ = it.leaf_;
+    out.entry_ = it.entry_;
+    return out;
+  }
+
+  template <typename... Args>
+  static std::shared_ptr<Node>
+  makeLeaf(size_t hash, const K& key, Args&&... args) {
+    auto leaf = std::make_shared<Node>();
+    leaf->leaf = true;
+    leaf->hash = hash;
+    leaf->entries.emplace_back(
+        std::piecewise_construct,
+        std::forward_as_tuple(key),
+        std::forward_as_tuple(std::forward<Args>(args)...));
+    return leaf;
+  }
+
+  // node must be a unique branch and key must not be present yet
+  template <typename... Args>
+  static void
+  insertImpl(Node* node, size_t hash, const K& key, Args&&... args) {
+    unsigned shift = 0;
+    while (true) {
+      auto bit = bitFor(hash, shift);
+      auto pos = position(node->bitmap, bit);
+      if (!(node->bitmap & bit)) {
+        node->children.insert(
+            node->children.begin() + pos,
+            makeLeaf(hash, key, std::forward<Args>(args)...));
+        node->bitmap |= bit;
+        return;
+      }
+      auto& child = node->children[pos];
+      if (child->leaf && child->hash == hash) {
+        // full hash collision, chain in the same leaf
+        ensureUnique(child);
+        child->entries.emplace_back(
+            std::piecewise_construct,
+            std::forward_as_tuple(key),
+            std::forward_as_tuple(std::forward<Args>(args)...));
+        return;
+      }
+      if (child->leaf) {
+        // push the existing leaf one level down, the hashes differ so they
+        // will eventually end up in different slots
+        auto branch = std::make_shared<Node>();
+        branch->bitmap = bitFor(child->hash, shift + kBitsPerLevel);
+        branch->children.push_back(std::move(child));
+        child = std::move(branch);
+      } else {
+        ensureUnique(child);
+      }
+      node = child.get();
+      shift += kBitsPerLevel;
+    }
+  }
+
+  // node must be a unique branch containing key, returns whether node is
+  // now empty
+  bool eraseImpl(Node* node, size_t hash, unsigned shift, const K& key) {
+    auto bit = bitFor(hash, shift);
+    auto pos = position(node->bitmap, bit);
+    auto& child = node->children[pos];
+    ensureUnique(child);
+    bool childEmpty{false};
+    if (child->leaf) {
+      auto& entries = child->entries;
+      entries.erase(std::find_if(
+          entries.begin(), entries.end(), [&](const auto& entry) {
+            return keyEqual_(entry.first, key);
+          }));
+      childEmpty = entries.empty();
+    } else {
+      childEmpty = eraseImpl(child.get(), hash, shift + kBitsPerLevel, key);
+      if (!childEmpty && child->children.size() == 1 &&
+          child->children.front()->leaf) {
+        // collapse branches left with a single leaf
+        auto onlyLeaf = child->children.front();
+        child = std::move(onlyLeaf);
+      }
+    }
+    if (childEmpty) {
+      node->children.erase(node->children.begin() + pos);
+      node->bitmap &= ~bit;
+    }
+    return node->children.empty();
+  }
+
+  const value_type*
+  findFrom(const Node* node, unsigned shift, const K& key) const {
+    auto hash = hasher_(key);
+    while (!node->leaf) {
+      auto bit = bitFor(hash, shift);
+      if (!(node->bitmap & bit)) {
+        return nullptr;
+      }
+      node = node->children[position(node->bitmap, bit)].get();
+      shift += kBitsPerLevel;
+    }
+    if (node->hash != hash) {
+      return nullptr;
+    }
+    for (const auto& entry : node->entries) {
+      if (keyEqual_(entry.first, key)) {
+        return &entry;
+      }
+    }
+    return nullptr;
+  }
+
+  template <typename Fn>
+  static void forEachEntry(const Node* node, Fn& fn) {
+    if (node->leaf) {
+      for (const auto& entry : node->entries) {
+        fn(entry);
+      }
+      return;
+    }
+    for (const auto& child : node->children) {
+      forEachEntry(child.get(), fn);
+    }
+  }
+
+  template <typename OnChanged, typename OnRemoved, typename OnAdded>
+  void diffNodes(
+      const Node* oldNode,
+      const Node* newNode,
+      unsigned shift,
+      OnChanged& onChanged,
+      OnRemoved& onRemoved,
+      OnAdded& onAdded) const {
+    if (oldNode == newNode) {
+      return;
+    }
+    auto removed = [&](const value_type& entry) {
+      onRemoved(entry.first, entry.second);
+    };
+    auto added = [&](const value_type& entry) {
+      onAdded(entry.first, entry.second);
+    };
+    if (!oldNode->leaf && !newNode->leaf) {
+      size_t oldPos = 0, newPos = 0;
+      for (uint32_t idx = 0; idx <= kLevelMask; ++idx) {
+        uint32_t bit = 1u << idx;
+        bool inOld = oldNode->bitmap & bit;
+        bool inNew = newNode->bitmap & bit;
+        if (inOld && inNew) {
+          diffNodes(
+              oldNode->children[oldPos++].get(),
+              newNode->children[newPos++].get(),
+              shift + kBitsPerLevel,
+              onChanged,
+              onRemoved,
+              onAdded);
+        } else if (inOld) {
+          forEachEntry(oldNode->children[oldPos++].get(), removed);
+        } else if (inNew) {
+          forEachEntry(newNode->children[newPos++].get(), added);
+        }
+      }
+      return;
+    }
+    // at least one side is a leaf, fall back to lookups within the two
+    // (small) subtrees
+    auto changedOrRemoved = [&](const value_type& entry) {
+      if (auto other = findFrom(newNode, shift, entry.first)) {
+        if (entry.second != other->second) {
+          onChanged(entry.first, entry.second, other->second);
+        }
+      } else {
+        onRemoved(entry.first, entry.second);
+      }
+    };
+    auto addedOnly = [&](const value_type& entry) {
+      if (!findFrom(oldNode, shift, entry.first)) {
+        onAdded(entry.first, entry.second);
+      }
+    };
+    forEachEntry(oldNode, changedOrRemoved);
+    forEachEntry(newNode, addedOnly);
+  }
+
+  std::shared_ptr<Node> root_;
+  size_type size_{0};
+  Hash hasher_;
+  KeyEqual keyEqual_;
+};
+
+} // namespace facebook::fboss::thrift_cow
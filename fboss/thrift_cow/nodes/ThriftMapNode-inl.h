@@ -16,9 +16,12 @@
 #include <thrift/lib/cpp2/reflection/folly_dynamic.h>
 #include <thrift/lib/cpp2/reflection/reflection.h>
 #include "fboss/agent/state/NodeBase-defs.h"
+#include "fboss/thrift_cow/nodes/EncodedCache.h"
 #include "fboss/thrift_cow/nodes/Serializer.h"
 #include "fboss/thrift_cow/nodes/Types.h"
 
+#include <utility>
+
 namespace facebook::fboss::thrift_cow {
 
 namespace map_helpers {
@@ -37,9 +40,9 @@ struct ExtractTypeClass<
 
 } // namespace map_helpers
 
-template <typename TypeClass, typename TType>
+template <typename TypeClass, typename TType, ContainerStorage Storage>
 struct ThriftMapFields {
-  using Self = ThriftMapFields<TypeClass, TType>;
+  using Self = ThriftMapFields<TypeClass, TType, Storage>;
   using CowType = FieldsType;
   using ThriftType = TType;
   using KeyTypeClass =
@@ -50,13 +53,17 @@ struct ThriftMapFields {
   using ValueTraits = ConvertToNodeTraits<ValueTypeClass, ValueTType>;
   using key_type = typename TType::key_type;
   using value_type = typename ValueTraits::type;
-  using StorageType = std::unordered_map<key_type, value_type>;
+  using StorageTraits = MapStorage<Storage, key_type, value_type>;
+  using StorageType = typename StorageTraits::type;
   using iterator = typename StorageType::iterator;
   using const_iterator = typename StorageType::const_iterator;
 
   // whether the contained type is another Cow node, or a primitive node
   static constexpr bool HasChildNodes = ValueTraits::isChild::value;
 
+  // whether clones share structure with the original, see ContainerStorage
+  static constexpr bool StructurallyShared = StorageTraits::kStructurallyShared;
+
   // constructors:
   // One takes a thrift type directly, one starts with empty vector
 
@@ -203,10 +210,17 @@ struct ThriftMapFields {
     return storage_.size();
   }
 
+  const StorageType& storage() const {
+    return storage_;
+  }
+
   template <typename Fn>
   void forEachChild(Fn fn) {
     if constexpr (HasChildNodes) {
-      for (auto&& [key, value] : storage_) {
+      // Iterate through the const storage: mutable iteration of persistent
+      // storage would unshare the whole map on every publish(). Children
+      // are shared between clones either way, only their flags change.
+      for (const auto& [key, value] : std::as_const(storage_)) {
         fn(value.get());
       }
     }
@@ -227,15 +241,15 @@ struct ThriftMapFields {
   StorageType storage_;
 };
 
-template <typename TypeClass, typename TType>
+template <typename TypeClass, typename TType, ContainerStorage Storage>
 class ThriftMapNode : public NodeBaseT<
-                          ThriftMapNode<TypeClass, TType>,
-                          ThriftMapFields<TypeClass, TType>> {
+                          ThriftMapNode<TypeClass, TType, Storage>,
+                          ThriftMapFields<TypeClass, TType, Storage>> {
  public:
-  using Self = ThriftMapNode<TypeClass, TType>;
-  using Fields = ThriftMapFields<TypeClass, TType>;
+  using Self = ThriftMapNode<TypeClass, TType, Storage>;
+  using Fields = ThriftMapFields<TypeClass, TType, Storage>;
   using ThriftType = typename Fields::ThriftType;
-  using BaseT = NodeBaseT<ThriftMapNode<TypeClass, TType>, Fields>;
+  using BaseT = NodeBaseT<Self, Fields>;
   using CowType = NodeType;
   using key_type = typename Fields::key_type;
   using value_type = typename Fields::value_type;
@@ -269,6 +283,18 @@ class ThriftMapNode : public NodeBaseT<
     return this->getFields()->encode(proto);
   }
 
+  /*
+   * Same as encode(), but memoizes the result once the node is
+   * published. Unpublished nodes may still change and are always encoded
+   * from scratch.
+   */
+  folly::fbstring encodeCached(fsdb::OperProtocol proto) const {
+    if (!this->isPublished()) {
+      return encode(proto);
+    }
+    return encodedCache_.getOrEncode(proto, [&]() { return encode(proto); });
+  }
+
   void fromEncoded(fsdb::OperProtocol proto, const folly::fbstring& encoded) {
     return this->writableFields()->fromEncoded(proto, encoded);
   }
@@ -414,6 +440,9 @@ class ThriftMapNode : public NodeBaseT<
 
  private:
   friend class CloneAllocator;
+
+  // not carried over by clone(), see EncodedCache
+  EncodedCache encodedCache_;
 };
 
 } // namespace facebook::fboss::thrift_cow
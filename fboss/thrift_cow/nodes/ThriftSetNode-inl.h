@@ -36,9 +36,9 @@ struct ExtractTypeClass<apache::thrift::type_class::set<ValueTypeClass>> {
 
 } // namespace set_helpers
 
-template <typename TypeClass, typename TType>
+template <typename TypeClass, typename TType, ContainerStorage Storage>
 struct ThriftSetFields {
-  using Self = ThriftSetFields<TypeClass, TType>;
+  using Self = ThriftSetFields<TypeClass, TType, Storage>;
   using CowType = FieldsType;
   using ThriftType = TType;
   using ValueTypeClass =
@@ -47,7 +47,7 @@ struct ThriftSetFields {
 
   using ValueTraits = ConvertToImmutableNodeTraits<ValueTypeClass, ValueTType>;
   using value_type = typename ValueTraits::type;
-  using StorageType = std::unordered_set<value_type>;
+  using StorageType = typename SetStorage<Storage, value_type>::type;
   using iterator = typename StorageType::iterator;
   using const_iterator = typename StorageType::const_iterator;
 
@@ -113,7 +113,14 @@ struct ThriftSetFields {
     return storage_.emplace(childFactory(std::forward<Args>(args)...));
   }
 
-  iterator erase(iterator pos) {
+  // some backends (e.g. F14) use the same type for both iterators
+  template <
+      typename It,
+      std::enable_if_t<
+          std::is_same_v<It, iterator> &&
+              !std::is_same_v<iterator, const_iterator>,
+          bool> = true>
+  iterator erase(It pos) {
     return storage_.erase(pos);
   }
 
@@ -222,15 +229,15 @@ struct ThriftSetFields {
   StorageType storage_;
 };
 
-template <typename TypeClass, typename TType>
+template <typename TypeClass, typename TType, ContainerStorage Storage>
 class ThriftSetNode : public NodeBaseT<
-                          ThriftSetNode<TypeClass, TType>,
-                          ThriftSetFields<TypeClass, TType>> {
+                          ThriftSetNode<TypeClass, TType, Storage>,
+                          ThriftSetFields<TypeClass, TType, Storage>> {
  public:
-  using Self = ThriftSetNode<TypeClass, TType>;
-  using Fields = ThriftSetFields<TypeClass, TType>;
+  using Self = ThriftSetNode<TypeClass, TType, Storage>;
+  using Fields = ThriftSetFields<TypeClass, TType, Storage>;
   using ThriftType = typename Fields::ThriftType;
-  using BaseT = NodeBaseT<ThriftSetNode<TypeClass, TType>, Fields>;
+  using BaseT = NodeBaseT<Self, Fields>;
   using CowType = NodeType;
   using value_type = typename Fields::value_type;
   using ValueTType = typename Fields::ValueTType;
@@ -273,7 +280,15 @@ class ThriftSetNode : public NodeBaseT<
     return this->writableFields()->emplace(std::forward<Args>(args)...);
   }
 
-  typename Fields::iterator erase(typename Fields::iterator pos) {
+  template <
+      typename It,
+      std::enable_if_t<
+          std::is_same_v<It, typename Fields::iterator> &&
+              !std::is_same_v<
+                  typename Fields::iterator,
+                  typename Fields::const_iterator>,
+          bool> = true>
+  typename Fields::iterator erase(It pos) {
     return this->writableFields()->erase(pos);
   }
 
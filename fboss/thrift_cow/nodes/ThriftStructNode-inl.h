@@ -19,6 +19,7 @@
 #include <thrift/lib/cpp2/reflection/reflection.h>
 #include "fboss/agent/state/NodeBase-defs.h"
 #include "fboss/fsdb/if/gen-cpp2/fsdb_oper_types.h"
+#include "fboss/thrift_cow/nodes/EncodedCache.h"
 #include "fboss/thrift_cow/nodes/Serializer.h"
 #include "fboss/thrift_cow/nodes/Types.h"
 #include "fboss/thrift_cow/visitors/PathVisitor.h"
@@ -398,6 +399,18 @@ class ThriftStructNode
     return this->getFields()->encode(proto);
   }
 
+  /*
+   * Same as encode(), but memoizes the result once the node is
+   * published. Unpublished nodes may still change and are always encoded
+   * from scratch.
+   */
+  folly::fbstring encodeCached(fsdb::OperProtocol proto) const {
+    if (!this->isPublished()) {
+      return encode(proto);
+    }
+    return encodedCache_.getOrEncode(proto, [&]() { return encode(proto); });
+  }
+
   void fromEncoded(fsdb::OperProtocol proto, const folly::fbstring& encoded) {
     return this->writableFields()->fromEncoded(proto, encoded);
   }
@@ -561,6 +574,9 @@ class ThriftStructNode
 
  private:
   friend class CloneAllocator;
+
+  // not carried over by clone(), see EncodedCache
+  EncodedCache encodedCache_;
 };
 
 } // namespace facebook::fboss::thrift_cow
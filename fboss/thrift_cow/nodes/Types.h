@@ -10,6 +10,8 @@
 
 #pragma once
 
+#include "fboss/thrift_cow/nodes/ContainerStorage.h"
+
 namespace facebook::fboss::thrift_cow {
 
 // used to denote node vs field types
@@ -35,16 +37,28 @@ struct ThriftListFields;
 template <typename TypeClass, typename TType>
 class ThriftListNode;
 
-template <typename TypeClass, typename TType>
+template <
+    typename TypeClass,
+    typename TType,
+    ContainerStorage Storage = ContainerStorageSelector<TType>::value>
 struct ThriftMapFields;
 
-template <typename TypeClass, typename TType>
+template <
+    typename TypeClass,
+    typename TType,
+    ContainerStorage Storage = ContainerStorageSelector<TType>::value>
 class ThriftMapNode;
 
-template <typename TypeClass, typename TType>
+template <
+    typename TypeClass,
+    typename TType,
+    ContainerStorage Storage = ContainerStorageSelector<TType>::value>
 struct ThriftSetFields;
 
-template <typename TypeClass, typename TType>
+template <
+    typename TypeClass,
+    typename TType,
+    ContainerStorage Storage = ContainerStorageSelector<TType>::value>
 class ThriftSetNode;
 
 template <typename TypeClass, typename TType, bool Immutable = false>
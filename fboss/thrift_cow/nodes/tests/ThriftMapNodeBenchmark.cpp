@@ -0,0 +1,192 @@
+/*
+ *  Copyright (c) 2004-present, Facebook, Inc.
+ *  All rights reserved.
+ *
+ *  This source code is licensed under the BSD-style license found in the
+ *  LICENSE file in the root directory of this source tree. An additional grant
+ *  of patent rights can be found in the PATENTS file in the same directory.
+ *
+ */
+
+#include <folly/Benchmark.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+
+#include "fboss/agent/gen-cpp2/switch_config_fatal_types.h"
+#include "fboss/thrift_cow/nodes/Types.h"
+#include "fboss/thrift_cow/visitors/DeltaVisitor.h"
+
+using namespace facebook::fboss;
+using namespace facebook::fboss::thrift_cow;
+using sk = cfg::switch_config_tags::strings;
+
+namespace {
+
+using MapTC = apache::thrift::type_class::map<
+    apache::thrift::type_class::integral,
+    apache::thrift::type_class::integral>;
+using MapTType = std::unordered_map<int, int>;
+
+template <ContainerStorage Storage>
+using MapNode = ThriftMapNode<MapTC, MapTType, Storage>;
+
+using StructMapTC = apache::thrift::type_class::map<
+    apache::thrift::type_class::integral,
+    apache::thrift::type_class::structure>;
+using StructMapTType = std::unordered_map<int, cfg::L4PortRange>;
+
+template <ContainerStorage Storage>
+using StructMapNode = ThriftMapNode<StructMapTC, StructMapTType, Storage>;
+
+template <ContainerStorage Storage>
+std::shared_ptr<MapNode<Storage>> buildMap(int size) {
+  auto node = std::make_shared<MapNode<Storage>>();
+  for (int i = 0; i < size; ++i) {
+    node->emplace(i, i);
+  }
+  node->publish();
+  return node;
+}
+
+// clone a published map and change a single entry, like a state update
+template <ContainerStorage Storage>
+void cloneAndModify(uint32_t iters, int size) {
+  std::shared_ptr<MapNode<Storage>> node;
+  BENCHMARK_SUSPEND {
+    node = buildMap<Storage>(size);
+  }
+  for (uint32_t i = 0; i < iters; ++i) {
+    auto cloned = node->clone();
+    auto key = folly::Random::rand32(size);
+    *cloned->ref(key) = i;
+    folly::doNotOptimizeAway(cloned);
+  }
+  BENCHMARK_SUSPEND {
+    node.reset();
+  }
+}
+
+template <ContainerStorage Storage>
+std::shared_ptr<StructMapNode<Storage>> buildStructMap(int size) {
+  StructMapTType thrift;
+  for (int i = 0; i < size; ++i) {
+    cfg::L4PortRange range;
+    range.min() = i;
+    range.max() = i + 1;
+    thrift.emplace(i, std::move(range));
+  }
+  auto node = std::make_shared<StructMapNode<Storage>>(std::move(thrift));
+  node->publish();
+  return node;
+}
+
+// clone a published map of structs, change a member of one entry and
+// publish the clone, as a state update followed by its publish
+template <ContainerStorage Storage>
+void cloneModifyPublish(uint32_t iters, int size) {
+  std::shared_ptr<StructMapNode<Storage>> node;
+  BENCHMARK_SUSPEND {
+    node = buildStructMap<Storage>(size);
+  }
+  for (uint32_t i = 0; i < iters; ++i) {
+    auto cloned = node;
+    auto key = folly::Random::rand32(size);
+    StructMapNode<Storage>::modify(&cloned, folly::to<std::string>(key));
+    cloned->ref(key)->template set<sk::max>(i);
+    cloned->publish();
+    folly::doNotOptimizeAway(cloned);
+  }
+  BENCHMARK_SUSPEND {
+    node.reset();
+  }
+}
+
+template <ContainerStorage Storage>
+void lookup(uint32_t iters, int size) {
+  std::shared_ptr<MapNode<Storage>> node;
+  BENCHMARK_SUSPEND {
+    node = buildMap<Storage>(size);
+  }
+  const auto& constNode = *node;
+  for (uint32_t i = 0; i < iters; ++i) {
+    auto it = constNode.find(folly::Random::rand32(size));
+    folly::doNotOptimizeAway(it);
+  }
+  BENCHMARK_SUSPEND {
+    node.reset();
+  }
+}
+
+// delta between a map and a clone with a single changed entry
+template <ContainerStorage Storage>
+void delta(uint32_t iters, int size) {
+  std::shared_ptr<MapNode<Storage>> oldNode, newNode;
+  BENCHMARK_SUSPEND {
+    oldNode = buildMap<Storage>(size);
+    newNode = oldNode->clone();
+    *newNode->ref(size / 2) = -1;
+    newNode->publish();
+  }
+  for (uint32_t i = 0; i < iters; ++i) {
+    std::vector<std::string> path;
+    int numDeltas = 0;
+    DeltaVisitor<MapTC>::visit(
+        path,
+        oldNode,
+        newNode,
+        DeltaVisitMode::MINIMAL,
+        [&](const auto&, const auto&, const auto&, auto) { ++numDeltas; });
+    folly::doNotOptimizeAway(numDeltas);
+  }
+  BENCHMARK_SUSPEND {
+    oldNode.reset();
+    newNode.reset();
+  }
+}
+
+} // namespace
+
+#define MAP_STORAGE_BENCHMARK_FNS(fn)                       \
+  void fn##Unordered(uint32_t iters, int size) {             \
+    fn<ContainerStorage::UNORDERED>(iters, size);            \
+  }                                                          \
+  void fn##F14Vector(uint32_t iters, int size) {             \
+    fn<ContainerStorage::F14_VECTOR>(iters, size);           \
+  }                                                          \
+  void fn##Persistent(uint32_t iters, int size) {            \
+    fn<ContainerStorage::PERSISTENT>(iters, size);           \
+  }
+
+#define MAP_STORAGE_BENCHMARKS(fn, name, size)               \
+  BENCHMARK_NAMED_PARAM(fn##Unordered, name, size)           \
+  BENCHMARK_RELATIVE_NAMED_PARAM(fn##F14Vector, name, size)  \
+  BENCHMARK_RELATIVE_NAMED_PARAM(fn##Persistent, name, size)
+
+namespace {
+MAP_STORAGE_BENCHMARK_FNS(cloneAndModify)
+MAP_STORAGE_BENCHMARK_FNS(cloneModifyPublish)
+MAP_STORAGE_BENCHMARK_FNS(lookup)
+MAP_STORAGE_BENCHMARK_FNS(delta)
+} // namespace
+
+MAP_STORAGE_BENCHMARKS(cloneAndModify, 10k, 10000)
+MAP_STORAGE_BENCHMARKS(cloneAndModify, 100k, 100000)
+MAP_STORAGE_BENCHMARKS(cloneAndModify, 1M, 1000000)
+BENCHMARK_DRAW_LINE();
+MAP_STORAGE_BENCHMARKS(cloneModifyPublish, 10k, 10000)
+MAP_STORAGE_BENCHMARKS(cloneModifyPublish, 100k, 100000)
+MAP_STORAGE_BENCHMARKS(cloneModifyPublish, 1M, 1000000)
+BENCHMARK_DRAW_LINE();
+MAP_STORAGE_BENCHMARKS(lookup, 10k, 10000)
+MAP_STORAGE_BENCHMARKS(lookup, 100k, 100000)
+MAP_STORAGE_BENCHMARKS(lookup, 1M, 1000000)
+BENCHMARK_DRAW_LINE();
+MAP_STORAGE_BENCHMARKS(delta, 10k, 10000)
+MAP_STORAGE_BENCHMARKS(delta, 100k, 100000)
+MAP_STORAGE_BENCHMARKS(delta, 1M, 1000000)
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
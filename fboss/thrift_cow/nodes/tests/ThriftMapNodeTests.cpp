@@ -19,6 +19,7 @@
 #include "fboss/thrift_cow/nodes/tests/gen-cpp2/test_fatal_types.h"
 
 #include <gtest/gtest.h>
+#include <set>
 #include <type_traits>
 
 using namespace facebook::fboss;
@@ -594,3 +595,62 @@ TEST(ThriftMapNodeTests, ThriftMapNodeStructsModify) {
   ASSERT_EQ(node->size(), 3);
   ASSERT_NE(node->find(TestEnum::THIRD), node->end());
 }
+
+TEST(ThriftMapNodeTests, ThriftMapNodePersistentStorage) {
+  using TestNodeType = ThriftMapNode<
+      apache::thrift::type_class::map<
+          apache::thrift::type_class::integral,
+          apache::thrift::type_class::structure>,
+      std::unordered_map<int, cfg::L4PortRange>,
+      ContainerStorage::PERSISTENT>;
+
+  std::unordered_map<int, cfg::L4PortRange> data;
+  for (int i = 0; i < 1000; ++i) {
+    data.emplace(i, buildPortRange(i, i + 1));
+  }
+
+  auto node = std::make_shared<TestNodeType>(data);
+  ASSERT_EQ(node->size(), 1000);
+  ASSERT_EQ(node->toThrift(), data);
+  node->publish();
+  ASSERT_TRUE(node->cref(10)->isPublished());
+
+  // clone shares storage until modified, publishing it does not unshare it
+  auto cloned = node->clone();
+  ASSERT_TRUE(
+      cloned->getFields()->storage().sharesStorageWith(
+          node->getFields()->storage()));
+  auto published = node->clone();
+  published->publish();
+  ASSERT_TRUE(
+      published->getFields()->storage().sharesStorageWith(
+          node->getFields()->storage()));
+
+  TestNodeType::modify(&cloned, "10");
+  cloned->ref(10)->set<sk::max>(999);
+  ASSERT_TRUE(cloned->remove(20));
+  cloned->emplace(5000, buildPortRange(1, 2));
+
+  // original is untouched
+  ASSERT_EQ(node->toThrift(), data);
+  ASSERT_EQ(node->cref(10)->get<sk::max>(), 11);
+  ASSERT_EQ(cloned->cref(10)->get<sk::max>(), 999);
+  ASSERT_EQ(cloned->size(), 1000);
+
+  // only the modified entries show up as differences
+  std::set<std::string> changed, removed, added;
+  node->getFields()->storage().forEachDifference(
+      cloned->getFields()->storage(),
+      [&](const auto& key, const auto&, const auto&) {
+        changed.insert(folly::to<std::string>(key));
+      },
+      [&](const auto& key, const auto&) {
+        removed.insert(folly::to<std::string>(key));
+      },
+      [&](const auto& key, const auto&) {
+        added.insert(folly::to<std::string>(key));
+      });
+  ASSERT_EQ(changed, std::set<std::string>({"10"}));
+  ASSERT_EQ(removed, std::set<std::string>({"20"}));
+  ASSERT_EQ(added, std::set<std::string>({"5000"}));
+}
@@ -448,6 +448,36 @@ TEST(ThriftStructNodeTests, ThriftStructNodeEncode) {
   ASSERT_EQ(decoded, data);
 }
 
+TEST(ThriftStructNodeTests, ThriftStructNodeEncodeCached) {
+  TestStruct data;
+  data.inlineInt() = 123;
+  data.inlineString() = "HelloThere";
+
+  auto node = std::make_shared<ThriftStructNode<TestStruct>>(data);
+  auto encoded = node->encode(fsdb::OperProtocol::COMPACT);
+
+  // unpublished nodes are never cached
+  ASSERT_EQ(node->encodeCached(fsdb::OperProtocol::COMPACT), encoded);
+
+  node->publish();
+  ASSERT_EQ(node->encodeCached(fsdb::OperProtocol::COMPACT), encoded);
+  ASSERT_EQ(node->encodeCached(fsdb::OperProtocol::COMPACT), encoded);
+  ASSERT_EQ(
+      node->encodeCached(fsdb::OperProtocol::BINARY),
+      node->encode(fsdb::OperProtocol::BINARY));
+
+  // modified clone must not see the cached bytes of the original
+  auto cloned = node->clone();
+  cloned->set<k::inlineInt>(456);
+  cloned->publish();
+  auto clonedEncoded = cloned->encodeCached(fsdb::OperProtocol::COMPACT);
+  ASSERT_NE(clonedEncoded, encoded);
+  auto decoded = apache::thrift::CompactSerializer::deserialize<TestStruct>(
+      clonedEncoded.toStdString());
+  ASSERT_EQ(*decoded.inlineInt(), 456);
+  ASSERT_EQ(node->encodeCached(fsdb::OperProtocol::COMPACT), encoded);
+}
+
 TEST(ThriftStructNodeTests, UnsignedInteger) {
   ThriftStructFields<TestStruct> fields;
   using UnderlyingType = folly::remove_cvref_t<
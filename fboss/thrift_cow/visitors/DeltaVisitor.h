@@ -346,6 +346,44 @@ struct DeltaVisitor<
       Func&& f) {
     bool hasDifferences{false};
 
+    if constexpr (Fields::StructurallyShared) {
+      // only walk the parts of the map that are no longer shared between
+      // old and new
+      oldFields.storage().forEachDifference(
+          newFields.storage(),
+          [&](const auto& key, const auto& oldVal, const auto& newVal) {
+            path.push_back(folly::to<std::string>(key));
+            if (DeltaVisitor<MappedTypeClass>::visit(
+                    path, oldVal, newVal, mode, std::forward<Func>(f))) {
+              hasDifferences = true;
+            }
+            path.pop_back();
+          },
+          [&](const auto& key, const auto& oldVal) {
+            hasDifferences = true;
+            path.push_back(folly::to<std::string>(key));
+            dv_detail::visitAddedOrRemovedNode<MappedTypeClass>(
+                path,
+                oldVal,
+                std::decay_t<decltype(oldVal)>{},
+                mode,
+                std::forward<Func>(f));
+            path.pop_back();
+          },
+          [&](const auto& key, const auto& newVal) {
+            hasDifferences = true;
+            path.push_back(folly::to<std::string>(key));
+            dv_detail::visitAddedOrRemovedNode<MappedTypeClass>(
+                path,
+                std::decay_t<decltype(newVal)>{},
+                newVal,
+                mode,
+                std::forward<Func>(f));
+            path.pop_back();
+          });
+      return hasDifferences;
+    }
+
     // changed fields
     for (const auto& [key, val] : oldFields) {
       path.push_back(folly::to<std::string>(key));
@@ -10,6 +10,7 @@
 #pragma once
 
 #include <memory>
+#include <optional>
 
 #include <fboss/thrift_storage/CowStorage.h>
 #include <folly/FBString.h>
@@ -43,14 +44,29 @@ class CowStateUpdate {
   using CowStateUpdateFn = std::function<std::shared_ptr<CowState>(
       const std::shared_ptr<CowState>&)>;
 
-  explicit CowStateUpdate(folly::StringPiece name, int behaviorFlags)
-      : name_(name.str()), behaviorFlags_(behaviorFlags) {}
+  explicit CowStateUpdate(
+      folly::StringPiece name,
+      int behaviorFlags,
+      std::optional<std::string> coalescingKey = std::nullopt)
+      : name_(name.str()),
+        behaviorFlags_(behaviorFlags),
+        coalescingKey_(std::move(coalescingKey)) {}
   virtual ~CowStateUpdate() = default;
 
   const std::string& getName() const {
     return name_;
   }
 
+  /*
+   * Updates with the same coalescing key overwrite the same part of the
+   * state, e.g. they set the same path. When several of them are applied in
+   * one batch only the last one runs, the others are superseded and share
+   * its onSuccess(). If it fails, the latest earlier one runs in its place.
+   */
+  const std::optional<std::string>& getCoalescingKey() const {
+    return coalescingKey_;
+  }
+
   bool allowsCoalescing() const {
     return !isNonCoalescing();
   }
@@ -92,11 +108,15 @@ class CowStateUpdate {
 
   std::string name_;
   int behaviorFlags_{static_cast<int>(BehaviorFlags::NONE)};
+  std::optional<std::string> coalescingKey_;
 
-  // An intrusive list hook for maintaining the list of pending updates.
+  // Link in CowStorageMgr's lock free stack of pending updates.
+  CowStateUpdate<Root>* nextPending_{nullptr};
+  // An intrusive list hook for maintaining the list of updates being
+  // applied.
   folly::IntrusiveListHook listHook_;
-  // The CowStateMgr code needs access to our listHook_ member so it can
-  // maintain the update list.
+  // The CowStateMgr code needs access to our listHook_ and nextPending_
+  // members so it can maintain the update lists.
   friend class CowStorageMgr<Root>;
 };
 
@@ -111,8 +131,9 @@ class FunctionCowStateUpdate : public CowStateUpdate<Root> {
   FunctionCowStateUpdate(
       folly::StringPiece name,
       CowStateUpdateFn fn,
-      int flags = Base::kDefaultBehaviorFlags)
-      : Base(name, flags), function_(fn) {}
+      int flags = Base::kDefaultBehaviorFlags,
+      std::optional<std::string> coalescingKey = std::nullopt)
+      : Base(name, flags, std::move(coalescingKey)), function_(fn) {}
 
   std::shared_ptr<CowState> applyUpdate(
       const std::shared_ptr<CowState>& origState) override {
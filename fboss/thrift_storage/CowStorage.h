@@ -2,10 +2,12 @@
 
 #pragma once
 
+#include <fboss/thrift_cow/nodes/EncodedCache.h>
 #include <fboss/thrift_cow/nodes/Types.h>
 #include <fboss/thrift_cow/visitors/ExtendedPathVisitor.h>
 #include <fboss/thrift_cow/visitors/PathVisitor.h>
 #include <fboss/thrift_storage/Storage.h>
+#include <fboss/thrift_storage/visitors/CompactPathVisitor.h>
 #include <folly/logging/xlog.h>
 
 namespace facebook::fboss::fsdb {
@@ -141,7 +143,8 @@ class CowStorage : public Storage<Root, CowStorage<Root>> {
             thrift_cow::PathVisitMode::FULL,
             [&](auto& node, auto begin, auto end) {
               if (begin == end) {
-                result.contents() = node.encode(protocol);
+                result.contents() = thrift_cow::encodeNode(
+                    node, protocol, encodedCacheEnabled_);
                 result.protocol() = protocol;
               }
             });
@@ -165,7 +168,8 @@ class CowStorage : public Storage<Root, CowStorage<Root>> {
         rootNode, begin, end, [&](auto& path, auto& node) {
           TaggedOperState state;
           state.path()->path() = path;
-          state.state()->contents() = node.encode(protocol);
+          state.state()->contents() =
+              thrift_cow::encodeNode(node, protocol, encodedCacheEnabled_);
           state.state()->protocol() = protocol;
           result.emplace_back(std::move(state));
         });
@@ -205,9 +209,22 @@ class CowStorage : public Storage<Root, CowStorage<Root>> {
         break;
       }
 
-      auto rawPath = *unit.path()->raw();
       // TODO: verify old state matches expected?
 
+      if (auto compactPath = unit.compactPath()) {
+        // compact paths are relative to Root and resolved directly against
+        // the cow nodes, see CompactPathVisitor
+        CompactPathOp op;
+        op.protocol = *delta.protocol();
+        if (auto newState = unit.newState()) {
+          op.encoded = &*newState;
+        }
+        result = detail::parseTraverseResult(
+            applyCompactPath<Root>(&root_, *compactPath, op));
+        continue;
+      }
+
+      const auto& rawPath = *unit.path()->raw();
       if (unit.newState()) {
         OperState newState;
         newState.contents() = *unit.newState();
@@ -245,6 +262,19 @@ class CowStorage : public Storage<Root, CowStorage<Root>> {
     }
   }
 
+  /*
+   * Opt in to memoizing encoded struct and map subtrees on published
+   * nodes, see thrift_cow::EncodedCache. Repeated get_encoded calls for
+   * unchanged subtrees then only copy the cached bytes.
+   */
+  void setEncodedCacheEnabled(bool enabled) {
+    encodedCacheEnabled_ = enabled;
+  }
+
+  bool encodedCacheEnabled() const {
+    return encodedCacheEnabled_;
+  }
+
   const std::shared_ptr<StorageImpl>& root() const {
     return root_;
   }
@@ -254,6 +284,7 @@ class CowStorage : public Storage<Root, CowStorage<Root>> {
 
  private:
   std::shared_ptr<StorageImpl> root_;
+  bool encodedCacheEnabled_{false};
 };
 
 template <typename Root>
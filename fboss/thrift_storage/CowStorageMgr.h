@@ -5,9 +5,12 @@
 #include <fboss/thrift_storage/CowStateUpdate.h>
 #include <fboss/thrift_storage/CowStorage.h>
 #include <folly/Synchronized.h>
+#include <folly/container/F14Map.h>
 #include <folly/io/async/ScopedEventBaseThread.h>
 #include <folly/logging/xlog.h>
 
+#include <atomic>
+
 namespace facebook::fboss::fsdb {
 
 template <typename Root>
@@ -38,9 +41,18 @@ class CowStorageMgr {
    *
    */
   void updateState(std::unique_ptr<CowStateUpdate<Root>> update) {
-    pendingUpdates_.wlock()->push_back(*update.release());
-    updateEvbThread_.getEventBase()->runInEventBaseThread(
-        handlePendingUpdatesHelper, this);
+    auto* pending = update.release();
+    auto* head = pendingUpdates_.load(std::memory_order_relaxed);
+    do {
+      pending->nextPending_ = head;
+    } while (!pendingUpdates_.compare_exchange_weak(
+        head, pending, std::memory_order_release, std::memory_order_relaxed));
+    // Only the update that makes the queue non-empty wakes up the update
+    // thread, which then drains everything queued until it runs.
+    if (!head) {
+      updateEvbThread_.getEventBase()->runInEventBaseThread(
+          handlePendingUpdatesHelper, this);
+    }
   }
   /**
    * Schedule an update to the CowState.
@@ -92,6 +104,30 @@ class CowStorageMgr {
     updateState(std::move(update));
   }
 
+  /**
+   * Schedule an update to the CowState that may be coalesced by key.
+   *
+   * @param name  A name to identify the source of this update.
+   * @param key   Updates with the same key must overwrite the same part of
+   *              the state, e.g. set the same path.
+   * @param fn    The function that will prepare the new CowState.
+   *
+   * If several updates with the same key are pending when the update thread
+   * runs, only the last one is applied. This keeps high rate publishers that
+   * repeatedly set the same paths from falling behind.
+   */
+  void updateStateCoalesced(
+      folly::StringPiece name,
+      std::string key,
+      CowStateUpdateFn fn) {
+    auto update = std::make_unique<FunctionCowStateUpdate<Root>>(
+        name,
+        std::move(fn),
+        CowStateUpdate<Root>::kDefaultBehaviorFlags,
+        std::move(key));
+    updateState(std::move(update));
+  }
+
   /*
    * A version of updateState() that doesn't return until the update has been
    * applied.
@@ -116,44 +152,60 @@ class CowStorageMgr {
     mgr->handlePendingUpdates();
   }
   void handlePendingUpdates() {
+    // Take all queued updates at once. The stack is in LIFO order, pushing
+    // each update to the front of the list restores submission order.
     CowStateUpdateList updates;
-    // Dequeue all queued updates
-    pendingUpdates_.withWLock([&updates](auto& pendingUpdates) {
-      auto iter = pendingUpdates.begin();
-      while (iter != pendingUpdates.end()) {
+    auto* pending =
+        pendingUpdates_.exchange(nullptr, std::memory_order_acquire);
+    while (pending) {
+      auto* next = pending->nextPending_;
+      pending->nextPending_ = nullptr;
+      updates.push_front(*pending);
+      pending = next;
+    }
+
+    while (!updates.empty()) {
+      CowStateUpdateList batch;
+      auto iter = updates.begin();
+      while (iter != updates.end()) {
         auto* update = &(*iter);
         if (update->isNonCoalescing()) {
-          if (iter == pendingUpdates.begin()) {
-            // First update is non coalescing, splice it onto the updates list
-            // and apply transaction by itself
+          if (iter == updates.begin()) {
+            // First update is non coalescing, apply transaction by itself
             ++iter;
             break;
           } else {
-            // Splice all updates upto this non coalescing update, we will
-            // get the non coalescing update in the next round
+            // Batch all updates upto this non coalescing update, we will
+            // get the non coalescing update in the next batch
             break;
           }
         }
         ++iter;
       }
-      updates.splice(
-          updates.begin(), pendingUpdates, pendingUpdates.begin(), iter);
-    });
-    // handlePendingUpdates() is invoked once for each update, but a previous
-    // call might have already processed everything.  If we don't have anything
-    // to do just return early.
-    if (updates.empty()) {
-      return;
+      batch.splice(batch.begin(), updates, updates.begin(), iter);
+      applyUpdates(batch);
+    }
+  }
+
+  void applyUpdates(CowStateUpdateList& updates) {
+    // Updates for each coalescing key in submission order, only the last one
+    // is applied. Earlier ones are superseded and share its outcome, unless
+    // it fails: then the latest earlier one is applied in its place.
+    folly::F14FastMap<std::string, std::vector<CowStateUpdate<Root>*>>
+        updatesForKey;
+    for (auto& update : updates) {
+      if (const auto& key = update.getCoalescingKey()) {
+        updatesForKey[*key].push_back(&update);
+      }
     }
+
     auto oldAppliedState = getState();
     auto newDesiredState = oldAppliedState;
-    auto iter = updates.begin();
-    while (iter != updates.end()) {
-      auto* update = &(*iter);
-      ++iter;
-
+    // Returns false, after calling onError() and deleting the update, if it
+    // failed
+    auto applyUpdate = [&newDesiredState](CowStateUpdate<Root>* update) {
       std::shared_ptr<CowState> intermediateState;
-      XLOG(INFO) << "preparing state update " << update->getName();
+      XLOG(DBG2) << "preparing state update " << update->getName();
       try {
         intermediateState = update->applyUpdate(newDesiredState);
       } catch (const std::exception& ex) {
@@ -162,6 +214,7 @@ class CowStorageMgr {
         // won't call it's onSuccess() function later.
         update->onError(ex);
         delete update;
+        return false;
       }
       // We have applied the update to software switch state, so call success
       // on the update.
@@ -174,10 +227,41 @@ class CowStorageMgr {
         intermediateState->publish();
         newDesiredState = intermediateState;
       }
+      return true;
+    };
+
+    auto iter = updates.begin();
+    while (iter != updates.end()) {
+      auto* update = &(*iter);
+      ++iter;
+
+      const auto& key = update->getCoalescingKey();
+      if (!key) {
+        applyUpdate(update);
+        continue;
+      }
+      auto& keyUpdates = updatesForKey[*key];
+      if (keyUpdates.back() != update) {
+        XLOG(DBG3) << "skipping superseded state update " << update->getName();
+        continue;
+      }
+      // Fall back to earlier updates for the key until one applies. Failed
+      // ones are removed from the list, the rest get onSuccess() below.
+      while (!keyUpdates.empty()) {
+        auto* candidate = keyUpdates.back();
+        keyUpdates.pop_back();
+        if (applyUpdate(candidate)) {
+          break;
+        }
+      }
     }
-    // Invoke callback on change
+    // Invoke callback once for the whole batch
     if (newDesiredState != oldAppliedState) {
-      storage_.wlock()->reset(new CowStorage<Root>(newDesiredState));
+      storage_.withWLock([&](auto& storage) {
+        auto newStorage = std::make_unique<CowStorage<Root>>(newDesiredState);
+        newStorage->setEncodedCacheEnabled(storage->encodedCacheEnabled());
+        storage = std::move(newStorage);
+      });
       stateUpdateCb_(oldAppliedState, newDesiredState);
       newDesiredState.reset();
     }
@@ -191,9 +275,11 @@ class CowStorageMgr {
   folly::Synchronized<std::unique_ptr<CowStorage<Root>>> storage_;
   CowStateUpdateCb stateUpdateCb_;
   /*
-   * A list of pending state updates to be applied.
+   * Lock free stack of pending state updates to be applied, linked through
+   * CowStateUpdate::nextPending_. Producers push, the update thread takes
+   * the whole stack at once.
    */
-  folly::Synchronized<CowStateUpdateList> pendingUpdates_;
+  std::atomic<CowStateUpdate<Root>*> pendingUpdates_{nullptr};
   folly::ScopedEventBaseThread updateEvbThread_{"CowStorageMgrUpdateThread"};
 };
 
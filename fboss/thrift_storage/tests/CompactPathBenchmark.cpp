@@ -0,0 +1,136 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+#include <thrift/lib/cpp2/protocol/Serializer.h>
+
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_fatal_types.h"
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_types.h"
+#include "fboss/thrift_cow/nodes/Serializer.h"
+#include "fboss/thrift_storage/CowStorage.h"
+#include "fboss/thrift_storage/visitors/CompactPathCodec.h"
+
+DEFINE_int32(
+    compact_path_units_per_delta,
+    16,
+    "Number of leaf updates in each delta, like a small stats delta");
+
+using namespace facebook::fboss;
+using namespace facebook::fboss::fsdb;
+
+namespace {
+
+using StructTC = apache::thrift::type_class::structure;
+using IntegralTC = apache::thrift::type_class::integral;
+
+// leaf counter updates under string keyed map entries, the common shape
+// of stats deltas
+std::vector<std::vector<std::string>> makePaths() {
+  std::vector<std::vector<std::string>> paths;
+  for (int i = 0; i < FLAGS_compact_path_units_per_delta; ++i) {
+    paths.push_back(
+        {"stringToStruct", folly::to<std::string>("eth1/", i, "/1"), "max"});
+  }
+  return paths;
+}
+
+OperDelta makeDelta(
+    const std::vector<std::vector<std::string>>& paths,
+    bool compact,
+    int value) {
+  OperDelta delta;
+  delta.protocol() = OperProtocol::COMPACT;
+  for (const auto& path : paths) {
+    OperDeltaUnit unit;
+    if (compact) {
+      folly::fbstring encoded;
+      encodeCompactPath<TestStruct>(path.begin(), path.end(), encoded);
+      unit.compactPath() = std::move(encoded);
+    } else {
+      unit.path()->raw() = path;
+    }
+    unit.newState() =
+        thrift_cow::serialize<IntegralTC>(OperProtocol::COMPACT, value);
+    delta.changes()->push_back(std::move(unit));
+  }
+  return delta;
+}
+
+CowStorage<TestStruct> makeStorage(
+    const std::vector<std::vector<std::string>>& paths) {
+  TestStruct root;
+  for (const auto& path : paths) {
+    root.stringToStruct()->emplace(path[1], TestStructSimple());
+  }
+  auto storage = CowStorage<TestStruct>(std::move(root));
+  storage.publish();
+  return storage;
+}
+
+// publisher side: build and serialize a delta
+void publish(uint32_t iters, bool compact) {
+  std::vector<std::vector<std::string>> paths;
+  BENCHMARK_SUSPEND {
+    paths = makePaths();
+  }
+  for (uint32_t i = 0; i < iters; ++i) {
+    auto serialized = apache::thrift::CompactSerializer::serialize<std::string>(
+        makeDelta(paths, compact, i));
+    folly::doNotOptimizeAway(serialized);
+  }
+}
+
+// subscriber side: deserialize a delta and apply it to storage
+void apply(uint32_t iters, bool compact) {
+  std::vector<std::vector<std::string>> paths;
+  std::optional<CowStorage<TestStruct>> storage;
+  std::string serialized;
+  BENCHMARK_SUSPEND {
+    paths = makePaths();
+    storage.emplace(makeStorage(paths));
+    serialized = apache::thrift::CompactSerializer::serialize<std::string>(
+        makeDelta(paths, compact, 1));
+  }
+  for (uint32_t i = 0; i < iters; ++i) {
+    auto delta =
+        apache::thrift::CompactSerializer::deserialize<OperDelta>(serialized);
+    auto result = storage->patch(delta);
+    folly::doNotOptimizeAway(result);
+  }
+  BENCHMARK_SUSPEND {
+    storage.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK(PublishRawPaths, iters) {
+  publish(iters, false);
+}
+
+BENCHMARK_RELATIVE(PublishCompactPaths, iters) {
+  publish(iters, true);
+}
+
+BENCHMARK(ApplyRawPaths, iters) {
+  apply(iters, false);
+}
+
+BENCHMARK_RELATIVE(ApplyCompactPaths, iters) {
+  apply(iters, true);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  auto paths = makePaths();
+  for (bool compact : {false, true}) {
+    auto serialized = apache::thrift::CompactSerializer::serialize<std::string>(
+        makeDelta(paths, compact, 1));
+    LOG(INFO) << (compact ? "Compact" : "Raw")
+              << " paths, serialized delta bytes: " << serialized.size();
+  }
+  folly::runBenchmarks();
+  return 0;
+}
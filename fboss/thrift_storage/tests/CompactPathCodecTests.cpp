@@ -0,0 +1,211 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#include <folly/String.h>
+#include <gtest/gtest.h>
+
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_fatal_types.h"
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_types.h"
+#include "fboss/thrift_cow/nodes/Serializer.h"
+#include "fboss/thrift_storage/CowStorage.h"
+#include "fboss/thrift_storage/visitors/CompactPathCodec.h"
+
+using namespace facebook::fboss;
+using namespace facebook::fboss::fsdb;
+
+TEST(CompactPathCodecTests, RoundTrip) {
+  std::vector<std::vector<std::string>> paths = {
+      {},
+      {"tx"},
+      {"member", "min"},
+      {"structMap", "3", "max"},
+      {"structMap", "-3"},
+      {"integralSet", "5"},
+      {"variantMember", "str"},
+      {"structList", "2", "min"},
+      {"enumMap", "2", "min"},
+      {"enumSet", "3"},
+      {"mapOfStringToI32", "some key"},
+      {"stringToStruct", "", "max"},
+      {"listTypedef", "0"},
+  };
+
+  for (const auto& path : paths) {
+    folly::fbstring compact;
+    ASSERT_EQ(
+        encodeCompactPath<TestStruct>(path.begin(), path.end(), compact),
+        CompactPathResult::OK)
+        << folly::join('/', path);
+
+    std::vector<std::string> decoded;
+    ASSERT_EQ(
+        decodeCompactPath<TestStruct>(compact, decoded),
+        CompactPathResult::OK)
+        << folly::join('/', path);
+    EXPECT_EQ(decoded, path);
+  }
+}
+
+TEST(CompactPathCodecTests, EnumKeysByName) {
+  std::vector<std::string> path = {"enumMap", "SECOND", "max"};
+  folly::fbstring compact;
+  ASSERT_EQ(
+      encodeCompactPath<TestStruct>(path.begin(), path.end(), compact),
+      CompactPathResult::OK);
+  std::vector<std::string> decoded;
+  ASSERT_EQ(
+      decodeCompactPath<TestStruct>(compact, decoded), CompactPathResult::OK);
+  // keys are decoded in the same form DeltaVisitor emits them
+  EXPECT_EQ(decoded, std::vector<std::string>({"enumMap", "2", "max"}));
+}
+
+TEST(CompactPathCodecTests, SmallerThanRaw) {
+  std::vector<std::string> path = {"stringToStruct", "eth1/1/1", "max"};
+  folly::fbstring compact;
+  ASSERT_EQ(
+      encodeCompactPath<TestStruct>(path.begin(), path.end(), compact),
+      CompactPathResult::OK);
+  // field id (1 byte) + length prefixed key + field id (1 byte)
+  EXPECT_EQ(compact.size(), 1 + 1 + 8 + 1);
+}
+
+TEST(CompactPathCodecTests, InvalidPaths) {
+  auto encode = [](std::vector<std::string> path) {
+    folly::fbstring compact;
+    return encodeCompactPath<TestStruct>(path.begin(), path.end(), compact);
+  };
+  EXPECT_EQ(encode({"doesNotExist"}), CompactPathResult::INVALID_STRUCT_MEMBER);
+  EXPECT_EQ(
+      encode({"variantMember", "nope"}),
+      CompactPathResult::INVALID_VARIANT_MEMBER);
+  EXPECT_EQ(encode({"structMap", "abc"}), CompactPathResult::INVALID_MAP_KEY);
+  EXPECT_EQ(
+      encode({"structList", "-1"}), CompactPathResult::INVALID_ARRAY_INDEX);
+  EXPECT_EQ(encode({"tx", "extra"}), CompactPathResult::INVALID_PATH);
+
+  std::vector<std::string> decoded;
+  // field id 1000 does not exist
+  CompactPathWriter writer;
+  writer.writeSigned(1000);
+  EXPECT_EQ(
+      decodeCompactPath<TestStruct>(writer.data(), decoded),
+      CompactPathResult::INVALID_STRUCT_MEMBER);
+  // truncated varint
+  folly::fbstring truncated("\x80", 1);
+  EXPECT_EQ(
+      decodeCompactPath<TestStruct>(truncated, decoded),
+      CompactPathResult::MALFORMED);
+}
+
+TEST(CompactPathCodecTests, CompactAndExpandDelta) {
+  std::vector<std::string> basePath = {"agent", "test"};
+  OperDelta delta;
+  OperDeltaUnit inside;
+  inside.path()->raw() = {"agent", "test", "structMap", "3", "min"};
+  OperDeltaUnit outside;
+  outside.path()->raw() = {"agent", "other"};
+  delta.changes() = {inside, outside};
+
+  compactDeltaPaths<TestStruct>(delta, basePath);
+  ASSERT_TRUE(delta.changes()->at(0).compactPath());
+  EXPECT_TRUE(delta.changes()->at(0).path()->raw()->empty());
+  EXPECT_FALSE(delta.changes()->at(1).compactPath());
+
+  EXPECT_EQ(
+      expandDeltaPaths<TestStruct>(delta, basePath), CompactPathResult::OK);
+  EXPECT_EQ(delta.changes()->at(0), inside);
+  EXPECT_EQ(delta.changes()->at(1), outside);
+}
+
+TEST(CompactPathCodecTests, PatchStorage) {
+  auto storage = CowStorage<TestStruct>(TestStruct());
+  TestStructSimple value;
+  value.min() = 1;
+  value.max() = 2;
+
+  std::vector<std::string> path = {"structMap", "7"};
+  OperDeltaUnit unit;
+  folly::fbstring compact;
+  ASSERT_EQ(
+      encodeCompactPath<TestStruct>(path.begin(), path.end(), compact),
+      CompactPathResult::OK);
+  unit.compactPath() = compact;
+  unit.newState() =
+      thrift_cow::serialize<apache::thrift::type_class::structure>(
+          OperProtocol::COMPACT, value);
+  OperDelta delta;
+  delta.changes() = {unit};
+  delta.protocol() = OperProtocol::COMPACT;
+
+  EXPECT_EQ(storage.patch(delta), std::nullopt);
+  EXPECT_EQ(storage.get<TestStructSimple>(path).value(), value);
+
+  delta.changes()->at(0).compactPath() = folly::fbstring("\x80", 1);
+  EXPECT_EQ(storage.patch(delta), StorageError::INVALID_PATH);
+}
+
+TEST(CompactPathCodecTests, PatchStorageLeavesAndRemove) {
+  auto storage = CowStorage<TestStruct>(TestStruct());
+  auto makeDelta = [](const std::vector<std::string>& path,
+                      std::optional<folly::fbstring> newState) {
+    OperDeltaUnit unit;
+    folly::fbstring compact;
+    EXPECT_EQ(
+        encodeCompactPath<TestStruct>(path.begin(), path.end(), compact),
+        CompactPathResult::OK);
+    unit.compactPath() = compact;
+    if (newState) {
+      unit.newState() = *newState;
+    }
+    OperDelta delta;
+    delta.changes() = {unit};
+    delta.protocol() = OperProtocol::COMPACT;
+    return delta;
+  };
+  auto encodeI32 = [](int32_t value) {
+    return thrift_cow::serialize<apache::thrift::type_class::integral>(
+        OperProtocol::COMPACT, value);
+  };
+
+  // primitive leaves below map and list entries which don't exist yet
+  std::vector<std::string> mapLeaf = {"structMap", "-3", "max"};
+  EXPECT_EQ(storage.patch(makeDelta(mapLeaf, encodeI32(5))), std::nullopt);
+  EXPECT_EQ(storage.get<int32_t>(mapLeaf).value(), 5);
+
+  std::vector<std::string> listLeaf = {"structList", "1", "min"};
+  EXPECT_EQ(storage.patch(makeDelta(listLeaf, encodeI32(6))), std::nullopt);
+  EXPECT_EQ(storage.get<int32_t>(listLeaf).value(), 6);
+
+  std::vector<std::string> stringKey = {"mapOfStringToI32", "some key"};
+  EXPECT_EQ(storage.patch(makeDelta(stringKey, encodeI32(7))), std::nullopt);
+  EXPECT_EQ(storage.get<int32_t>(stringKey).value(), 7);
+
+  // set members are added by their key alone
+  std::vector<std::string> setMember = {"integralSet", "5"};
+  EXPECT_EQ(storage.patch(makeDelta(setMember, encodeI32(5))), std::nullopt);
+  EXPECT_EQ(
+      storage.get<std::set<int32_t>>({"integralSet"}).value(),
+      std::set<int32_t>({5}));
+
+  // removes
+  EXPECT_EQ(
+      storage.patch(makeDelta({"structMap", "-3"}, std::nullopt)),
+      std::nullopt);
+  EXPECT_TRUE(
+      storage.get<std::map<int32_t, TestStructSimple>>({"structMap"})
+          .value()
+          .empty());
+  EXPECT_EQ(storage.patch(makeDelta(setMember, std::nullopt)), std::nullopt);
+  EXPECT_TRUE(
+      storage.get<std::set<int32_t>>({"integralSet"}).value().empty());
+  EXPECT_EQ(storage.patch(makeDelta(stringKey, std::nullopt)), std::nullopt);
+  EXPECT_TRUE(storage.get<std::map<std::string, int32_t>>({"mapOfStringToI32"})
+                  .value()
+                  .empty());
+
+  // path continuing past a primitive leaves storage untouched
+  auto delta = makeDelta(listLeaf, encodeI32(8));
+  // list index 0
+  delta.changes()->at(0).compactPath()->push_back('\0');
+  EXPECT_EQ(storage.patch(delta), StorageError::INVALID_PATH);
+  EXPECT_EQ(storage.get<int32_t>(listLeaf).value(), 6);
+}
@@ -0,0 +1,165 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/Random.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_fatal_types.h"
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_types.h"
+#include "fboss/thrift_storage/CowStateUpdate.h"
+#include "fboss/thrift_storage/CowStorageMgr.h"
+
+DEFINE_int32(
+    storage_mgr_num_keys,
+    1000,
+    "Number of distinct map entries updated by the producers");
+
+using namespace facebook::fboss::fsdb;
+using k = thriftpath_test_tags::strings;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using CowState = CowStateUpdate<TestStruct>::CowState;
+
+/*
+ * Sets a single map entry and records the time from submission until the
+ * batch containing it was applied, including when it was superseded.
+ */
+class TimedUpdate : public CowStateUpdate<TestStruct> {
+ public:
+  TimedUpdate(
+      int key,
+      int value,
+      bool coalesce,
+      std::vector<uint64_t>* latenciesNs)
+      : CowStateUpdate<TestStruct>(
+            "TimedUpdate",
+            kDefaultBehaviorFlags,
+            coalesce ? std::optional<std::string>(
+                           folly::to<std::string>("structMap/", key))
+                     : std::nullopt),
+        key_(key),
+        value_(value),
+        latenciesNs_(latenciesNs) {}
+
+  std::shared_ptr<CowState> applyUpdate(
+      const std::shared_ptr<CowState>& origState) override {
+    auto out = origState->clone();
+    out->modify("structMap");
+    TestStructSimple member;
+    member.min() = value_;
+    member.max() = value_;
+    auto& structMap = out->ref<k::structMap>();
+    structMap->remove(key_);
+    structMap->emplace(key_, member);
+    return out;
+  }
+
+  void onError(const std::exception& ex) noexcept override {
+    XLOG(FATAL) << "unexpected error applying benchmark update: "
+                << folly::exceptionStr(ex);
+  }
+
+  void onSuccess() override {
+    // only called on the update thread
+    latenciesNs_->push_back(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            Clock::now() - submitted_)
+            .count());
+  }
+
+ private:
+  int key_;
+  int value_;
+  std::vector<uint64_t>* latenciesNs_;
+  Clock::time_point submitted_{Clock::now()};
+};
+
+void runProducers(
+    folly::UserCounters& counters,
+    uint32_t iters,
+    int numProducers,
+    bool coalesce) {
+  std::unique_ptr<CowStorageMgr<TestStruct>> mgr;
+  std::vector<uint64_t> latenciesNs;
+  BENCHMARK_SUSPEND {
+    auto storage = CowStorage<TestStruct>(TestStruct());
+    storage.publish();
+    mgr = std::make_unique<CowStorageMgr<TestStruct>>(std::move(storage));
+    latenciesNs.reserve(iters);
+  }
+
+  std::vector<std::thread> producers;
+  for (int producer = 0; producer < numProducers; ++producer) {
+    auto numUpdates = iters / numProducers +
+        (producer < static_cast<int>(iters % numProducers) ? 1 : 0);
+    producers.emplace_back([&, numUpdates] {
+      for (uint32_t i = 0; i < numUpdates; ++i) {
+        mgr->updateState(std::make_unique<TimedUpdate>(
+            folly::Random::rand32(FLAGS_storage_mgr_num_keys),
+            i,
+            coalesce,
+            &latenciesNs));
+      }
+    });
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+  // returns once everything queued before it has been applied
+  mgr->updateStateBlocking(
+      "drain",
+      [](const std::shared_ptr<CowState>&) -> std::shared_ptr<CowState> {
+        return nullptr;
+      });
+
+  BENCHMARK_SUSPEND {
+    if (!latenciesNs.empty()) {
+      auto p99 = latenciesNs.begin() + latenciesNs.size() * 99 / 100;
+      std::nth_element(latenciesNs.begin(), p99, latenciesNs.end());
+      counters["p99_apply_us"] = *p99 / 1000;
+    }
+    mgr.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK_COUNTERS(OneProducer, counters, iters) {
+  runProducers(counters, iters, 1, false);
+}
+
+BENCHMARK_COUNTERS(FourProducers, counters, iters) {
+  runProducers(counters, iters, 4, false);
+}
+
+BENCHMARK_COUNTERS(SixteenProducers, counters, iters) {
+  runProducers(counters, iters, 16, false);
+}
+
+BENCHMARK_DRAW_LINE();
+
+BENCHMARK_COUNTERS(OneProducerCoalesced, counters, iters) {
+  runProducers(counters, iters, 1, true);
+}
+
+BENCHMARK_COUNTERS(FourProducersCoalesced, counters, iters) {
+  runProducers(counters, iters, 4, true);
+}
+
+BENCHMARK_COUNTERS(SixteenProducersCoalesced, counters, iters) {
+  runProducers(counters, iters, 16, true);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
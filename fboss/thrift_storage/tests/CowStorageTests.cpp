@@ -3,6 +3,7 @@
 #include <folly/String.h>
 #include <folly/dynamic.h>
 #include <folly/logging/xlog.h>
+#include <folly/synchronization/Baton.h>
 #include <gtest/gtest.h>
 
 #include <thrift/lib/cpp2/protocol/DebugProtocol.h>
@@ -34,6 +35,35 @@ CowStorage<TestStruct> createTestStorage() {
   return storage;
 }
 
+// Coalesced update recording its outcome
+class RecordingUpdate : public CowStateUpdate<TestStruct> {
+ public:
+  RecordingUpdate(
+      std::string name,
+      CowStateUpdateFn fn,
+      std::vector<std::string>& results)
+      : CowStateUpdate<TestStruct>(name, kDefaultBehaviorFlags, "name"),
+        name_(std::move(name)),
+        fn_(std::move(fn)),
+        results_(results) {}
+
+  std::shared_ptr<CowState> applyUpdate(
+      const std::shared_ptr<CowState>& origState) override {
+    return fn_(origState);
+  }
+  void onError(const std::exception& /*ex*/) noexcept override {
+    results_.push_back(name_ + ":error");
+  }
+  void onSuccess() override {
+    results_.push_back(name_ + ":success");
+  }
+
+ private:
+  std::string name_;
+  CowStateUpdateFn fn_;
+  std::vector<std::string>& results_;
+};
+
 } // namespace
 
 namespace facebook::fboss::fsdb {
@@ -150,3 +180,90 @@ TEST_F(CowStorageUpdateTests, updateIsCloned) {
         });
   }
 }
+
+TEST_F(CowStorageUpdateTests, updateCoalescedByKey) {
+  int numCallbacks = 0;
+  mgr_ = std::make_unique<CowStorageMgr<TestStruct>>(
+      createTestStorage(),
+      [&numCallbacks](const auto&, const auto&) { ++numCallbacks; });
+
+  // hold the update thread so the following updates end up in one batch
+  folly::Baton<> started, unblock;
+  mgr_->updateState(
+      "Block",
+      [&started, &unblock](const std::shared_ptr<CowState>&)
+          -> std::shared_ptr<CowState> {
+        started.post();
+        unblock.wait();
+        return nullptr;
+      });
+  started.wait();
+
+  std::vector<std::string> applied;
+  auto setName = [&applied](std::string name) {
+    return [&applied, name](const std::shared_ptr<CowState>& in) {
+      applied.push_back(name);
+      auto out = in->clone();
+      out->ref<k::name>() = name;
+      return out;
+    };
+  };
+  mgr_->updateStateCoalesced("SetName1", "name", setName("first"));
+  mgr_->updateState("SetTxFalse", setTx(false));
+  mgr_->updateStateCoalesced("SetName2", "name", setName("second"));
+  unblock.post();
+  waitForCowStateUpdates();
+
+  EXPECT_EQ(applied, std::vector<std::string>({"second"}));
+  EXPECT_EQ(mgr_->getState()->get<k::name>()->ref(), "second");
+  EXPECT_FALSE(mgr_->getState()->get<k::tx>()->ref());
+  EXPECT_EQ(numCallbacks, 1);
+}
+
+TEST_F(CowStorageUpdateTests, updateCoalescedFallsBackOnError) {
+  mgr_ = std::make_unique<CowStorageMgr<TestStruct>>(
+      createTestStorage(), [](const auto&, const auto&) {});
+
+  folly::Baton<> started, unblock;
+  mgr_->updateState(
+      "Block",
+      [&started, &unblock](const std::shared_ptr<CowState>&)
+          -> std::shared_ptr<CowState> {
+        started.post();
+        unblock.wait();
+        return nullptr;
+      });
+  started.wait();
+
+  auto setName = [](std::string name) {
+    return [name](const std::shared_ptr<CowState>& in) {
+      auto out = in->clone();
+      out->ref<k::name>() = name;
+      return out;
+    };
+  };
+  // Superseded updates share the outcome of the update applied in their
+  // place, not of the failed one
+  std::vector<std::string> results;
+  auto makeUpdate = [&results](
+                        std::string name,
+                        CowStorageMgr<TestStruct>::CowStateUpdateFn fn) {
+    return std::make_unique<RecordingUpdate>(
+        std::move(name), std::move(fn), results);
+  };
+  mgr_->updateState(makeUpdate("first", setName("first")));
+  mgr_->updateState(makeUpdate("second", setName("second")));
+  mgr_->updateState(makeUpdate(
+      "third",
+      [](const std::shared_ptr<CowState>&) -> std::shared_ptr<CowState> {
+        throw std::runtime_error("failed");
+      }));
+  unblock.post();
+  waitForCowStateUpdates();
+
+  EXPECT_EQ(mgr_->getState()->get<k::name>()->ref(), "second");
+  EXPECT_EQ(
+      results,
+      std::vector<std::string>(
+          {"third:error", "first:success", "second:success"}));
+}
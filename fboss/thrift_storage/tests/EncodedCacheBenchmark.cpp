@@ -0,0 +1,91 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#include <folly/Benchmark.h>
+#include <folly/Conv.h>
+#include <folly/init/Init.h>
+#include <gflags/gflags.h>
+
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_fatal_types.h"
+#include "fboss/fsdb/tests/gen-cpp2/thriftpath_test_types.h"
+#include "fboss/thrift_storage/CowStorage.h"
+
+DEFINE_int32(
+    encoded_cache_map_size,
+    10000,
+    "Number of entries in the map subtree read by the benchmarks");
+DEFINE_int32(
+    encoded_cache_reads,
+    100,
+    "Number of reads of the same subtree per benchmark iteration");
+
+using namespace facebook::fboss::fsdb;
+
+namespace {
+
+CowStorage<TestStruct> createLargeStorage(bool cacheEnabled) {
+  TestStruct root;
+  for (int i = 0; i < FLAGS_encoded_cache_map_size; ++i) {
+    TestStructSimple member;
+    member.min() = i;
+    member.max() = i * 2;
+    root.structMap()->emplace(i, member);
+    root.stringToStruct()->emplace(folly::to<std::string>("key", i), member);
+  }
+  auto storage = CowStorage<TestStruct>(std::move(root));
+  storage.setEncodedCacheEnabled(cacheEnabled);
+  // only published nodes are cached
+  storage.publish();
+  return storage;
+}
+
+void readSubtree(
+    uint32_t iters,
+    bool cacheEnabled,
+    const std::vector<std::string>& path,
+    OperProtocol protocol) {
+  std::optional<CowStorage<TestStruct>> storage;
+  BENCHMARK_SUSPEND {
+    storage.emplace(createLargeStorage(cacheEnabled));
+  }
+  for (uint32_t i = 0; i < iters; ++i) {
+    for (int read = 0; read < FLAGS_encoded_cache_reads; ++read) {
+      auto result = storage->get_encoded(path, protocol);
+      folly::doNotOptimizeAway(result);
+    }
+  }
+  BENCHMARK_SUSPEND {
+    storage.reset();
+  }
+}
+
+} // namespace
+
+BENCHMARK(ReadStructMapCompact, iters) {
+  readSubtree(iters, false, {"structMap"}, OperProtocol::COMPACT);
+}
+
+BENCHMARK_RELATIVE(ReadStructMapCompactCached, iters) {
+  readSubtree(iters, true, {"structMap"}, OperProtocol::COMPACT);
+}
+
+BENCHMARK(ReadStringToStructBinary, iters) {
+  readSubtree(iters, false, {"stringToStruct"}, OperProtocol::BINARY);
+}
+
+BENCHMARK_RELATIVE(ReadStringToStructBinaryCached, iters) {
+  readSubtree(iters, true, {"stringToStruct"}, OperProtocol::BINARY);
+}
+
+BENCHMARK(ReadRootCompact, iters) {
+  readSubtree(iters, false, {}, OperProtocol::COMPACT);
+}
+
+BENCHMARK_RELATIVE(ReadRootCompactCached, iters) {
+  readSubtree(iters, true, {}, OperProtocol::COMPACT);
+}
+
+int main(int argc, char** argv) {
+  folly::init(&argc, &argv, true);
+  folly::runBenchmarks();
+  return 0;
+}
@@ -0,0 +1,603 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#pragma once
+
+#include <fatal/type/enum.h>
+#include <folly/Conv.h>
+#include <folly/FBString.h>
+#include <folly/Range.h>
+#include <folly/Varint.h>
+#include <folly/container/F14Map.h>
+#include <thrift/lib/cpp2/TypeClass.h>
+#include <thrift/lib/cpp2/reflection/reflection.h>
+#include "fboss/fsdb/if/gen-cpp2/fsdb_oper_types.h"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace facebook::fboss::fsdb {
+
+/*
+ * CompactPathCodec converts between the raw form of an oper path (member
+ * names and stringified keys) and its compact form, used for
+ * OperDeltaUnit.compactPath. Units carrying a compact path are
+ * self-describing, receivers handle both forms on any stream.
+ *
+ * A compact path is a sequence of varints, one element per path token:
+ *  - struct/union member: zigzag encoded thrift field id
+ *  - list index: index
+ *  - integral/enum map key or set value: zigzag encoded value
+ *  - string/binary map key or set value: length followed by the bytes
+ *
+ * Elements carry no type information, the thrift type of the path root
+ * determines how each element is interpreted. Struct and union members are
+ * resolved through a dispatch table built once per type, keyed by field id
+ * (decode) or name (encode), instead of a string search at every level.
+ *
+ * Map keys of other types (e.g. floating point) are not supported; such
+ * paths fail with UNSUPPORTED_KEY_TYPE and are sent in raw form instead.
+ */
+
+enum class CompactPathResult {
+  OK,
+  INVALID_PATH,
+  INVALID_STRUCT_MEMBER,
+  INVALID_VARIANT_MEMBER,
+  INVALID_ARRAY_INDEX,
+  INVALID_MAP_KEY,
+  UNSUPPORTED_KEY_TYPE,
+  MALFORMED,
+};
+
+class CompactPathWriter {
+ public:
+  void writeVarint(uint64_t value) {
+    uint8_t buf[folly::kMaxVarintLength64];
+    auto len = folly::encodeVarint(value, buf);
+    out_.append(reinterpret_cast<const char*>(buf), len);
+  }
+
+  void writeSigned(int64_t value) {
+    writeVarint(folly::encodeZigZag(value));
+  }
+
+  void writeBytes(folly::StringPiece bytes) {
+    writeVarint(bytes.size());
+    out_.append(bytes.data(), bytes.size());
+  }
+
+  folly::fbstring& data() {
+    return out_;
+  }
+
+ private:
+  folly::fbstring out_;
+};
+
+class CompactPathReader {
+ public:
+  explicit CompactPathReader(folly::ByteRange in) : in_(in) {}
+
+  bool empty() const {
+    return in_.empty();
+  }
+
+  std::optional<uint64_t> readVarint() {
+    auto value = folly::tryDecodeVarint(in_);
+    if (value.hasError()) {
+      return std::nullopt;
+    }
+    return value.value();
+  }
+
+  std::optional<int64_t> readSigned() {
+    auto value = readVarint();
+    if (!value) {
+      return std::nullopt;
+    }
+    return folly::decodeZigZag(*value);
+  }
+
+  std::optional<folly::StringPiece> readBytes() {
+    auto len = readVarint();
+    if (!len || *len > in_.size()) {
+      return std::nullopt;
+    }
+    folly::StringPiece bytes(reinterpret_cast<const char*>(in_.data()), *len);
+    in_.advance(*len);
+    return bytes;
+  }
+
+ private:
+  folly::ByteRange in_;
+};
+
+template <typename TC>
+struct CompactPathCodec;
+
+namespace cpc_detail {
+
+using PathIter = std::vector<std::string>::const_iterator;
+using EncodeFn =
+    CompactPathResult (*)(PathIter, PathIter, CompactPathWriter&);
+using DecodeFn =
+    CompactPathResult (*)(CompactPathReader&, std::vector<std::string>&);
+
+struct MemberDispatch {
+  std::string name;
+  int16_t id;
+  EncodeFn encode;
+  DecodeFn decode;
+};
+
+class MemberDispatchTable {
+ public:
+  void add(MemberDispatch member) {
+    byId_.emplace(member.id, members_.size());
+    byName_.emplace(member.name, members_.size());
+    members_.push_back(std::move(member));
+  }
+
+  const MemberDispatch* findById(int64_t id) const {
+    auto it = byId_.find(id);
+    return it == byId_.end() ? nullptr : &members_[it->second];
+  }
+
+  const MemberDispatch* findByName(const std::string& name) const {
+    auto it = byName_.find(name);
+    return it == byName_.end() ? nullptr : &members_[it->second];
+  }
+
+ private:
+  std::vector<MemberDispatch> members_;
+  folly::F14FastMap<int64_t, size_t> byId_;
+  folly::F14FastMap<std::string, size_t> byName_;
+};
+
+template <typename Name>
+std::string memberName() {
+  return std::string(fatal::z_data<Name>(), fatal::size<Name>::value);
+}
+
+template <typename TC, typename TType>
+MemberDispatch makeMemberDispatch(std::string name, int16_t id) {
+  return MemberDispatch{
+      std::move(name),
+      id,
+      &CompactPathCodec<TC>::template encode<TType>,
+      &CompactPathCodec<TC>::template decode<TType>};
+}
+
+template <typename TType>
+const MemberDispatchTable& structDispatchTable() {
+  static const MemberDispatchTable table = [] {
+    MemberDispatchTable result;
+    fatal::foreach<typename apache::thrift::reflect_struct<TType>::members>(
+        [&](auto tag) {
+          using member = decltype(fatal::tag_type(tag));
+          result.add(makeMemberDispatch<
+                     typename member::type_class,
+                     typename member::type>(
+              memberName<typename member::name>(), member::id::value));
+        });
+    return result;
+  }();
+  return table;
+}
+
+template <typename TType>
+const MemberDispatchTable& variantDispatchTable() {
+  static const MemberDispatchTable table = [] {
+    MemberDispatchTable result;
+    fatal::foreach<
+        typename apache::thrift::reflect_variant<TType>::traits::descriptors>(
+        [&](auto tag) {
+          using descriptor = decltype(fatal::tag_type(tag));
+          using metadata = typename descriptor::metadata;
+          result.add(makeMemberDispatch<
+                     typename metadata::type_class,
+                     typename descriptor::type>(
+              memberName<typename metadata::name>(), metadata::id::value));
+        });
+    return result;
+  }();
+  return table;
+}
+
+inline CompactPathResult encodeMember(
+    const MemberDispatchTable& table,
+    PathIter begin,
+    PathIter end,
+    CompactPathWriter& out,
+    CompactPathResult notFound) {
+  if (begin == end) {
+    return CompactPathResult::OK;
+  }
+  const auto* member = table.findByName(*begin++);
+  if (!member) {
+    return notFound;
+  }
+  out.writeSigned(member->id);
+  return member->encode(begin, end, out);
+}
+
+inline CompactPathResult decodeMember(
+    const MemberDispatchTable& table,
+    CompactPathReader& in,
+    std::vector<std::string>& out,
+    CompactPathResult notFound) {
+  if (in.empty()) {
+    return CompactPathResult::OK;
+  }
+  auto id = in.readSigned();
+  if (!id) {
+    return CompactPathResult::MALFORMED;
+  }
+  const auto* member = table.findById(*id);
+  if (!member) {
+    return notFound;
+  }
+  out.push_back(member->name);
+  return member->decode(in, out);
+}
+
+template <typename KeyTC, typename KeyT>
+CompactPathResult encodeKey(const std::string& token, CompactPathWriter& out) {
+  if constexpr (std::is_same_v<
+                    KeyTC,
+                    apache::thrift::type_class::enumeration>) {
+    KeyT value;
+    if (!fatal::enum_traits<KeyT>::try_parse(value, token)) {
+      auto parsed = folly::tryTo<std::underlying_type_t<KeyT>>(token);
+      if (parsed.hasError()) {
+        return CompactPathResult::INVALID_MAP_KEY;
+      }
+      value = static_cast<KeyT>(parsed.value());
+    }
+    out.writeSigned(static_cast<int64_t>(value));
+    return CompactPathResult::OK;
+  } else if constexpr (std::is_same_v<
+                           KeyTC,
+                           apache::thrift::type_class::integral>) {
+    auto parsed = folly::tryTo<KeyT>(token);
+    if (parsed.hasError()) {
+      return CompactPathResult::INVALID_MAP_KEY;
+    }
+    out.writeSigned(static_cast<int64_t>(parsed.value()));
+    return CompactPathResult::OK;
+  } else if constexpr (
+      std::is_same_v<KeyTC, apache::thrift::type_class::string> ||
+      std::is_same_v<KeyTC, apache::thrift::type_class::binary>) {
+    out.writeBytes(token);
+    return CompactPathResult::OK;
+  } else {
+    return CompactPathResult::UNSUPPORTED_KEY_TYPE;
+  }
+}
+
+template <typename KeyTC, typename KeyT>
+CompactPathResult decodeKey(
+    CompactPathReader& in,
+    std::vector<std::string>& out) {
+  if constexpr (
+      std::is_same_v<KeyTC, apache::thrift::type_class::enumeration> ||
+      std::is_same_v<KeyTC, apache::thrift::type_class::integral>) {
+    auto value = in.readSigned();
+    if (!value) {
+      return CompactPathResult::MALFORMED;
+    }
+    // same form as DeltaVisitor emits for these keys
+    if constexpr (std::is_same_v<KeyT, bool>) {
+      out.push_back(folly::to<std::string>(*value != 0));
+    } else {
+      out.push_back(folly::to<std::string>(*value));
+    }
+    return CompactPathResult::OK;
+  } else if constexpr (
+      std::is_same_v<KeyTC, apache::thrift::type_class::string> ||
+      std::is_same_v<KeyTC, apache::thrift::type_class::binary>) {
+    auto bytes = in.readBytes();
+    if (!bytes) {
+      return CompactPathResult::MALFORMED;
+    }
+    out.emplace_back(bytes->begin(), bytes->end());
+    return CompactPathResult::OK;
+  } else {
+    return CompactPathResult::UNSUPPORTED_KEY_TYPE;
+  }
+}
+
+} // namespace cpc_detail
+
+/**
+ * Set
+ */
+template <typename ValueTypeClass>
+struct CompactPathCodec<apache::thrift::type_class::set<ValueTypeClass>> {
+  template <typename TType>
+  static CompactPathResult encode(
+      cpc_detail::PathIter begin,
+      cpc_detail::PathIter end,
+      CompactPathWriter& out) {
+    using ValueT = typename TType::value_type;
+    if (begin == end) {
+      return CompactPathResult::OK;
+    }
+    auto result =
+        cpc_detail::encodeKey<ValueTypeClass, ValueT>(*begin++, out);
+    if (result != CompactPathResult::OK) {
+      return result;
+    }
+    return CompactPathCodec<ValueTypeClass>::template encode<ValueT>(
+        begin, end, out);
+  }
+
+  template <typename TType>
+  static CompactPathResult decode(
+      CompactPathReader& in,
+      std::vector<std::string>& out) {
+    using ValueT = typename TType::value_type;
+    if (in.empty()) {
+      return CompactPathResult::OK;
+    }
+    auto result = cpc_detail::decodeKey<ValueTypeClass, ValueT>(in, out);
+    if (result != CompactPathResult::OK) {
+      return result;
+    }
+    return CompactPathCodec<ValueTypeClass>::template decode<ValueT>(in, out);
+  }
+};
+
+/**
+ * List
+ */
+template <typename ValueTypeClass>
+struct CompactPathCodec<apache::thrift::type_class::list<ValueTypeClass>> {
+  template <typename TType>
+  static CompactPathResult encode(
+      cpc_detail::PathIter begin,
+      cpc_detail::PathIter end,
+      CompactPathWriter& out) {
+    using ValueT = typename TType::value_type;
+    if (begin == end) {
+      return CompactPathResult::OK;
+    }
+    auto index = folly::tryTo<uint32_t>(*begin++);
+    if (index.hasError()) {
+      return CompactPathResult::INVALID_ARRAY_INDEX;
+    }
+    out.writeVarint(index.value());
+    return CompactPathCodec<ValueTypeClass>::template encode<ValueT>(
+        begin, end, out);
+  }
+
+  template <typename TType>
+  static CompactPathResult decode(
+      CompactPathReader& in,
+      std::vector<std::string>& out) {
+    using ValueT = typename TType::value_type;
+    if (in.empty()) {
+      return CompactPathResult::OK;
+    }
+    auto index = in.readVarint();
+    if (!index) {
+      return CompactPathResult::MALFORMED;
+    }
+    out.push_back(folly::to<std::string>(*index));
+    return CompactPathCodec<ValueTypeClass>::template decode<ValueT>(in, out);
+  }
+};
+
+/**
+ * Map
+ */
+template <typename KeyTypeClass, typename MappedTypeClass>
+struct CompactPathCodec<
+    apache::thrift::type_class::map<KeyTypeClass, MappedTypeClass>> {
+  template <typename TType>
+  static CompactPathResult encode(
+      cpc_detail::PathIter begin,
+      cpc_detail::PathIter end,
+      CompactPathWriter& out) {
+    using KeyT = typename TType::key_type;
+    using MappedT = typename TType::mapped_type;
+    if (begin == end) {
+      return CompactPathResult::OK;
+    }
+    auto result = cpc_detail::encodeKey<KeyTypeClass, KeyT>(*begin++, out);
+    if (result != CompactPathResult::OK) {
+      return result;
+    }
+    return CompactPathCodec<MappedTypeClass>::template encode<MappedT>(
+        begin, end, out);
+  }
+
+  template <typename TType>
+  static CompactPathResult decode(
+      CompactPathReader& in,
+      std::vector<std::string>& out) {
+    using KeyT = typename TType::key_type;
+    using MappedT = typename TType::mapped_type;
+    if (in.empty()) {
+      return CompactPathResult::OK;
+    }
+    auto result = cpc_detail::decodeKey<KeyTypeClass, KeyT>(in, out);
+    if (result != CompactPathResult::OK) {
+      return result;
+    }
+    return CompactPathCodec<MappedTypeClass>::template decode<MappedT>(
+        in, out);
+  }
+};
+
+/**
+ * Variant
+ */
+template <>
+struct CompactPathCodec<apache::thrift::type_class::variant> {
+  template <typename TType>
+  static CompactPathResult encode(
+      cpc_detail::PathIter begin,
+      cpc_detail::PathIter end,
+      CompactPathWriter& out) {
+    return cpc_detail::encodeMember(
+        cpc_detail::variantDispatchTable<TType>(),
+        begin,
+        end,
+        out,
+        CompactPathResult::INVALID_VARIANT_MEMBER);
+  }
+
+  template <typename TType>
+  static CompactPathResult decode(
+      CompactPathReader& in,
+      std::vector<std::string>& out) {
+    return cpc_detail::decodeMember(
+        cpc_detail::variantDispatchTable<TType>(),
+        in,
+        out,
+        CompactPathResult::INVALID_VARIANT_MEMBER);
+  }
+};
+
+/**
+ * Structure
+ */
+template <>
+struct CompactPathCodec<apache::thrift::type_class::structure> {
+  template <typename TType>
+  static CompactPathResult encode(
+      cpc_detail::PathIter begin,
+      cpc_detail::PathIter end,
+      CompactPathWriter& out) {
+    return cpc_detail::encodeMember(
+        cpc_detail::structDispatchTable<TType>(),
+        begin,
+        end,
+        out,
+        CompactPathResult::INVALID_STRUCT_MEMBER);
+  }
+
+  template <typename TType>
+  static CompactPathResult decode(
+      CompactPathReader& in,
+      std::vector<std::string>& out) {
+    return cpc_detail::decodeMember(
+        cpc_detail::structDispatchTable<TType>(),
+        in,
+        out,
+        CompactPathResult::INVALID_STRUCT_MEMBER);
+  }
+};
+
+/**
+ * Primitives - fallback specialization
+ * - string / binary
+ * - floating_point
+ * - integral
+ * - enumeration
+ */
+template <typename TC>
+struct CompactPathCodec {
+  static_assert(
+      !std::is_same<apache::thrift::type_class::unknown, TC>::value,
+      "No static reflection support for the given type. "
+      "Forgot to specify reflection option or include fatal header file? "
+      "Refer to thrift/lib/cpp2/reflection/reflection.h");
+
+  template <typename TType>
+  static CompactPathResult encode(
+      cpc_detail::PathIter begin,
+      cpc_detail::PathIter end,
+      CompactPathWriter& /* out */) {
+    return begin == end ? CompactPathResult::OK
+                        : CompactPathResult::INVALID_PATH;
+  }
+
+  template <typename TType>
+  static CompactPathResult decode(
+      CompactPathReader& /* in */,
+      std::vector<std::string>& /* out */) {
+    // trailing elements are detected by decodeCompactPath
+    return CompactPathResult::OK;
+  }
+};
+
+template <typename Root>
+CompactPathResult encodeCompactPath(
+    std::vector<std::string>::const_iterator begin,
+    std::vector<std::string>::const_iterator end,
+    folly::fbstring& out) {
+  using RootCodec = CompactPathCodec<apache::thrift::type_class::structure>;
+  CompactPathWriter writer;
+  auto result = RootCodec::template encode<Root>(begin, end, writer);
+  if (result == CompactPathResult::OK) {
+    out = std::move(writer.data());
+  }
+  return result;
+}
+
+template <typename Root>
+CompactPathResult decodeCompactPath(
+    const folly::fbstring& compact,
+    std::vector<std::string>& out) {
+  using RootCodec = CompactPathCodec<apache::thrift::type_class::structure>;
+  CompactPathReader reader(folly::ByteRange(folly::StringPiece(compact)));
+  auto result = RootCodec::template decode<Root>(reader, out);
+  if (result == CompactPathResult::OK && !reader.empty()) {
+    return CompactPathResult::MALFORMED;
+  }
+  return result;
+}
+
+/*
+ * Rewrite the raw unit paths of a delta published under basePath into
+ * compact paths relative to basePath, where Root is the type at basePath.
+ * Units that cannot be encoded are left in raw form.
+ */
+template <typename Root>
+void compactDeltaPaths(
+    OperDelta& delta,
+    const std::vector<std::string>& basePath) {
+  for (auto& unit : *delta.changes()) {
+    const auto& rawPath = *unit.path()->raw();
+    if (rawPath.size() < basePath.size() ||
+        !std::equal(basePath.begin(), basePath.end(), rawPath.begin())) {
+      continue;
+    }
+    folly::fbstring compact;
+    if (encodeCompactPath<Root>(
+            rawPath.begin() + basePath.size(), rawPath.end(), compact) ==
+        CompactPathResult::OK) {
+      unit.compactPath() = std::move(compact);
+      unit.path()->raw()->clear();
+    }
+  }
+}
+
+/*
+ * Inverse of compactDeltaPaths, for receivers that need raw paths. Returns
+ * the first decoding error, in which case the delta is partially expanded.
+ */
+template <typename Root>
+CompactPathResult expandDeltaPaths(
+    OperDelta& delta,
+    const std::vector<std::string>& basePath) {
+  for (auto& unit : *delta.changes()) {
+    if (!unit.compactPath()) {
+      continue;
+    }
+    std::vector<std::string> rawPath = basePath;
+    auto result = decodeCompactPath<Root>(*unit.compactPath(), rawPath);
+    if (result != CompactPathResult::OK) {
+      return result;
+    }
+    unit.path()->raw() = std::move(rawPath);
+    unit.compactPath().reset();
+  }
+  return CompactPathResult::OK;
+}
+
+} // namespace facebook::fboss::fsdb
@@ -0,0 +1,325 @@
+// (c) Facebook, Inc. and its affiliates. Confidential and proprietary.
+
+#pragma once
+
+#include <fboss/thrift_cow/nodes/Types.h>
+#include <fboss/thrift_cow/visitors/PathVisitor.h>
+#include <fboss/thrift_storage/visitors/CompactPathCodec.h>
+#include <folly/container/F14Map.h>
+
+#include <memory>
+#include <optional>
+#include <type_traits>
+
+namespace facebook::fboss::fsdb {
+
+/*
+ * CompactPathVisitor applies a compact path (see CompactPathCodec) directly
+ * to a thrift_cow tree. Struct and union members are resolved by field id
+ * through a dispatch table built once per node type, map/set keys and list
+ * indices are read straight into their native types. No path tokens are
+ * materialized, so the receiver never resolves a member name or parses a
+ * stringified key.
+ *
+ * Nodes along the path are made writable the same way
+ * ThriftStructNode::modifyPath does: published children are cloned and
+ * missing ones default constructed.
+ */
+
+struct CompactPathOp {
+  // set the node at the path from this encoded value, remove it if null
+  const folly::fbstring* encoded{nullptr};
+  OperProtocol protocol{OperProtocol::BINARY};
+
+  bool isRemove() const {
+    return encoded == nullptr;
+  }
+};
+
+template <typename TC>
+struct CompactPathVisitor;
+
+namespace cpv_detail {
+
+using thrift_cow::ThriftTraverseResult;
+
+template <typename T>
+struct IsChildNode : std::false_type {};
+
+template <typename T>
+struct IsChildNode<std::shared_ptr<T>> : std::true_type {};
+
+/*
+ * Visit child of a container once it has been made writable. Child is
+ * either std::shared_ptr<Node> or std::optional<ThriftPrimitiveNode>.
+ */
+template <typename ChildTC, typename Child>
+ThriftTraverseResult visitChild(
+    Child& child,
+    CompactPathReader& in,
+    const CompactPathOp& op) {
+  if (in.empty()) {
+    child->fromEncoded(op.protocol, *op.encoded);
+    return ThriftTraverseResult::OK;
+  }
+  if constexpr (IsChildNode<std::decay_t<Child>>::value) {
+    return CompactPathVisitor<ChildTC>::visit(*child, in, op);
+  } else {
+    // path continues past a primitive
+    return ThriftTraverseResult::NON_EXISTENT_NODE;
+  }
+}
+
+template <typename Node>
+using MemberFn =
+    ThriftTraverseResult (*)(Node&, CompactPathReader&, const CompactPathOp&);
+
+template <typename Node>
+using MemberTable = folly::F14FastMap<int64_t, MemberFn<Node>>;
+
+template <typename Node, typename Name, typename ChildTC>
+ThriftTraverseResult
+visitMember(Node& node, CompactPathReader& in, const CompactPathOp& op) {
+  if (in.empty() && op.isRemove()) {
+    node.template remove<Name>();
+    return ThriftTraverseResult::OK;
+  }
+  node.template modify<Name>();
+  return visitChild<ChildTC>(node.template ref<Name>(), in, op);
+}
+
+template <typename Node>
+const MemberTable<Node>& structMemberTable() {
+  static const MemberTable<Node> table = [] {
+    MemberTable<Node> result;
+    fatal::foreach<typename Node::Fields::Members>([&](auto tag) {
+      using member = decltype(fatal::tag_type(tag));
+      result.emplace(
+          member::id::value,
+          &visitMember<
+              Node,
+              typename member::name,
+              typename member::type_class>);
+    });
+    return result;
+  }();
+  return table;
+}
+
+template <typename Node>
+const MemberTable<Node>& variantMemberTable() {
+  static const MemberTable<Node> table = [] {
+    MemberTable<Node> result;
+    fatal::foreach<typename Node::Fields::Members>([&](auto tag) {
+      using metadata =
+          typename decltype(fatal::tag_type(tag))::metadata;
+      result.emplace(
+          metadata::id::value,
+          &visitMember<
+              Node,
+              typename metadata::name,
+              typename metadata::type_class>);
+    });
+    return result;
+  }();
+  return table;
+}
+
+template <typename Node>
+ThriftTraverseResult visitMemberById(
+    Node& node,
+    const MemberTable<Node>& table,
+    CompactPathReader& in,
+    const CompactPathOp& op,
+    ThriftTraverseResult notFound) {
+  auto id = in.readSigned();
+  if (!id) {
+    return notFound;
+  }
+  auto it = table.find(*id);
+  if (it == table.end()) {
+    return notFound;
+  }
+  return it->second(node, in, op);
+}
+
+template <typename KeyTC, typename KeyT>
+std::optional<KeyT> readKey(CompactPathReader& in) {
+  if constexpr (
+      std::is_same_v<KeyTC, apache::thrift::type_class::enumeration> ||
+      std::is_same_v<KeyTC, apache::thrift::type_class::integral>) {
+    auto value = in.readSigned();
+    if (!value) {
+      return std::nullopt;
+    }
+    return static_cast<KeyT>(*value);
+  } else if constexpr (
+      std::is_same_v<KeyTC, apache::thrift::type_class::string> ||
+      std::is_same_v<KeyTC, apache::thrift::type_class::binary>) {
+    auto bytes = in.readBytes();
+    if (!bytes) {
+      return std::nullopt;
+    }
+    return KeyT(bytes->begin(), bytes->end());
+  } else {
+    // see CompactPathResult::UNSUPPORTED_KEY_TYPE
+    return std::nullopt;
+  }
+}
+
+} // namespace cpv_detail
+
+/**
+ * Set
+ */
+template <typename ValueTypeClass>
+struct CompactPathVisitor<apache::thrift::type_class::set<ValueTypeClass>> {
+  template <typename Node>
+  static thrift_cow::ThriftTraverseResult
+  visit(Node& node, CompactPathReader& in, const CompactPathOp& op) {
+    using ValueTType = typename Node::ValueTType;
+    auto value = cpv_detail::readKey<ValueTypeClass, ValueTType>(in);
+    if (!value) {
+      return thrift_cow::ThriftTraverseResult::INVALID_SET_MEMBER;
+    }
+    if (!in.empty()) {
+      // set members are primitives
+      return thrift_cow::ThriftTraverseResult::NON_EXISTENT_NODE;
+    }
+    if (op.isRemove()) {
+      if constexpr (std::is_same_v<
+                        ValueTypeClass,
+                        apache::thrift::type_class::string>) {
+        node.remove(*value);
+      } else {
+        node.template remove<typename Node::Fields>(*value);
+      }
+    } else {
+      // the value of a set member is its key
+      node.modifyImpl(*value);
+    }
+    return thrift_cow::ThriftTraverseResult::OK;
+  }
+};
+
+/**
+ * List
+ */
+template <typename ValueTypeClass>
+struct CompactPathVisitor<apache::thrift::type_class::list<ValueTypeClass>> {
+  template <typename Node>
+  static thrift_cow::ThriftTraverseResult
+  visit(Node& node, CompactPathReader& in, const CompactPathOp& op) {
+    auto index = in.readVarint();
+    if (!index) {
+      return thrift_cow::ThriftTraverseResult::INVALID_ARRAY_INDEX;
+    }
+    if (in.empty() && op.isRemove()) {
+      node.remove(static_cast<std::size_t>(*index));
+      return thrift_cow::ThriftTraverseResult::OK;
+    }
+    node.modify(static_cast<std::size_t>(*index));
+    return cpv_detail::visitChild<ValueTypeClass>(
+        node.ref(*index), in, op);
+  }
+};
+
+/**
+ * Map
+ */
+template <typename KeyTypeClass, typename MappedTypeClass>
+struct CompactPathVisitor<
+    apache::thrift::type_class::map<KeyTypeClass, MappedTypeClass>> {
+  template <typename Node>
+  static thrift_cow::ThriftTraverseResult
+  visit(Node& node, CompactPathReader& in, const CompactPathOp& op) {
+    using KeyT = typename Node::key_type;
+    auto key = cpv_detail::readKey<KeyTypeClass, KeyT>(in);
+    if (!key) {
+      return thrift_cow::ThriftTraverseResult::INVALID_MAP_KEY;
+    }
+    if (in.empty() && op.isRemove()) {
+      if constexpr (std::is_same_v<
+                        KeyTypeClass,
+                        apache::thrift::type_class::string>) {
+        node.remove(*key);
+      } else {
+        node.template remove<typename Node::Fields>(*key);
+      }
+      return thrift_cow::ThriftTraverseResult::OK;
+    }
+    node.modifyImpl(*key);
+    return cpv_detail::visitChild<MappedTypeClass>(node.ref(*key), in, op);
+  }
+};
+
+/**
+ * Variant
+ */
+template <>
+struct CompactPathVisitor<apache::thrift::type_class::variant> {
+  template <typename Node>
+  static thrift_cow::ThriftTraverseResult
+  visit(Node& node, CompactPathReader& in, const CompactPathOp& op) {
+    return cpv_detail::visitMemberById(
+        node,
+        cpv_detail::variantMemberTable<Node>(),
+        in,
+        op,
+        thrift_cow::ThriftTraverseResult::INVALID_VARIANT_MEMBER);
+  }
+};
+
+/**
+ * Structure
+ */
+template <>
+struct CompactPathVisitor<apache::thrift::type_class::structure> {
+  template <typename Node>
+  static thrift_cow::ThriftTraverseResult
+  visit(Node& node, CompactPathReader& in, const CompactPathOp& op) {
+    return cpv_detail::visitMemberById(
+        node,
+        cpv_detail::structMemberTable<Node>(),
+        in,
+        op,
+        thrift_cow::ThriftTraverseResult::INVALID_STRUCT_MEMBER);
+  }
+};
+
+/*
+ * Set or remove the node at compactPath below root, cloning root first if
+ * it is published. Root is only replaced if the whole path applied.
+ */
+template <typename Root>
+thrift_cow::ThriftTraverseResult applyCompactPath(
+    std::shared_ptr<thrift_cow::ThriftStructNode<Root>>* root,
+    const folly::fbstring& compactPath,
+    const CompactPathOp& op) {
+  using thrift_cow::ThriftTraverseResult;
+  CompactPathReader in(folly::ByteRange(folly::StringPiece(compactPath)));
+  if (in.empty() && op.isRemove()) {
+    // same as removePath, removing the root is a no-op
+    return ThriftTraverseResult::OK;
+  }
+
+  auto newRoot = ((*root)->isPublished()) ? (*root)->clone() : *root;
+  auto result = ThriftTraverseResult::OK;
+  try {
+    if (in.empty()) {
+      newRoot->fromEncoded(op.protocol, *op.encoded);
+    } else {
+      result = CompactPathVisitor<apache::thrift::type_class::structure>::visit(
+          *newRoot, in, op);
+    }
+  } catch (const std::exception&) {
+    result = ThriftTraverseResult::VISITOR_EXCEPTION;
+  }
+
+  if (result == ThriftTraverseResult::OK && newRoot.get() != root->get()) {
+    root->swap(newRoot);
+  }
+  return result;
+}
+
+} // namespace facebook::fboss::fsdb